@@ -0,0 +1,311 @@
+#include "lyricParser.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+
+using namespace std;
+
+namespace lyric {
+
+    namespace {
+
+        const int64_t MERGE_THRESHOLD_MS = 100;
+        const int64_t MAX_NUMBER = INT64_MAX / 10 - 10;
+
+        inline bool isDigit(char16_t c) {
+            return c >= u'0' && c <= u'9';
+        }
+
+        // 与 java.util.regex 中的 \s 一致
+        inline bool isSpace(char16_t c) {
+            return c == u' ' || c == u'\t' || c == u'\n' || c == u'\x0B' || c == u'\f' ||
+                   c == u'\r';
+        }
+
+        /**
+         * 读取从 pos 开始的连续数字，返回数字个数，value 为其数值（溢出时截断）
+         */
+        size_t readNumber(const char16_t *data, size_t pos, size_t end, int64_t &value) {
+            size_t count = 0;
+            value = 0;
+            while (pos + count < end && isDigit(data[pos + count])) {
+                if (value < MAX_NUMBER) value = value * 10 + (data[pos + count] - u'0');
+                count++;
+            }
+            return count;
+        }
+
+        /**
+         * 匹配 [mm:ss.x{1,5}] 格式的时间标签，成功时返回标签结束位置，失败返回 0
+         */
+        size_t matchLrcTag(const char16_t *data, size_t pos, size_t end, int64_t &time) {
+            if (end - pos < 8 || data[pos] != u'[') return 0;
+            if (!isDigit(data[pos + 1]) || !isDigit(data[pos + 2]) || data[pos + 3] != u':' ||
+                !isDigit(data[pos + 4]) || !isDigit(data[pos + 5]) || data[pos + 6] != u'.')
+                return 0;
+
+            int64_t mil = 0;
+            size_t digits = readNumber(data, pos + 7, end, mil);
+            size_t tagEnd = pos + 7 + digits;
+            if (digits < 1 || digits > 5 || tagEnd >= end || data[tagEnd] != u']') return 0;
+
+            // 毫秒位数不固定，统一换算为三位
+            switch (digits) {
+                case 1: mil *= 100; break;
+                case 2: mil *= 10; break;
+                case 4: mil /= 10; break;
+                case 5: mil /= 100; break;
+                default: break;
+            }
+
+            int64_t min = (data[pos + 1] - u'0') * 10 + (data[pos + 2] - u'0');
+            int64_t sec = (data[pos + 4] - u'0') * 10 + (data[pos + 5] - u'0');
+            time = min * 60 * 1000 + sec * 1000 + mil;
+            return tagEnd + 1;
+        }
+
+        /**
+         * 匹配 open(\d+),\s?(\d+)close 格式的 QRC 时间标签，成功时返回标签结束位置，失败返回 0
+         */
+        size_t matchQrcTag(const char16_t *data, size_t pos, size_t end, char16_t open,
+                           char16_t close, int64_t &start, int64_t &duration) {
+            if (data[pos] != open) return 0;
+
+            size_t cur = pos + 1;
+            size_t digits = readNumber(data, cur, end, start);
+            if (digits == 0) return 0;
+            cur += digits;
+
+            if (cur >= end || data[cur] != u',') return 0;
+            cur++;
+            if (cur < end && isSpace(data[cur])) cur++;
+
+            digits = readNumber(data, cur, end, duration);
+            if (digits == 0) return 0;
+            cur += digits;
+
+            if (cur >= end || data[cur] != close) return 0;
+            return cur + 1;
+        }
+
+        /**
+         * 按 \r\n、\n、\r 切分行，对每行调用 fn(begin, end)
+         */
+        template<typename Fn>
+        void forEachLine(const char16_t *data, size_t length, Fn fn) {
+            size_t begin = 0;
+            for (size_t i = 0; i < length; i++) {
+                if (data[i] != u'\n' && data[i] != u'\r') continue;
+                fn(begin, i);
+                if (data[i] == u'\r' && i + 1 < length && data[i + 1] == u'\n') i++;
+                begin = i + 1;
+            }
+            fn(begin, length);
+        }
+
+        void appendLine(Timeline &timeline, int64_t start, int64_t duration) {
+            timeline.lineStart.push_back(start);
+            timeline.lineDuration.push_back(duration);
+            timeline.lineTextOffset.push_back(static_cast<int32_t>(timeline.text.size()));
+            timeline.lineWordOffset.push_back(static_cast<int32_t>(timeline.wordStart.size()));
+        }
+
+        void appendTime(u16string &out, int64_t time) {
+            int64_t minutes = time / 1000 / 60;
+            int64_t seconds = time / 1000 % 60;
+            int64_t milliseconds = time % 1000;
+
+            char buffer[32];
+            int length = snprintf(buffer, sizeof(buffer), "[%02lld:%02lld.%03lld]",
+                                  static_cast<long long>(minutes),
+                                  static_cast<long long>(seconds),
+                                  static_cast<long long>(milliseconds));
+            for (int i = 0; i < length; i++) out.push_back(static_cast<char16_t>(buffer[i]));
+        }
+
+        /**
+         * 将 source 的第 index 行（含其逐字）追加到 target 末尾，start 为该行新的开始时间
+         */
+        void copyLine(Timeline &target, const Timeline &source, size_t index, int64_t start) {
+            size_t wordBegin = source.lineWordOffset[index];
+            size_t wordEnd = source.lineWordOffset[index + 1];
+            int32_t textShift = static_cast<int32_t>(target.text.size()) -
+                                source.lineTextOffset[index];
+
+            for (size_t w = wordBegin; w < wordEnd; w++) {
+                target.wordStart.push_back(source.wordStart[w]);
+                target.wordDuration.push_back(source.wordDuration[w]);
+                target.wordTextOffset.push_back(source.wordTextOffset[w] + textShift);
+                target.wordTextLength.push_back(source.wordTextLength[w]);
+            }
+            target.text.append(source.text,
+                               source.lineTextOffset[index],
+                               source.lineTextOffset[index + 1] - source.lineTextOffset[index]);
+            appendLine(target, start, source.lineDuration[index]);
+        }
+    }
+
+    Timeline parseQrc(const char16_t *data, size_t length) {
+        Timeline timeline;
+
+        forEachLine(data, length, [&](size_t begin, size_t end) {
+            // 查找开头的时间标签
+            int64_t lineStart = 0, lineDuration = 0;
+            size_t pos = begin;
+            size_t sentence = 0;
+            for (; pos < end && sentence == 0; pos++) {
+                sentence = matchQrcTag(data, pos, end, u'[', u']', lineStart, lineDuration);
+            }
+            if (sentence == 0) return;
+
+            // 查找句子里的时间标签，两个标签之间的非空文本即为一个字
+            size_t wordCount = timeline.wordStart.size();
+            size_t textBegin = sentence;
+            for (pos = sentence; pos < end; pos++) {
+                int64_t wordStart = 0, wordDuration = 0;
+                size_t tagEnd = matchQrcTag(data, pos, end, u'(', u')', wordStart, wordDuration);
+                if (tagEnd == 0) continue;
+
+                if (pos > textBegin) {
+                    timeline.wordStart.push_back(wordStart);
+                    timeline.wordDuration.push_back(wordDuration);
+                    timeline.wordTextOffset.push_back(static_cast<int32_t>(timeline.text.size()));
+                    timeline.wordTextLength.push_back(static_cast<int32_t>(pos - textBegin));
+                    timeline.text.append(data + textBegin, pos - textBegin);
+                }
+                textBegin = tagEnd;
+                pos = tagEnd - 1;
+            }
+
+            // 没有逐字的行直接跳过
+            if (timeline.wordStart.size() == wordCount) return;
+            appendLine(timeline, lineStart, lineDuration);
+        });
+
+        return timeline;
+    }
+
+    Timeline parseLrc(const char16_t *data, size_t length) {
+        Timeline timeline;
+
+        forEachLine(data, length, [&](size_t begin, size_t end) {
+            int64_t time = 0;
+            size_t content = 0;
+            for (size_t pos = begin; pos < end && content == 0; pos++) {
+                content = matchLrcTag(data, pos, end, time);
+            }
+            if (content == 0) return;
+
+            // "//" 为空行占位符
+            size_t contentLength = end - content;
+            bool placeholder = contentLength == 2 && data[content] == u'/' &&
+                               data[content + 1] == u'/';
+            if (!placeholder) timeline.text.append(data + content, contentLength);
+            appendLine(timeline, time, 0);
+        });
+
+        return timeline;
+    }
+
+    Timeline mergeTranslation(const Timeline &lyric, const Timeline &translation) {
+        size_t lyricCount = lyric.lineCount();
+        size_t transCount = translation.lineCount();
+
+        // 歌词行按时间排序的索引，用于二分查找与翻译时间最接近的一行
+        vector<size_t> byTime(lyricCount);
+        iota(byTime.begin(), byTime.end(), 0);
+        stable_sort(byTime.begin(), byTime.end(), [&](size_t a, size_t b) {
+            return lyric.lineStart[a] < lyric.lineStart[b];
+        });
+        auto firstAtOrAfter = [&](int64_t time) {
+            return lower_bound(byTime.begin(), byTime.end(), time, [&](size_t index, int64_t t) {
+                return lyric.lineStart[index] < t;
+            });
+        };
+
+        vector<int64_t> transStart(translation.lineStart);
+        for (size_t i = 0; i < transCount && lyricCount > 0; i++) {
+            int64_t time = transStart[i];
+            auto next = firstAtOrAfter(time);
+
+            // 距离相同时取原歌词中靠前的一行，与逐个比较的结果保持一致
+            size_t best = lyricCount;
+            if (next != byTime.end()) best = *next;
+            if (next != byTime.begin()) {
+                size_t prev = *firstAtOrAfter(lyric.lineStart[*(next - 1)]);
+                if (best == lyricCount) {
+                    best = prev;
+                } else {
+                    int64_t prevDistance = time - lyric.lineStart[prev];
+                    int64_t nextDistance = lyric.lineStart[best] - time;
+                    if (prevDistance < nextDistance ||
+                        (prevDistance == nextDistance && prev < best)) {
+                        best = prev;
+                    }
+                }
+            }
+
+            int64_t distance = llabs(lyric.lineStart[best] - time);
+            if (distance < MERGE_THRESHOLD_MS) transStart[i] = lyric.lineStart[best];
+        }
+
+        // 歌词在前、翻译在后，按时间稳定排序
+        vector<size_t> order(lyricCount + transCount);
+        iota(order.begin(), order.end(), 0);
+        auto startOf = [&](size_t index) {
+            return index < lyricCount ? lyric.lineStart[index] : transStart[index - lyricCount];
+        };
+        stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return startOf(a) < startOf(b);
+        });
+
+        Timeline result;
+        result.text.reserve(lyric.text.size() + translation.text.size());
+        result.lineStart.reserve(order.size());
+        result.lineDuration.reserve(order.size());
+        result.lineTextOffset.reserve(order.size() + 1);
+        result.lineWordOffset.reserve(order.size() + 1);
+        result.wordStart.reserve(lyric.wordCount() + translation.wordCount());
+        result.wordDuration.reserve(lyric.wordCount() + translation.wordCount());
+        result.wordTextOffset.reserve(lyric.wordCount() + translation.wordCount());
+        result.wordTextLength.reserve(lyric.wordCount() + translation.wordCount());
+
+        for (size_t index: order) {
+            if (index < lyricCount) {
+                copyLine(result, lyric, index, lyric.lineStart[index]);
+            } else {
+                copyLine(result, translation, index - lyricCount, transStart[index - lyricCount]);
+            }
+        }
+        return result;
+    }
+
+    u16string toLrc(const Timeline &timeline) {
+        u16string out;
+        out.reserve(timeline.text.size() + timeline.lineCount() * 12 + timeline.wordCount() * 11);
+
+        for (size_t i = 0; i < timeline.lineCount(); i++) {
+            if (i > 0) out.push_back(u'\n');
+            appendTime(out, timeline.lineStart[i]);
+
+            size_t wordBegin = timeline.lineWordOffset[i];
+            size_t wordEnd = timeline.lineWordOffset[i + 1];
+            if (wordBegin == wordEnd) {
+                out.append(timeline.text,
+                           timeline.lineTextOffset[i],
+                           timeline.lineTextOffset[i + 1] - timeline.lineTextOffset[i]);
+                continue;
+            }
+
+            // 逐字行：每个字后跟随其结束时间
+            for (size_t w = wordBegin; w < wordEnd; w++) {
+                out.append(timeline.text, timeline.wordTextOffset[w], timeline.wordTextLength[w]);
+                appendTime(out, timeline.wordStart[w] + timeline.wordDuration[w]);
+            }
+        }
+        return out;
+    }
+
+}
@@ -0,0 +1,65 @@
+#ifndef LYRIC_PARSER_H
+#define LYRIC_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lyric {
+
+    /**
+     * 以数组结构（struct-of-arrays）存储的歌词时间轴
+     *
+     * 所有行与逐字的文本都顺序存放在同一个 UTF-16 缓冲区 text 中，
+     * 第 i 行的文本为 text[lineTextOffset[i], lineTextOffset[i + 1])，
+     * 其逐字为 [lineWordOffset[i], lineWordOffset[i + 1])，
+     * 第 j 个字的文本为 text[wordTextOffset[j], wordTextOffset[j] + wordTextLength[j])。
+     * 行的两个 Offset 数组都比行数多一个结尾哨兵。
+     */
+    struct Timeline {
+        std::u16string text;
+
+        std::vector<int64_t> lineStart;
+        std::vector<int64_t> lineDuration;
+        std::vector<int32_t> lineTextOffset{0};
+        std::vector<int32_t> lineWordOffset{0};
+
+        std::vector<int64_t> wordStart;
+        std::vector<int64_t> wordDuration;
+        std::vector<int32_t> wordTextOffset;
+        std::vector<int32_t> wordTextLength;
+
+        size_t lineCount() const { return lineStart.size(); }
+
+        size_t wordCount() const { return wordStart.size(); }
+
+        bool isEmpty() const { return lineStart.empty(); }
+    };
+
+    /**
+     * 解析 [start,duration]word(start,duration)... 格式的 QRC 逐字歌词，
+     * 没有任何逐字的行会被忽略
+     */
+    Timeline parseQrc(const char16_t *data, size_t length);
+
+    /**
+     * 解析 [mm:ss.xx]content 格式的 LRC 歌词，LRC 行没有逐字及时长，duration 恒为 0
+     */
+    Timeline parseLrc(const char16_t *data, size_t length);
+
+    /**
+     * 将翻译合并进歌词：每句翻译对齐到时间最接近（相差小于 100ms）的歌词行，
+     * 然后按时间稳定排序，同一时间的歌词行排在翻译之前
+     */
+    Timeline mergeTranslation(const Timeline &lyric, const Timeline &translation);
+
+    /**
+     * 序列化为 [mm:ss.xxx]content 的 LRC 文本，逐字行输出为 word[mm:ss.xxx]... 的形式，
+     * 其中每个字后的时间标签为该字的结束时间
+     */
+    std::u16string toLrc(const Timeline &timeline);
+
+}
+
+#endif //LYRIC_PARSER_H
@@ -0,0 +1,94 @@
+
+#include <jni.h>
+#include "lyricParser.h"
+
+using namespace std;
+
+namespace {
+
+    typedef lyric::Timeline (*Parser)(const char16_t *, size_t);
+
+    /**
+     * 直接在 jstring 的 UTF-16 内容上解析，避免转换为 UTF-8
+     */
+    lyric::Timeline parseString(JNIEnv *env, jstring str, Parser parser) {
+        if (str == nullptr) return {};
+
+        auto length = static_cast<size_t>(env->GetStringLength(str));
+        auto chars = env->GetStringChars(str, nullptr);
+        if (chars == nullptr) return {};
+
+        auto timeline = parser(reinterpret_cast<const char16_t *>(chars), length);
+        env->ReleaseStringChars(str, chars);
+        return timeline;
+    }
+
+    jlongArray toLongArray(JNIEnv *env, const vector<int64_t> &values) {
+        auto size = static_cast<jsize>(values.size());
+        jlongArray array = env->NewLongArray(size);
+        env->SetLongArrayRegion(array, 0, size, reinterpret_cast<const jlong *>(values.data()));
+        return array;
+    }
+
+    jintArray toIntArray(JNIEnv *env, const vector<int32_t> &values) {
+        auto size = static_cast<jsize>(values.size());
+        jintArray array = env->NewIntArray(size);
+        env->SetIntArrayRegion(array, 0, size, reinterpret_cast<const jint *>(values.data()));
+        return array;
+    }
+
+    jstring toJString(JNIEnv *env, const u16string &str) {
+        return env->NewString(reinterpret_cast<const jchar *>(str.data()),
+                              static_cast<jsize>(str.size()));
+    }
+
+    jobject toTimeline(JNIEnv *env, const lyric::Timeline &timeline) {
+        if (timeline.isEmpty()) return nullptr;
+
+        jclass timeline_class = env->FindClass("com/lalilu/lmedia/entity/LyricTimeline");
+        jmethodID constructor = env->GetMethodID(timeline_class, "<init>",
+                                                 "(Ljava/lang/String;[J[J[I[I[J[J[I[I)V");
+
+        return env->NewObject(
+                timeline_class,
+                constructor,
+                toJString(env, timeline.text),
+                toLongArray(env, timeline.lineStart),
+                toLongArray(env, timeline.lineDuration),
+                toIntArray(env, timeline.lineTextOffset),
+                toIntArray(env, timeline.lineWordOffset),
+                toLongArray(env, timeline.wordStart),
+                toLongArray(env, timeline.wordDuration),
+                toIntArray(env, timeline.wordTextOffset),
+                toIntArray(env, timeline.wordTextLength)
+        );
+    }
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_lalilu_lmedia_wrapper_LyricParser_parseQrc(JNIEnv *env, jobject thiz, jstring lyric) {
+    return toTimeline(env, parseString(env, lyric, lyric::parseQrc));
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_lalilu_lmedia_wrapper_LyricParser_parseLrc(JNIEnv *env, jobject thiz, jstring lyric) {
+    return toTimeline(env, parseString(env, lyric, lyric::parseLrc));
+}
+
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_lalilu_lmedia_wrapper_LyricParser_toLrc(JNIEnv *env, jobject thiz,
+                                                  jstring lyric,
+                                                  jstring translation) {
+    // 优先按 QRC 逐字歌词解析，失败时回退到 LRC
+    auto timeline = parseString(env, lyric, lyric::parseQrc);
+    if (timeline.isEmpty()) timeline = parseString(env, lyric, lyric::parseLrc);
+
+    auto trans = parseString(env, translation, lyric::parseLrc);
+    if (!trans.isEmpty()) timeline = lyric::mergeTranslation(timeline, trans);
+
+    if (timeline.isEmpty()) return nullptr;
+    return toJString(env, lyric::toLrc(timeline));
+}
@@ -0,0 +1,678 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+/*
+ * taglib-bench: reproducible micro- and macro-benchmarks for TagLib.
+ *
+ * For every input file the following operations are timed:
+ *
+ *   open        FileRef construction without audio properties
+ *   tag         reading the basic Tag fields
+ *   properties  File::properties()
+ *   pictures    File::complexProperties("PICTURE")
+ *   fast        FileRef construction with ReadStyle::Fast audio properties
+ *   average     FileRef construction with ReadStyle::Average audio properties
+ *   accurate    FileRef construction with ReadStyle::Accurate audio properties
+ *   save        File::save() on a scratch copy of the file
+ *
+ * Results are written as JSON, including the number of heap allocations and,
+ * where the platform exposes them (/proc/self/io), read/write syscall counts.
+ * With --arena the files are opened with FileRef::ArenaAllocation.
+ *
+ * With --strings the throughput of the String conversions is measured
+ * instead, on generated ASCII, Latin-1 and CJK heavy tag values:
+ *
+ *   fromUTF8    String construction from UTF-8
+ *   toUTF8      String::to8Bit(true)
+ *   fromUTF16   String construction from UTF-16LE
+ *   toUTF16     String::data(String::UTF16LE)
+ *
+ * Usage: taglib-bench [--iterations N] [--ops op,op,...] [--output FILE]
+ *                     [--arena] [--strings] [FILE|DIRECTORY]...
+ *
+ * Without arguments the files in tests/data are used.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "taglib.h"
+#include "tpropertymap.h"
+#include "tstringlist.h"
+#include "tvariant.h"
+#include "fileref.h"
+#include "tag.h"
+#include "tdebuglistener.h"
+
+namespace fs = std::filesystem;
+using namespace std;
+
+// Every heap allocation of the process, including those made inside TagLib,
+// goes through these replacements so that they can be counted.
+
+namespace
+{
+  atomic<unsigned long long> allocationCount(0);
+  atomic<unsigned long long> allocationBytes(0);
+
+  void *countedAlloc(size_t size)
+  {
+    allocationCount.fetch_add(1, memory_order_relaxed);
+    allocationBytes.fetch_add(size, memory_order_relaxed);
+    if(void *p = malloc(size ? size : 1))
+      return p;
+    throw bad_alloc();
+  }
+}
+
+void *operator new(size_t size) { return countedAlloc(size); }
+void *operator new[](size_t size) { return countedAlloc(size); }
+void *operator new(size_t size, const nothrow_t &) noexcept
+{
+  try { return countedAlloc(size); } catch(...) { return nullptr; }
+}
+void *operator new[](size_t size, const nothrow_t &) noexcept
+{
+  try { return countedAlloc(size); } catch(...) { return nullptr; }
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+namespace
+{
+  struct IOCounters
+  {
+    unsigned long long readCalls = 0;
+    unsigned long long writeCalls = 0;
+    unsigned long long readBytes = 0;
+    unsigned long long writeBytes = 0;
+  };
+
+  bool ioCountersAvailable = false;
+
+  // Reads /proc/self/io without allocating, so that sampling does not
+  // disturb the allocation counters.
+  IOCounters sampleIO()
+  {
+    IOCounters c;
+#ifndef _WIN32
+    const int fd = ::open("/proc/self/io", O_RDONLY);
+    if(fd < 0)
+      return c;
+
+    char buffer[512];
+    const ssize_t n = ::read(fd, buffer, sizeof(buffer) - 1);
+    ::close(fd);
+    if(n <= 0)
+      return c;
+    buffer[n] = '\0';
+
+    const auto field = [&buffer](const char *name) -> unsigned long long {
+      const char *p = strstr(buffer, name);
+      return p ? strtoull(p + strlen(name), nullptr, 10) : 0;
+    };
+    c.readBytes  = field("rchar:");
+    c.writeBytes = field("wchar:");
+    c.readCalls  = field("syscr:");
+    c.writeCalls = field("syscw:");
+    ioCountersAvailable = true;
+#endif
+    return c;
+  }
+
+  IOCounters operator-(const IOCounters &a, const IOCounters &b)
+  {
+    IOCounters c;
+    c.readCalls  = a.readCalls  - b.readCalls;
+    c.writeCalls = a.writeCalls - b.writeCalls;
+    c.readBytes  = a.readBytes  - b.readBytes;
+    c.writeBytes = a.writeBytes - b.writeBytes;
+    return c;
+  }
+
+  // The cost of sampling /proc/self/io itself, subtracted from every result.
+  IOCounters sampleOverhead;
+
+  struct Result
+  {
+    string file;
+    string format;
+    string operation;
+    unsigned int iterations = 0;
+    vector<double> nanoseconds;
+    unsigned long long allocations = 0;
+    unsigned long long allocatedBytes = 0;
+    IOCounters io;
+  };
+
+  // A single timed iteration. setup() runs outside of the measured region,
+  // run() inside of it.
+  struct Operation
+  {
+    const char *name;
+    void (*setup)(const string &path, const string &scratch);
+    void (*run)(const string &path, const string &scratch);
+  };
+
+  TagLib::FileRef::AllocationStrategy allocation = TagLib::FileRef::HeapAllocation;
+
+  // Objects shared between setup() and run() of the micro benchmarks.
+  TagLib::FileRef *currentFile = nullptr;
+
+  void resetCurrentFile()
+  {
+    delete currentFile;
+    currentFile = nullptr;
+  }
+
+  void noSetup(const string &, const string &) {}
+
+  void openFileSetup(const string &path, const string &)
+  {
+    resetCurrentFile();
+    currentFile = new TagLib::FileRef(path.c_str(), false, TagLib::AudioProperties::Average,
+                                      allocation);
+  }
+
+  void copyFileSetup(const string &path, const string &scratch)
+  {
+    resetCurrentFile();
+    fs::copy_file(path, scratch, fs::copy_options::overwrite_existing);
+    currentFile = new TagLib::FileRef(scratch.c_str(), false, TagLib::AudioProperties::Average,
+                                      allocation);
+    if(!currentFile->isNull() && currentFile->tag()) {
+      // Alternate the title so that every save has something to write.
+      const TagLib::String title = currentFile->tag()->title();
+      currentFile->tag()->setTitle(title == "taglib-bench" ? "TAGLIB-BENCH" : "taglib-bench");
+    }
+  }
+
+  volatile size_t sink = 0;
+
+  void runOpen(const string &path, const string &)
+  {
+    TagLib::FileRef f(path.c_str(), false, TagLib::AudioProperties::Average, allocation);
+    sink = sink + f.isNull();
+  }
+
+  void runTag(const string &, const string &)
+  {
+    if(const TagLib::Tag *tag = currentFile->tag()) {
+      sink = sink + tag->title().size() + tag->artist().size() + tag->album().size()
+        + tag->comment().size() + tag->genre().size() + tag->year() + tag->track();
+    }
+  }
+
+  void runProperties(const string &, const string &)
+  {
+    sink = sink + currentFile->properties().size();
+  }
+
+  void runPictures(const string &, const string &)
+  {
+    sink = sink + currentFile->complexProperties("PICTURE").size();
+  }
+
+  template <TagLib::AudioProperties::ReadStyle style>
+  void runAudioProperties(const string &path, const string &)
+  {
+    TagLib::FileRef f(path.c_str(), true, style, allocation);
+    if(const TagLib::AudioProperties *p = f.audioProperties())
+      sink = sink + p->lengthInMilliseconds();
+  }
+
+  void runSave(const string &, const string &)
+  {
+    sink = sink + currentFile->save();
+  }
+
+  const Operation operations[] = {
+    { "open",       noSetup,       runOpen },
+    { "tag",        openFileSetup, runTag },
+    { "properties", openFileSetup, runProperties },
+    { "pictures",   openFileSetup, runPictures },
+    { "fast",       noSetup,       runAudioProperties<TagLib::AudioProperties::Fast> },
+    { "average",    noSetup,       runAudioProperties<TagLib::AudioProperties::Average> },
+    { "accurate",   noSetup,       runAudioProperties<TagLib::AudioProperties::Accurate> },
+    { "save",       copyFileSetup, runSave },
+  };
+
+  Result measure(const Operation &op, const string &path, const string &format,
+                 const string &scratch, unsigned int iterations)
+  {
+    Result r;
+    r.file = path;
+    r.format = format;
+    r.operation = op.name;
+    r.iterations = iterations;
+
+    // One untimed warm-up iteration to populate the page cache and any
+    // lazily initialized statics.
+    op.setup(path, scratch);
+    op.run(path, scratch);
+
+    for(unsigned int i = 0; i < iterations; ++i) {
+      op.setup(path, scratch);
+
+      const IOCounters ioBefore = sampleIO();
+      const unsigned long long countBefore = allocationCount.load();
+      const unsigned long long bytesBefore = allocationBytes.load();
+      const auto start = chrono::steady_clock::now();
+
+      op.run(path, scratch);
+
+      const auto end = chrono::steady_clock::now();
+      r.allocations    += allocationCount.load() - countBefore;
+      r.allocatedBytes += allocationBytes.load() - bytesBefore;
+      const IOCounters io = sampleIO() - ioBefore - sampleOverhead;
+      r.io.readCalls  += io.readCalls;
+      r.io.writeCalls += io.writeCalls;
+      r.io.readBytes  += io.readBytes;
+      r.io.writeBytes += io.writeBytes;
+
+      r.nanoseconds.push_back(static_cast<double>(
+        chrono::duration_cast<chrono::nanoseconds>(end - start).count()));
+    }
+
+    resetCurrentFile();
+    return r;
+  }
+
+  string jsonEscape(const string &s)
+  {
+    string out;
+    out.reserve(s.size());
+    for(char c : s) {
+      switch(c) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n";  break;
+      case '\t': out += "\\t";  break;
+      default:
+        if(static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          out += buf;
+        }
+        else {
+          out += c;
+        }
+      }
+    }
+    return out;
+  }
+
+  void writeJson(ostream &out, const vector<Result> &results, unsigned int iterations)
+  {
+    out << "{\n";
+    out << "  \"taglib\": \"" << TAGLIB_MAJOR_VERSION << "." << TAGLIB_MINOR_VERSION
+        << "." << TAGLIB_PATCH_VERSION << "\",\n";
+    out << "  \"iterations\": " << iterations << ",\n";
+    out << "  \"ioCounters\": " << (ioCountersAvailable ? "true" : "false") << ",\n";
+    out << "  \"allocation\": \""
+        << (allocation == TagLib::FileRef::ArenaAllocation ? "arena" : "heap") << "\",\n";
+    out << "  \"results\": [";
+
+    for(size_t i = 0; i < results.size(); ++i) {
+      const Result &r = results[i];
+      vector<double> sorted = r.nanoseconds;
+      sort(sorted.begin(), sorted.end());
+      double total = 0;
+      for(double ns : sorted)
+        total += ns;
+      const double n = sorted.empty() ? 1.0 : static_cast<double>(sorted.size());
+
+      out << (i == 0 ? "\n" : ",\n");
+      out << "    {\"file\": \"" << jsonEscape(r.file) << "\""
+          << ", \"format\": \"" << jsonEscape(r.format) << "\""
+          << ", \"op\": \"" << r.operation << "\""
+          << ", \"iterations\": " << r.iterations
+          << ", \"minNs\": " << static_cast<long long>(sorted.empty() ? 0 : sorted.front())
+          << ", \"medianNs\": " << static_cast<long long>(sorted.empty() ? 0 : sorted[sorted.size() / 2])
+          << ", \"meanNs\": " << static_cast<long long>(total / n)
+          << ", \"allocations\": " << r.allocations / n
+          << ", \"allocatedBytes\": " << r.allocatedBytes / n
+          << ", \"readSyscalls\": " << r.io.readCalls / n
+          << ", \"writeSyscalls\": " << r.io.writeCalls / n
+          << ", \"bytesRead\": " << r.io.readBytes / n
+          << ", \"bytesWritten\": " << r.io.writeBytes / n
+          << "}";
+    }
+    out << "\n  ]\n}\n";
+  }
+
+  void collectFiles(const fs::path &path, vector<string> &files)
+  {
+    error_code ec;
+    if(fs::is_directory(path, ec)) {
+      vector<string> entries;
+      for(const auto &entry : fs::directory_iterator(path, ec)) {
+        if(entry.is_regular_file(ec))
+          entries.push_back(entry.path().string());
+      }
+      sort(entries.begin(), entries.end());
+      files.insert(files.end(), entries.begin(), entries.end());
+    }
+    else if(fs::is_regular_file(path, ec)) {
+      files.push_back(path.string());
+    }
+  }
+
+  string formatOf(const string &path)
+  {
+    string ext = fs::path(path).extension().string();
+    if(!ext.empty())
+      ext.erase(0, 1);
+    transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return tolower(c); });
+    return ext;
+  }
+
+  // String conversion benchmarks.  A corpus is a list of typical tag values
+  // which are converted as a whole in every iteration.
+
+  struct StringCorpus
+  {
+    const char *name;
+    vector<string> utf8;
+    vector<TagLib::ByteVector> utf16;
+    vector<TagLib::String> strings;
+    size_t bytes = 0;
+  };
+
+  struct StringResult
+  {
+    string corpus;
+    string operation;
+    size_t bytes = 0;
+    vector<double> nanoseconds;
+  };
+
+  StringCorpus makeCorpus(const char *name, const vector<const char *> &words)
+  {
+    StringCorpus c;
+    c.name = name;
+
+    // 20000 values of two to seven words, chosen deterministically.
+    unsigned int seed = 1;
+    for(unsigned int i = 0; i < 20000; ++i) {
+      string value;
+      seed = seed * 1103515245 + 12345;
+      const unsigned int count = 2 + (seed >> 16) % 6;
+      for(unsigned int k = 0; k < count; ++k) {
+        seed = seed * 1103515245 + 12345;
+        if(k > 0)
+          value += ' ';
+        value += words[(seed >> 16) % words.size()];
+      }
+
+      const TagLib::String s(value, TagLib::String::UTF8);
+      c.bytes += value.size();
+      c.utf8.push_back(value);
+      c.utf16.push_back(s.data(TagLib::String::UTF16LE));
+      c.strings.push_back(s);
+    }
+    return c;
+  }
+
+  vector<StringCorpus> stringCorpora()
+  {
+    vector<StringCorpus> corpora;
+    corpora.push_back(makeCorpus("ascii", {
+      "The", "Night", "Love", "Song", "of", "Remix", "Live", "Blue", "Radio",
+      "Edit", "Part", "II", "feat.", "Orchestra", "Symphony", "No.", "9", "Dance"
+    }));
+    corpora.push_back(makeCorpus("latin1", {
+      "Caf\xc3\xa9", "M\xc3\xbcnchen", "Se\xc3\xb1or", "Gr\xc3\xbc\xc3\x9f""e", "Ol\xc3\xa1",
+      "Fran\xc3\xa7ois", "Nuit", "\xc3\x89t\xc3\xa9", "Sinfon\xc3\xad""a", "Lied", "und", "de"
+    }));
+    corpora.push_back(makeCorpus("cjk", {
+      "\xe5\xa4\x9c\xe6\x98\x8e\xe3\x81\x91", "\xe6\x9d\xb1\xe4\xba\xac",
+      "\xe9\x9f\xb3\xe6\xa5\xbd", "\xe6\xb5\xb7\xe9\x98\x94\xe5\xa4\xa9\xe7\xa9\xba",
+      "\xe3\x81\x82\xe3\x81\x84", "\xec\x82\xac\xeb\x9e\x91", "\xe5\xa5\xbd",
+      "\xe6\x98\x9f", "\xe3\x83\xa9\xe3\x82\xa4\xe3\x83\x96", "OST", "Vol.2"
+    }));
+    return corpora;
+  }
+
+  template <typename F>
+  StringResult measureStrings(const StringCorpus &c, const char *operation,
+                              unsigned int iterations, F run)
+  {
+    StringResult r;
+    r.corpus = c.name;
+    r.operation = operation;
+    r.bytes = c.bytes;
+
+    run();
+    for(unsigned int i = 0; i < iterations; ++i) {
+      const auto start = chrono::steady_clock::now();
+      run();
+      const auto end = chrono::steady_clock::now();
+      r.nanoseconds.push_back(static_cast<double>(
+        chrono::duration_cast<chrono::nanoseconds>(end - start).count()));
+    }
+    return r;
+  }
+
+  vector<StringResult> runStringBenchmarks(unsigned int iterations, const vector<string> &selected)
+  {
+    const auto wanted = [&selected](const char *name) {
+      return selected.empty() || find(selected.begin(), selected.end(), name) != selected.end();
+    };
+
+    vector<StringResult> results;
+    for(const auto &c : stringCorpora()) {
+      if(wanted("fromUTF8")) {
+        results.push_back(measureStrings(c, "fromUTF8", iterations, [&c] {
+          for(const auto &value : c.utf8)
+            sink = sink + TagLib::String(value, TagLib::String::UTF8).size();
+        }));
+      }
+      if(wanted("toUTF8")) {
+        results.push_back(measureStrings(c, "toUTF8", iterations, [&c] {
+          for(const auto &s : c.strings)
+            sink = sink + s.to8Bit(true).size();
+        }));
+      }
+      if(wanted("fromUTF16")) {
+        results.push_back(measureStrings(c, "fromUTF16", iterations, [&c] {
+          for(const auto &value : c.utf16)
+            sink = sink + TagLib::String(value, TagLib::String::UTF16LE).size();
+        }));
+      }
+      if(wanted("toUTF16")) {
+        results.push_back(measureStrings(c, "toUTF16", iterations, [&c] {
+          for(const auto &s : c.strings)
+            sink = sink + s.data(TagLib::String::UTF16LE).size();
+        }));
+      }
+    }
+    return results;
+  }
+
+  void writeStringJson(ostream &out, const vector<StringResult> &results, unsigned int iterations)
+  {
+    out << "{\n";
+    out << "  \"taglib\": \"" << TAGLIB_MAJOR_VERSION << "." << TAGLIB_MINOR_VERSION
+        << "." << TAGLIB_PATCH_VERSION << "\",\n";
+    out << "  \"iterations\": " << iterations << ",\n";
+    out << "  \"strings\": [";
+
+    for(size_t i = 0; i < results.size(); ++i) {
+      const StringResult &r = results[i];
+      vector<double> sorted = r.nanoseconds;
+      sort(sorted.begin(), sorted.end());
+      const double minNs = sorted.empty() ? 0 : sorted.front();
+      const double medianNs = sorted.empty() ? 0 : sorted[sorted.size() / 2];
+
+      out << (i == 0 ? "\n" : ",\n");
+      out << "    {\"corpus\": \"" << r.corpus << "\""
+          << ", \"op\": \"" << r.operation << "\""
+          << ", \"utf8Bytes\": " << r.bytes
+          << ", \"minNs\": " << static_cast<long long>(minNs)
+          << ", \"medianNs\": " << static_cast<long long>(medianNs)
+          << ", \"mbPerSecond\": " << (minNs > 0 ? r.bytes * 1000.0 / minNs : 0)
+          << "}";
+    }
+    out << "\n  ]\n}\n";
+  }
+
+  // Malformed test files produce debug messages which would otherwise be
+  // mixed into the timings and the output.
+  class SilentListener : public TagLib::DebugListener
+  {
+  public:
+    void printMessage(const TagLib::String &) override {}
+  };
+
+  void usage(const char *argv0)
+  {
+    cerr << "Usage: " << argv0
+         << " [--iterations N] [--ops op,op,...] [--output FILE] [--arena] [--strings]"
+            " [FILE|DIRECTORY]...\n"
+         << "Operations:";
+    for(const auto &op : operations)
+      cerr << " " << op.name;
+    cerr << "\nString operations: fromUTF8 toUTF8 fromUTF16 toUTF16" << endl;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  unsigned int iterations = 20;
+  string outputPath;
+  bool strings = false;
+  vector<string> selected;
+  vector<string> files;
+  bool pathGiven = false;
+
+  for(int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    if(arg == "--iterations" && i + 1 < argc) {
+      iterations = static_cast<unsigned int>(max(1, atoi(argv[++i])));
+    }
+    else if(arg == "--output" && i + 1 < argc) {
+      outputPath = argv[++i];
+    }
+    else if(arg == "--ops" && i + 1 < argc) {
+      stringstream ss(argv[++i]);
+      string name;
+      while(getline(ss, name, ','))
+        selected.push_back(name);
+    }
+    else if(arg == "--arena") {
+      allocation = TagLib::FileRef::ArenaAllocation;
+    }
+    else if(arg == "--strings") {
+      strings = true;
+    }
+    else if(arg == "--help" || arg == "-h") {
+      usage(argv[0]);
+      return 0;
+    }
+    else if(!arg.empty() && arg[0] == '-') {
+      usage(argv[0]);
+      return 1;
+    }
+    else {
+      pathGiven = true;
+      collectFiles(arg, files);
+    }
+  }
+
+  // A misspelled path must not silently benchmark the bundled files instead.
+  if(!pathGiven) {
+    collectFiles(TAGLIB_BENCH_DATA_DIR, files);
+  }
+  else if(files.empty()) {
+    cerr << argv[0] << ": No files found in the given paths" << endl;
+    return 1;
+  }
+
+  SilentListener listener;
+  TagLib::setDebugListener(&listener);
+
+  if(strings) {
+    const vector<StringResult> results = runStringBenchmarks(iterations, selected);
+    if(outputPath.empty()) {
+      writeStringJson(cout, results, iterations);
+    }
+    else {
+      ofstream out(outputPath.c_str());
+      writeStringJson(out, results, iterations);
+    }
+    return 0;
+  }
+
+  // Calibrate the cost of sampling the I/O counters.
+  {
+    const IOCounters a = sampleIO();
+    const IOCounters b = sampleIO();
+    sampleOverhead = b - a;
+  }
+
+  const string scratchBase = (fs::temp_directory_path() / "taglib-bench-scratch").string();
+
+  vector<Result> results;
+  for(const auto &path : files) {
+    if(TagLib::FileRef(path.c_str(), false).isNull())
+      continue;
+
+    const string format = formatOf(path);
+    const string scratch = scratchBase + (format.empty() ? "" : "." + format);
+
+    for(const auto &op : operations) {
+      if(!selected.empty() && find(selected.begin(), selected.end(), op.name) == selected.end())
+        continue;
+      results.push_back(measure(op, path, format, scratch, iterations));
+    }
+
+    error_code ec;
+    fs::remove(scratch, ec);
+  }
+
+  if(outputPath.empty()) {
+    writeJson(cout, results, iterations);
+  }
+  else {
+    ofstream out(outputPath.c_str());
+    writeJson(out, results, iterations);
+  }
+
+  return 0;
+}
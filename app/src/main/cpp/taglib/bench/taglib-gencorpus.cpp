@@ -0,0 +1,962 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+/*
+ * taglib-gencorpus: writes a synthetic corpus of large audio files for the
+ * scaling benchmarks of taglib-bench.
+ *
+ * The container structure of every file is written directly, the audio
+ * payload is filled with deterministic pseudo random data (or silence where
+ * random data could be mistaken for a frame sync).  The tags are then added
+ * through TagLib itself, so that they look exactly like the ones TagLib
+ * produces.
+ *
+ * Variants:
+ *
+ *   mp3        MPEG-1 Layer III, 128 kbps CBR, no Xing header
+ *   mp3-xing   like mp3, with a Xing header in the first frame
+ *   mp3-junk   like mp3, with --junk bytes of garbage before the first sync
+ *   mp3-gap    like mp3, with --gap zero bytes between the ID3v2 tag and
+ *              the first frame
+ *   flac       FLAC with STREAMINFO and opaque frame data
+ *   m4a        AAC in a non-fragmented MP4 container
+ *   m4a-frag   AAC in a fragmented MP4 container with --fragments moof atoms
+ *   opus       Ogg Opus, 96 kbps
+ *   vorbis     Ogg Vorbis, 128 kbps
+ *   wav        16 bit stereo PCM in RIFF/WAVE
+ *   aiff       16 bit stereo PCM in AIFF
+ *   dsf        DSD64 stereo
+ *   ape        Monkey's Audio (descriptor version 3990)
+ *
+ * Usage: taglib-gencorpus [options] OUTPUT_DIRECTORY
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "tbytevector.h"
+#include "tpropertymap.h"
+#include "tstringlist.h"
+#include "tvariant.h"
+#include "fileref.h"
+#ifdef TAGLIB_WITH_MP4
+#include "mp4file.h"
+#endif
+
+namespace fs = std::filesystem;
+using namespace std;
+using TagLib::ByteVector;
+
+namespace
+{
+  struct Options
+  {
+    unsigned int seconds = 180;
+    unsigned int tags = 16;
+    unsigned int lyrics = 4096;
+    unsigned int picture = 256 * 1024;
+    unsigned int junk = 64 * 1024;
+    unsigned int gap = 1024 * 1024;
+    unsigned int fragments = 2000;
+    unsigned long long seed = 1;
+  };
+
+  // Deterministic pseudo random bytes, so that the corpus is reproducible.
+  class Random
+  {
+  public:
+    explicit Random(unsigned long long seed) : state(seed) {}
+
+    unsigned char next()
+    {
+      state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+      return static_cast<unsigned char>(state >> 56);
+    }
+
+    ByteVector bytes(size_t length)
+    {
+      ByteVector v(static_cast<unsigned int>(length), '\0');
+      for(auto &c : v)
+        c = static_cast<char>(next());
+      return v;
+    }
+
+  private:
+    unsigned long long state;
+  };
+
+  // Writes ByteVectors to a file in a buffered way.
+  class Writer
+  {
+  public:
+    explicit Writer(const string &path) : out(path.c_str(), ios::binary | ios::trunc) {}
+
+    bool isOpen() const { return out.is_open(); }
+
+    void write(const ByteVector &v)
+    {
+      out.write(v.data(), v.size());
+      written += v.size();
+    }
+
+    void fill(unsigned long long length, Random *random)
+    {
+      const size_t chunkSize = 64 * 1024;
+      while(length > 0) {
+        const size_t n = static_cast<size_t>(min<unsigned long long>(length, chunkSize));
+        write(random ? random->bytes(n) : ByteVector(static_cast<unsigned int>(n), '\0'));
+        length -= n;
+      }
+    }
+
+    unsigned long long position() const { return written; }
+
+  private:
+    ofstream out;
+    unsigned long long written = 0;
+  };
+
+  ByteVector be32(unsigned int v) { return ByteVector::fromUInt(v, true); }
+  ByteVector le32(unsigned int v) { return ByteVector::fromUInt(v, false); }
+  ByteVector be16(unsigned short v) { return ByteVector::fromUShort(v, true); }
+  ByteVector le16(unsigned short v) { return ByteVector::fromUShort(v, false); }
+  ByteVector be64(unsigned long long v) { return ByteVector::fromULongLong(v, true); }
+  ByteVector le64(unsigned long long v) { return ByteVector::fromULongLong(v, false); }
+
+  ByteVector zeros(unsigned int n) { return ByteVector(n, '\0'); }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // MPEG
+  ////////////////////////////////////////////////////////////////////////////
+
+  // MPEG-1 Layer III, 128 kbps, 44100 Hz, stereo, no padding: 417 bytes.
+  const unsigned int mpegFrameLength = 417;
+  const unsigned int mpegSamplesPerFrame = 1152;
+
+  ByteVector mpegFrameHeader()
+  {
+    return ByteVector("\xFF\xFB\x90\x00", 4);
+  }
+
+  bool writeMPEG(const string &path, const Options &o, bool xing,
+                 unsigned int junk, unsigned int gap)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    if(junk > 0) {
+      // Garbage without any 0xFF byte, so that no false frame sync appears.
+      Random random(o.seed);
+      ByteVector data = random.bytes(junk);
+      for(auto &c : data)
+        c = static_cast<char>(static_cast<unsigned char>(c) & 0x7F);
+      w.write(data);
+    }
+    w.fill(gap, nullptr);
+
+    const unsigned int frames = o.seconds * 44100 / mpegSamplesPerFrame;
+    for(unsigned int i = 0; i < frames; ++i) {
+      ByteVector frame = mpegFrameHeader();
+      if(i == 0 && xing) {
+        frame.append(zeros(32));
+        frame.append("Xing");
+        frame.append(be32(0x03));
+        frame.append(be32(frames));
+        frame.append(be32(frames * mpegFrameLength));
+      }
+      frame.resize(mpegFrameLength, '\0');
+      w.write(frame);
+    }
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // FLAC
+  ////////////////////////////////////////////////////////////////////////////
+
+  bool writeFLAC(const string &path, const Options &o)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    const unsigned long long totalSamples = 44100ULL * o.seconds;
+
+    ByteVector streamInfo;
+    streamInfo.append(be16(4096));
+    streamInfo.append(be16(4096));
+    streamInfo.append(zeros(6));
+    streamInfo.append(be64((44100ULL << 44) | (1ULL << 41) | (15ULL << 36) | totalSamples));
+    streamInfo.append(zeros(16));
+
+    w.write("fLaC");
+    w.write(be32(0x80000000U | streamInfo.size()));
+    w.write(streamInfo);
+
+    // Roughly 700 kbps of opaque frame data.
+    Random random(o.seed);
+    w.fill(87500ULL * o.seconds, &random);
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // MP4
+  ////////////////////////////////////////////////////////////////////////////
+
+  ByteVector atom(const char *name, const ByteVector &body)
+  {
+    ByteVector v = be32(8 + body.size());
+    v.append(ByteVector(name, 4));
+    v.append(body);
+    return v;
+  }
+
+  ByteVector fullAtom(const char *name, unsigned int versionAndFlags, const ByteVector &body)
+  {
+    ByteVector v = be32(versionAndFlags);
+    v.append(body);
+    return atom(name, v);
+  }
+
+  ByteVector matrix()
+  {
+    ByteVector v;
+    v.append(be32(0x00010000));
+    v.append(zeros(12));
+    v.append(be32(0x00010000));
+    v.append(zeros(12));
+    v.append(be32(0x40000000));
+    return v;
+  }
+
+  // AAC-LC, 44100 Hz, stereo, 128 kbps.
+  const unsigned int aacFrameLength = 372;
+  const unsigned int aacSamplesPerFrame = 1024;
+
+  ByteVector mp4aSampleEntry()
+  {
+    ByteVector decoderConfig;
+    decoderConfig.append(char(0x40));         // objectTypeIndication: AAC
+    decoderConfig.append(char(0x15));         // streamType: audio
+    decoderConfig.append(zeros(3));           // bufferSizeDB
+    decoderConfig.append(be32(128000));       // maxBitrate
+    decoderConfig.append(be32(128000));       // avgBitrate
+    decoderConfig.append(ByteVector("\x05\x02\x12\x10", 4));
+
+    ByteVector es;
+    es.append(be16(1));                       // ES_ID
+    es.append(char(0));                       // flags
+    es.append(char(0x04));
+    es.append(static_cast<char>(decoderConfig.size()));
+    es.append(decoderConfig);
+    es.append(ByteVector("\x06\x01\x02", 3));
+
+    ByteVector esds;
+    esds.append(char(0x03));
+    esds.append(static_cast<char>(es.size()));
+    esds.append(es);
+
+    ByteVector entry;
+    entry.append(zeros(6));
+    entry.append(be16(1));                    // data reference index
+    entry.append(zeros(8));
+    entry.append(be16(2));                    // channels
+    entry.append(be16(16));                   // sample size
+    entry.append(zeros(4));
+    entry.append(be32(44100U << 16));         // sample rate (16.16)
+    entry.append(fullAtom("esds", 0, esds));
+    return atom("mp4a", entry);
+  }
+
+  ByteVector mp4Track(unsigned int totalSamples, const ByteVector &sampleTables)
+  {
+    ByteVector tkhd;
+    tkhd.append(zeros(8));
+    tkhd.append(be32(1));                     // track ID
+    tkhd.append(zeros(4));
+    tkhd.append(be32(totalSamples / 44100 * 1000));
+    tkhd.append(zeros(8));
+    tkhd.append(zeros(4));
+    tkhd.append(be16(0x0100));                // volume
+    tkhd.append(zeros(2));
+    tkhd.append(matrix());
+    tkhd.append(zeros(8));
+
+    ByteVector mdhd;
+    mdhd.append(zeros(8));
+    mdhd.append(be32(44100));
+    mdhd.append(be32(totalSamples));
+    mdhd.append(be16(0x55C4));                // language: und
+    mdhd.append(zeros(2));
+
+    ByteVector hdlr;
+    hdlr.append(zeros(4));
+    hdlr.append("soun");
+    hdlr.append(zeros(12));
+    hdlr.append(ByteVector("SoundHandler\0", 13));
+
+    ByteVector stsd = be32(1);
+    stsd.append(mp4aSampleEntry());
+
+    ByteVector dref = be32(1);
+    dref.append(fullAtom("url ", 1, ByteVector()));
+
+    ByteVector smhd = zeros(4);
+
+    ByteVector stbl = fullAtom("stsd", 0, stsd);
+    stbl.append(sampleTables);
+
+    ByteVector minf = fullAtom("smhd", 0, smhd);
+    minf.append(atom("dinf", fullAtom("dref", 0, dref)));
+    minf.append(atom("stbl", stbl));
+
+    ByteVector mdia = fullAtom("mdhd", 0, mdhd);
+    mdia.append(fullAtom("hdlr", 0, hdlr));
+    mdia.append(atom("minf", minf));
+
+    ByteVector trak = fullAtom("tkhd", 7, tkhd);
+    trak.append(atom("mdia", mdia));
+    return atom("trak", trak);
+  }
+
+  ByteVector mp4MovieHeader(unsigned int seconds)
+  {
+    ByteVector mvhd;
+    mvhd.append(zeros(8));
+    mvhd.append(be32(1000));
+    mvhd.append(be32(seconds * 1000));
+    mvhd.append(be32(0x00010000));            // rate
+    mvhd.append(be16(0x0100));                // volume
+    mvhd.append(zeros(10));
+    mvhd.append(matrix());
+    mvhd.append(zeros(24));
+    mvhd.append(be32(2));                     // next track ID
+    return fullAtom("mvhd", 0, mvhd);
+  }
+
+  ByteVector mp4FileType()
+  {
+    ByteVector ftyp("M4A ");
+    ftyp.append(zeros(4));
+    ftyp.append("M4A mp42isom");
+    return atom("ftyp", ftyp);
+  }
+
+  bool writeMP4(const string &path, const Options &o)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    // About one second of audio per chunk; the sample count is rounded up to
+    // whole chunks so that a single stsc entry describes the whole track.
+    const unsigned int samplesPerChunk = 43;
+    const unsigned int chunks =
+      max(1U, (o.seconds * 44100 / aacSamplesPerFrame + samplesPerChunk - 1) / samplesPerChunk);
+    const unsigned int samples = chunks * samplesPerChunk;
+
+    const auto buildMoov = [&](unsigned int mdatDataOffset) {
+      ByteVector stts = be32(1);
+      stts.append(be32(samples));
+      stts.append(be32(aacSamplesPerFrame));
+
+      ByteVector stsc = be32(1);
+      stsc.append(be32(1));
+      stsc.append(be32(samplesPerChunk));
+      stsc.append(be32(1));
+
+      ByteVector stsz = be32(aacFrameLength);
+      stsz.append(be32(samples));
+
+      ByteVector stco = be32(chunks);
+      for(unsigned int i = 0; i < chunks; ++i)
+        stco.append(be32(mdatDataOffset + i * samplesPerChunk * aacFrameLength));
+
+      ByteVector tables = fullAtom("stts", 0, stts);
+      tables.append(fullAtom("stsc", 0, stsc));
+      tables.append(fullAtom("stsz", 0, stsz));
+      tables.append(fullAtom("stco", 0, stco));
+
+      ByteVector moov = mp4MovieHeader(o.seconds);
+      moov.append(mp4Track(samples * aacSamplesPerFrame, tables));
+      return atom("moov", moov);
+    };
+
+    const ByteVector ftyp = mp4FileType();
+    const unsigned int moovSize = buildMoov(0).size();
+    const unsigned int dataOffset = ftyp.size() + moovSize + 8;
+    const unsigned long long dataSize =
+      static_cast<unsigned long long>(samples) * aacFrameLength;
+
+    w.write(ftyp);
+    w.write(buildMoov(dataOffset));
+    w.write(be32(static_cast<unsigned int>(8 + dataSize)));
+    w.write("mdat");
+    Random random(o.seed);
+    w.fill(dataSize, &random);
+    return true;
+  }
+
+  bool writeFragmentedMP4(const string &path, const Options &o)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    const unsigned int totalFrames = max(1U, o.seconds * 44100 / aacSamplesPerFrame);
+    const unsigned int fragments = max(1U, min(o.fragments, totalFrames));
+
+    ByteVector emptyTables = fullAtom("stts", 0, be32(0));
+    emptyTables.append(fullAtom("stsc", 0, be32(0)));
+    ByteVector stsz = be32(0);
+    stsz.append(be32(0));
+    emptyTables.append(fullAtom("stsz", 0, stsz));
+    emptyTables.append(fullAtom("stco", 0, be32(0)));
+
+    ByteVector trex = be32(1);                // track ID
+    trex.append(be32(1));                     // sample description index
+    trex.append(be32(aacSamplesPerFrame));
+    trex.append(be32(aacFrameLength));
+    trex.append(be32(0));
+
+    ByteVector moov = mp4MovieHeader(o.seconds);
+    moov.append(mp4Track(totalFrames * aacSamplesPerFrame, emptyTables));
+    moov.append(atom("mvex", fullAtom("trex", 0, trex)));
+
+    w.write(mp4FileType());
+    w.write(atom("moov", moov));
+
+    Random random(o.seed);
+    for(unsigned int i = 0; i < fragments; ++i) {
+      const unsigned long long firstFrame =
+        static_cast<unsigned long long>(totalFrames) * i / fragments;
+      const unsigned int framesInFragment = static_cast<unsigned int>(
+        static_cast<unsigned long long>(totalFrames) * (i + 1) / fragments - firstFrame);
+      const unsigned long long dataSize =
+        static_cast<unsigned long long>(framesInFragment) * aacFrameLength;
+
+      // tfhd: base-data-offset, default-sample-duration and default-sample-size
+      // present; the base data offset points to the payload of the mdat below.
+      const auto buildMoof = [&](unsigned long long baseDataOffset) {
+        ByteVector tfhd = be32(1);
+        tfhd.append(be64(baseDataOffset));
+        tfhd.append(be32(aacSamplesPerFrame));
+        tfhd.append(be32(aacFrameLength));
+
+        ByteVector tfdt = be64(firstFrame * aacSamplesPerFrame);
+
+        ByteVector trun = be32(framesInFragment);
+        trun.append(be32(0));
+
+        ByteVector traf = fullAtom("tfhd", 0x000019, tfhd);
+        traf.append(fullAtom("tfdt", 0x01000000, tfdt));
+        traf.append(fullAtom("trun", 0x000001, trun));
+
+        ByteVector moof = fullAtom("mfhd", 0, be32(i + 1));
+        moof.append(atom("traf", traf));
+        return atom("moof", moof);
+      };
+
+      const unsigned long long moofSize = buildMoof(0).size();
+      w.write(buildMoof(w.position() + moofSize + 8));
+      w.write(be32(static_cast<unsigned int>(8 + dataSize)));
+      w.write("mdat");
+      w.fill(dataSize, &random);
+    }
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // Ogg
+  ////////////////////////////////////////////////////////////////////////////
+
+  unsigned int oggChecksum(const ByteVector &data)
+  {
+    static unsigned int table[256];
+    static bool initialized = false;
+    if(!initialized) {
+      for(unsigned int i = 0; i < 256; ++i) {
+        unsigned int r = i << 24;
+        for(int j = 0; j < 8; ++j)
+          r = (r & 0x80000000U) ? (r << 1) ^ 0x04C11DB7U : (r << 1);
+        table[i] = r;
+      }
+      initialized = true;
+    }
+
+    unsigned int crc = 0;
+    for(const char c : data)
+      crc = (crc << 8) ^ table[((crc >> 24) & 0xFF) ^ static_cast<unsigned char>(c)];
+    return crc;
+  }
+
+  class OggWriter
+  {
+  public:
+    explicit OggWriter(Writer &writer) : w(writer) {}
+
+    // Writes a page which contains the complete \a packets.
+    void writePage(const vector<ByteVector> &packets, long long granule, bool bos, bool eos)
+    {
+      ByteVector lacing;
+      ByteVector body;
+      for(const auto &packet : packets) {
+        unsigned int size = packet.size();
+        while(size >= 255) {
+          lacing.append(static_cast<char>(255));
+          size -= 255;
+        }
+        lacing.append(static_cast<char>(size));
+        body.append(packet);
+      }
+
+      ByteVector page("OggS");
+      page.append(char(0));
+      page.append(static_cast<char>((bos ? 0x02 : 0) | (eos ? 0x04 : 0)));
+      page.append(ByteVector::fromLongLong(granule, false));
+      page.append(le32(serial));
+      page.append(le32(sequence++));
+      page.append(zeros(4));
+      page.append(static_cast<char>(lacing.size()));
+      page.append(lacing);
+      page.append(body);
+
+      const ByteVector checksum = le32(oggChecksum(page));
+      copy(checksum.begin(), checksum.end(), page.begin() + 22);
+      w.write(page);
+    }
+
+  private:
+    Writer &w;
+    const unsigned int serial = 0x7461676C;
+    unsigned int sequence = 0;
+  };
+
+  // Writes one page per second of audio, each with \a packetsPerSecond packets.
+  void writeOggAudio(OggWriter &ogg, const Options &o, unsigned int packetsPerSecond,
+                     unsigned int packetSize, long long samplesPerSecond, long long granuleBase)
+  {
+    Random random(o.seed);
+    for(unsigned int s = 0; s < o.seconds; ++s) {
+      vector<ByteVector> packets;
+      for(unsigned int i = 0; i < packetsPerSecond; ++i)
+        packets.push_back(random.bytes(packetSize));
+      ogg.writePage(packets, granuleBase + samplesPerSecond * (s + 1), false,
+                    s + 1 == o.seconds);
+    }
+  }
+
+  bool writeOpus(const string &path, const Options &o)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    const unsigned short preSkip = 312;
+
+    ByteVector head("OpusHead");
+    head.append(char(1));                     // version
+    head.append(char(2));                     // channels
+    head.append(le16(preSkip));
+    head.append(le32(48000));
+    head.append(le16(0));                     // output gain
+    head.append(char(0));                     // channel mapping family
+
+    ByteVector tags("OpusTags");
+    tags.append(le32(13));
+    tags.append("taglib-corpus");
+    tags.append(le32(0));
+
+    OggWriter ogg(w);
+    ogg.writePage({ head }, 0, true, false);
+    ogg.writePage({ tags }, 0, false, false);
+
+    // 20 ms packets at 96 kbps.
+    writeOggAudio(ogg, o, 50, 240, 48000, preSkip);
+    return true;
+  }
+
+  bool writeVorbis(const string &path, const Options &o)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    ByteVector id("\x01vorbis", 7);
+    id.append(le32(0));                       // version
+    id.append(char(2));                       // channels
+    id.append(le32(44100));
+    id.append(le32(0));                       // maximum bitrate
+    id.append(le32(128000));                  // nominal bitrate
+    id.append(le32(0));                       // minimum bitrate
+    id.append(static_cast<char>(0xB8));       // block sizes
+    id.append(char(1));                       // framing
+
+    ByteVector comment("\x03vorbis", 7);
+    comment.append(le32(13));
+    comment.append("taglib-corpus");
+    comment.append(le32(0));
+    comment.append(char(1));
+
+    ByteVector setup("\x05vorbis", 7);
+    Random random(o.seed + 1);
+    setup.append(random.bytes(3000));
+
+    OggWriter ogg(w);
+    ogg.writePage({ id }, 0, true, false);
+    ogg.writePage({ comment, setup }, 0, false, false);
+
+    writeOggAudio(ogg, o, 80, 200, 44100, 0);
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // PCM and DSD
+  ////////////////////////////////////////////////////////////////////////////
+
+  bool writeWAV(const string &path, const Options &o)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    const unsigned int dataSize = 176400U * o.seconds;
+
+    ByteVector fmt = le16(1);                 // PCM
+    fmt.append(le16(2));
+    fmt.append(le32(44100));
+    fmt.append(le32(176400));
+    fmt.append(le16(4));
+    fmt.append(le16(16));
+
+    w.write("RIFF");
+    w.write(le32(4 + 8 + fmt.size() + 8 + dataSize));
+    w.write("WAVE");
+    w.write("fmt ");
+    w.write(le32(fmt.size()));
+    w.write(fmt);
+    w.write("data");
+    w.write(le32(dataSize));
+    Random random(o.seed);
+    w.fill(dataSize, &random);
+    return true;
+  }
+
+  bool writeAIFF(const string &path, const Options &o)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    const unsigned int frames = 44100U * o.seconds;
+    const unsigned int dataSize = frames * 4;
+
+    ByteVector comm = be16(2);
+    comm.append(be32(frames));
+    comm.append(be16(16));
+    comm.append(ByteVector("\x40\x0E\xAC\x44\x00\x00\x00\x00\x00\x00", 10));
+
+    w.write("FORM");
+    w.write(be32(4 + 8 + comm.size() + 8 + 8 + dataSize));
+    w.write("AIFF");
+    w.write("COMM");
+    w.write(be32(comm.size()));
+    w.write(comm);
+    w.write("SSND");
+    w.write(be32(8 + dataSize));
+    w.write(zeros(8));
+    Random random(o.seed);
+    w.fill(dataSize, &random);
+    return true;
+  }
+
+  bool writeDSF(const string &path, const Options &o)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    const unsigned long long sampleCount = 2822400ULL * o.seconds;
+    const unsigned int blockSize = 4096;
+    const unsigned long long blocks = (sampleCount / 8 + blockSize - 1) / blockSize;
+    const unsigned long long dataSize = 2 * blocks * blockSize;
+    const unsigned long long fileSize = 28 + 52 + 12 + dataSize;
+
+    w.write("DSD ");
+    w.write(le64(28));
+    w.write(le64(fileSize));
+    w.write(le64(0));                         // no metadata yet
+
+    w.write("fmt ");
+    w.write(le64(52));
+    w.write(le32(1));                         // format version
+    w.write(le32(0));                         // DSD raw
+    w.write(le32(2));                         // stereo
+    w.write(le32(2));
+    w.write(le32(2822400));
+    w.write(le32(1));
+    w.write(le64(sampleCount));
+    w.write(le32(blockSize));
+    w.write(zeros(4));
+
+    w.write("data");
+    w.write(le64(12 + dataSize));
+    Random random(o.seed);
+    w.fill(dataSize, &random);
+    return true;
+  }
+
+  bool writeAPE(const string &path, const Options &o)
+  {
+    Writer w(path);
+    if(!w.isOpen())
+      return false;
+
+    const unsigned int blocksPerFrame = 73728 * 4;
+    const unsigned int totalBlocks = 44100U * o.seconds;
+    const unsigned int totalFrames = max(1U, (totalBlocks + blocksPerFrame - 1) / blocksPerFrame);
+    const unsigned int finalFrameBlocks = totalBlocks - (totalFrames - 1) * blocksPerFrame;
+    const unsigned int dataSize = 87500U * o.seconds;
+
+    w.write("MAC ");
+    w.write(le16(3990));
+    w.write(le16(0));
+    w.write(le32(52));                        // descriptor bytes
+    w.write(le32(24));                        // header bytes
+    w.write(le32(0));                         // seek table bytes
+    w.write(le32(0));                         // header data bytes
+    w.write(le32(dataSize));
+    w.write(le32(0));
+    w.write(le32(0));                         // terminating data bytes
+    w.write(zeros(16));                       // MD5
+
+    w.write(le16(2000));                      // compression level
+    w.write(le16(0));
+    w.write(le32(blocksPerFrame));
+    w.write(le32(finalFrameBlocks));
+    w.write(le32(totalFrames));
+    w.write(le16(16));
+    w.write(le16(2));
+    w.write(le32(44100));
+
+    Random random(o.seed);
+    w.fill(dataSize, &random);
+    return true;
+  }
+
+  ////////////////////////////////////////////////////////////////////////////
+  // Tags
+  ////////////////////////////////////////////////////////////////////////////
+
+  TagLib::String lyrics(unsigned int length)
+  {
+    static const wchar_t *const lines[] = {
+      L"The quick brown fox jumps over the lazy dog",
+      L"\x6211\x80FD\x541E\x4E0B\x73BB\x7483\x800C\x4E0D\x4F24\x8EAB\x4F53",
+      L"\x3044\x308D\x306F\x306B\x307B\x3078\x3068\x3061\x308A\x306C\x308B\x3092",
+      L"Sphinx of black quartz, judge my vow",
+    };
+
+    wstring text;
+    unsigned int line = 0;
+    while(text.size() < length) {
+      wchar_t stamp[16];
+      swprintf(stamp, 16, L"[%02u:%02u.%02u]", line / 20 % 100, line * 3 % 60, line % 100);
+      text += stamp;
+      text += lines[line % 4];
+      text += L'\n';
+      ++line;
+    }
+    text.resize(length);
+    return TagLib::String(text);
+  }
+
+  ByteVector picture(unsigned int length, unsigned long long seed)
+  {
+    ByteVector data("\xFF\xD8\xFF\xE0\x00\x10JFIF\x00\x01\x01\x00\x00\x01\x00\x01\x00\x00", 20);
+    if(length > data.size() + 2) {
+      Random random(seed);
+      data.append(random.bytes(length - data.size() - 2));
+    }
+    data.append(ByteVector("\xFF\xD9", 2));
+    return data;
+  }
+
+  bool addTags(const string &path, const Options &o)
+  {
+    TagLib::FileRef f(path.c_str(), false);
+    if(f.isNull()) {
+      cerr << "TagLib could not open the generated file " << path << endl;
+      return false;
+    }
+
+    TagLib::PropertyMap properties;
+    properties.replace("TITLE", TagLib::String("Synthetic track"));
+    properties.replace("ARTIST", TagLib::String("taglib-gencorpus"));
+    properties.replace("ALBUM", TagLib::String("Scaling corpus"));
+    properties.replace("DATE", TagLib::String("2024"));
+    properties.replace("TRACKNUMBER", TagLib::String("1"));
+    properties.replace("GENRE", TagLib::String("Noise"));
+    for(unsigned int i = 0; i < o.tags; ++i) {
+      char key[32];
+      snprintf(key, sizeof(key), "BENCHTAG%04u", i);
+      properties.replace(key, TagLib::String("value of benchmark tag ") + TagLib::String::number(i));
+    }
+    if(o.lyrics > 0)
+      properties.replace("LYRICS", lyrics(o.lyrics));
+    const TagLib::PropertyMap ignored = f.setProperties(properties);
+
+#ifdef TAGLIB_WITH_MP4
+    // MP4 has no generic mapping for unknown keys, store them as freeform items.
+    if(auto mp4 = dynamic_cast<TagLib::MP4::File *>(f.file())) {
+      for(const auto &[key, values] : ignored)
+        mp4->tag()->setItem("----:com.apple.iTunes:" + key, TagLib::MP4::Item(values));
+    }
+#else
+    (void)ignored;
+#endif
+
+    if(o.picture > 0) {
+      f.setComplexProperties("PICTURE", {
+        {
+          {"data", picture(o.picture, o.seed)},
+          {"mimeType", "image/jpeg"},
+          {"description", "Front cover"},
+          {"pictureType", "Front Cover"}
+        }
+      });
+    }
+
+    return f.save();
+  }
+
+  struct Variant
+  {
+    const char *name;
+    const char *extension;
+    bool (*write)(const string &path, const Options &o);
+  };
+
+  const Variant variants[] = {
+    { "mp3",      "mp3",  [](const string &p, const Options &o) { return writeMPEG(p, o, false, 0, 0); } },
+    { "mp3-xing", "mp3",  [](const string &p, const Options &o) { return writeMPEG(p, o, true, 0, 0); } },
+    { "mp3-junk", "mp3",  [](const string &p, const Options &o) { return writeMPEG(p, o, false, o.junk, 0); } },
+    { "mp3-gap",  "mp3",  [](const string &p, const Options &o) { return writeMPEG(p, o, false, 0, o.gap); } },
+    { "flac",     "flac", writeFLAC },
+    { "m4a",      "m4a",  writeMP4 },
+    { "m4a-frag", "m4a",  writeFragmentedMP4 },
+    { "opus",     "opus", writeOpus },
+    { "vorbis",   "ogg",  writeVorbis },
+    { "wav",      "wav",  writeWAV },
+    { "aiff",     "aiff", writeAIFF },
+    { "dsf",      "dsf",  writeDSF },
+    { "ape",      "ape",  writeAPE },
+  };
+
+  void usage(const char *argv0)
+  {
+    cerr << "Usage: " << argv0 << " [options] OUTPUT_DIRECTORY\n"
+         << "  --variants v,v,...  variants to generate (default: all)\n"
+         << "  --seconds N         audio length in seconds (default: 180)\n"
+         << "  --tags N            number of additional text tags (default: 16)\n"
+         << "  --lyrics N          length of the lyrics in characters (default: 4096)\n"
+         << "  --picture N         size of the front cover in bytes (default: 262144)\n"
+         << "  --junk N            garbage before the first frame of mp3-junk (default: 65536)\n"
+         << "  --gap N             gap after the ID3v2 tag of mp3-gap (default: 1048576)\n"
+         << "  --fragments N       number of moof atoms in m4a-frag (default: 2000)\n"
+         << "  --seed N            seed of the payload data (default: 1)\n"
+         << "Variants:";
+    for(const auto &v : variants)
+      cerr << " " << v.name;
+    cerr << endl;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Options o;
+  vector<string> selected;
+  string outputDirectory;
+
+  for(int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    const bool hasValue = i + 1 < argc;
+    if(arg == "--variants" && hasValue) {
+      stringstream ss(argv[++i]);
+      string name;
+      while(getline(ss, name, ','))
+        selected.push_back(name);
+    }
+    else if(arg == "--seconds" && hasValue)
+      o.seconds = static_cast<unsigned int>(max(1L, strtol(argv[++i], nullptr, 10)));
+    else if(arg == "--tags" && hasValue)
+      o.tags = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+    else if(arg == "--lyrics" && hasValue)
+      o.lyrics = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+    else if(arg == "--picture" && hasValue)
+      o.picture = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+    else if(arg == "--junk" && hasValue)
+      o.junk = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+    else if(arg == "--gap" && hasValue)
+      o.gap = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+    else if(arg == "--fragments" && hasValue)
+      o.fragments = static_cast<unsigned int>(strtoul(argv[++i], nullptr, 10));
+    else if(arg == "--seed" && hasValue)
+      o.seed = strtoull(argv[++i], nullptr, 10);
+    else if(!arg.empty() && arg[0] != '-' && outputDirectory.empty())
+      outputDirectory = arg;
+    else {
+      usage(argv[0]);
+      return 1;
+    }
+  }
+
+  if(outputDirectory.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  error_code ec;
+  fs::create_directories(outputDirectory, ec);
+
+  int failures = 0;
+  for(const auto &v : variants) {
+    if(!selected.empty() && find(selected.begin(), selected.end(), v.name) == selected.end())
+      continue;
+
+    const string path = (fs::path(outputDirectory) / (string(v.name) + "." + v.extension)).string();
+    if(!v.write(path, o) || !addTags(path, o)) {
+      cerr << "Failed to generate " << path << endl;
+      ++failures;
+      continue;
+    }
+    cout << path << " " << fs::file_size(path, ec) << endl;
+  }
+
+  return failures == 0 ? 0 : 1;
+}
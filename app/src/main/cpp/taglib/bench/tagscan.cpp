@@ -0,0 +1,438 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+/*
+ * tagscan: parallel library scanner built on FileRef.
+ *
+ * The given directories are walked recursively, the files are sorted by
+ * device and inode, so that neighbouring files are usually close to each
+ * other on disk, and parsed on a work-stealing thread pool.  Every worker
+ * owns a contiguous slice of the sorted list and only steals from the end of
+ * other slices once its own is exhausted.
+ *
+ * For every file a JSON object is written on a line of its own, containing
+ * the basic tag, the property map, whether lyrics are present and a digest of
+ * every embedded picture.  A summary with the throughput and the p50/p99
+ * per-file latency and the counts of the problems found in the files, see
+ * TagLib::Diagnostics, is written to stderr at the end.
+ *
+ * Usage: tagscan [--threads N] [--read-style fast|average|accurate]
+ *                [--output FILE] [--quiet] FILE|DIRECTORY...
+ *
+ * Each FileRef is only ever used by the thread which created it, which is
+ * the supported way of using TagLib from several threads.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <sys/stat.h>
+#endif
+
+#include "tpropertymap.h"
+#include "tstringlist.h"
+#include "tvariant.h"
+#include "fileref.h"
+#include "tag.h"
+#include "tdebuglistener.h"
+#include "tdiagnostics.h"
+
+namespace fs = std::filesystem;
+using namespace std;
+
+namespace
+{
+  struct Job
+  {
+    string path;
+    unsigned long long device = 0;
+    unsigned long long inode = 0;
+  };
+
+  // A queue owned by a single worker.  The owner takes jobs from the front,
+  // thieves take them from the back, so that both ends keep their locality.
+  class WorkQueue
+  {
+  public:
+    void push(const Job *job)
+    {
+      lock_guard<mutex> lock(m);
+      jobs.push_back(job);
+    }
+
+    const Job *pop()
+    {
+      lock_guard<mutex> lock(m);
+      if(jobs.empty())
+        return nullptr;
+      const Job *job = jobs.front();
+      jobs.pop_front();
+      return job;
+    }
+
+    const Job *steal()
+    {
+      lock_guard<mutex> lock(m);
+      if(jobs.empty())
+        return nullptr;
+      const Job *job = jobs.back();
+      jobs.pop_back();
+      return job;
+    }
+
+  private:
+    mutex m;
+    deque<const Job *> jobs;
+  };
+
+  struct Options
+  {
+    unsigned int threads = 0;
+    TagLib::AudioProperties::ReadStyle readStyle = TagLib::AudioProperties::Average;
+    bool quiet = false;
+  };
+
+  struct Stats
+  {
+    vector<double> latencies;
+    unsigned long long invalid = 0;
+    unsigned long long stolen = 0;
+  };
+
+  string jsonEscape(const string &s)
+  {
+    string out;
+    out.reserve(s.size() + 2);
+    for(char c : s) {
+      switch(c) {
+      case '"':  out += "\\\""; break;
+      case '\\': out += "\\\\"; break;
+      case '\n': out += "\\n";  break;
+      case '\r': out += "\\r";  break;
+      case '\t': out += "\\t";  break;
+      default:
+        if(static_cast<unsigned char>(c) < 0x20) {
+          char buf[8];
+          snprintf(buf, sizeof(buf), "\\u%04x", c);
+          out += buf;
+        }
+        else {
+          out += c;
+        }
+      }
+    }
+    return out;
+  }
+
+  string jsonString(const TagLib::String &s)
+  {
+    return "\"" + jsonEscape(s.to8Bit(true)) + "\"";
+  }
+
+  // 64 bit FNV-1a, good enough to tell identical artwork apart.
+  string digest(const TagLib::ByteVector &data)
+  {
+    unsigned long long hash = 0xcbf29ce484222325ULL;
+    for(char c : data) {
+      hash ^= static_cast<unsigned char>(c);
+      hash *= 0x100000001b3ULL;
+    }
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx", hash);
+    return buf;
+  }
+
+  string scan(const Job &job, const Options &options, bool &valid)
+  {
+    TagLib::FileRef f(job.path.c_str(), true, options.readStyle);
+    valid = !f.isNull();
+
+    string line = "{\"path\":\"" + jsonEscape(job.path) + "\"";
+    if(!valid)
+      return line + ",\"valid\":false}";
+
+    line += ",\"valid\":true";
+
+    if(const TagLib::Tag *tag = f.tag()) {
+      line += ",\"tag\":{\"title\":" + jsonString(tag->title())
+        + ",\"artist\":" + jsonString(tag->artist())
+        + ",\"album\":" + jsonString(tag->album())
+        + ",\"comment\":" + jsonString(tag->comment())
+        + ",\"genre\":" + jsonString(tag->genre())
+        + ",\"year\":" + to_string(tag->year())
+        + ",\"track\":" + to_string(tag->track()) + "}";
+    }
+
+    const TagLib::PropertyMap properties = f.properties();
+    line += ",\"properties\":{";
+    bool first = true;
+    for(const auto &[key, values] : properties) {
+      if(key == "LYRICS")
+        continue;
+      line += first ? "" : ",";
+      line += jsonString(key) + ":[";
+      for(auto it = values.begin(); it != values.end(); ++it)
+        line += (it == values.begin() ? "" : ",") + jsonString(*it);
+      line += "]";
+      first = false;
+    }
+    line += "}";
+
+    const bool hasLyrics = properties.contains("LYRICS") && !properties["LYRICS"].toString().isEmpty();
+    line += ",\"lyrics\":";
+    line += hasLyrics ? "true" : "false";
+
+    line += ",\"pictures\":[";
+    first = true;
+    for(const auto &picture : f.complexProperties("PICTURE")) {
+      const TagLib::ByteVector data = picture.value("data").value<TagLib::ByteVector>();
+      line += first ? "{" : ",{";
+      line += "\"mimeType\":" + jsonString(picture.value("mimeType").value<TagLib::String>());
+      line += ",\"size\":" + to_string(data.size());
+      line += ",\"fnv1a\":\"" + digest(data) + "\"}";
+      first = false;
+    }
+    line += "]";
+
+    if(const TagLib::AudioProperties *audio = f.audioProperties()) {
+      line += ",\"audio\":{\"lengthMs\":" + to_string(audio->lengthInMilliseconds())
+        + ",\"bitrate\":" + to_string(audio->bitrate())
+        + ",\"sampleRate\":" + to_string(audio->sampleRate())
+        + ",\"channels\":" + to_string(audio->channels()) + "}";
+    }
+
+    return line + "}";
+  }
+
+  void collectFiles(const fs::path &path, vector<Job> &jobs)
+  {
+    const auto add = [&jobs](const fs::path &p) {
+      Job job;
+      job.path = p.string();
+#ifndef _WIN32
+      struct stat st;
+      if(::stat(job.path.c_str(), &st) == 0) {
+        job.device = static_cast<unsigned long long>(st.st_dev);
+        job.inode = static_cast<unsigned long long>(st.st_ino);
+      }
+#endif
+      jobs.push_back(move(job));
+    };
+
+    error_code ec;
+    if(fs::is_directory(path, ec)) {
+      for(fs::recursive_directory_iterator it(path, fs::directory_options::skip_permission_denied, ec), end;
+          it != end; it.increment(ec)) {
+        if(ec)
+          break;
+        if(it->is_regular_file(ec))
+          add(it->path());
+      }
+    }
+    else if(fs::is_regular_file(path, ec)) {
+      add(path);
+    }
+  }
+
+  double percentile(const vector<double> &sorted, double p)
+  {
+    if(sorted.empty())
+      return 0.0;
+    const size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+    return sorted[min(index, sorted.size() - 1)];
+  }
+
+  void usage(const char *argv0)
+  {
+    cerr << "Usage: " << argv0
+         << " [--threads N] [--read-style fast|average|accurate] [--output FILE] [--quiet]"
+            " FILE|DIRECTORY..." << endl;
+  }
+}
+
+int main(int argc, char *argv[])
+{
+  Options options;
+  string outputPath;
+  vector<Job> jobs;
+
+  for(int i = 1; i < argc; ++i) {
+    const string arg = argv[i];
+    if(arg == "--threads" && i + 1 < argc) {
+      options.threads = static_cast<unsigned int>(max(1, atoi(argv[++i])));
+    }
+    else if(arg == "--read-style" && i + 1 < argc) {
+      const string style = argv[++i];
+      if(style == "fast")
+        options.readStyle = TagLib::AudioProperties::Fast;
+      else if(style == "average")
+        options.readStyle = TagLib::AudioProperties::Average;
+      else if(style == "accurate")
+        options.readStyle = TagLib::AudioProperties::Accurate;
+      else {
+        usage(argv[0]);
+        return 1;
+      }
+    }
+    else if(arg == "--output" && i + 1 < argc) {
+      outputPath = argv[++i];
+    }
+    else if(arg == "--quiet") {
+      options.quiet = true;
+    }
+    else if(arg == "--help" || arg == "-h") {
+      usage(argv[0]);
+      return 0;
+    }
+    else if(!arg.empty() && arg[0] == '-') {
+      usage(argv[0]);
+      return 1;
+    }
+    else {
+      collectFiles(arg, jobs);
+    }
+  }
+
+  if(jobs.empty()) {
+    usage(argv[0]);
+    return 1;
+  }
+
+  sort(jobs.begin(), jobs.end(), [](const Job &a, const Job &b) {
+    if(a.device != b.device)
+      return a.device < b.device;
+    if(a.inode != b.inode)
+      return a.inode < b.inode;
+    return a.path < b.path;
+  });
+
+  if(options.threads == 0)
+    options.threads = max(1U, thread::hardware_concurrency());
+  options.threads = static_cast<unsigned int>(min<size_t>(options.threads, jobs.size()));
+
+  ofstream outputFile;
+  if(!outputPath.empty()) {
+    outputFile.open(outputPath);
+    if(!outputFile) {
+      cerr << "Could not open " << outputPath << endl;
+      return 1;
+    }
+  }
+  ostream &out = outputPath.empty() ? cout : outputFile;
+
+  // Corrupt files produce debug messages from every thread, which would
+  // otherwise be interleaved with the JSON lines.  Their counts are written
+  // to the summary instead.
+  TagLib::setDebugMessagesEnabled(false);
+  TagLib::Diagnostics::reset();
+
+  // Contiguous slices of the inode ordered list, one per worker.
+  vector<WorkQueue> queues(options.threads);
+  for(size_t i = 0; i < jobs.size(); ++i)
+    queues[i * options.threads / jobs.size()].push(&jobs[i]);
+
+  vector<Stats> stats(options.threads);
+  mutex outputMutex;
+
+  const auto worker = [&](unsigned int self) {
+    Stats &s = stats[self];
+    string buffer;
+    for(;;) {
+      const Job *job = queues[self].pop();
+      for(unsigned int k = 1; !job && k < options.threads; ++k) {
+        job = queues[(self + k) % options.threads].steal();
+        if(job)
+          ++s.stolen;
+      }
+      // Jobs are never added after the start, so all queues are drained.
+      if(!job)
+        break;
+
+      bool valid = false;
+      const auto start = chrono::steady_clock::now();
+      const string line = scan(*job, options, valid);
+      const auto end = chrono::steady_clock::now();
+
+      s.latencies.push_back(chrono::duration<double, milli>(end - start).count());
+      if(!valid)
+        ++s.invalid;
+
+      if(!options.quiet) {
+        buffer += line;
+        buffer += '\n';
+        if(buffer.size() >= 64 * 1024) {
+          lock_guard<mutex> lock(outputMutex);
+          out << buffer;
+          buffer.clear();
+        }
+      }
+    }
+    if(!buffer.empty()) {
+      lock_guard<mutex> lock(outputMutex);
+      out << buffer;
+    }
+  };
+
+  const auto start = chrono::steady_clock::now();
+  vector<thread> threads;
+  for(unsigned int i = 0; i < options.threads; ++i)
+    threads.emplace_back(worker, i);
+  for(auto &t : threads)
+    t.join();
+  const double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+  out.flush();
+
+  vector<double> latencies;
+  unsigned long long invalid = 0;
+  unsigned long long stolen = 0;
+  for(const auto &s : stats) {
+    latencies.insert(latencies.end(), s.latencies.begin(), s.latencies.end());
+    invalid += s.invalid;
+    stolen += s.stolen;
+  }
+  sort(latencies.begin(), latencies.end());
+
+  cerr << "{\"files\":" << jobs.size()
+       << ",\"invalid\":" << invalid
+       << ",\"threads\":" << options.threads
+       << ",\"stolen\":" << stolen
+       << ",\"seconds\":" << seconds
+       << ",\"filesPerSecond\":" << (seconds > 0 ? static_cast<double>(jobs.size()) / seconds : 0.0)
+       << ",\"p50Ms\":" << percentile(latencies, 0.50)
+       << ",\"p99Ms\":" << percentile(latencies, 0.99)
+       << ",\"maxMs\":" << (latencies.empty() ? 0.0 : latencies.back())
+       << ",\"diagnostics\":" << TagLib::Diagnostics::toString().to8Bit()
+       << "}" << endl;
+
+  return 0;
+}
@@ -145,6 +145,8 @@ TAGLIB_C_EXPORT TagLib_File *taglib_file_new(const char *filename);
 /*!
  * Creates a TagLib file based on \a filename.  Rather than attempting to guess
  * the type, it will use the one specified by \a type.
+ *
+ * \returns NULL if TagLib was built without support for \a type.
  */
 TAGLIB_C_EXPORT TagLib_File *taglib_file_new_type(const char *filename, TagLib_File_Type type);
 
@@ -287,7 +289,8 @@ TAGLIB_C_EXPORT void taglib_tag_set_year(TagLib_Tag *tag, unsigned int year);
 TAGLIB_C_EXPORT void taglib_tag_set_track(TagLib_Tag *tag, unsigned int track);
 
 /*!
- * Frees all of the strings that have been created by the tag.
+ * Frees all of the strings that have been created by the tag in the calling
+ * thread.  Strings returned in other threads have to be freed by them.
  */
 TAGLIB_C_EXPORT void taglib_tag_free_strings(void);
 
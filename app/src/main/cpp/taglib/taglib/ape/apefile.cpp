@@ -248,19 +248,20 @@ void APE::File::read(bool readProperties)
     d->ID3v2Size = d->ID3v2Header->completeTagSize();
   }
 
-  // Look for an ID3v1 tag
+  // Look for an ID3v1 tag and an APE tag, both from a single read of the
+  // end of the file
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  const Utils::TailProbe tail = Utils::probeTail(this);
 
-  if(d->ID3v1Location >= 0)
-    d->tag.set(ApeID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
+  d->ID3v1Location = tail.id3v1Location;
 
-  // Look for an APE tag
+  if(d->ID3v1Location >= 0)
+    d->tag.set(ApeID3v1Index, new ID3v1::Tag(this, d->ID3v1Location, tail.id3v1Data()));
 
-  d->APELocation = Utils::findAPE(this, d->ID3v1Location);
+  d->APELocation = tail.apeFooterLocation;
 
   if(d->APELocation >= 0) {
-    d->tag.set(ApeAPEIndex, new APE::Tag(this, d->APELocation));
+    d->tag.set(ApeAPEIndex, new APE::Tag(this, d->APELocation, tail.apeData()));
     d->APESize = APETag()->footer()->completeTagSize();
     d->APELocation = d->APELocation + APE::Footer::size() - d->APESize;
   }
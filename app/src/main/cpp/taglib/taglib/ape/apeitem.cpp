@@ -215,7 +215,8 @@ void APE::Item::parse(const ByteVector &data)
   // 11 bytes is the minimum size for an APE item
 
   if(data.size() < 11) {
-    debug("APE::Item::parse() -- no data in item");
+    diagnose(Diagnostics::APE, Diagnostics::Truncated,
+             "APE::Item::parse() -- no data in item");
     return;
   }
 
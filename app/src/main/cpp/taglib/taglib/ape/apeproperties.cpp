@@ -125,7 +125,8 @@ void APE::Properties::read(File *file, offset_t streamLength)
   }
 
   if(vers < 0) {
-    debug("APE::Properties::read() -- APE descriptor not found");
+    diagnose(Diagnostics::APE, Diagnostics::Missing,
+             "APE::Properties::read() -- APE descriptor not found");
     return;
   }
 
@@ -149,7 +150,8 @@ void APE::Properties::analyzeCurrent(File *file)
   file->seek(2, File::Current);
   const ByteVector descriptor = file->readBlock(44);
   if(descriptor.size() < 44) {
-    debug("APE::Properties::analyzeCurrent() -- descriptor is too short.");
+    diagnose(Diagnostics::APE, Diagnostics::Truncated,
+             "APE::Properties::analyzeCurrent() -- descriptor is too short.");
     return;
   }
 
@@ -161,7 +163,8 @@ void APE::Properties::analyzeCurrent(File *file)
   // Read the header
   const ByteVector header = file->readBlock(24);
   if(header.size() < 24) {
-    debug("APE::Properties::analyzeCurrent() -- MAC header is too short.");
+    diagnose(Diagnostics::APE, Diagnostics::Truncated,
+             "APE::Properties::analyzeCurrent() -- MAC header is too short.");
     return;
   }
 
@@ -183,7 +186,8 @@ void APE::Properties::analyzeOld(File *file)
 {
   const ByteVector header = file->readBlock(26);
   if(header.size() < 26) {
-    debug("APE::Properties::analyzeOld() -- MAC header is too short.");
+    diagnose(Diagnostics::APE, Diagnostics::Truncated,
+             "APE::Properties::analyzeOld() -- MAC header is too short.");
     return;
   }
 
@@ -213,7 +217,8 @@ void APE::Properties::analyzeOld(File *file)
   file->seek(16, File::Current);
   const ByteVector fmt = file->readBlock(28);
   if(fmt.size() < 28 || !fmt.startsWith("WAVEfmt ")) {
-    debug("APE::Properties::analyzeOld() -- fmt header is too short.");
+    diagnose(Diagnostics::APE, Diagnostics::Truncated,
+             "APE::Properties::analyzeOld() -- fmt header is too short.");
     return;
   }
 
@@ -39,6 +39,7 @@
 #include "tdebug.h"
 #include "tfile.h"
 #include "tpropertymap.h"
+#include "tagutils.h"
 #include "apefooter.h"
 #include "apeitem.h"
 
@@ -93,6 +94,28 @@ APE::Tag::Tag(TagLib::File *file, offset_t footerLocation) :
   read();
 }
 
+APE::Tag::Tag(TagLib::File *file, offset_t footerLocation, const ByteVector &data) :
+  d(std::make_unique<TagPrivate>())
+{
+  d->file = file;
+  d->footerLocation = footerLocation;
+
+  if(data.size() >= Footer::size()) {
+    d->footer.setData(data.mid(data.size() - Footer::size()));
+
+    const unsigned int tagSize = d->footer.tagSize();
+    if(tagSize <= Footer::size())
+      return;
+
+    if(tagSize <= data.size()) {
+      parse(data.mid(data.size() - tagSize, tagSize - Footer::size()));
+      return;
+    }
+  }
+
+  read();
+}
+
 APE::Tag::~Tag() = default;
 
 ByteVector APE::Tag::fileIdentifier()
@@ -280,38 +303,48 @@ StringList APE::Tag::complexPropertyKeys() const
 
 List<VariantMap> APE::Tag::complexProperties(const String &key) const
 {
-  List<VariantMap> props;
+  return complexProperties(key, AllValues);
+}
+
+List<VariantMap> APE::Tag::complexProperties(const String &key,
+                                             ComplexPropertySelection selection) const
+{
   const String uppercaseKey = key.upper();
   if(uppercaseKey == "PICTURE") {
-    const StringList itemNames = StringList(FRONT_COVER).append(BACK_COVER);
-    for(const auto &itemName: itemNames) {
-      if(d->itemListMap.contains(itemName)) {
-        Item picture = d->itemListMap.value(itemName);
-        if(picture.type() == Item::Binary) {
-          ByteVector data = picture.binaryData();
-          // Do not search for a description if the first byte could start JPG or PNG
-          // data.
-          int index = data.isEmpty() || data.at(0) == '\xff' || data.at(0) == '\x89'
-              ? -1 : data.find('\0');
-          String description;
-          if(index >= 0) {
-            description = String(data.mid(0, index), String::UTF8);
-            data = data.mid(index + 1);
-          }
-
-          VariantMap property;
-          property.insert("data", data);
-          if(!description.isEmpty()) {
-            property.insert("description", description);
-          }
-          property.insert("pictureType",
-            itemName == BACK_COVER ? "Back Cover" : "Front Cover");
-          props.append(property);
-        }
+    StringList itemNames;
+    for(const auto &itemName : {FRONT_COVER, BACK_COVER}) {
+      if(d->itemListMap.contains(itemName) &&
+         d->itemListMap.value(itemName).type() == Item::Binary) {
+        itemNames.append(itemName);
       }
     }
+    return Utils::selectComplexProperties(itemNames, selection,
+      [](const String &itemName) {
+        return itemName == FRONT_COVER;
+      },
+      [this](const String &itemName) {
+        ByteVector data = d->itemListMap.value(itemName).binaryData();
+        // Do not search for a description if the first byte could start JPG or PNG
+        // data.
+        int index = data.isEmpty() || data.at(0) == '\xff' || data.at(0) == '\x89'
+            ? -1 : data.find('\0');
+        String description;
+        if(index >= 0) {
+          description = String(data.mid(0, index), String::UTF8);
+          data = data.mid(index + 1);
+        }
+
+        VariantMap property;
+        property.insert("data", data);
+        if(!description.isEmpty()) {
+          property.insert("description", description);
+        }
+        property.insert("pictureType",
+          itemName == BACK_COVER ? "Back Cover" : "Front Cover");
+        return property;
+      });
   }
-  return props;
+  return List<VariantMap>();
 }
 
 bool APE::Tag::setComplexProperties(const String &key, const List<VariantMap> &value)
@@ -475,7 +508,8 @@ void APE::Tag::parse(const ByteVector &data)
 
     const int nullPos = data.find('\0', pos + 8);
     if(nullPos < 0) {
-      debug("APE::Tag::parse() - Couldn't find a key/value separator. Stopped parsing.");
+      diagnose(Diagnostics::APE, Diagnostics::InvalidData,
+               "APE::Tag::parse() - Couldn't find a key/value separator. Stopped parsing.");
       return;
     }
 
@@ -483,7 +517,8 @@ void APE::Tag::parse(const ByteVector &data)
     const unsigned int valLength = data.toUInt(pos, false);
 
     if(valLength >= data.size() || pos > data.size() - valLength) {
-      debug("APE::Tag::parse() - Invalid val length. Stopped parsing.");
+      diagnose(Diagnostics::APE, Diagnostics::InvalidSize,
+               "APE::Tag::parse() - Invalid val length. Stopped parsing.");
       return;
     }
 
@@ -497,7 +532,8 @@ void APE::Tag::parse(const ByteVector &data)
       d->itemListMap.insert(item.key().upper(), item);
     }
     else {
-      debug("APE::Tag::parse() - Skipped an item due to an invalid key.");
+      diagnose(Diagnostics::APE, Diagnostics::InvalidData,
+               "APE::Tag::parse() - Skipped an item due to an invalid key.");
     }
 
     pos += keyLength + valLength + 9;
@@ -66,6 +66,14 @@ namespace TagLib {
        */
       Tag(TagLib::File *file, offset_t footerLocation);
 
+      /*!
+       * Create an APE tag with APE footer at \a footerLocation in \a file and
+       * parse it from \a data, which holds the bytes of the file up to and
+       * including the footer.  If \a data does not contain the complete tag,
+       * it is read from \a file instead.
+       */
+      Tag(TagLib::File *file, offset_t footerLocation, const ByteVector &data);
+
       /*!
        * Destroys this Tag instance.
        */
@@ -132,6 +140,8 @@ namespace TagLib {
 
       StringList complexPropertyKeys() const override;
       List<VariantMap> complexProperties(const String &key) const override;
+      List<VariantMap> complexProperties(const String &key,
+                                         ComplexPropertySelection selection) const override;
       bool setComplexProperties(const String &key, const List<VariantMap> &value) override;
 
       /*!
@@ -162,65 +162,72 @@ ASF::Picture ASF::Attribute::toPicture() const
   return d->pictureValue;
 }
 
-String ASF::Attribute::parse(ASF::File &f, int kind)
+String ASF::Attribute::parse(const ByteVector &data, unsigned int &offset, int kind)
 {
+  HeaderReader reader(data, offset);
   unsigned int size, nameLength;
   String name;
   d->pictureValue = Picture::fromInvalid();
   // extended content descriptor
   if(kind == 0) {
-    nameLength = readWORD(&f);
-    name = readString(&f, nameLength);
-    d->type = static_cast<ASF::Attribute::AttributeTypes>(readWORD(&f));
-    size = readWORD(&f);
+    nameLength = reader.readWORD();
+    name = reader.readString(nameLength);
+    d->type = static_cast<ASF::Attribute::AttributeTypes>(reader.readWORD());
+    size = reader.readWORD();
   }
   // metadata & metadata library
   else {
-    int temp = readWORD(&f);
+    int temp = reader.readWORD();
     // metadata library
     if(kind == 2) {
       d->language = temp;
     }
-    d->stream = readWORD(&f);
-    nameLength = readWORD(&f);
-    d->type = static_cast<ASF::Attribute::AttributeTypes>(readWORD(&f));
-    size = readDWORD(&f);
-    name = readString(&f, nameLength);
+    d->stream = reader.readWORD();
+    nameLength = reader.readWORD();
+    d->type = static_cast<ASF::Attribute::AttributeTypes>(reader.readWORD());
+    size = reader.readDWORD();
+    name = reader.readString(nameLength);
   }
 
   if(kind != 2 && size > 65535) {
-    debug("ASF::Attribute::parse() -- Value larger than 64kB");
+    diagnose(Diagnostics::ASF, Diagnostics::InvalidSize,
+             "ASF::Attribute::parse() -- Value larger than 64kB");
   }
 
   switch(d->type) {
   case WordType:
-    d->numericValue = readWORD(&f);
+    d->numericValue = reader.readWORD();
     break;
 
   case BoolType:
     if(kind == 0) {
-      d->numericValue = (readDWORD(&f) != 0);
+      d->numericValue = (reader.readDWORD() != 0);
     }
     else {
-      d->numericValue = (readWORD(&f) != 0);
+      d->numericValue = (reader.readWORD() != 0);
     }
     break;
 
   case DWordType:
-    d->numericValue = readDWORD(&f);
+    d->numericValue = reader.readDWORD();
     break;
 
   case QWordType:
-    d->numericValue = readQWORD(&f);
+    d->numericValue = reader.readQWORD();
     break;
 
   case UnicodeType:
-    d->stringValue = readString(&f, size);
+    d->stringValue = reader.readString(size);
     break;
 
   case BytesType:
   case GuidType:
-    d->byteVectorValue = f.readBlock(size);
+    // Pictures share the buffer of the header instead of being copied, other
+    // values must not keep it alive.
+    if(d->type == BytesType && name == "WM/Picture")
+      d->byteVectorValue = reader.readBlock(size);
+    else
+      d->byteVectorValue = reader.copyBlock(size);
     break;
   }
 
@@ -229,8 +236,12 @@ String ASF::Attribute::parse(ASF::File &f, int kind)
     if(d->pictureValue.isValid()) {
       d->byteVectorValue.clear();
     }
+    else {
+      d->byteVectorValue = ByteVector(d->byteVectorValue.data(), d->byteVectorValue.size());
+    }
   }
 
+  offset = reader.offset();
   return name;
 }
 
@@ -25,6 +25,8 @@
 
 #include "asffile.h"
 
+#include <algorithm>
+#include <limits>
 #include <utility>
 
 #include "tdebug.h"
@@ -89,6 +91,10 @@ namespace
   const ByteVector contentEncryptionGuid("\xFB\xB3\x11\x22\x23\xBD\xD2\x11\xB4\xB7\x00\xA0\xC9\x55\xFC\x6E", 16);
   const ByteVector extendedContentEncryptionGuid("\x14\xE6\x8A\x29\x22\x26 \x17\x4C\xB9\x35\xDA\xE0\x7E\xE9\x28\x9C", 16);
   const ByteVector advancedContentEncryptionGuid("\xB6\x9B\x07\x7A\xA4\xDA\x12\x4E\xA5\xCA\x91\xD3\x8D\xC1\x1A\x8D", 16);
+
+  // Large enough for the header object of most files, including small cover
+  // art.
+  constexpr unsigned int HeaderReadSize = 64 * 1024;
 }  // namespace
 
 class ASF::File::FilePrivate::BaseObject
@@ -97,7 +103,7 @@ public:
   ByteVector data;
   virtual ~BaseObject() = default;
   virtual ByteVector guid() const = 0;
-  virtual void parse(ASF::File *file, long long size);
+  virtual void parse(ASF::File *file, const ByteVector &objectData);
   virtual ByteVector render(ASF::File *file);
 };
 
@@ -113,21 +119,21 @@ class ASF::File::FilePrivate::FilePropertiesObject : public ASF::File::FilePriva
 {
 public:
   ByteVector guid() const override;
-  void parse(ASF::File *file, long long size) override;
+  void parse(ASF::File *file, const ByteVector &objectData) override;
 };
 
 class ASF::File::FilePrivate::StreamPropertiesObject : public ASF::File::FilePrivate::BaseObject
 {
 public:
   ByteVector guid() const override;
-  void parse(ASF::File *file, long long size) override;
+  void parse(ASF::File *file, const ByteVector &objectData) override;
 };
 
 class ASF::File::FilePrivate::ContentDescriptionObject : public ASF::File::FilePrivate::BaseObject
 {
 public:
   ByteVector guid() const override;
-  void parse(ASF::File *file, long long size) override;
+  void parse(ASF::File *file, const ByteVector &objectData) override;
   ByteVector render(ASF::File *file) override;
 };
 
@@ -136,7 +142,7 @@ class ASF::File::FilePrivate::ExtendedContentDescriptionObject : public ASF::Fil
 public:
   ByteVectorList attributeData;
   ByteVector guid() const override;
-  void parse(ASF::File *file, long long size) override;
+  void parse(ASF::File *file, const ByteVector &objectData) override;
   ByteVector render(ASF::File *file) override;
 };
 
@@ -145,7 +151,7 @@ class ASF::File::FilePrivate::MetadataObject : public ASF::File::FilePrivate::Ba
 public:
   ByteVectorList attributeData;
   ByteVector guid() const override;
-  void parse(ASF::File *file, long long size) override;
+  void parse(ASF::File *file, const ByteVector &objectData) override;
   ByteVector render(ASF::File *file) override;
 };
 
@@ -154,7 +160,7 @@ class ASF::File::FilePrivate::MetadataLibraryObject : public ASF::File::FilePriv
 public:
   ByteVectorList attributeData;
   ByteVector guid() const override;
-  void parse(ASF::File *file, long long size) override;
+  void parse(ASF::File *file, const ByteVector &objectData) override;
   ByteVector render(ASF::File *file) override;
 };
 
@@ -164,7 +170,7 @@ public:
   List<ASF::File::FilePrivate::BaseObject *> objects;
   HeaderExtensionObject();
   ByteVector guid() const override;
-  void parse(ASF::File *file, long long size) override;
+  void parse(ASF::File *file, const ByteVector &objectData) override;
   ByteVector render(ASF::File *file) override;
 };
 
@@ -172,7 +178,7 @@ class ASF::File::FilePrivate::CodecListObject : public ASF::File::FilePrivate::B
 {
 public:
   ByteVector guid() const override;
-  void parse(ASF::File *file, long long size) override;
+  void parse(ASF::File *file, const ByteVector &objectData) override;
 
 private:
   enum CodecType
@@ -183,13 +189,11 @@ private:
   };
 };
 
-void ASF::File::FilePrivate::BaseObject::parse(ASF::File *file, long long size)
+void ASF::File::FilePrivate::BaseObject::parse(ASF::File * /*file*/, const ByteVector &objectData)
 {
-  data.clear();
-  if(size > 24 && size <= file->length())
-    data = file->readBlock(size - 24);
-  else
-    data = ByteVector();
+  // objectData is a slice of the header, which must not be kept alive by the
+  // objects.
+  data = ByteVector(objectData.data(), objectData.size());
 }
 
 ByteVector ASF::File::FilePrivate::BaseObject::render(ASF::File * /*file*/)
@@ -197,7 +201,8 @@ ByteVector ASF::File::FilePrivate::BaseObject::render(ASF::File * /*file*/)
   return guid() + ByteVector::fromLongLong(data.size() + 24, false) + data;
 }
 
-ASF::File::FilePrivate::UnknownObject::UnknownObject(const ByteVector &guid) : myGuid(guid)
+ASF::File::FilePrivate::UnknownObject::UnknownObject(const ByteVector &guid) :
+  myGuid(guid.data(), guid.size())
 {
 }
 
@@ -211,11 +216,12 @@ ByteVector ASF::File::FilePrivate::FilePropertiesObject::guid() const
   return filePropertiesGuid;
 }
 
-void ASF::File::FilePrivate::FilePropertiesObject::parse(ASF::File *file, long long size)
+void ASF::File::FilePrivate::FilePropertiesObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  BaseObject::parse(file, size);
+  BaseObject::parse(file, objectData);
   if(data.size() < 64) {
-    debug("ASF::File::FilePrivate::FilePropertiesObject::parse() -- data is too short.");
+    diagnose(Diagnostics::ASF, Diagnostics::Truncated,
+             "ASF::File::FilePrivate::FilePropertiesObject::parse() -- data is too short.");
     return;
   }
 
@@ -229,11 +235,12 @@ ByteVector ASF::File::FilePrivate::StreamPropertiesObject::guid() const
   return streamPropertiesGuid;
 }
 
-void ASF::File::FilePrivate::StreamPropertiesObject::parse(ASF::File *file, long long size)
+void ASF::File::FilePrivate::StreamPropertiesObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  BaseObject::parse(file, size);
+  BaseObject::parse(file, objectData);
   if(data.size() < 70) {
-    debug("ASF::File::FilePrivate::StreamPropertiesObject::parse() -- data is too short.");
+    diagnose(Diagnostics::ASF, Diagnostics::Truncated,
+             "ASF::File::FilePrivate::StreamPropertiesObject::parse() -- data is too short.");
     return;
   }
 
@@ -249,18 +256,19 @@ ByteVector ASF::File::FilePrivate::ContentDescriptionObject::guid() const
   return contentDescriptionGuid;
 }
 
-void ASF::File::FilePrivate::ContentDescriptionObject::parse(ASF::File *file, long long /*size*/)
+void ASF::File::FilePrivate::ContentDescriptionObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  const int titleLength     = readWORD(file);
-  const int artistLength    = readWORD(file);
-  const int copyrightLength = readWORD(file);
-  const int commentLength   = readWORD(file);
-  const int ratingLength    = readWORD(file);
-  file->d->tag->setTitle(readString(file,titleLength));
-  file->d->tag->setArtist(readString(file,artistLength));
-  file->d->tag->setCopyright(readString(file,copyrightLength));
-  file->d->tag->setComment(readString(file,commentLength));
-  file->d->tag->setRating(readString(file,ratingLength));
+  HeaderReader reader(objectData);
+  const int titleLength     = reader.readWORD();
+  const int artistLength    = reader.readWORD();
+  const int copyrightLength = reader.readWORD();
+  const int commentLength   = reader.readWORD();
+  const int ratingLength    = reader.readWORD();
+  file->d->tag->setTitle(reader.readString(titleLength));
+  file->d->tag->setArtist(reader.readString(artistLength));
+  file->d->tag->setCopyright(reader.readString(copyrightLength));
+  file->d->tag->setComment(reader.readString(commentLength));
+  file->d->tag->setRating(reader.readString(ratingLength));
 }
 
 ByteVector ASF::File::FilePrivate::ContentDescriptionObject::render(ASF::File *file)
@@ -289,12 +297,16 @@ ByteVector ASF::File::FilePrivate::ExtendedContentDescriptionObject::guid() cons
   return extendedContentDescriptionGuid;
 }
 
-void ASF::File::FilePrivate::ExtendedContentDescriptionObject::parse(ASF::File *file, long long /*size*/)
+void ASF::File::FilePrivate::ExtendedContentDescriptionObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  int count = readWORD(file);
-  while(count--) {
+  if(objectData.size() < 2)
+    return;
+
+  int count = objectData.toUShort(0U, false);
+  unsigned int offset = 2;
+  while(count-- && offset < objectData.size()) {
     ASF::Attribute attribute;
-    String name = attribute.parse(*file);
+    String name = attribute.parse(objectData, offset);
     file->d->tag->addAttribute(name, attribute);
   }
 }
@@ -312,12 +324,16 @@ ByteVector ASF::File::FilePrivate::MetadataObject::guid() const
   return metadataGuid;
 }
 
-void ASF::File::FilePrivate::MetadataObject::parse(ASF::File *file, long long /*size*/)
+void ASF::File::FilePrivate::MetadataObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  int count = readWORD(file);
-  while(count--) {
+  if(objectData.size() < 2)
+    return;
+
+  int count = objectData.toUShort(0U, false);
+  unsigned int offset = 2;
+  while(count-- && offset < objectData.size()) {
     ASF::Attribute attribute;
-    String name = attribute.parse(*file, 1);
+    String name = attribute.parse(objectData, offset, 1);
     file->d->tag->addAttribute(name, attribute);
   }
 }
@@ -335,12 +351,16 @@ ByteVector ASF::File::FilePrivate::MetadataLibraryObject::guid() const
   return metadataLibraryGuid;
 }
 
-void ASF::File::FilePrivate::MetadataLibraryObject::parse(ASF::File *file, long long /*size*/)
+void ASF::File::FilePrivate::MetadataLibraryObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  int count = readWORD(file);
-  while(count--) {
+  if(objectData.size() < 2)
+    return;
+
+  int count = objectData.toUShort(0U, false);
+  unsigned int offset = 2;
+  while(count-- && offset < objectData.size()) {
     ASF::Attribute attribute;
-    String name = attribute.parse(*file, 2);
+    String name = attribute.parse(objectData, offset, 2);
     file->d->tag->addAttribute(name, attribute);
   }
 }
@@ -363,20 +383,21 @@ ByteVector ASF::File::FilePrivate::HeaderExtensionObject::guid() const
   return headerExtensionGuid;
 }
 
-void ASF::File::FilePrivate::HeaderExtensionObject::parse(ASF::File *file, long long /*size*/)
+void ASF::File::FilePrivate::HeaderExtensionObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  file->seek(18, File::Current);
-  long long dataSize = readDWORD(file);
+  HeaderReader reader(objectData);
+  reader.skip(18);
+  long long dataSize = reader.readDWORD();
   long long dataPos = 0;
   while(dataPos < dataSize) {
-    ByteVector uid = file->readBlock(16);
-    if(uid.size() != 16) {
+    ByteVector uid = reader.readBlock(16);
+    long long size = reader.readQWORD();
+    if(!reader.ok() || size < 24 || size > dataSize - dataPos) {
       file->setValid(false);
       break;
     }
-    bool ok;
-    long long size = readQWORD(file, &ok);
-    if(!ok || size < 0 || size > dataSize - dataPos) {
+    const ByteVector subObjectData = reader.readBlock(static_cast<unsigned int>(size - 24));
+    if(!reader.ok()) {
       file->setValid(false);
       break;
     }
@@ -392,7 +413,7 @@ void ASF::File::FilePrivate::HeaderExtensionObject::parse(ASF::File *file, long
     else {
       obj = new UnknownObject(uid);
     }
-    obj->parse(file, size);
+    obj->parse(file, subObjectData);
     objects.append(obj);
     dataPos += size;
   }
@@ -413,11 +434,12 @@ ByteVector ASF::File::FilePrivate::CodecListObject::guid() const
   return codecListGuid;
 }
 
-void ASF::File::FilePrivate::CodecListObject::parse(ASF::File *file, long long size)
+void ASF::File::FilePrivate::CodecListObject::parse(ASF::File *file, const ByteVector &objectData)
 {
-  BaseObject::parse(file, size);
+  BaseObject::parse(file, objectData);
   if(data.size() <= 20) {
-    debug("ASF::File::FilePrivate::CodecListObject::parse() -- data is too short.");
+    diagnose(Diagnostics::ASF, Diagnostics::Truncated,
+             "ASF::File::FilePrivate::CodecListObject::parse() -- data is too short.");
     return;
   }
 
@@ -607,8 +629,13 @@ void ASF::File::read()
   if(!isValid())
     return;
 
-  if(readBlock(16) != headerGuid) {
-    debug("ASF::File::read(): Not an ASF file.");
+  // The header object contains all of the metadata, it is read into memory
+  // as a whole and its objects are parsed from there.
+
+  ByteVector header = readBlock(HeaderReadSize);
+  if(!header.startsWith(headerGuid)) {
+    diagnose(Diagnostics::ASF, Diagnostics::InvalidHeader,
+             "ASF::File::read(): Not an ASF file.");
     setValid(false);
     return;
   }
@@ -616,32 +643,38 @@ void ASF::File::read()
   d->tag = std::make_unique<ASF::Tag>();
   d->properties = std::make_unique<ASF::Properties>();
 
-  bool ok;
-  d->headerSize = readQWORD(this, &ok);
-  if(!ok) {
+  if(header.size() < 30) {
     setValid(false);
     return;
   }
-  int numObjects = readDWORD(this, &ok);
-  if(!ok) {
+  d->headerSize = header.toLongLong(16, false);
+  const int numObjects = header.toUInt(24, false);
+
+  const auto headerSize = std::min<unsigned long long>(d->headerSize, length());
+  if(d->headerSize < 30 || headerSize > std::numeric_limits<unsigned int>::max()) {
     setValid(false);
     return;
   }
-  seek(2, Current);
+  if(header.size() < headerSize)
+    header.append(readBlock(static_cast<size_t>(headerSize - header.size())));
+  else
+    header.resize(static_cast<unsigned int>(headerSize));
+
+  HeaderReader reader(header, 30);
 
   FilePrivate::FilePropertiesObject   *filePropertiesObject   = nullptr;
   FilePrivate::StreamPropertiesObject *streamPropertiesObject = nullptr;
   for(int i = 0; i < numObjects; i++) {
-    const ByteVector guid = readBlock(16);
-    if(guid.size() != 16) {
-      setValid(false);
-      break;
-    }
-    auto size = readQWORD(this, &ok);
-    if(!ok) {
+    const ByteVector guid = reader.readBlock(16);
+    const long long size = reader.readQWORD();
+    if(!reader.ok() || size < 24) {
       setValid(false);
       break;
     }
+    // An object which claims to be larger than the header gets what is left.
+    const ByteVector objectData = reader.readBlock(
+      static_cast<unsigned int>(std::min<long long>(size - 24, reader.remaining())));
+
     FilePrivate::BaseObject *obj;
     if(guid == filePropertiesGuid) {
       filePropertiesObject = new FilePrivate::FilePropertiesObject();
@@ -674,12 +707,13 @@ void ASF::File::read()
       }
       obj = new FilePrivate::UnknownObject(guid);
     }
-    obj->parse(this, size);
+    obj->parse(this, objectData);
     d->objects.append(obj);
   }
 
   if(!filePropertiesObject || !streamPropertiesObject) {
-    debug("ASF::File::read(): Missing mandatory header objects.");
+    diagnose(Diagnostics::ASF, Diagnostics::Missing,
+             "ASF::File::read(): Missing mandatory header objects.");
     setValid(false);
     return;
   }
@@ -29,6 +29,7 @@
 #include <utility>
 
 #include "tpropertymap.h"
+#include "tagutils.h"
 #include "asfattribute.h"
 #include "asfpicture.h"
 
@@ -342,12 +343,13 @@ void ASF::Tag::removeUnsupportedProperties(const StringList &props)
 
 PropertyMap ASF::Tag::setProperties(const PropertyMap &props)
 {
-  static Map<String, String> reverseKeyMap;
-  if(reverseKeyMap.isEmpty()) {
+  static const Map<String, String> reverseKeyMap = [] {
+    Map<String, String> m;
     for(const auto &[k, t] : keyTranslation) {
-      reverseKeyMap[t] = k;
+      m[t] = k;
     }
-  }
+    return m;
+  }();
 
   const PropertyMap origProps = properties();
   for(const auto &[prop, _] : origProps) {
@@ -410,22 +412,33 @@ StringList ASF::Tag::complexPropertyKeys() const
 
 List<VariantMap> ASF::Tag::complexProperties(const String &key) const
 {
-  List<VariantMap> props;
+  return complexProperties(key, AllValues);
+}
+
+List<VariantMap> ASF::Tag::complexProperties(const String &key,
+                                             ComplexPropertySelection selection) const
+{
   const String uppercaseKey = key.upper();
   if(uppercaseKey == "PICTURE") {
-    const AttributeList pictures = d->attributeListMap.value("WM/Picture");
-    for(const Attribute &attr : pictures) {
-      ASF::Picture picture = attr.toPicture();
-      VariantMap property;
-      property.insert("data", picture.picture());
-      property.insert("mimeType", picture.mimeType());
-      property.insert("description", picture.description());
-      property.insert("pictureType",
-        ASF::Picture::typeToString(picture.type()));
-      props.append(property);
+    List<ASF::Picture> pictures;
+    for(const Attribute &attr : d->attributeListMap.value("WM/Picture")) {
+      pictures.append(attr.toPicture());
     }
+    return Utils::selectComplexProperties(pictures, selection,
+      [](const ASF::Picture &picture) {
+        return picture.type() == ASF::Picture::FrontCover;
+      },
+      [](const ASF::Picture &picture) {
+        VariantMap property;
+        property.insert("data", picture.picture());
+        property.insert("mimeType", picture.mimeType());
+        property.insert("description", picture.description());
+        property.insert("pictureType",
+          ASF::Picture::typeToString(picture.type()));
+        return property;
+      });
   }
-  return props;
+  return List<VariantMap>();
 }
 
 bool ASF::Tag::setComplexProperties(const String &key, const List<VariantMap> &value)
@@ -37,54 +37,113 @@ namespace TagLib
     namespace
     {
 
-      inline unsigned short readWORD(File *file, bool *ok = nullptr)
+      // Reads the little endian values of an ASF header object from a buffer
+      // holding the whole header.  Reads beyond the end of the buffer return
+      // zero or empty values and clear ok().  Blocks from readBlock() share
+      // the data of the buffer instead of copying it, so they keep the whole
+      // header alive; values which are kept after parsing use copyBlock().
+
+      class HeaderReader
       {
-        const ByteVector v = file->readBlock(2);
-        if(v.size() != 2) {
-          if(ok) *ok = false;
-          return 0;
+      public:
+        HeaderReader(const ByteVector &data, unsigned int offset = 0) :
+          data(data),
+          position(offset)
+        {
         }
-        if(ok) *ok = true;
-        return v.toUShort(false);
-      }
 
-      inline unsigned int readDWORD(File *file, bool *ok = nullptr)
-      {
-        const ByteVector v = file->readBlock(4);
-        if(v.size() != 4) {
-          if(ok) *ok = false;
-          return 0;
+        bool ok() const
+        {
+          return valid;
         }
-        if(ok) *ok = true;
-        return v.toUInt(false);
-      }
 
-      inline long long readQWORD(File *file, bool *ok = nullptr)
-      {
-        const ByteVector v = file->readBlock(8);
-        if(v.size() != 8) {
-          if(ok) *ok = false;
-          return 0;
+        unsigned int offset() const
+        {
+          return position;
         }
-        if(ok) *ok = true;
-        return v.toLongLong(false);
-      }
 
-      inline String readString(File *file, int length)
-      {
-        ByteVector data = file->readBlock(length);
-        unsigned int size = data.size();
-        while (size >= 2) {
-          if(data[size - 1] != '\0' || data[size - 2] != '\0') {
-            break;
+        unsigned int remaining() const
+        {
+          return position < data.size() ? data.size() - position : 0;
+        }
+
+        void skip(unsigned int length)
+        {
+          if(length > remaining()) {
+            valid = false;
+            position = data.size();
+          }
+          else {
+            position += length;
           }
-          size -= 2;
         }
-        if(size != data.size()) {
-          data.resize(size);
+
+        ByteVector readBlock(unsigned int length)
+        {
+          if(length > remaining()) {
+            valid = false;
+            position = data.size();
+            return ByteVector();
+          }
+          const ByteVector block = data.mid(position, length);
+          position += length;
+          return block;
         }
-        return String(data, String::UTF16LE);
-      }
+
+        ByteVector copyBlock(unsigned int length)
+        {
+          const ByteVector block = readBlock(length);
+          return ByteVector(block.data(), block.size());
+        }
+
+        unsigned short readWORD()
+        {
+          if(remaining() < 2) {
+            skip(2);
+            return 0;
+          }
+          position += 2;
+          return data.toUShort(position - 2, false);
+        }
+
+        unsigned int readDWORD()
+        {
+          if(remaining() < 4) {
+            skip(4);
+            return 0;
+          }
+          position += 4;
+          return data.toUInt(position - 4, false);
+        }
+
+        long long readQWORD()
+        {
+          if(remaining() < 8) {
+            skip(8);
+            return 0;
+          }
+          position += 8;
+          return data.toLongLong(position - 8, false);
+        }
+
+        String readString(unsigned int length)
+        {
+          ByteVector block = readBlock(length);
+          unsigned int size = block.size();
+          while(size >= 2) {
+            if(block[size - 1] != '\0' || block[size - 2] != '\0') {
+              break;
+            }
+            size -= 2;
+          }
+          return String(block.mid(0, size), String::UTF16LE);
+        }
+
+      private:
+        const ByteVector data;
+        unsigned int position;
+        bool valid { true };
+      };
 
       inline ByteVector renderString(const String &str, bool includeLength = false)
       {
@@ -0,0 +1,455 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "audiopayload.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "tfilestream.h"
+#include "txxhash.h"
+#include "tagutils.h"
+#include "apefooter.h"
+#include "flacfile.h"
+#include "id3v2header.h"
+#include "mpegfile.h"
+#include "mpegheader.h"
+#include "oggfile.h"
+#include "oggpageheader.h"
+#ifdef TAGLIB_WITH_DSF
+#include "dsffile.h"
+#endif
+#ifdef TAGLIB_WITH_MP4
+#include "mp4file.h"
+#endif
+#ifdef TAGLIB_WITH_RIFF
+#include "aifffile.h"
+#include "wavfile.h"
+#endif
+
+using namespace TagLib;
+
+namespace
+{
+  using Range = AudioPayload::Range;
+
+  // The payload is hashed in blocks of this size, the digest of the file is
+  // the hash of the block digests.  The blocks are the unit of work of the
+  // threads, so the digest does not depend on the number of threads.
+  constexpr size_t BlockSize = 1024 * 1024;
+
+  // Payloads smaller than this many blocks per thread are not worth starting
+  // a thread for.
+  constexpr size_t MinBlocksPerThread = 4;
+
+  // Locating the payload
+
+  void append(List<Range> &ranges, offset_t offset, offset_t length, offset_t fileLength)
+  {
+    if(offset < 0 || offset >= fileLength || length <= 0)
+      return;
+    ranges.append({ offset, std::min(length, fileLength - offset) });
+  }
+
+  List<Range> mpegRanges(MPEG::File *file)
+  {
+    List<Range> ranges;
+    const offset_t first = file->firstFrameOffset();
+    const offset_t last = file->lastFrameOffset();
+    if(first < 0 || last < first)
+      return ranges;
+
+    // The last frame may be truncated, it must not reach into the tags at the
+    // end of the file.
+    const Utils::TailProbe tail = Utils::probeTail(file);
+    offset_t tagStart = file->length();
+    if(tail.apeFooterLocation >= 0) {
+      const ByteVector data = tail.apeData();
+      const APE::Footer footer(data.mid(data.size() - APE::Footer::size()));
+      tagStart = tail.apeFooterLocation + APE::Footer::size() - footer.completeTagSize();
+    }
+    else if(tail.lyrics3Location >= 0) {
+      tagStart = tail.lyrics3Location;
+    }
+    else if(tail.id3v1Location >= 0) {
+      tagStart = tail.id3v1Location;
+    }
+
+    const MPEG::Header header(file, last, false);
+    const offset_t end = last + (header.isValid() ? header.frameLength() : 0);
+    append(ranges, first, std::min(end, tagStart) - first, file->length());
+    return ranges;
+  }
+
+  List<Range> flacRanges(FLAC::File *file)
+  {
+    List<Range> ranges;
+    const offset_t fileLength = file->length();
+
+    offset_t offset = 0;
+    if(Utils::findID3v2(file) == 0) {
+      file->seek(0);
+      offset = ID3v2::Header(file->readBlock(ID3v2::Header::size())).completeTagSize();
+    }
+    offset = file->find("fLaC", offset);
+    if(offset < 0)
+      return ranges;
+    offset += 4;
+
+    // Skip the metadata blocks, the last one has the high bit of its type set.
+    for(;;) {
+      file->seek(offset);
+      const ByteVector header = file->readBlock(4);
+      if(header.size() != 4)
+        return ranges;
+      offset += 4 + header.toUInt(1U, 3U);
+      if(header[0] & 0x80)
+        break;
+    }
+
+    const offset_t id3v1Location = Utils::findID3v1(file);
+    const offset_t end = id3v1Location >= offset ? id3v1Location : fileLength;
+    append(ranges, offset, end - offset, fileLength);
+    return ranges;
+  }
+
+#ifdef TAGLIB_WITH_MP4
+  List<Range> mp4Ranges(MP4::File *file)
+  {
+    List<Range> ranges;
+    const offset_t fileLength = file->length();
+
+    for(offset_t offset = 0; offset + 8 <= fileLength;) {
+      file->seek(offset);
+      const ByteVector header = file->readBlock(16);
+      if(header.size() < 8)
+        break;
+
+      offset_t size = header.toUInt();
+      offset_t headerSize = 8;
+      if(size == 1) {
+        if(header.size() < 16)
+          break;
+        size = header.toLongLong(8U);
+        headerSize = 16;
+      }
+      else if(size == 0) {
+        size = fileLength - offset;
+      }
+      if(size < headerSize)
+        break;
+
+      if(header.containsAt("mdat", 4))
+        append(ranges, offset + headerSize, size - headerSize, fileLength);
+      offset += size;
+    }
+    return ranges;
+  }
+#endif
+
+#ifdef TAGLIB_WITH_RIFF
+  // WAV and AIFF: the payload of the first chunk called \a id.
+  List<Range> riffRanges(File *file, const ByteVector &id, bool bigEndian)
+  {
+    List<Range> ranges;
+    const offset_t fileLength = file->length();
+
+    for(offset_t offset = 12; offset + 8 <= fileLength;) {
+      file->seek(offset);
+      const ByteVector header = file->readBlock(8);
+      if(header.size() != 8)
+        break;
+
+      const offset_t size = header.toUInt(4U, bigEndian);
+      if(header.startsWith(id)) {
+        offset_t payload = offset + 8;
+        // The sound data chunk of AIFF starts with its offset and block size.
+        if(bigEndian) {
+          file->seek(payload);
+          const ByteVector ssnd = file->readBlock(8);
+          if(ssnd.size() != 8 || size < 8)
+            break;
+          payload += 8 + ssnd.toUInt(0U, true);
+          append(ranges, payload, offset + 8 + size - payload, fileLength);
+        }
+        else {
+          append(ranges, payload, size, fileLength);
+        }
+        break;
+      }
+      offset += 8 + size + (size & 1);
+    }
+    return ranges;
+  }
+#endif
+
+#ifdef TAGLIB_WITH_DSF
+  List<Range> dsfRanges(DSF::File *file)
+  {
+    List<Range> ranges;
+    const offset_t fileLength = file->length();
+
+    // The chunk sizes are 64 bit and include the 12 byte chunk header.
+    for(offset_t offset = 0; offset + 12 <= fileLength;) {
+      file->seek(offset);
+      const ByteVector header = file->readBlock(12);
+      if(header.size() != 12)
+        break;
+
+      const offset_t size = header.toLongLong(4U, false);
+      if(size < 12)
+        break;
+      if(header.startsWith("data")) {
+        append(ranges, offset + 12, size - 12, fileLength);
+        break;
+      }
+      offset += size;
+    }
+    return ranges;
+  }
+#endif
+
+  // The bodies of the pages after the last page which ends a header packet,
+  // these have a granule position of 0.
+  List<Range> oggRanges(Ogg::File *file)
+  {
+    List<Range> ranges;
+    const offset_t fileLength = file->length();
+
+    bool audio = false;
+    for(offset_t offset = 0; offset < fileLength;) {
+      const Ogg::PageHeader header(file, offset);
+      if(!header.isValid())
+        break;
+
+      const offset_t body = offset + header.size();
+      offset = body + header.dataSize();
+
+      // Pages before this one only continued header packets.
+      if(!audio && header.absoluteGranularPosition() == 0) {
+        ranges.clear();
+        continue;
+      }
+      if(header.absoluteGranularPosition() > 0)
+        audio = true;
+      append(ranges, body, header.dataSize(), fileLength);
+    }
+
+    // A stream without audio pages has no payload.
+    if(!audio)
+      ranges.clear();
+    return ranges;
+  }
+
+  // Hashing the payload
+
+  struct Piece
+  {
+    offset_t offset;
+    offset_t length;
+    offset_t position;  // position in the concatenated payload
+  };
+
+  std::vector<Piece> pieces(const List<Range> &ranges)
+  {
+    std::vector<Piece> result;
+    result.reserve(ranges.size());
+    offset_t position = 0;
+    for(const auto &range : ranges) {
+      result.push_back({ range.offset, range.length, position });
+      position += range.length;
+    }
+    return result;
+  }
+
+  offset_t payloadLength(const std::vector<Piece> &pieces)
+  {
+    return pieces.empty() ? 0 : pieces.back().position + pieces.back().length;
+  }
+
+  // Reads \a length bytes at \a position of the concatenated payload.  Pieces
+  // which lie close to each other, like the bodies of Ogg pages, are read
+  // with a single call.
+  template <class Source>
+  ByteVector readPayload(Source *source, const std::vector<Piece> &pieces,
+                         offset_t position, size_t length)
+  {
+    auto it = std::upper_bound(pieces.begin(), pieces.end(), position,
+      [](offset_t value, const Piece &piece) { return value < piece.position; });
+    if(it == pieces.begin())
+      return ByteVector();
+    --it;
+
+    auto last = it;
+    const offset_t end = position + static_cast<offset_t>(length);
+    while(last + 1 != pieces.end() && (last + 1)->position < end)
+      ++last;
+
+    const offset_t first = it->offset + (position - it->position);
+    const offset_t spanEnd = last->offset + std::min(last->length, end - last->position);
+    const offset_t span = spanEnd - first;
+
+    if(it == last) {
+      source->seek(first);
+      return source->readBlock(length);
+    }
+
+    ByteVector data(static_cast<unsigned int>(length), 0);
+    unsigned int size = 0;
+    const auto copy = [&](const ByteVector &from, offset_t offset, offset_t count) {
+      if(offset + count > static_cast<offset_t>(from.size()))
+        count = std::max<offset_t>(0, static_cast<offset_t>(from.size()) - offset);
+      ::memcpy(data.data() + size, from.data() + offset, static_cast<size_t>(count));
+      size += static_cast<unsigned int>(count);
+    };
+
+    if(span <= static_cast<offset_t>(length + length / 4)) {
+      source->seek(first);
+      const ByteVector block = source->readBlock(static_cast<size_t>(span));
+      for(auto piece = it; piece <= last; ++piece) {
+        const offset_t from = std::max(piece->offset, first);
+        const offset_t to = std::min(piece->offset + piece->length, spanEnd);
+        copy(block, from - first, to - from);
+      }
+    }
+    else {
+      for(auto piece = it; piece <= last; ++piece) {
+        const offset_t from = std::max(piece->offset, first);
+        const offset_t to = std::min(piece->offset + piece->length, spanEnd);
+        source->seek(from);
+        copy(source->readBlock(static_cast<size_t>(to - from)), 0, to - from);
+      }
+    }
+    data.resize(size);
+    return data;
+  }
+
+  template <class Source>
+  void hashBlocks(Source *source, const std::vector<Piece> &pieces,
+                  size_t firstBlock, size_t lastBlock, std::vector<uint64_t> &digests)
+  {
+    const offset_t length = payloadLength(pieces);
+    for(size_t block = firstBlock; block < lastBlock; ++block) {
+      const offset_t position = static_cast<offset_t>(block) * BlockSize;
+      const auto size = static_cast<size_t>(std::min<offset_t>(BlockSize, length - position));
+      const ByteVector data = readPayload(source, pieces, position, size);
+      digests[block] = Utils::xxh64(data.data(), data.size());
+    }
+  }
+
+  size_t blockCount(offset_t length)
+  {
+    return static_cast<size_t>((length + BlockSize - 1) / BlockSize);
+  }
+
+  ByteVector digest(const std::vector<uint64_t> &digests, offset_t length)
+  {
+    ByteVector data;
+    for(auto value : digests)
+      data.append(ByteVector::fromULongLong(value));
+    data.append(ByteVector::fromLongLong(length));
+    return ByteVector::fromULongLong(Utils::xxh64(data.data(), data.size()));
+  }
+}  // namespace
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+List<AudioPayload::Range> AudioPayload::ranges(File *file)
+{
+  if(!file || !file->isValid())
+    return List<Range>();
+
+  if(auto mpeg = dynamic_cast<MPEG::File *>(file))
+    return mpegRanges(mpeg);
+  if(auto flac = dynamic_cast<FLAC::File *>(file))
+    return flacRanges(flac);
+#ifdef TAGLIB_WITH_MP4
+  if(auto mp4 = dynamic_cast<MP4::File *>(file))
+    return mp4Ranges(mp4);
+#endif
+#ifdef TAGLIB_WITH_RIFF
+  if(dynamic_cast<RIFF::WAV::File *>(file))
+    return riffRanges(file, "data", false);
+  if(dynamic_cast<RIFF::AIFF::File *>(file))
+    return riffRanges(file, "SSND", true);
+#endif
+#ifdef TAGLIB_WITH_DSF
+  if(auto dsf = dynamic_cast<DSF::File *>(file))
+    return dsfRanges(dsf);
+#endif
+  if(auto ogg = dynamic_cast<Ogg::File *>(file))
+    return oggRanges(ogg);
+  return List<Range>();
+}
+
+ByteVector AudioPayload::hash(File *file)
+{
+  const std::vector<Piece> payload = pieces(ranges(file));
+  const offset_t length = payloadLength(payload);
+  if(length == 0)
+    return ByteVector();
+
+  std::vector<uint64_t> digests(blockCount(length));
+  hashBlocks(file, payload, 0, digests.size(), digests);
+  return digest(digests, length);
+}
+
+ByteVector AudioPayload::hash(File *file, int fileDescriptor, unsigned int threads)
+{
+#ifdef _WIN32
+  (void)fileDescriptor;
+  (void)threads;
+  return hash(file);
+#else
+  const std::vector<Piece> payload = pieces(ranges(file));
+  const offset_t length = payloadLength(payload);
+  if(length == 0)
+    return ByteVector();
+
+  std::vector<uint64_t> digests(blockCount(length));
+
+  if(threads == 0)
+    threads = std::max(1U, std::thread::hardware_concurrency());
+  threads = static_cast<unsigned int>(
+    std::min<size_t>(threads, std::max<size_t>(1, digests.size() / MinBlocksPerThread)));
+
+  // Every thread reads a contiguous run of blocks through its own stream, the
+  // positional reads do not share a file offset.
+  const auto work = [&](size_t firstBlock, size_t lastBlock) {
+    FileStream stream(fileDescriptor, true, FileStream::BorrowDescriptor);
+    hashBlocks(&stream, payload, firstBlock, lastBlock, digests);
+  };
+
+  std::vector<std::thread> workers;
+  const size_t blocks = digests.size();
+  for(unsigned int i = 1; i < threads; ++i)
+    workers.emplace_back(work, blocks * i / threads, blocks * (i + 1) / threads);
+  work(0, blocks / threads);
+  for(auto &worker : workers)
+    worker.join();
+
+  return digest(digests, length);
+#endif
+}
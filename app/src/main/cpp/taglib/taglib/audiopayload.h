@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_AUDIOPAYLOAD_H
+#define TAGLIB_AUDIOPAYLOAD_H
+
+#include "tbytevector.h"
+#include "tlist.h"
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  class File;
+
+  //! Locates and hashes the audio data of a file, leaving out its tags
+
+  /*!
+   * The audio payload is the part of a file which stays the same when its tags
+   * are edited: the MPEG frames, the FLAC frames after the metadata blocks, the
+   * contents of the MP4 "mdat" boxes, the RIFF "data" or "SSND" chunk, the DSF
+   * "data" chunk and the bodies of the Ogg pages after the header packets.
+   *
+   * hash() returns the same digest for two files with the same audio payload,
+   * so it can be used to find copies of a recording whose tags differ, or to
+   * check that writing a tag did not touch the audio.  The digest is not a
+   * cryptographic hash.
+   *
+   * \note Ogg pages are hashed without their headers, which contain the page
+   * sequence numbers and checksums that change when the comment header grows
+   * or shrinks by a page.
+   */
+  class TAGLIB_EXPORT AudioPayload
+  {
+  public:
+    /*!
+     * A region of the file, \a length bytes starting at \a offset.
+     */
+    struct Range
+    {
+      offset_t offset;
+      offset_t length;
+    };
+
+    /*!
+     * Returns the regions of \a file which contain audio data in file order,
+     * or an empty list if the format of \a file is not supported or the file
+     * is not valid.
+     */
+    static List<Range> ranges(File *file);
+
+    /*!
+     * Returns the 8 byte digest of the audio payload of \a file, reading it
+     * through the stream of \a file.  Returns an empty ByteVector if ranges()
+     * is empty.
+     */
+    static ByteVector hash(File *file);
+
+    /*!
+     * Returns the same digest as hash(File *), but reads the payload from
+     * \a fileDescriptor, which has to refer to the file that \a file was
+     * opened from.  Large payloads are split between up to \a threads threads,
+     * each reading its part with positional reads; 0 uses one thread per
+     * hardware thread.
+     *
+     * \note The descriptor is only borrowed.  On Windows this falls back to
+     * hash(File *).
+     */
+    static ByteVector hash(File *file, int fileDescriptor, unsigned int threads = 0);
+
+  private:
+    AudioPayload() = delete;
+  };
+
+}  // namespace TagLib
+
+#endif
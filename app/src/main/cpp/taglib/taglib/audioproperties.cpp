@@ -29,6 +29,9 @@ using namespace TagLib;
 
 class AudioProperties::AudioPropertiesPrivate
 {
+public:
+  Accuracy lengthAccuracy { Exact };
+  Accuracy bitrateAccuracy { Exact };
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -62,10 +65,35 @@ int AudioProperties::sampleRate() const
   return 0;
 }
 
+AudioProperties::Accuracy AudioProperties::lengthAccuracy() const
+{
+  if(lengthInMilliseconds() <= 0)
+    return Unknown;
+  return d->lengthAccuracy;
+}
+
+AudioProperties::Accuracy AudioProperties::bitrateAccuracy() const
+{
+  if(bitrate() <= 0)
+    return Unknown;
+  return d->bitrateAccuracy;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 // protected methods
 ////////////////////////////////////////////////////////////////////////////////
 
-AudioProperties::AudioProperties(ReadStyle)
+AudioProperties::AudioProperties(ReadStyle) :
+  d(std::make_unique<AudioPropertiesPrivate>())
+{
+}
+
+void AudioProperties::setLengthAccuracy(Accuracy accuracy)
+{
+  d->lengthAccuracy = accuracy;
+}
+
+void AudioProperties::setBitrateAccuracy(Accuracy accuracy)
 {
+  d->bitrateAccuracy = accuracy;
 }
@@ -59,7 +59,27 @@ namespace TagLib {
       //! Read more of the file and make better values guesses
       Average,
       //! Read as much of the file as needed to report accurate values
-      Accurate
+      Accurate,
+      /*!
+       * Only read the headers at the beginning of the stream and never seek
+       * to its end, e.g. for slow network or FUSE backed storage.  Values
+       * which would need the end of the stream are estimated from the headers
+       * and the file size where possible, see lengthAccuracy().  Tags at the
+       * end of the file are still read.
+       */
+      HeaderOnly
+    };
+
+    /*!
+     * How reliable a reported value is.
+     */
+    enum Accuracy {
+      //! The value was read from or computed for the whole stream.
+      Exact,
+      //! The value was estimated, e.g. from a nominal bitrate and the file size.
+      Estimated,
+      //! The value could not be determined and is reported as zero.
+      Unknown
     };
 
     /*!
@@ -113,6 +133,17 @@ namespace TagLib {
      */
     virtual int channels() const = 0;
 
+    /*!
+     * Returns how reliable lengthInMilliseconds() is.  Sample rate and
+     * channels are always taken from the stream headers.
+     */
+    Accuracy lengthAccuracy() const;
+
+    /*!
+     * Returns how reliable bitrate() is.
+     */
+    Accuracy bitrateAccuracy() const;
+
   protected:
 
     /*!
@@ -124,6 +155,19 @@ namespace TagLib {
      */
     AudioProperties(ReadStyle style);
 
+    /*!
+     * Marks the length as estimated or unknown.  Values are considered exact
+     * unless a subclass says otherwise, or unknown if they are zero.
+     */
+    void setLengthAccuracy(Accuracy accuracy);
+
+    /*!
+     * Marks the bitrate as estimated or unknown.
+     *
+     * \see setLengthAccuracy()
+     */
+    void setBitrateAccuracy(Accuracy accuracy);
+
   private:
     class AudioPropertiesPrivate;
     TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
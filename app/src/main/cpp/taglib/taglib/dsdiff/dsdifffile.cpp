@@ -624,15 +624,17 @@ void DSDIFF::File::read(bool readProperties, Properties::ReadStyle propertiesSty
     unsigned long long chunkSize = readBlock(8).toLongLong(bigEndian);
 
     if(!isValidChunkID(chunkName)) {
-      debug("DSDIFF::File::read() -- Chunk '" + chunkName + "' has invalid ID");
+      diagnose(Diagnostics::DSDIFF, Diagnostics::InvalidHeader,
+               "DSDIFF::File::read() -- Chunk '" + chunkName + "' has invalid ID");
       setValid(false);
       break;
     }
 
     if(static_cast<unsigned long long>(tell()) + chunkSize >
        static_cast<unsigned long long>(length())) {
-      debug("DSDIFF::File::read() -- Chunk '" + chunkName
-            + "' has invalid size (larger than the file size)");
+      diagnose(Diagnostics::DSDIFF, Diagnostics::InvalidSize,
+               "DSDIFF::File::read() -- Chunk '" + chunkName
+               + "' has invalid size (larger than the file size)");
       setValid(false);
       break;
     }
@@ -685,14 +687,16 @@ void DSDIFF::File::read(bool readProperties, Properties::ReadStyle propertiesSty
         long long dstChunkSize = readBlock(8).toLongLong(bigEndian);
 
         if(!isValidChunkID(dstChunkName)) {
-          debug("DSDIFF::File::read() -- DST Chunk '" + dstChunkName + "' has invalid ID");
+          diagnose(Diagnostics::DSDIFF, Diagnostics::InvalidHeader,
+                   "DSDIFF::File::read() -- DST Chunk '" + dstChunkName + "' has invalid ID");
           setValid(false);
           break;
         }
 
         if(static_cast<long long>(tell()) + dstChunkSize > dstChunkEnd) {
-          debug("DSDIFF::File::read() -- DST Chunk '" + dstChunkName
-                + "' has invalid size (larger than the DST chunk)");
+          diagnose(Diagnostics::DSDIFF, Diagnostics::InvalidSize,
+                   "DSDIFF::File::read() -- DST Chunk '" + dstChunkName
+                   + "' has invalid size (larger than the DST chunk)");
           setValid(false);
           break;
         }
@@ -728,14 +732,16 @@ void DSDIFF::File::read(bool readProperties, Properties::ReadStyle propertiesSty
         long long propChunkSize = readBlock(8).toLongLong(bigEndian);
 
         if(!isValidChunkID(propChunkName)) {
-          debug("DSDIFF::File::read() -- PROP Chunk '" + propChunkName + "' has invalid ID");
+          diagnose(Diagnostics::DSDIFF, Diagnostics::InvalidHeader,
+                   "DSDIFF::File::read() -- PROP Chunk '" + propChunkName + "' has invalid ID");
           setValid(false);
           break;
         }
 
         if(static_cast<long long>(tell()) + propChunkSize > propChunkEnd) {
-          debug("DSDIFF::File::read() -- PROP Chunk '" + propChunkName
-                + "' has invalid size (larger than the PROP chunk)");
+          diagnose(Diagnostics::DSDIFF, Diagnostics::InvalidSize,
+                   "DSDIFF::File::read() -- PROP Chunk '" + propChunkName
+                   + "' has invalid size (larger than the PROP chunk)");
           setValid(false);
           break;
         }
@@ -775,14 +781,16 @@ void DSDIFF::File::read(bool readProperties, Properties::ReadStyle propertiesSty
         long long diinChunkSize = readBlock(8).toLongLong(bigEndian);
 
         if(!isValidChunkID(diinChunkName)) {
-          debug("DSDIFF::File::read() -- DIIN Chunk '" + diinChunkName + "' has invalid ID");
+          diagnose(Diagnostics::DSDIFF, Diagnostics::InvalidHeader,
+                   "DSDIFF::File::read() -- DIIN Chunk '" + diinChunkName + "' has invalid ID");
           setValid(false);
           break;
         }
 
         if(static_cast<long long>(tell()) + diinChunkSize > diinChunkEnd) {
-          debug("DSDIFF::File::read() -- DIIN Chunk '" + diinChunkName
-                + "' has invalid size (larger than the DIIN chunk)");
+          diagnose(Diagnostics::DSDIFF, Diagnostics::InvalidSize,
+                   "DSDIFF::File::read() -- DIIN Chunk '" + diinChunkName
+                   + "' has invalid size (larger than the DIIN chunk)");
           setValid(false);
           break;
         }
@@ -823,7 +831,8 @@ void DSDIFF::File::read(bool readProperties, Properties::ReadStyle propertiesSty
     return;
 
   if(d->childChunkIndex[PROPChunk] < 0) {
-    debug("DSDIFF::File::read() -- no PROP chunk found");
+    diagnose(Diagnostics::DSDIFF, Diagnostics::Missing,
+             "DSDIFF::File::read() -- no PROP chunk found");
     setValid(false);
     return;
   }
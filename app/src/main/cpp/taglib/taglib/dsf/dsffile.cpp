@@ -172,7 +172,8 @@ void DSF::File::read(AudioProperties::ReadStyle propertiesStyle)
   // DSD chunk
   ByteVector chunkName = readBlock(4);
   if(chunkName != "DSD ") {
-    debug("DSF::File::read() -- Not a DSF file.");
+    diagnose(Diagnostics::DSF, Diagnostics::InvalidHeader,
+             "DSF::File::read() -- Not a DSF file.");
     setValid(false);
     return;
   }
@@ -181,7 +182,8 @@ void DSF::File::read(AudioProperties::ReadStyle propertiesStyle)
 
   // Integrity check
   if(dsdHeaderSize != 28) {
-    debug("DSF::File::read() -- File is corrupted, wrong DSD header size");
+    diagnose(Diagnostics::DSF, Diagnostics::InvalidSize,
+             "DSF::File::read() -- File is corrupted, wrong DSD header size");
     setValid(false);
     return;
   }
@@ -190,7 +192,8 @@ void DSF::File::read(AudioProperties::ReadStyle propertiesStyle)
 
   // File is malformed or corrupted, allow trailing garbage
   if(d->fileSize > length()) {
-    debug("DSF::File::read() -- File is corrupted wrong length");
+    diagnose(Diagnostics::DSF, Diagnostics::InvalidSize,
+             "DSF::File::read() -- File is corrupted wrong length");
     setValid(false);
     return;
   }
@@ -199,7 +202,8 @@ void DSF::File::read(AudioProperties::ReadStyle propertiesStyle)
 
   // File is malformed or corrupted
   if(d->metadataOffset > d->fileSize) {
-    debug("DSF::File::read() -- Invalid metadata offset.");
+    diagnose(Diagnostics::DSF, Diagnostics::InvalidSize,
+             "DSF::File::read() -- Invalid metadata offset.");
     setValid(false);
     return;
   }
@@ -207,14 +211,16 @@ void DSF::File::read(AudioProperties::ReadStyle propertiesStyle)
   // Format chunk
   chunkName = readBlock(4);
   if(chunkName != "fmt ") {
-    debug("DSF::File::read() -- Missing 'fmt ' chunk.");
+    diagnose(Diagnostics::DSF, Diagnostics::Missing,
+             "DSF::File::read() -- Missing 'fmt ' chunk.");
     setValid(false);
     return;
   }
 
   long long fmtHeaderSize = readBlock(8).toLongLong(false);
   if(fmtHeaderSize != 52) {
-    debug("DSF::File::read() -- File is corrupted, wrong FMT header size");
+    diagnose(Diagnostics::DSF, Diagnostics::InvalidSize,
+             "DSF::File::read() -- File is corrupted, wrong FMT header size");
     setValid(false);
     return;
   }
@@ -30,33 +30,51 @@
 #include "fileref.h"
 
 #include <cstring>
+#include <mutex>
 #include <utility>
 
+#include "tarena.h"
 #include "tfilestream.h"
 #include "tpropertymap.h"
 #include "tstringlist.h"
 #include "tvariant.h"
 #include "tdebug.h"
-#include "aifffile.h"
+#include "flacfile.h"
+#include "mpegfile.h"
+#ifdef TAGLIB_WITH_APE
 #include "apefile.h"
+#include "mpcfile.h"
+#include "wavpackfile.h"
+#endif
+#ifdef TAGLIB_WITH_ASF
 #include "asffile.h"
-#include "flacfile.h"
+#endif
+#ifdef TAGLIB_WITH_DSF
+#include "dsffile.h"
+#include "dsdifffile.h"
+#endif
+#ifdef TAGLIB_WITH_MOD
 #include "itfile.h"
 #include "modfile.h"
+#include "s3mfile.h"
+#include "xmfile.h"
+#endif
+#ifdef TAGLIB_WITH_MP4
 #include "mp4file.h"
-#include "mpcfile.h"
-#include "mpegfile.h"
+#endif
+#ifdef TAGLIB_WITH_RIFF
+#include "aifffile.h"
+#include "wavfile.h"
+#endif
+#ifdef TAGLIB_WITH_TRUEAUDIO
+#include "trueaudiofile.h"
+#endif
+#ifdef TAGLIB_WITH_VORBIS
 #include "oggflacfile.h"
 #include "opusfile.h"
-#include "s3mfile.h"
 #include "speexfile.h"
-#include "trueaudiofile.h"
 #include "vorbisfile.h"
-#include "wavfile.h"
-#include "wavpackfile.h"
-#include "xmfile.h"
-#include "dsffile.h"
-#include "dsdifffile.h"
+#endif
 
 using namespace TagLib;
 
@@ -70,7 +88,18 @@ class FileRef::StreamTypeResolver::StreamTypeResolverPrivate
 
 namespace
 {
+  // Resolvers may be added while other threads create FileRefs.  Readers take
+  // a copy of the list under the lock, the implicit sharing makes this cheap
+  // and lets them iterate without holding it.  Writers therefore never modify
+  // the shared list in place but replace it with a new one.
   List<const FileRef::FileTypeResolver *> fileTypeResolvers;
+  std::mutex fileTypeResolversMutex;
+
+  List<const FileRef::FileTypeResolver *> currentFileTypeResolvers()
+  {
+    std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+    return fileTypeResolvers;
+  }
 
   // Detect the file type by user-defined resolvers.
 
@@ -84,7 +113,8 @@ namespace
     if(::strlen(fileName) == 0)
       return nullptr;
 #endif
-    for(const auto &resolver : std::as_const(fileTypeResolvers)) {
+    const auto resolvers = currentFileTypeResolvers();
+    for(const auto &resolver : resolvers) {
       File *file = resolver->createFile(fileName, readAudioProperties, audioPropertiesStyle);
       if(file)
         return file;
@@ -96,7 +126,8 @@ namespace
   File *detectByResolvers(IOStream* stream, bool readAudioProperties,
                           AudioProperties::ReadStyle audioPropertiesStyle)
   {
-    for(const auto &resolver : std::as_const(fileTypeResolvers)) {
+    const auto resolvers = currentFileTypeResolvers();
+    for(const auto &resolver : resolvers) {
       if(auto streamResolver = dynamic_cast<const FileRef::StreamTypeResolver *>(resolver)) {
         if(File *file = streamResolver->createFileFromStream(
              stream, readAudioProperties, audioPropertiesStyle))
@@ -136,6 +167,7 @@ namespace
 
     if(ext == "MP3" || ext == "MP2" || ext == "AAC")
       file = new MPEG::File(stream, readAudioProperties, audioPropertiesStyle);
+#ifdef TAGLIB_WITH_VORBIS
     else if(ext == "OGG")
       file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(ext == "OGA") {
@@ -146,28 +178,44 @@ namespace
         file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
       }
     }
+#endif
     else if(ext == "FLAC")
       file = new FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
+#ifdef TAGLIB_WITH_APE
     else if(ext == "MPC")
       file = new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(ext == "WV")
       file = new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_VORBIS
     else if(ext == "SPX")
       file = new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(ext == "OPUS")
       file = new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_TRUEAUDIO
     else if(ext == "TTA")
       file = new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_MP4
     else if(ext == "M4A" || ext == "M4R" || ext == "M4B" || ext == "M4P" || ext == "MP4" || ext == "3G2" || ext == "M4V")
       file = new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_ASF
     else if(ext == "WMA" || ext == "ASF")
       file = new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_RIFF
     else if(ext == "AIF" || ext == "AIFF" || ext == "AFC" || ext == "AIFC")
       file = new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(ext == "WAV")
       file = new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_APE
     else if(ext == "APE")
       file = new APE::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_MOD
     // module, nst and wow are possible but uncommon extensions
     else if(ext == "MOD" || ext == "MODULE" || ext == "NST" || ext == "WOW")
       file = new Mod::File(stream, readAudioProperties, audioPropertiesStyle);
@@ -177,10 +225,13 @@ namespace
       file = new IT::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(ext == "XM")
       file = new XM::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_DSF
     else if(ext == "DSF")
       file = new DSF::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(ext == "DFF" || ext == "DSDIFF")
       file = new DSDIFF::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
 
     // if file is not valid, leave it to content-based detection.
 
@@ -200,38 +251,58 @@ namespace
   {
     File *file = nullptr;
 
+    // Only the formats which are built are probed.
+
     if(MPEG::File::isSupported(stream))
       file = new MPEG::File(stream, readAudioProperties, audioPropertiesStyle);
+#ifdef TAGLIB_WITH_VORBIS
     else if(Ogg::Vorbis::File::isSupported(stream))
       file = new Ogg::Vorbis::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(Ogg::FLAC::File::isSupported(stream))
       file = new Ogg::FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
     else if(FLAC::File::isSupported(stream))
       file = new FLAC::File(stream, readAudioProperties, audioPropertiesStyle);
+#ifdef TAGLIB_WITH_APE
     else if(MPC::File::isSupported(stream))
       file = new MPC::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(WavPack::File::isSupported(stream))
       file = new WavPack::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_VORBIS
     else if(Ogg::Speex::File::isSupported(stream))
       file = new Ogg::Speex::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(Ogg::Opus::File::isSupported(stream))
       file = new Ogg::Opus::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_TRUEAUDIO
     else if(TrueAudio::File::isSupported(stream))
       file = new TrueAudio::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_MP4
     else if(MP4::File::isSupported(stream))
       file = new MP4::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_ASF
     else if(ASF::File::isSupported(stream))
       file = new ASF::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_RIFF
     else if(RIFF::AIFF::File::isSupported(stream))
       file = new RIFF::AIFF::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(RIFF::WAV::File::isSupported(stream))
       file = new RIFF::WAV::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_APE
     else if(APE::File::isSupported(stream))
       file = new APE::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
+#ifdef TAGLIB_WITH_DSF
     else if(DSF::File::isSupported(stream))
       file = new DSF::File(stream, readAudioProperties, audioPropertiesStyle);
     else if(DSDIFF::File::isSupported(stream))
       file = new DSDIFF::File(stream, readAudioProperties, audioPropertiesStyle);
+#endif
 
     // isSupported() only does a quick check, so double check the file here.
 
@@ -254,6 +325,8 @@ public:
   {
     delete file;
     delete stream;
+    if(arena)
+      arena->release();
   }
 
   FileRefPrivate(const FileRefPrivate &) = delete;
@@ -275,6 +348,7 @@ public:
 
   File *file { nullptr };
   IOStream *stream { nullptr };
+  ParseArena *arena { nullptr };
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -299,6 +373,30 @@ FileRef::FileRef(IOStream *stream, bool readAudioProperties, AudioProperties::Re
   parse(stream, readAudioProperties, audioPropertiesStyle);
 }
 
+FileRef::FileRef(FileName fileName, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle,
+                 AllocationStrategy allocation) :
+  d(std::make_shared<FileRefPrivate>())
+{
+  if(allocation == ArenaAllocation)
+    d->arena = new ParseArena;
+
+  ParseArena::Scope scope(d->arena);
+  parse(fileName, readAudioProperties, audioPropertiesStyle);
+}
+
+FileRef::FileRef(IOStream *stream, bool readAudioProperties,
+                 AudioProperties::ReadStyle audioPropertiesStyle,
+                 AllocationStrategy allocation) :
+  d(std::make_shared<FileRefPrivate>())
+{
+  if(allocation == ArenaAllocation)
+    d->arena = new ParseArena;
+
+  ParseArena::Scope scope(d->arena);
+  parse(stream, readAudioProperties, audioPropertiesStyle);
+}
+
 FileRef::FileRef(File *file) :
   d(std::make_shared<FileRefPrivate>())
 {
@@ -322,6 +420,7 @@ PropertyMap FileRef::properties() const
   if(d->isNullWithDebugMessage(__func__)) {
     return PropertyMap();
   }
+  ParseArena::Scope scope(d->arena);
   return d->file->properties();
 }
 
@@ -354,9 +453,28 @@ List<VariantMap> FileRef::complexProperties(const String &key) const
   if(d->isNullWithDebugMessage(__func__)) {
     return List<VariantMap>();
   }
+  ParseArena::Scope scope(d->arena);
   return d->file->complexProperties(key);
 }
 
+List<VariantMap> FileRef::complexProperties(const String &key,
+                                            Tag::ComplexPropertySelection selection) const
+{
+  if(d->isNullWithDebugMessage(__func__)) {
+    return List<VariantMap>();
+  }
+  ParseArena::Scope scope(d->arena);
+  return d->file->complexProperties(key, selection);
+}
+
+unsigned int FileRef::complexPropertyCount(const String &key) const
+{
+  if(d->isNullWithDebugMessage(__func__)) {
+    return 0;
+  }
+  return d->file->complexPropertyCount(key);
+}
+
 bool FileRef::setComplexProperties(const String &key, const List<VariantMap> &value)
 {
   if(d->isNullWithDebugMessage(__func__)) {
@@ -388,30 +506,47 @@ bool FileRef::save()
 
 const FileRef::FileTypeResolver *FileRef::addFileTypeResolver(const FileRef::FileTypeResolver *resolver) // static
 {
-  fileTypeResolvers.prepend(resolver);
+  List<const FileRef::FileTypeResolver *> resolvers;
+  resolvers.append(resolver);
+
+  std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+  resolvers.append(fileTypeResolvers);
+  fileTypeResolvers = resolvers;
   return resolver;
 }
 
 void FileRef::clearFileTypeResolvers() // static
 {
-  fileTypeResolvers.clear();
+  std::lock_guard<std::mutex> lock(fileTypeResolversMutex);
+  fileTypeResolvers = List<const FileRef::FileTypeResolver *>();
 }
 
 StringList FileRef::defaultFileExtensions()
 {
   StringList l;
 
+#ifdef TAGLIB_WITH_VORBIS
   l.append("ogg");
+#endif
   l.append("flac");
+#ifdef TAGLIB_WITH_VORBIS
   l.append("oga");
   l.append("opus");
+#endif
   l.append("mp3");
   l.append("mp2");
+#ifdef TAGLIB_WITH_APE
   l.append("mpc");
   l.append("wv");
+#endif
+#ifdef TAGLIB_WITH_VORBIS
   l.append("spx");
+#endif
+#ifdef TAGLIB_WITH_TRUEAUDIO
   l.append("tta");
+#endif
   l.append("aac");
+#ifdef TAGLIB_WITH_MP4
   l.append("m4a");
   l.append("m4r");
   l.append("m4b");
@@ -419,14 +554,22 @@ StringList FileRef::defaultFileExtensions()
   l.append("3g2");
   l.append("mp4");
   l.append("m4v");
+#endif
+#ifdef TAGLIB_WITH_ASF
   l.append("wma");
   l.append("asf");
+#endif
+#ifdef TAGLIB_WITH_RIFF
   l.append("aif");
   l.append("aiff");
   l.append("afc");
   l.append("aifc");
   l.append("wav");
+#endif
+#ifdef TAGLIB_WITH_APE
   l.append("ape");
+#endif
+#ifdef TAGLIB_WITH_MOD
   l.append("mod");
   l.append("module"); // alias for "mod"
   l.append("nst"); // alias for "mod"
@@ -434,9 +577,12 @@ StringList FileRef::defaultFileExtensions()
   l.append("s3m");
   l.append("it");
   l.append("xm");
+#endif
+#ifdef TAGLIB_WITH_DSF
   l.append("dsf");
   l.append("dff");
   l.append("dsdiff"); // alias for "dff"
+#endif
 
   return l;
 }
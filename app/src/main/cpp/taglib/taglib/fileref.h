@@ -142,6 +142,33 @@ namespace TagLib {
       std::unique_ptr<StreamTypeResolverPrivate> d;
     };
 
+    /*!
+     * Where the objects created while parsing a file are allocated.
+     */
+    enum AllocationStrategy {
+      //! Every object is allocated on the heap on its own.
+      HeapAllocation,
+      /*!
+       * Frames, atoms, pages and the shared data of strings and byte vectors
+       * created while the file is opened and while properties() or
+       * complexProperties() is called are placed in an arena, which is
+       * released together with the FileRef.  This turns the many small
+       * allocations of a read only scan into a few large ones.
+       *
+       * The arena only grows until the FileRef is destroyed, so this is meant
+       * for files which are opened, read and closed again, not for FileRefs
+       * which are kept around and edited repeatedly.
+       *
+       * \note Strings and byte vectors returned by the FileRef stay valid
+       * after it is destroyed, but keep the whole arena, up to 1 MiB, in
+       * memory until they are destroyed as well.  Implicit copies share that
+       * data, so values which are kept for long should be rebuilt, e.g. with
+       * String(s.toCString(true), String::UTF8) or
+       * ByteVector(v.data(), v.size()), or read with HeapAllocation.
+       */
+      ArenaAllocation
+    };
+
     /*!
      * Creates a null FileRef.
      */
@@ -178,6 +205,24 @@ namespace TagLib {
                      AudioProperties::ReadStyle
                      audioPropertiesStyle = AudioProperties::Average);
 
+    /*!
+     * Same as FileRef(FileName, bool, AudioProperties::ReadStyle), but
+     * allocates the parsed objects according to \a allocation.
+     */
+    FileRef(FileName fileName,
+            bool readAudioProperties,
+            AudioProperties::ReadStyle audioPropertiesStyle,
+            AllocationStrategy allocation);
+
+    /*!
+     * Same as FileRef(IOStream *, bool, AudioProperties::ReadStyle), but
+     * allocates the parsed objects according to \a allocation.
+     */
+    FileRef(IOStream* stream,
+            bool readAudioProperties,
+            AudioProperties::ReadStyle audioPropertiesStyle,
+            AllocationStrategy allocation);
+
     /*!
      * Construct a FileRef using \a file.  The FileRef now takes ownership of the
      * pointer and will delete the File when it passes out of scope.
@@ -278,6 +323,21 @@ namespace TagLib {
      */
     List<VariantMap> complexProperties(const String &key) const;
 
+    /*!
+     * Get the complex properties for a given \a key like
+     * complexProperties(const String &), but only those picked by
+     * \a selection, e.g. Tag::FrontCoverOrFirst to get the cover of a file
+     * without loading its other pictures.
+     */
+    List<VariantMap> complexProperties(const String &key,
+                                       Tag::ComplexPropertySelection selection) const;
+
+    /*!
+     * Returns the number of complex properties for \a key, e.g. the number
+     * of pictures for "PICTURE", without loading their data.
+     */
+    unsigned int complexPropertyCount(const String &key) const;
+
     /*!
      * Set all complex properties for a given \a key using variant maps as
      * \a value with the same format as returned by complexProperties().
@@ -27,6 +27,7 @@
 
 #include <algorithm>
 #include <utility>
+#include <vector>
 
 #include "tdebug.h"
 #include "tpropertymap.h"
@@ -48,6 +49,13 @@ namespace
   const long MinPaddingLength = 4096;
   const long MaxPaddingLegnth = 1024 * 1024;
 
+  // The metadata is read in pieces of this size, which usually covers all
+  // blocks in front of the image data of the first picture.
+  const unsigned int MetadataReadSize = 64 * 1024;
+
+  // Enough for the fields in front of the image data of most pictures.
+  const unsigned int PictureHeaderSize = 1024;
+
   const char LastBlockFlag = '\x80';
 }  // namespace
 
@@ -170,12 +178,27 @@ StringList FLAC::File::complexPropertyKeys() const
 }
 
 List<VariantMap> FLAC::File::complexProperties(const String &key) const
+{
+  return complexProperties(key, Tag::AllValues);
+}
+
+List<VariantMap> FLAC::File::complexProperties(const String &key,
+                                               Tag::ComplexPropertySelection selection) const
 {
   const String uppercaseKey = key.upper();
   if(uppercaseKey == "PICTURE") {
-    List<VariantMap> props;
+    List<const Picture *> pictures;
     for(const auto &block : std::as_const(d->blocks)) {
-      if(auto picture = dynamic_cast<Picture *>(block)) {
+      if(auto picture = dynamic_cast<const Picture *>(block))
+        pictures.append(picture);
+    }
+    // The picture data is only read from the file for the pictures which
+    // are returned.
+    return Utils::selectComplexProperties(pictures, selection,
+      [](const Picture *picture) {
+        return picture->type() == Picture::FrontCover;
+      },
+      [](const Picture *picture) {
         VariantMap property;
         property.insert("data", picture->data());
         property.insert("mimeType", picture->mimeType());
@@ -186,12 +209,21 @@ List<VariantMap> FLAC::File::complexProperties(const String &key) const
         property.insert("height", picture->height());
         property.insert("numColors", picture->numColors());
         property.insert("colorDepth", picture->colorDepth());
-        props.append(property);
-      }
-    }
-    return props;
+        return property;
+      });
   }
-  return TagLib::File::complexProperties(key);
+  return TagLib::File::complexProperties(key, selection);
+}
+
+unsigned int FLAC::File::complexPropertyCount(const String &key) const
+{
+  if(key.upper() == "PICTURE") {
+    return static_cast<unsigned int>(std::count_if(d->blocks.cbegin(), d->blocks.cend(),
+      [](MetadataBlock *block) {
+        return dynamic_cast<Picture *>(block) != nullptr;
+      }));
+  }
+  return TagLib::File::complexPropertyCount(key);
 }
 
 bool FLAC::File::setComplexProperties(const String &key, const List<VariantMap> &value)
@@ -256,7 +288,8 @@ bool FLAC::File::save()
     }
     if(commentBlock && (*it)->code() == MetadataBlock::Picture) {
       // Set the new Vorbis Comment block before the first picture block
-      d->blocks.insert(it, commentBlock);
+      it = d->blocks.insert(it, commentBlock);
+      ++it;
       commentBlock = nullptr;
     }
     ++it;
@@ -264,7 +297,15 @@ bool FLAC::File::save()
   if(commentBlock)
     d->blocks.append(commentBlock);
 
-  // Render data for the metadata blocks
+  // Render data for the metadata blocks.  Blocks which have not been read
+  // yet are copied from the file and stay lazy at their new position.
+
+  struct LazyBlock {
+    MetadataBlock *block;
+    offset_t position;
+    unsigned int length;
+  };
+  std::vector<LazyBlock> lazyBlocks;
 
   ByteVector data;
   for(const auto &block : std::as_const(d->blocks)) {
@@ -272,6 +313,8 @@ bool FLAC::File::save()
     ByteVector blockHeader = ByteVector::fromUInt(blockData.size());
     blockHeader[0] = block->code();
     data.append(blockHeader);
+    if(block->isLazy())
+      lazyBlocks.push_back({ block, data.size(), blockData.size() });
     data.append(blockData);
   }
 
@@ -346,6 +389,9 @@ bool FLAC::File::save()
     }
   }
 
+  for(const auto &lazyBlock : lazyBlocks)
+    lazyBlock.block->setContentLocation(this, d->flacStart + lazyBlock.position, lazyBlock.length);
+
   if(ID3v1Tag() && !ID3v1Tag()->isEmpty()) {
 
     // ID3v1 tag is not empty. Update the old one or create a new one.
@@ -411,8 +457,12 @@ void FLAC::File::removePicture(Picture *picture, bool del)
   if(it != d->blocks.end())
     d->blocks.erase(it);
 
+  // A picture kept by the caller must not depend on this file.
+
   if(del)
     delete picture;
+  else
+    picture->load();
 }
 
 void FLAC::File::removePictures()
@@ -526,7 +576,8 @@ void FLAC::File::scan()
     nextBlockOffset = find("fLaC");
 
   if(nextBlockOffset < 0) {
-    debug("FLAC::File::scan() -- FLAC stream not found");
+    diagnose(Diagnostics::FLAC, Diagnostics::Missing,
+             "FLAC::File::scan() -- FLAC stream not found");
     setValid(false);
     return;
   }
@@ -534,12 +585,30 @@ void FLAC::File::scan()
   nextBlockOffset += 4;
   d->flacStart = nextBlockOffset;
 
+  // Read the metadata in large pieces.  Only the stream info, the Vorbis
+  // comment and the fields in front of the image data of pictures are read
+  // right away, other blocks are read from the file when needed.
+
+  ByteVector buffer;
+  offset_t bufferOffset = 0;
+
+  const auto readRange = [&](offset_t offset, unsigned int size) {
+    if(offset < bufferOffset || offset + size > bufferOffset + buffer.size()) {
+      seek(offset);
+      buffer = readBlock(std::max(size, MetadataReadSize));
+      bufferOffset = offset;
+    }
+    return buffer.mid(static_cast<unsigned int>(offset - bufferOffset), size);
+  };
+
+  const offset_t fileLength = length();
+
   while(true) {
 
-    seek(nextBlockOffset);
-    const ByteVector header = readBlock(4);
+    const ByteVector header = readRange(nextBlockOffset, 4);
     if(header.size() != 4) {
-      debug("FLAC::File::scan() -- Failed to read a block header");
+      diagnose(Diagnostics::FLAC, Diagnostics::Truncated,
+               "FLAC::File::scan() -- Failed to read a block header");
       setValid(false);
       return;
     }
@@ -563,7 +632,8 @@ void FLAC::File::scan()
     // First block should be the stream_info metadata
 
     if(d->blocks.isEmpty() && blockType != MetadataBlock::StreamInfo) {
-      debug("FLAC::File::scan() -- First block should be the stream_info metadata");
+      diagnose(Diagnostics::FLAC, Diagnostics::InvalidHeader,
+               "FLAC::File::scan() -- First block should be the stream_info metadata");
       setValid(false);
       return;
     }
@@ -571,37 +641,60 @@ void FLAC::File::scan()
     if(blockLength == 0
       && blockType != MetadataBlock::Padding && blockType != MetadataBlock::SeekTable)
     {
-      debug("FLAC::File::scan() -- Zero-sized metadata block found");
+      diagnose(Diagnostics::FLAC, Diagnostics::InvalidSize,
+               "FLAC::File::scan() -- Zero-sized metadata block found");
       setValid(false);
       return;
     }
 
-    const ByteVector data = readBlock(blockLength);
-    if(data.size() != blockLength) {
-      debug("FLAC::File::scan() -- Failed to read a metadata block");
+    const offset_t dataOffset = nextBlockOffset + 4;
+    if(dataOffset + blockLength > fileLength) {
+      diagnose(Diagnostics::FLAC, Diagnostics::Truncated,
+               "FLAC::File::scan() -- Failed to read a metadata block");
       setValid(false);
       return;
     }
 
     MetadataBlock *block = nullptr;
 
-    // Found the vorbis-comment
-    if(blockType == MetadataBlock::VorbisComment) {
-      if(d->xiphCommentData.isEmpty()) {
+    if(blockType == MetadataBlock::StreamInfo || blockType == MetadataBlock::VorbisComment) {
+      const ByteVector data = readRange(dataOffset, blockLength);
+      if(data.size() != blockLength) {
+        diagnose(Diagnostics::FLAC, Diagnostics::Truncated,
+                 "FLAC::File::scan() -- Failed to read a metadata block");
+        setValid(false);
+        return;
+      }
+
+      if(blockType == MetadataBlock::StreamInfo) {
+        block = new UnknownMetadataBlock(blockType, data);
+      }
+      // Found the vorbis-comment
+      else if(d->xiphCommentData.isEmpty()) {
         d->xiphCommentData = data;
         block = new UnknownMetadataBlock(MetadataBlock::VorbisComment, data);
       }
       else {
-        debug("FLAC::File::scan() -- multiple Vorbis Comment blocks found, discarding");
+        diagnose(Diagnostics::FLAC, Diagnostics::Duplicate,
+                 "FLAC::File::scan() -- multiple Vorbis Comment blocks found, discarding");
       }
     }
     else if(blockType == MetadataBlock::Picture) {
       auto picture = new FLAC::Picture();
-      if(picture->parse(data)) {
+      const ByteVector pictureHeader =
+        readRange(dataOffset, std::min(blockLength, PictureHeaderSize));
+      if(picture->parseHeader(pictureHeader, blockLength)) {
+        picture->setContentLocation(this, dataOffset, blockLength);
+        block = picture;
+      }
+      else if(pictureHeader.size() < blockLength
+              && picture->parse(readRange(dataOffset, blockLength))) {
+        // Unusually long mime type or description
         block = picture;
       }
       else {
-        debug("FLAC::File::scan() -- invalid picture found, discarding");
+        diagnose(Diagnostics::FLAC, Diagnostics::InvalidData,
+                 "FLAC::File::scan() -- invalid picture found, discarding");
         delete picture;
       }
     }
@@ -609,7 +702,8 @@ void FLAC::File::scan()
       // Skip all padding blocks.
     }
     else {
-      block = new UnknownMetadataBlock(blockType, data);
+      block = new UnknownMetadataBlock(blockType, ByteVector());
+      block->setContentLocation(this, dataOffset, blockLength);
     }
 
     if(block)
@@ -189,6 +189,14 @@ namespace TagLib {
        * for \a key "PICTURE".
        */
       List<VariantMap> complexProperties(const String &key) const override;
+      List<VariantMap> complexProperties(const String &key,
+                                         Tag::ComplexPropertySelection selection) const override;
+
+      /*!
+       * Returns the number of pictures stored in METADATA_BLOCK_PICTURE for
+       * \a key "PICTURE" without reading their data.
+       */
+      unsigned int complexPropertyCount(const String &key) const override;
 
       /*!
        * Set the complex properties \a value as pictures in METADATA_BLOCK_PICTURE
@@ -25,12 +25,63 @@
 
 #include "flacmetadatablock.h"
 
+#include "tdebug.h"
+#include "tfile.h"
+
 using namespace TagLib;
 
 class FLAC::MetadataBlock::MetadataBlockPrivate
 {
+public:
+  TagLib::File *file { nullptr };
+  offset_t offset { 0 };
+  unsigned int length { 0 };
 };
 
 FLAC::MetadataBlock::MetadataBlock() = default;
 
 FLAC::MetadataBlock::~MetadataBlock() = default;
+
+////////////////////////////////////////////////////////////////////////////////
+// protected members
+////////////////////////////////////////////////////////////////////////////////
+
+bool FLAC::MetadataBlock::isLazy() const
+{
+  return d && d->file;
+}
+
+ByteVector FLAC::MetadataBlock::readContent() const
+{
+  if(!isLazy())
+    return ByteVector();
+
+  d->file->seek(d->offset);
+  ByteVector content = d->file->readBlock(d->length);
+  if(content.size() != d->length) {
+    diagnose(Diagnostics::FLAC, Diagnostics::Truncated,
+             "FLAC::MetadataBlock::readContent() -- Failed to read the block.");
+    content.resize(d->length);
+  }
+  return content;
+}
+
+void FLAC::MetadataBlock::detach()
+{
+  d.reset();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void FLAC::MetadataBlock::setContentLocation(TagLib::File *file, offset_t offset,
+                                             unsigned int length)
+{
+  if(!d)
+    d = std::make_unique<MetadataBlockPrivate>();
+
+  d->file = file;
+  d->offset = offset;
+  d->length = length;
+}
@@ -29,9 +29,16 @@
 #include "tlist.h"
 #include "tbytevector.h"
 #include "taglib_export.h"
+#include "taglib.h"
 
 namespace TagLib {
+
+  class File;
+
   namespace FLAC {
+
+    class File;
+
     class TAGLIB_EXPORT MetadataBlock
     {
     public:
@@ -61,7 +68,30 @@ namespace TagLib {
        */
       virtual ByteVector render() const = 0;
 
+    protected:
+      /*!
+       * Returns true if the content of the block has not been read yet and
+       * has to be read from the file when needed.
+       */
+      bool isLazy() const;
+
+      /*!
+       * Reads the complete content of a lazy block from the file.  Returns an
+       * empty vector if the block is not lazy.
+       */
+      ByteVector readContent() const;
+
+      /*!
+       * Makes the block independent from the file, which has to be done
+       * before its content is changed.
+       */
+      void detach();
+
     private:
+      friend class File;
+
+      void setContentLocation(TagLib::File *file, offset_t offset, unsigned int length);
+
       class MetadataBlockPrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
       std::unique_ptr<MetadataBlockPrivate> d;
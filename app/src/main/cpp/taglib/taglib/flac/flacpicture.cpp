@@ -40,6 +40,11 @@ public:
   int colorDepth { 0 };
   int numColors { 0 };
   ByteVector data;
+
+  // Location of the image data in the block, which is read when needed.
+  unsigned int dataPosition { 0 };
+  unsigned int dataLength { 0 };
+  bool loaded { false };
 };
 
 FLAC::Picture::Picture() :
@@ -62,51 +67,34 @@ int FLAC::Picture::code() const
 
 bool FLAC::Picture::parse(const ByteVector &data)
 {
+  detach();
+  d->loaded = false;
+
   if(data.size() < 32) {
-    debug("A picture block must contain at least 5 bytes.");
+    diagnose(Diagnostics::FLAC, Diagnostics::Truncated,
+             "A picture block must contain at least 5 bytes.");
     return false;
   }
 
-  unsigned int pos = 0;
-  d->type = static_cast<FLAC::Picture::Type>(data.toUInt(pos));
-  pos += 4;
-  unsigned int mimeTypeLength = data.toUInt(pos);
-  pos += 4;
-  if(pos + mimeTypeLength + 24 > data.size()) {
-    debug("Invalid picture block.");
+  if(!parseHeader(data, data.size())) {
+    diagnose(Diagnostics::FLAC, Diagnostics::InvalidData,
+             "Invalid picture block.");
     return false;
   }
-  d->mimeType = String(data.mid(pos, mimeTypeLength), String::UTF8);
-  pos += mimeTypeLength;
-  unsigned int descriptionLength = data.toUInt(pos);
-  pos += 4;
-  if(pos + descriptionLength + 20 > data.size()) {
-    debug("Invalid picture block.");
-    return false;
-  }
-  d->description = String(data.mid(pos, descriptionLength), String::UTF8);
-  pos += descriptionLength;
-  d->width = data.toUInt(pos);
-  pos += 4;
-  d->height = data.toUInt(pos);
-  pos += 4;
-  d->colorDepth = data.toUInt(pos);
-  pos += 4;
-  d->numColors = data.toUInt(pos);
-  pos += 4;
-  unsigned int dataLength = data.toUInt(pos);
-  pos += 4;
-  if(pos + dataLength > data.size()) {
-    debug("Invalid picture block.");
-    return false;
-  }
-  d->data = data.mid(pos, dataLength);
+
+  d->data = data.mid(d->dataPosition, d->dataLength);
 
   return true;
 }
 
 ByteVector FLAC::Picture::render() const
 {
+  // An unchanged block is copied from the file without reading the image
+  // data into memory.
+
+  if(isLazy())
+    return readContent();
+
   ByteVector result;
   result.append(ByteVector::fromUInt(d->type));
   ByteVector mimeTypeData = d->mimeType.data(String::UTF8);
@@ -131,6 +119,7 @@ FLAC::Picture::Type FLAC::Picture::type() const
 
 void FLAC::Picture::setType(FLAC::Picture::Type type)
 {
+  load();
   d->type = type;
 }
 
@@ -141,6 +130,7 @@ String FLAC::Picture::mimeType() const
 
 void FLAC::Picture::setMimeType(const String &mimeType)
 {
+  load();
   d->mimeType = mimeType;
 }
 
@@ -151,6 +141,7 @@ String FLAC::Picture::description() const
 
 void FLAC::Picture::setDescription(const String &description)
 {
+  load();
   d->description = description;
 }
 
@@ -161,6 +152,7 @@ int FLAC::Picture::width() const
 
 void FLAC::Picture::setWidth(int width)
 {
+  load();
   d->width = width;
 }
 
@@ -171,6 +163,7 @@ int FLAC::Picture::height() const
 
 void FLAC::Picture::setHeight(int height)
 {
+  load();
   d->height = height;
 }
 
@@ -181,6 +174,7 @@ int FLAC::Picture::colorDepth() const
 
 void FLAC::Picture::setColorDepth(int colorDepth)
 {
+  load();
   d->colorDepth = colorDepth;
 }
 
@@ -191,15 +185,76 @@ int FLAC::Picture::numColors() const
 
 void FLAC::Picture::setNumColors(int numColors)
 {
+  load();
   d->numColors = numColors;
 }
 
 ByteVector FLAC::Picture::data() const
 {
+  if(isLazy() && !d->loaded) {
+    d->data = readContent().mid(d->dataPosition, d->dataLength);
+    d->loaded = true;
+  }
   return d->data;
 }
 
 void FLAC::Picture::setData(const ByteVector &data)
 {
+  detach();
   d->data = data;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+bool FLAC::Picture::parseHeader(const ByteVector &header, unsigned int length)
+{
+  if(length < 32 || header.size() < 8)
+    return false;
+
+  unsigned int pos = 0;
+  const auto type = static_cast<FLAC::Picture::Type>(header.toUInt(pos));
+  pos += 4;
+  const unsigned int mimeTypeLength = header.toUInt(pos);
+  pos += 4;
+  if(mimeTypeLength > length || pos + mimeTypeLength + 24 > length ||
+     pos + mimeTypeLength + 4 > header.size())
+    return false;
+  const ByteVector mimeType = header.mid(pos, mimeTypeLength);
+  pos += mimeTypeLength;
+  const unsigned int descriptionLength = header.toUInt(pos);
+  pos += 4;
+  if(descriptionLength > length || pos + descriptionLength + 20 > length ||
+     pos + descriptionLength + 20 > header.size())
+    return false;
+  d->type = type;
+  d->mimeType = String(mimeType, String::UTF8);
+  d->description = String(header.mid(pos, descriptionLength), String::UTF8);
+  pos += descriptionLength;
+  d->width = header.toUInt(pos);
+  pos += 4;
+  d->height = header.toUInt(pos);
+  pos += 4;
+  d->colorDepth = header.toUInt(pos);
+  pos += 4;
+  d->numColors = header.toUInt(pos);
+  pos += 4;
+  const unsigned int dataLength = header.toUInt(pos);
+  pos += 4;
+  if(dataLength > length || pos + dataLength > length)
+    return false;
+
+  d->dataPosition = pos;
+  d->dataLength = dataLength;
+
+  return true;
+}
+
+void FLAC::Picture::load()
+{
+  if(isLazy()) {
+    data();
+    detach();
+  }
+}
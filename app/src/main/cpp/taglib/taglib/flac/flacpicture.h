@@ -151,6 +151,21 @@ namespace TagLib {
       bool parse(const ByteVector &rawData);
 
     private:
+      friend class File;
+
+      /*!
+       * Parses the fields in front of the image data from \a header, which
+       * is the beginning of a block of \a length bytes.  The image data is
+       * read from the file when it is first needed.  Returns false if the
+       * block is invalid or \a header does not contain all fields.
+       */
+      bool parseHeader(const ByteVector &header, unsigned int length);
+
+      /*!
+       * Reads the image data if needed and detaches the block from the file.
+       */
+      void load();
+
       class PicturePrivate;
       TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
       std::unique_ptr<PicturePrivate> d;
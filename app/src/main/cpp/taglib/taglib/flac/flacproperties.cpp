@@ -99,7 +99,8 @@ ByteVector FLAC::Properties::signature() const
 void FLAC::Properties::read(const ByteVector &data, offset_t streamLength)
 {
   if(data.size() < 18) {
-    debug("FLAC::Properties::read() - FLAC properties must contain at least 18 bytes.");
+    diagnose(Diagnostics::FLAC, Diagnostics::Truncated,
+             "FLAC::Properties::read() - FLAC properties must contain at least 18 bytes.");
     return;
   }
 
@@ -32,6 +32,7 @@ class FLAC::UnknownMetadataBlock::UnknownMetadataBlockPrivate
 public:
   int code { 0 };
   ByteVector data;
+  bool loaded { false };
 };
 
 FLAC::UnknownMetadataBlock::UnknownMetadataBlock(int code, const ByteVector &data) :
@@ -55,15 +56,25 @@ void FLAC::UnknownMetadataBlock::setCode(int code)
 
 ByteVector FLAC::UnknownMetadataBlock::data() const
 {
+  if(isLazy() && !d->loaded) {
+    d->data = readContent();
+    d->loaded = true;
+  }
   return d->data;
 }
 
 void FLAC::UnknownMetadataBlock::setData(const ByteVector &data)
 {
+  detach();
   d->data = data;
 }
 
 ByteVector FLAC::UnknownMetadataBlock::render() const
 {
+  // Unchanged content is copied from the file without keeping it in memory.
+
+  if(isLazy() && !d->loaded)
+    return readContent();
+
   return d->data;
 }
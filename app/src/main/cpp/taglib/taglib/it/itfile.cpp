@@ -191,11 +191,13 @@ void IT::File::read(bool)
   if(!isOpen())
     return;
 
-  seek(0);
-  READ_ASSERT(readBlock(4) == "IMPM");
+  Mod::HeaderReader reader(this);
+
+  reader.seek(0);
+  READ_ASSERT(reader.readBlock(4) == "IMPM");
   READ_STRING(d->tag.setTitle, 26);
 
-  seek(2, Current);
+  reader.seek(2, Current);
 
   READ_U16L_AS(length);
   READ_U16L_AS(instrumentCount);
@@ -223,8 +225,8 @@ void IT::File::read(bool)
   if(special & Properties::MessageAttached) {
     READ_U16L_AS(messageLength);
     READ_U32L_AS(messageOffset);
-    seek(messageOffset);
-    ByteVector messageBytes = readBlock(messageLength);
+    reader.seek(messageOffset);
+    ByteVector messageBytes = reader.readBlock(messageLength);
     READ_ASSERT(messageBytes.size() == messageLength);
     int index = messageBytes.find(static_cast<char>(0));
     if(index > -1)
@@ -233,10 +235,10 @@ void IT::File::read(bool)
     message = messageBytes;
   }
 
-  seek(64);
+  reader.seek(64);
 
-  ByteVector pannings = readBlock(64);
-  ByteVector volumes  = readBlock(64);
+  ByteVector pannings = reader.readBlock(64);
+  ByteVector volumes  = reader.readBlock(64);
   READ_ASSERT(pannings.size() == 64 && volumes.size() == 64);
   int channels = 0;
   for(int i = 0; i < 64; ++ i) {
@@ -267,28 +269,28 @@ void IT::File::read(bool)
   //       e.g. VLC seems to interpret a nil as a space. I
   //       don't know what is the proper behaviour.
   for(unsigned short i = 0; i < instrumentCount; ++ i) {
-    seek(192L + length + (static_cast<long>(i) << 2));
+    reader.seek(192L + length + (static_cast<long>(i) << 2));
     READ_U32L_AS(instrumentOffset);
-    seek(instrumentOffset);
+    reader.seek(instrumentOffset);
 
-    ByteVector instrumentMagic = readBlock(4);
+    ByteVector instrumentMagic = reader.readBlock(4);
     READ_ASSERT(instrumentMagic == "IMPI");
 
     READ_STRING_AS(dosFileName, 13);
 
-    seek(15, Current);
+    reader.seek(15, Current);
 
     READ_STRING_AS(instrumentName, 26);
     comment.append(instrumentName);
   }
 
   for(unsigned short i = 0; i < sampleCount; ++ i) {
-    seek(192L + length + (static_cast<long>(instrumentCount) << 2) + (static_cast<long>(i) << 2));
+    reader.seek(192L + length + (static_cast<long>(instrumentCount) << 2) + (static_cast<long>(i) << 2));
     READ_U32L_AS(sampleOffset);
 
-    seek(sampleOffset);
+    reader.seek(sampleOffset);
 
-    ByteVector sampleMagic = readBlock(4);
+    ByteVector sampleMagic = reader.readBlock(4);
     READ_ASSERT(sampleMagic == "IMPS");
 
     READ_STRING_AS(dosFileName, 13);
@@ -112,8 +112,10 @@ void Mod::File::read(bool)
   if(!isOpen())
     return;
 
-  seek(1080);
-  ByteVector modId = readBlock(4);
+  Mod::HeaderReader reader(this);
+
+  reader.seek(1080);
+  ByteVector modId = reader.readBlock(4);
   READ_ASSERT(modId.size() == 4);
 
   int          channels    =  4;
@@ -157,7 +159,7 @@ void Mod::File::read(bool)
   d->properties.setChannels(channels);
   d->properties.setInstrumentCount(instruments);
 
-  seek(0);
+  reader.seek(0);
   READ_STRING(d->tag.setTitle, 20);
 
   offset_t pos = 20;
@@ -166,7 +168,7 @@ void Mod::File::read(bool)
     READ_STRING_AS(instrumentName, 22);
     // skip unused data
     pos += 22 + 2 + 1 + 1 + 2 + 2;
-    seek(pos);
+    reader.seek(pos);
 
     // // value in words, * 2 (<< 1) for bytes:
     // READ_U16B_AS(sampleLength);
@@ -24,10 +24,26 @@
  ***************************************************************************/
 
 #include "modfilebase.h"
+#include "modfileprivate.h"
 
 using namespace TagLib;
 using namespace Mod;
 
+namespace
+{
+  // Cuts a name at the first nil and replaces 0xff with spaces.
+  String decodeString(ByteVector data)
+  {
+    int index = data.find(static_cast<char>(0));
+    if(index > -1)
+    {
+      data.resize(index);
+    }
+    data.replace('\xff', ' ');
+    return data;
+  }
+}  // namespace
+
 class Mod::FileBase::FileBasePrivate
 {
 };
@@ -53,14 +69,7 @@ bool Mod::FileBase::readString(String &s, unsigned long size)
 {
   ByteVector data(readBlock(size));
   if(data.size() < size) return false;
-  int index = data.find(static_cast<char>(0));
-  if(index > -1)
-  {
-    data.resize(index);
-  }
-  data.replace('\xff', ' ');
-
-  s = data;
+  s = decodeString(data);
   return true;
 }
 
@@ -127,3 +136,110 @@ bool Mod::FileBase::readU32B(unsigned long &number) {
   number = data.toUInt(true);
   return true;
 }
+
+////////////////////////////////////////////////////////////////////////////////
+// HeaderReader
+////////////////////////////////////////////////////////////////////////////////
+
+Mod::HeaderReader::HeaderReader(TagLib::File *file, unsigned int windowSize) :
+  file(file),
+  windowSize(windowSize)
+{
+}
+
+void Mod::HeaderReader::seek(offset_t offset, TagLib::File::Position p)
+{
+  if(p == TagLib::File::Beginning)
+    position = offset;
+  else if(p == TagLib::File::Current)
+    position += offset;
+  else
+    position = file->length() + offset;
+}
+
+offset_t Mod::HeaderReader::tell() const
+{
+  return position;
+}
+
+ByteVector Mod::HeaderReader::readBlock(unsigned long length)
+{
+  if(position < 0)
+    return ByteVector();
+
+  const offset_t windowEnd = windowOffset + window.size();
+  if(position < windowOffset || position + static_cast<offset_t>(length) > windowEnd) {
+    // Blocks larger than the window are read as they are, they are usually
+    // messages or sample data which would only push the headers out.
+    if(length > windowSize) {
+      file->seek(position);
+      const ByteVector data = file->readBlock(length);
+      position += data.size();
+      return data;
+    }
+    // A window which reached the end of the file is not read again.
+    if(!windowAtEnd || position < windowOffset) {
+      file->seek(position);
+      window = file->readBlock(windowSize);
+      windowOffset = position;
+      windowAtEnd = window.size() < windowSize;
+    }
+  }
+
+  const offset_t index = position - windowOffset;
+  if(index >= static_cast<offset_t>(window.size()))
+    return ByteVector();
+
+  const ByteVector data = window.mid(static_cast<unsigned int>(index),
+                                     static_cast<unsigned int>(length));
+  position += data.size();
+  return data;
+}
+
+bool Mod::HeaderReader::readString(String &s, unsigned long size)
+{
+  const ByteVector data(readBlock(size));
+  if(data.size() < size) return false;
+  s = decodeString(data);
+  return true;
+}
+
+bool Mod::HeaderReader::readByte(unsigned char &byte)
+{
+  const ByteVector data(readBlock(1));
+  if(data.size() < 1) return false;
+  byte = data[0];
+  return true;
+}
+
+bool Mod::HeaderReader::readU16L(unsigned short &number)
+{
+  const ByteVector data(readBlock(2));
+  if(data.size() < 2) return false;
+  number = data.toUShort(false);
+  return true;
+}
+
+bool Mod::HeaderReader::readU32L(unsigned long &number)
+{
+  const ByteVector data(readBlock(4));
+  if(data.size() < 4) return false;
+  number = data.toUInt(false);
+  return true;
+}
+
+bool Mod::HeaderReader::readU16B(unsigned short &number)
+{
+  const ByteVector data(readBlock(2));
+  if(data.size() < 2) return false;
+  number = data.toUShort(true);
+  return true;
+}
+
+bool Mod::HeaderReader::readU32B(unsigned long &number)
+{
+  const ByteVector data(readBlock(4));
+  if(data.size() < 4) return false;
+  number = data.toUInt(true);
+  return true;
+}
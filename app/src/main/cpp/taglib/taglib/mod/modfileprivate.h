@@ -22,7 +22,55 @@
 #ifndef TAGLIB_MODFILEPRIVATE_H
 #define TAGLIB_MODFILEPRIVATE_H
 
-// some helper-macros only used internally by (s3m|it|xm)file.cpp
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include "tfile.h"
+#include "tstring.h"
+
+namespace TagLib {
+  namespace Mod {
+
+    // Reads the headers of a module through a window of the file.  The many
+    // small fields and name tables are decoded from memory, a read is only
+    // needed when a field lies outside of the current window.  The position of
+    // the file itself is not changed by seek().
+    class HeaderReader
+    {
+    public:
+      static constexpr unsigned int DefaultWindowSize = 64 * 1024;
+
+      HeaderReader(TagLib::File *file, unsigned int windowSize = DefaultWindowSize);
+
+      void seek(offset_t offset, TagLib::File::Position p = TagLib::File::Beginning);
+      offset_t tell() const;
+
+      ByteVector readBlock(unsigned long length);
+
+      bool readString(String &s, unsigned long size);
+      bool readByte(unsigned char &byte);
+      bool readU16L(unsigned short &number);
+      bool readU32L(unsigned long &number);
+      bool readU16B(unsigned short &number);
+      bool readU32B(unsigned long &number);
+
+    private:
+      TagLib::File *const file;
+      const unsigned int windowSize;
+      ByteVector window;
+      offset_t windowOffset { 0 };
+      bool windowAtEnd { false };
+      offset_t position { 0 };
+    };
+
+  }  // namespace Mod
+}  // namespace TagLib
+
+#endif
+
+// some helper-macros only used internally by (mod|s3m|it|xm)file.cpp, they
+// read through a HeaderReader called reader
 #define READ_ASSERT(cond)                                                 \
   do {                                                                    \
     if(!(cond)) {                                                         \
@@ -34,7 +82,7 @@
 #define READ(setter, type, read)                                          \
   do {                                                                    \
     type number;                                                          \
-    READ_ASSERT(read(number));                                            \
+    READ_ASSERT(reader.read(number));                                     \
     setter(number);                                                       \
   } while(0)
 
@@ -47,13 +95,13 @@
 #define READ_STRING(setter, size)                                         \
   do {                                                                    \
     String s;                                                             \
-    READ_ASSERT(readString(s, size));                                     \
+    READ_ASSERT(reader.readString(s, size));                              \
     setter(s);                                                            \
   } while(0)
 
 #define READ_AS(type, name, read)                                         \
   type name = 0;                                                          \
-  READ_ASSERT(read(name))
+  READ_ASSERT(reader.read(name))
 
 #define READ_BYTE_AS(name) READ_AS(unsigned char, name, readByte)
 #define READ_U16L_AS(name) READ_AS(unsigned short, name, readU16L)
@@ -63,5 +111,5 @@
 
 #define READ_STRING_AS(name, size)                                        \
   String name;                                                            \
-  READ_ASSERT(readString(name, size))
+  READ_ASSERT(reader.readString(name, size))
 #endif
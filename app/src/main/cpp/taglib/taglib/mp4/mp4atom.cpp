@@ -28,6 +28,7 @@
 #include <climits>
 #include <utility>
 
+#include "tarena.h"
 #include "tdebug.h"
 
 using namespace TagLib;
@@ -59,7 +60,8 @@ MP4::Atom::Atom(File *file)
   if(header.size() != 8) {
     // The atom header must be 8 bytes long, otherwise there is either
     // trailing garbage or the file is truncated
-    debug("MP4: Couldn't read 8 bytes of data for atom header");
+    diagnose(Diagnostics::MP4, Diagnostics::Truncated,
+             "MP4: Couldn't read 8 bytes of data for atom header");
     d->length = 0;
     file->seek(0, File::End);
     return;
@@ -79,7 +81,8 @@ MP4::Atom::Atom(File *file)
       d->length = static_cast<long>(longLength);
     }
     else {
-      debug("MP4: 64-bit atoms are not supported");
+      diagnose(Diagnostics::MP4, Diagnostics::Unsupported,
+               "MP4: 64-bit atoms are not supported");
       d->length = 0;
       file->seek(0, File::End);
       return;
@@ -87,7 +90,8 @@ MP4::Atom::Atom(File *file)
   }
 
   if(d->length < 8 || d->length > file->length() - d->offset) {
-    debug("MP4: Invalid atom size");
+    diagnose(Diagnostics::MP4, Diagnostics::InvalidSize,
+             "MP4: Invalid atom size");
     d->length = 0;
     file->seek(0, File::End);
     return;
@@ -97,7 +101,8 @@ MP4::Atom::Atom(File *file)
   for(int i = 0; i < 4; ++i) {
     const char ch = d->name.at(i);
     if((ch < ' ' || ch > '~') && ch != '\251') {
-      debug("MP4: Invalid atom type");
+      diagnose(Diagnostics::MP4, Diagnostics::InvalidHeader,
+               "MP4: Invalid atom type");
       d->length = 0;
       file->seek(0, File::End);
     }
@@ -136,6 +141,16 @@ MP4::Atom::Atom(File *file)
 
 MP4::Atom::~Atom() = default;
 
+void *MP4::Atom::operator new(size_t size)
+{
+  return ParseArena::allocate(size);
+}
+
+void MP4::Atom::operator delete(void *p)
+{
+  ParseArena::deallocate(p);
+}
+
 MP4::Atom *
 MP4::Atom::find(const char *name1, const char *name2, const char *name3, const char *name4)
 {
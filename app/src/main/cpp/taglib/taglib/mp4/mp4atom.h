@@ -81,6 +81,8 @@ namespace TagLib {
       ~Atom();
       Atom(const Atom &) = delete;
       Atom &operator=(const Atom &) = delete;
+      static void *operator new(size_t size);
+      static void operator delete(void *p);
       Atom *find(const char *name1, const char *name2 = nullptr, const char *name3 = nullptr, const char *name4 = nullptr);
       bool path(AtomList &path, const char *name1, const char *name2 = nullptr, const char *name3 = nullptr);
       AtomList findall(const char *name, bool recursive = false);
@@ -25,6 +25,7 @@
 
 #include "mp4itemfactory.h"
 
+#include <mutex>
 #include <utility>
 
 #include "tbytevector.h"
@@ -38,9 +39,14 @@ using namespace MP4;
 class ItemFactory::ItemFactoryPrivate
 {
 public:
+  // The maps are built on first use, since they come from virtual methods,
+  // which may be called from several threads parsing files concurrently.
   NameHandlerMap handlerTypeForName;
   Map<ByteVector, String> propertyKeyForName;
   Map<String, ByteVector> nameForPropertyKey;
+  std::once_flag handlerTypeForNameOnce;
+  std::once_flag propertyKeyForNameOnce;
+  std::once_flag nameForPropertyKeyOnce;
 };
 
 ItemFactory ItemFactory::factory;
@@ -235,22 +241,22 @@ std::pair<String, StringList> ItemFactory::itemToProperty(
 
 String ItemFactory::propertyKeyForName(const ByteVector &name) const
 {
-  if(d->propertyKeyForName.isEmpty()) {
+  std::call_once(d->propertyKeyForNameOnce, [this] {
     d->propertyKeyForName = namePropertyMap();
-  }
+  });
   return d->propertyKeyForName.value(name);
 }
 
 ByteVector ItemFactory::nameForPropertyKey(const String &key) const
 {
-  if(d->nameForPropertyKey.isEmpty()) {
-    if(d->propertyKeyForName.isEmpty()) {
+  std::call_once(d->nameForPropertyKeyOnce, [this] {
+    std::call_once(d->propertyKeyForNameOnce, [this] {
       d->propertyKeyForName = namePropertyMap();
-    }
+    });
     for(const auto &[k, t] : std::as_const(d->propertyKeyForName)) {
       d->nameForPropertyKey[t] = k;
     }
-  }
+  });
   return d->nameForPropertyKey.value(key);
 }
 
@@ -301,9 +307,9 @@ ItemFactory::NameHandlerMap ItemFactory::nameHandlerMap() const
 ItemFactory::ItemHandlerType ItemFactory::handlerTypeForName(
   const ByteVector &name) const
 {
-  if(d->handlerTypeForName.isEmpty()) {
+  std::call_once(d->handlerTypeForNameOnce, [this] {
     d->handlerTypeForName = nameHandlerMap();
-  }
+  });
   auto type = d->handlerTypeForName.value(name, ItemHandlerType::Unknown);
   if (type == ItemHandlerType::Unknown && name.size() == 4) {
     type = ItemHandlerType::Text;
@@ -399,7 +405,8 @@ MP4::AtomDataList ItemFactory::parseData2(
   while(pos < data.size()) {
     const auto length = static_cast<int>(data.toUInt(pos));
     if(length < 12) {
-      debug("MP4: Too short atom");
+      diagnose(Diagnostics::MP4, Diagnostics::Truncated,
+               "MP4: Too short atom");
       return result;
     }
 
@@ -407,11 +414,13 @@ MP4::AtomDataList ItemFactory::parseData2(
     const auto flags = static_cast<int>(data.toUInt(pos + 8));
     if(freeForm && i < 2) {
       if(i == 0 && name != "mean") {
-        debug("MP4: Unexpected atom \"" + name + "\", expecting \"mean\"");
+        diagnose(Diagnostics::MP4, Diagnostics::InvalidHeader,
+                 "MP4: Unexpected atom \"" + name + "\", expecting \"mean\"");
         return result;
       }
       if(i == 1 && name != "name") {
-        debug("MP4: Unexpected atom \"" + name + "\", expecting \"name\"");
+        diagnose(Diagnostics::MP4, Diagnostics::InvalidHeader,
+                 "MP4: Unexpected atom \"" + name + "\", expecting \"name\"");
         return result;
       }
       result.append(AtomData(static_cast<AtomDataType>(flags),
@@ -419,7 +428,8 @@ MP4::AtomDataList ItemFactory::parseData2(
     }
     else {
       if(name != "data") {
-        debug("MP4: Unexpected atom \"" + name + "\", expecting \"data\"");
+        diagnose(Diagnostics::MP4, Diagnostics::InvalidHeader,
+                 "MP4: Unexpected atom \"" + name + "\", expecting \"data\"");
         return result;
       }
       if(expectedFlags == -1 || flags == expectedFlags) {
@@ -569,7 +579,8 @@ std::pair<String, Item> ItemFactory::parseFreeForm(
 
     for(auto it = itBegin; it != data.end(); ++it) {
       if(it->type != type) {
-        debug("MP4: We currently don't support values with multiple types");
+        diagnose(Diagnostics::MP4, Diagnostics::Unsupported,
+                 "MP4: We currently don't support values with multiple types");
         break;
       }
     }
@@ -603,14 +614,16 @@ std::pair<String, Item> ItemFactory::parseCovr(
   while(pos < data.size()) {
     const int length = static_cast<int>(data.toUInt(pos));
     if(length < 12) {
-      debug("MP4: Too short atom");
+      diagnose(Diagnostics::MP4, Diagnostics::Truncated,
+               "MP4: Too short atom");
       break;
     }
 
     const ByteVector name = data.mid(pos + 4, 4);
     const int flags = static_cast<int>(data.toUInt(pos + 8));
     if(name != "data") {
-      debug("MP4: Unexpected atom \"" + name + "\", expecting \"data\"");
+      diagnose(Diagnostics::MP4, Diagnostics::InvalidHeader,
+               "MP4: Unexpected atom \"" + name + "\", expecting \"data\"");
       break;
     }
     if(flags == TypeJPEG || flags == TypePNG || flags == TypeBMP ||
@@ -619,7 +632,8 @@ std::pair<String, Item> ItemFactory::parseCovr(
                                  data.mid(pos + 16, length - 16)));
     }
     else {
-      debug("MP4: Unknown covr format " + String::number(flags));
+      diagnose(Diagnostics::MP4, Diagnostics::Unsupported,
+               "MP4: Unknown covr format " + String::number(flags));
     }
     pos += length;
   }
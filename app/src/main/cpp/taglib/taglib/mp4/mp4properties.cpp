@@ -129,7 +129,8 @@ MP4::Properties::read(File *file, Atoms *atoms)
 {
   MP4::Atom *moov = atoms->find("moov");
   if(!moov) {
-    debug("MP4: Atom 'moov' not found");
+    diagnose(Diagnostics::MP4, Diagnostics::Missing,
+             "MP4: Atom 'moov' not found");
     return;
   }
 
@@ -140,7 +141,8 @@ MP4::Properties::read(File *file, Atoms *atoms)
   for(const auto &track : trakList) {
     MP4::Atom *hdlr = track->find("mdia", "hdlr");
     if(!hdlr) {
-      debug("MP4: Atom 'trak.mdia.hdlr' not found");
+      diagnose(Diagnostics::MP4, Diagnostics::Missing,
+               "MP4: Atom 'trak.mdia.hdlr' not found");
       return;
     }
     trak = track;
@@ -152,13 +154,15 @@ MP4::Properties::read(File *file, Atoms *atoms)
     trak = nullptr;
   }
   if(!trak) {
-    debug("MP4: No audio tracks");
+    diagnose(Diagnostics::MP4, Diagnostics::Missing,
+             "MP4: No audio tracks");
     return;
   }
 
   MP4::Atom *mdhd = trak->find("mdia", "mdhd");
   if(!mdhd) {
-    debug("MP4: Atom 'trak.mdia.mdhd' not found");
+    diagnose(Diagnostics::MP4, Diagnostics::Missing,
+             "MP4: Atom 'trak.mdia.mdhd' not found");
     return;
   }
 
@@ -170,7 +174,8 @@ MP4::Properties::read(File *file, Atoms *atoms)
   long long length;
   if(version == 1) {
     if(data.size() < 36 + 8) {
-      debug("MP4: Atom 'trak.mdia.mdhd' is smaller than expected");
+      diagnose(Diagnostics::MP4, Diagnostics::Truncated,
+               "MP4: Atom 'trak.mdia.mdhd' is smaller than expected");
       return;
     }
     unit   = data.toUInt(28U);
@@ -178,7 +183,8 @@ MP4::Properties::read(File *file, Atoms *atoms)
   }
   else {
     if(data.size() < 24 + 8) {
-      debug("MP4: Atom 'trak.mdia.mdhd' is smaller than expected");
+      diagnose(Diagnostics::MP4, Diagnostics::Truncated,
+               "MP4: Atom 'trak.mdia.mdhd' is smaller than expected");
       return;
     }
     unit   = data.toUInt(20U);
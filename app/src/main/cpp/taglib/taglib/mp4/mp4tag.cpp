@@ -30,6 +30,7 @@
 
 #include "tdebug.h"
 #include "tpropertymap.h"
+#include "tagutils.h"
 #include "mp4itemfactory.h"
 #include "mp4atom.h"
 #include "mp4coverart.h"
@@ -521,36 +522,44 @@ StringList MP4::Tag::complexPropertyKeys() const
 
 List<VariantMap> MP4::Tag::complexProperties(const String &key) const
 {
-  List<VariantMap> props;
+  return complexProperties(key, AllValues);
+}
+
+List<VariantMap> MP4::Tag::complexProperties(const String &key,
+                                             ComplexPropertySelection selection) const
+{
   const String uppercaseKey = key.upper();
   if(uppercaseKey == "PICTURE") {
-    const CoverArtList pictures = d->items.value("covr").toCoverArtList();
-    for(const CoverArt &picture : pictures) {
-      String mimeType = "image/";
-      switch(picture.format()) {
-      case CoverArt::BMP:
-        mimeType.append("bmp");
-        break;
-      case CoverArt::JPEG:
-        mimeType.append("jpeg");
-        break;
-      case CoverArt::GIF:
-        mimeType.append("gif");
-        break;
-      case CoverArt::PNG:
-        mimeType.append("png");
-        break;
-      case CoverArt::Unknown:
-        break;
-      }
+    // Cover art in MP4 files has no picture type.
+    return Utils::selectComplexProperties(d->items.value("covr").toCoverArtList(),
+                                          selection,
+      [](const CoverArt &) { return false; },
+      [](const CoverArt &picture) {
+        String mimeType = "image/";
+        switch(picture.format()) {
+        case CoverArt::BMP:
+          mimeType.append("bmp");
+          break;
+        case CoverArt::JPEG:
+          mimeType.append("jpeg");
+          break;
+        case CoverArt::GIF:
+          mimeType.append("gif");
+          break;
+        case CoverArt::PNG:
+          mimeType.append("png");
+          break;
+        case CoverArt::Unknown:
+          break;
+        }
 
-      VariantMap property;
-      property.insert("data", picture.data());
-      property.insert("mimeType", mimeType);
-      props.append(property);
-    }
+        VariantMap property;
+        property.insert("data", picture.data());
+        property.insert("mimeType", mimeType);
+        return property;
+      });
   }
-  return props;
+  return List<VariantMap>();
 }
 
 bool MP4::Tag::setComplexProperties(const String &key, const List<VariantMap> &value)
@@ -588,6 +597,7 @@ void MP4::Tag::addItem(const String &name, const Item &value)
     d->items.insert(name, value);
   }
   else {
-    debug("MP4: Ignoring duplicate atom \"" + name + "\"");
+    diagnose(Diagnostics::MP4, Diagnostics::Duplicate,
+             "MP4: Ignoring duplicate atom \"" + name + "\"");
   }
 }
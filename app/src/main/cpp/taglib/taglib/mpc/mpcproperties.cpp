@@ -182,7 +182,8 @@ void MPC::Properties::readSV8(File *file, offset_t streamLength)
     bool eof;
     const unsigned long packetSize = readSize(file, packetSizeLength, eof);
     if(eof) {
-      debug("MPC::Properties::readSV8() - Reached to EOF.");
+      diagnose(Diagnostics::MPC, Diagnostics::Truncated,
+               "MPC::Properties::readSV8() - Reached to EOF.");
       break;
     }
 
@@ -190,7 +191,8 @@ void MPC::Properties::readSV8(File *file, offset_t streamLength)
 
     const ByteVector data = file->readBlock(dataSize);
     if(data.size() != dataSize) {
-      debug("MPC::Properties::readSV8() - dataSize doesn't match the actual data size.");
+      diagnose(Diagnostics::MPC, Diagnostics::InvalidSize,
+               "MPC::Properties::readSV8() - dataSize doesn't match the actual data size.");
       break;
     }
 
@@ -199,7 +201,8 @@ void MPC::Properties::readSV8(File *file, offset_t streamLength)
       // http://trac.musepack.net/wiki/SV8Specification#StreamHeaderPacket
 
       if(dataSize <= 5) {
-        debug("MPC::Properties::readSV8() - \"SH\" packet is too short to parse.");
+        diagnose(Diagnostics::MPC, Diagnostics::Truncated,
+                 "MPC::Properties::readSV8() - \"SH\" packet is too short to parse.");
         break;
       }
 
@@ -210,13 +213,15 @@ void MPC::Properties::readSV8(File *file, offset_t streamLength)
       pos += 1;
       d->sampleFrames = readSize(data, pos);
       if(pos > dataSize - 3) {
-        debug("MPC::Properties::readSV8() - \"SH\" packet is corrupt.");
+        diagnose(Diagnostics::MPC, Diagnostics::InvalidData,
+                 "MPC::Properties::readSV8() - \"SH\" packet is corrupt.");
         break;
       }
 
       const unsigned long begSilence = readSize(data, pos);
       if(pos > dataSize - 2) {
-        debug("MPC::Properties::readSV8() - \"SH\" packet is corrupt.");
+        diagnose(Diagnostics::MPC, Diagnostics::InvalidData,
+                 "MPC::Properties::readSV8() - \"SH\" packet is corrupt.");
         break;
       }
 
@@ -237,7 +242,8 @@ void MPC::Properties::readSV8(File *file, offset_t streamLength)
       // http://trac.musepack.net/wiki/SV8Specification#ReplaygainPacket
 
       if(dataSize <= 9) {
-        debug("MPC::Properties::readSV8() - \"RG\" packet is too short to parse.");
+        diagnose(Diagnostics::MPC, Diagnostics::Truncated,
+                 "MPC::Properties::readSV8() - \"RG\" packet is too short to parse.");
         break;
       }
 
@@ -95,6 +95,18 @@ ID3v1::Tag::Tag(File *file, offset_t tagOffset) :
   read();
 }
 
+ID3v1::Tag::Tag(File *file, offset_t tagOffset, const ByteVector &data) :
+  d(std::make_unique<TagPrivate>())
+{
+  d->file = file;
+  d->tagOffset = tagOffset;
+
+  if(data.size() == 128 && data.startsWith("TAG"))
+    parse(data);
+  else
+    read();
+}
+
 ID3v1::Tag::~Tag() = default;
 
 ByteVector ID3v1::Tag::render() const
@@ -222,7 +234,8 @@ void ID3v1::Tag::read()
     if(data.size() == 128 && data.startsWith("TAG"))
       parse(data);
     else
-      debug("ID3v1 tag is not valid or could not be read at the specified offset.");
+      diagnose(Diagnostics::ID3v1, Diagnostics::InvalidHeader,
+               "ID3v1 tag is not valid or could not be read at the specified offset.");
   }
 }
 
@@ -124,6 +124,13 @@ namespace TagLib {
        */
       Tag(File *file, offset_t tagOffset);
 
+      /*!
+       * Create an ID3v1 tag at \a tagOffset in \a file and parse it from
+       * \a data, which holds the 128 bytes of the tag.  If \a data is not a
+       * complete tag, it is read from \a file instead.
+       */
+      Tag(File *file, offset_t tagOffset, const ByteVector &data);
+
       /*!
        * Destroys this Tag instance.
        */
@@ -128,7 +128,8 @@ void AttachedPictureFrame::setPicture(const ByteVector &p)
 void AttachedPictureFrame::parseFields(const ByteVector &data)
 {
   if(data.size() < 5) {
-    debug("A picture frame must contain at least 5 bytes.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "A picture frame must contain at least 5 bytes.");
     return;
   }
 
@@ -139,7 +140,8 @@ void AttachedPictureFrame::parseFields(const ByteVector &data)
   d->mimeType = readStringField(data, String::Latin1, &pos);
   /* Now we need at least two more bytes available */
   if(static_cast<unsigned int>(pos) + 1 >= data.size()) {
-    debug("Truncated picture frame.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "Truncated picture frame.");
     return;
   }
 
@@ -184,7 +186,8 @@ AttachedPictureFrame::AttachedPictureFrame(const ByteVector &data, Header *h) :
 void AttachedPictureFrameV22::parseFields(const ByteVector &data)
 {
   if(data.size() < 5) {
-    debug("A picture frame must contain at least 5 bytes.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "A picture frame must contain at least 5 bytes.");
     return;
   }
 
@@ -229,8 +229,9 @@ void ChapterFrame::parseFields(const ByteVector &data)
 {
   unsigned int size = data.size();
   if(size < 18) {
-    debug("A CHAP frame must contain at least 18 bytes (1 byte element ID "
-          "terminated by null and 4x4 bytes for start and end time and offset).");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "A CHAP frame must contain at least 18 bytes (1 byte element ID "
+             "terminated by null and 4x4 bytes for start and end time and offset).");
     return;
   }
 
@@ -139,7 +139,8 @@ CommentsFrame *CommentsFrame::findByDescription(const ID3v2::Tag *tag, const Str
 void CommentsFrame::parseFields(const ByteVector &data)
 {
   if(data.size() < 5) {
-    debug("A comment frame must contain at least 5 bytes.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "A comment frame must contain at least 5 bytes.");
     return;
   }
 
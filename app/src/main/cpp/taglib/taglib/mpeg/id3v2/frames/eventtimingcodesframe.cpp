@@ -98,7 +98,8 @@ void EventTimingCodesFrame::parseFields(const ByteVector &data)
 {
   const int end = data.size();
   if(end < 1) {
-    debug("An event timing codes frame must contain at least 1 byte.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "An event timing codes frame must contain at least 1 byte.");
     return;
   }
 
@@ -138,7 +138,8 @@ void GeneralEncapsulatedObjectFrame::setObject(const ByteVector &data)
 void GeneralEncapsulatedObjectFrame::parseFields(const ByteVector &data)
 {
   if(data.size() < 4) {
-    debug("An object frame must contain at least 4 bytes.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "An object frame must contain at least 4 bytes.");
     return;
   }
 
@@ -92,7 +92,8 @@ void PrivateFrame::setData(const ByteVector & data)
 void PrivateFrame::parseFields(const ByteVector &data)
 {
   if(data.size() < 2) {
-    debug("A private frame must contain at least 2 bytes.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "A private frame must contain at least 2 bytes.");
     return;
   }
 
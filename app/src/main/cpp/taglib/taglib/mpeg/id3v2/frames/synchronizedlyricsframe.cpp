@@ -142,7 +142,8 @@ void SynchronizedLyricsFrame::parseFields(const ByteVector &data)
 {
   const int end = data.size();
   if(end < 7) {
-    debug("A synchronized lyrics frame must contain at least 7 bytes.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "A synchronized lyrics frame must contain at least 7 bytes.");
     return;
   }
 
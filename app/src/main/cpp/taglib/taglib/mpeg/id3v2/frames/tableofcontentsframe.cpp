@@ -240,9 +240,10 @@ void TableOfContentsFrame::parseFields(const ByteVector &data)
 {
   unsigned int size = data.size();
   if(size < 6) {
-    debug("A CTOC frame must contain at least 6 bytes (1 byte element ID terminated by "
-          "null, 1 byte flags, 1 byte entry count and 1 byte child element ID terminated "
-          "by null.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "A CTOC frame must contain at least 6 bytes (1 byte element ID terminated by "
+             "null, 1 byte flags, 1 byte entry count and 1 byte child element ID terminated "
+             "by null.");
     return;
   }
 
@@ -114,7 +114,8 @@ UniqueFileIdentifierFrame *UniqueFileIdentifierFrame::findByOwner(const ID3v2::T
 void UniqueFileIdentifierFrame::parseFields(const ByteVector &data)
 {
   if(data.size() < 1) {
-    debug("An UFID frame must contain at least 1 byte.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "An UFID frame must contain at least 1 byte.");
     return;
   }
 
@@ -140,7 +140,8 @@ UnsynchronizedLyricsFrame *UnsynchronizedLyricsFrame::findByDescription(const ID
 void UnsynchronizedLyricsFrame::parseFields(const ByteVector &data)
 {
   if(data.size() < 5) {
-    debug("An unsynchronized lyrics frame must contain at least 5 bytes.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "An unsynchronized lyrics frame must contain at least 5 bytes.");
     return;
   }
 
@@ -190,7 +190,8 @@ UserUrlLinkFrame *UserUrlLinkFrame::find(ID3v2::Tag *tag, const String &descript
 void UserUrlLinkFrame::parseFields(const ByteVector &data)
 {
   if(data.size() < 2) {
-    debug("A user URL link frame must contain at least 2 bytes.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+             "A user URL link frame must contain at least 2 bytes.");
     return;
   }
 
@@ -28,6 +28,7 @@
 #include <array>
 #include <bitset>
 
+#include "tarena.h"
 #include "tdebug.h"
 #include "tstringlist.h"
 #include "tzlib.h"
@@ -99,6 +100,16 @@ unsigned int Frame::headerSize()
 
 Frame::~Frame() = default;
 
+void *Frame::operator new(size_t size)
+{
+  return ParseArena::allocate(size);
+}
+
+void Frame::operator delete(void *p)
+{
+  ParseArena::deallocate(p);
+}
+
 ByteVector Frame::frameID() const
 {
   if(d->header)
@@ -303,13 +314,15 @@ ByteVector Frame::fieldData(const ByteVector &frameData) const
 
   if(zlib::isAvailable() && d->header->compression() && !d->header->encryption()) {
     if(frameData.size() <= frameDataOffset) {
-      debug("Compressed frame doesn't have enough data to decode");
+      diagnose(Diagnostics::ID3v2, Diagnostics::Truncated,
+               "Compressed frame doesn't have enough data to decode");
       return ByteVector();
     }
 
     const ByteVector outData = zlib::decompress(frameData.mid(frameDataOffset));
     if(!outData.isEmpty() && frameDataLength != outData.size()) {
-      debug("frameDataLength does not match the data length returned by zlib");
+      diagnose(Diagnostics::ID3v2, Diagnostics::InvalidSize,
+               "frameDataLength does not match the data length returned by zlib");
     }
 
     return outData;
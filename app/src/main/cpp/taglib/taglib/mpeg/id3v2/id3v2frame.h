@@ -66,6 +66,13 @@ namespace TagLib {
       Frame(const Frame &) = delete;
       Frame &operator=(const Frame &) = delete;
 
+      /*!
+       * Frames created while a FileRef with FileRef::ArenaAllocation parses
+       * a file are placed in its arena, others on the heap.
+       */
+      static void *operator new(size_t size);
+      static void operator delete(void *p);
+
       /*!
        * Returns the Frame ID (Structure, <a href="id3v2-structure.html#4">4</a>)
        * (Frames, <a href="id3v2-frames.html#4">4</a>)
@@ -159,12 +159,14 @@ std::pair<Frame::Header *, bool> FrameFactory::prepareFrameHeader(
   // as unknown frames.
 
   if(!zlib::isAvailable() && header->compression()) {
-    debug("Compressed frames are currently not supported.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Unsupported,
+             "Compressed frames are currently not supported.");
     return {header, false};
   }
 
   if(header->encryption()) {
-    debug("Encrypted frames are currently not supported.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Unsupported,
+             "Encrypted frames are currently not supported.");
     return {header, false};
   }
 
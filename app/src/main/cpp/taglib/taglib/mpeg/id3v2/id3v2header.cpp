@@ -194,14 +194,16 @@ void Header::parse(const ByteVector &data)
 
   if(sizeData.size() != 4) {
     d->tagSize = 0;
-    debug("TagLib::ID3v2::Header::parse() - The tag size as read was 0 bytes!");
+    diagnose(Diagnostics::ID3v2, Diagnostics::InvalidSize,
+             "TagLib::ID3v2::Header::parse() - The tag size as read was 0 bytes!");
     return;
   }
 
   if(std::any_of(sizeData.cbegin(), sizeData.cend(),
       [](unsigned char size) { return size >= 128; })) {
     d->tagSize = 0;
-    debug("TagLib::ID3v2::Header::parse() - One of the size bytes in the id3v2 header was greater than the allowed 128.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::InvalidSize,
+             "TagLib::ID3v2::Header::parse() - One of the size bytes in the id3v2 header was greater than the allowed 128.");
     return;
   }
 
@@ -37,6 +37,7 @@
 #include "id3v2footer.h"
 #include "id3v2synchdata.h"
 #include "id3v1genres.h"
+#include "tagutils.h"
 #include "frames/attachedpictureframe.h"
 #include "frames/generalencapsulatedobjectframe.h"
 #include "frames/textidentificationframe.h"
@@ -463,36 +464,71 @@ StringList ID3v2::Tag::complexPropertyKeys() const
 
 List<VariantMap> ID3v2::Tag::complexProperties(const String &key) const
 {
-  List<VariantMap> props;
+  return complexProperties(key, AllValues);
+}
+
+List<VariantMap> ID3v2::Tag::complexProperties(const String &key,
+                                               ComplexPropertySelection selection) const
+{
   const String uppercaseKey = key.upper();
   if(uppercaseKey == "PICTURE") {
-    const FrameList pictures = d->frameListMap.value("APIC");
-    for(const Frame *frame : pictures) {
-      if(auto picture = dynamic_cast<const AttachedPictureFrame *>(frame)) {
+    List<const AttachedPictureFrame *> pictures;
+    for(const Frame *frame : d->frameListMap.value("APIC")) {
+      if(auto picture = dynamic_cast<const AttachedPictureFrame *>(frame))
+        pictures.append(picture);
+    }
+    return Utils::selectComplexProperties(pictures, selection,
+      [](const AttachedPictureFrame *picture) {
+        return picture->type() == AttachedPictureFrame::FrontCover;
+      },
+      [](const AttachedPictureFrame *picture) {
         VariantMap property;
         property.insert("data", picture->picture());
         property.insert("mimeType", picture->mimeType());
         property.insert("description", picture->description());
         property.insert("pictureType",
           AttachedPictureFrame::typeToString(picture->type()));
-        props.append(property);
-      }
+        return property;
+      });
+  }
+  if(uppercaseKey == "GENERALOBJECT") {
+    List<const GeneralEncapsulatedObjectFrame *> geobs;
+    for(const Frame *frame : d->frameListMap.value("GEOB")) {
+      if(auto geob = dynamic_cast<const GeneralEncapsulatedObjectFrame *>(frame))
+        geobs.append(geob);
     }
-  }
-  else if(uppercaseKey == "GENERALOBJECT") {
-    const FrameList geobs = d->frameListMap.value("GEOB");
-    for(const Frame *frame : geobs) {
-      if(auto geob = dynamic_cast<const GeneralEncapsulatedObjectFrame *>(frame)) {
+    return Utils::selectComplexProperties(geobs, selection,
+      [](const GeneralEncapsulatedObjectFrame *) { return false; },
+      [](const GeneralEncapsulatedObjectFrame *geob) {
         VariantMap property;
         property.insert("data", geob->object());
         property.insert("mimeType", geob->mimeType());
         property.insert("description", geob->description());
         property.insert("fileName", geob->fileName());
-        props.append(property);
-      }
-    }
+        return property;
+      });
+  }
+  return List<VariantMap>();
+}
+
+unsigned int ID3v2::Tag::complexPropertyCount(const String &key) const
+{
+  const String uppercaseKey = key.upper();
+  if(uppercaseKey == "PICTURE") {
+    const FrameList frames = d->frameListMap.value("APIC");
+    return static_cast<unsigned int>(std::count_if(frames.begin(), frames.end(),
+      [](const Frame *frame) {
+        return dynamic_cast<const AttachedPictureFrame *>(frame) != nullptr;
+      }));
+  }
+  if(uppercaseKey == "GENERALOBJECT") {
+    const FrameList frames = d->frameListMap.value("GEOB");
+    return static_cast<unsigned int>(std::count_if(frames.begin(), frames.end(),
+      [](const Frame *frame) {
+        return dynamic_cast<const GeneralEncapsulatedObjectFrame *>(frame) != nullptr;
+      }));
   }
-  return props;
+  return 0;
 }
 
 bool ID3v2::Tag::setComplexProperties(const String &key, const List<VariantMap> &value)
@@ -797,7 +833,8 @@ void ID3v2::Tag::read()
   }
 
   if(extraSize != 0) {
-    debug("ID3v2::Tag::read() - Duplicate ID3v2 tags found.");
+    diagnose(Diagnostics::ID3v2, Diagnostics::Duplicate,
+             "ID3v2::Tag::read() - Duplicate ID3v2 tags found.");
     d->header.setTagSize(d->header.tagSize() + extraSize);
   }
 }
@@ -842,7 +879,8 @@ void ID3v2::Tag::parse(const ByteVector &origData)
 
     if(data.at(frameDataPosition) == 0) {
       if(d->header.footerPresent()) {
-        debug("Padding *and* a footer found.  This is not allowed by the spec.");
+        diagnose(Diagnostics::ID3v2, Diagnostics::InvalidData,
+                 "Padding *and* a footer found.  This is not allowed by the spec.");
       }
 
       break;
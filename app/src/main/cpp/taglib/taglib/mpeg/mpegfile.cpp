@@ -476,19 +476,20 @@ void MPEG::File::read(bool readProperties, Properties::ReadStyle readStyle)
     d->ID3v2OriginalSize = ID3v2Tag()->header()->completeTagSize();
   }
 
-  // Look for an ID3v1 tag
+  // Look for an ID3v1 tag and an APE tag, both from a single read of the
+  // end of the file
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  const Utils::TailProbe tail = Utils::probeTail(this);
 
-  if(d->ID3v1Location >= 0)
-    d->tag.set(ID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
+  d->ID3v1Location = tail.id3v1Location;
 
-  // Look for an APE tag
+  if(d->ID3v1Location >= 0)
+    d->tag.set(ID3v1Index, new ID3v1::Tag(this, d->ID3v1Location, tail.id3v1Data()));
 
-  d->APELocation = Utils::findAPE(this, d->ID3v1Location);
+  d->APELocation = tail.apeFooterLocation;
 
   if(d->APELocation >= 0) {
-    d->tag.set(APEIndex, new APE::Tag(this, d->APELocation));
+    d->tag.set(APEIndex, new APE::Tag(this, d->APELocation, tail.apeData()));
     d->APEOriginalSize = APETag()->footer()->completeTagSize();
     d->APELocation = d->APELocation + APE::Footer::size() - d->APEOriginalSize;
   }
@@ -522,34 +523,21 @@ offset_t MPEG::File::findID3v2(Properties::ReadStyle readStyle)
   if(firstHeader.isValid())
     return -1;
 
-  // Look for an ID3v2 tag until reaching the first valid MPEG frame.
-
-  ByteVector frameSyncBytes(2, '\0');
-  ByteVector tagHeaderBytes(3, '\0');
-  long position = 0;
-
-  while(true) {
-    seek(position);
-    const ByteVector buffer = readBlock(bufferSize());
-    if(buffer.isEmpty())
-      return -1;
+  // Look for an ID3v2 tag until reaching the first valid MPEG frame.  Both
+  // are found in one pass by searching for the tag header and every possible
+  // frame sync, see isFrameSync().  A sync which is not followed by a valid
+  // frame is skipped without restarting the search.
 
-    for(unsigned int i = 0; i < buffer.size(); ++i) {
-      frameSyncBytes[0] = frameSyncBytes[1];
-      frameSyncBytes[1] = buffer[i];
-      if(isFrameSync(frameSyncBytes)) {
-        const Header header(this, position + i - 1, true);
-        if(header.isValid())
-          return -1;
-      }
+  ByteVectorList patterns { headerID };
+  for(unsigned int b = 0xE0; b < 0xFF; ++b)
+    patterns.append(ByteVector(1, '\xFF').append(static_cast<char>(b)));
 
-      tagHeaderBytes[0] = tagHeaderBytes[1];
-      tagHeaderBytes[1] = tagHeaderBytes[2];
-      tagHeaderBytes[2] = buffer[i];
-      if(tagHeaderBytes == headerID)
-        return position + i - 2;
-    }
+  int index = -1;
+  const offset_t position = findAny(patterns, 0,
+    [this, &index](offset_t offset, int patternIndex) {
+      index = patternIndex;
+      return patternIndex == 0 || Header(this, offset, true).isValid();
+    });
 
-    position += bufferSize();
-  }
+  return index == 0 ? position : -1;
 }
@@ -155,14 +155,16 @@ void MPEG::Header::parse(File *file, offset_t offset, bool checkLength)
   const ByteVector data = file->readBlock(4);
 
   if(data.size() < 4) {
-    debug("MPEG::Header::parse() -- data is too short for an MPEG frame header.");
+    diagnose(Diagnostics::MPEG, Diagnostics::Truncated,
+             "MPEG::Header::parse() -- data is too short for an MPEG frame header.");
     return;
   }
 
   // Check for the MPEG synch bytes.
 
   if(!isFrameSync(data)) {
-    debug("MPEG::Header::parse() -- MPEG header did not match MPEG synch.");
+    diagnose(Diagnostics::MPEG, Diagnostics::InvalidHeader,
+             "MPEG::Header::parse() -- MPEG header did not match MPEG synch.");
     return;
   }
 
@@ -139,7 +139,8 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
 
   const offset_t firstFrameOffset = file->firstFrameOffset();
   if(firstFrameOffset < 0) {
-    debug("MPEG::Properties::read() -- Could not find an MPEG frame in the stream.");
+    diagnose(Diagnostics::MPEG, Diagnostics::Missing,
+             "MPEG::Properties::read() -- Could not find an MPEG frame in the stream.");
     return;
   }
 
@@ -179,7 +180,8 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
       // is accurate enough, we stop when the average bytes/frame rate is stable
       // for 10 frames and then calculate the length from the estimated bitrate
       // and the stream length.
-      if(readStyle == Fast) {
+      // The HeaderOnly read style cannot bound the scan, so it behaves like Fast.
+      if(readStyle == Fast || readStyle == HeaderOnly) {
         bitRate = 0;
         d->length = 0;
       }
@@ -214,6 +216,10 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
           ? static_cast<int>((bytesPerFrame * 8 * firstHeader.sampleRate())
                              / 1000 / firstHeader.samplesPerFrame())
           : 0;
+        if(readStyle != Accurate) {
+          setBitrateAccuracy(Estimated);
+          setLengthAccuracy(Estimated);
+        }
       }
     }
     else if(firstHeader.bitrate() > 0) {
@@ -224,14 +230,32 @@ void MPEG::Properties::read(File *file, ReadStyle readStyle)
       // Xing header.
       bitRate = firstHeader.bitrate();
     }
-    if(bitRate > 0) {
+    if(bitRate > 0 && readStyle == HeaderOnly) {
+      d->bitrate = bitRate;
+
+      // Assume that everything between the first frame and the tags at the
+      // end of the file is audio, instead of looking for the last frame.
+
+      offset_t streamEnd = file->length();
+      if(file->hasID3v1Tag())
+        streamEnd -= 128;
+      if(file->hasAPETag())
+        streamEnd -= file->APETag()->footer()->completeTagSize();
+
+      const offset_t streamLength = streamEnd - firstFrameOffset;
+      if(streamLength > 0)
+        d->length = static_cast<int>(streamLength * 8.0 / d->bitrate + 0.5);
+      setLengthAccuracy(Estimated);
+    }
+    else if(bitRate > 0) {
       d->bitrate = bitRate;
 
       // Look for the last MPEG audio frame to calculate the stream length.
 
       const offset_t lastFrameOffset = file->lastFrameOffset();
       if(lastFrameOffset < 0) {
-        debug("MPEG::Properties::read() -- Could not find an MPEG frame in the stream.");
+        diagnose(Diagnostics::MPEG, Diagnostics::Missing,
+                 "MPEG::Properties::read() -- Could not find an MPEG frame in the stream.");
       }
       else
       {
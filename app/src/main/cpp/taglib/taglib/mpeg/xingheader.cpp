@@ -89,12 +89,14 @@ void MPEG::XingHeader::parse(const ByteVector &data)
     // Xing header found.
 
     if(data.size() < static_cast<unsigned long>(offset + 16)) {
-      debug("MPEG::XingHeader::parse() -- Xing header found but too short.");
+      diagnose(Diagnostics::MPEG, Diagnostics::Truncated,
+               "MPEG::XingHeader::parse() -- Xing header found but too short.");
       return;
     }
 
     if((data[offset + 7] & 0x03) != 0x03) {
-      debug("MPEG::XingHeader::parse() -- Xing header doesn't contain the required information.");
+      diagnose(Diagnostics::MPEG, Diagnostics::InvalidData,
+               "MPEG::XingHeader::parse() -- Xing header doesn't contain the required information.");
       return;
     }
 
@@ -113,7 +115,8 @@ void MPEG::XingHeader::parse(const ByteVector &data)
       // VBRI header found.
 
       if(data.size() < static_cast<unsigned long>(offset + 32)) {
-        debug("MPEG::XingHeader::parse() -- VBRI header found but too short.");
+        diagnose(Diagnostics::MPEG, Diagnostics::Truncated,
+                 "MPEG::XingHeader::parse() -- VBRI header found but too short.");
         return;
       }
 
@@ -147,7 +147,8 @@ void Ogg::FLAC::File::read(bool readProperties, Properties::ReadStyle properties
   ByteVector oggHeader = packet(0);
 
   if (oggHeader.mid(28,4) != "fLaC") {
-    debug("Ogg::FLAC::File::read() -- Not an Ogg/FLAC file");
+    diagnose(Diagnostics::Ogg, Diagnostics::InvalidHeader,
+             "Ogg::FLAC::File::read() -- Not an Ogg/FLAC file");
     setValid(false);
     return;
   }*/
@@ -233,7 +234,8 @@ void Ogg::FLAC::File::scan()
 
   ByteVector header = metadataHeader.mid(0, 4);
   if(header.size() != 4) {
-    debug("Ogg::FLAC::File::scan() -- Invalid Ogg/FLAC metadata header");
+    diagnose(Diagnostics::Ogg, Diagnostics::InvalidHeader,
+             "Ogg::FLAC::File::scan() -- Invalid Ogg/FLAC metadata header");
     return;
   }
 
@@ -255,7 +257,8 @@ void Ogg::FLAC::File::scan()
   // Sanity: First block should be the stream_info metadata
 
   if(blockType != 0) {
-    debug("Ogg::FLAC::File::scan() -- Invalid Ogg/FLAC stream");
+    diagnose(Diagnostics::Ogg, Diagnostics::InvalidHeader,
+             "Ogg::FLAC::File::scan() -- Invalid Ogg/FLAC stream");
     return;
   }
 
@@ -267,7 +270,8 @@ void Ogg::FLAC::File::scan()
     metadataHeader = packet(++ipacket);
     header = metadataHeader.mid(0, 4);
     if(header.size() != 4) {
-      debug("Ogg::FLAC::File::scan() -- Invalid Ogg/FLAC metadata header");
+      diagnose(Diagnostics::Ogg, Diagnostics::InvalidHeader,
+               "Ogg::FLAC::File::scan() -- Invalid Ogg/FLAC metadata header");
       return;
     }
 
@@ -286,7 +290,8 @@ void Ogg::FLAC::File::scan()
       d->commentPacket = ipacket;
     }
     else if(blockType > 5) {
-      debug("Ogg::FLAC::File::scan() -- Unknown metadata block");
+      diagnose(Diagnostics::Ogg, Diagnostics::Unsupported,
+               "Ogg::FLAC::File::scan() -- Unknown metadata block");
     }
   }
 
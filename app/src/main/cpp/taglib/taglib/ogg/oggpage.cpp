@@ -30,6 +30,7 @@
 #include <array>
 #include <utility>
 
+#include "tarena.h"
 #include "tstring.h"
 #include "tdebug.h"
 #include "oggpageheader.h"
@@ -128,6 +129,16 @@ Ogg::Page::Page(Ogg::File *file, offset_t pageOffset) :
 
 Ogg::Page::~Page() = default;
 
+void *Ogg::Page::operator new(size_t size)
+{
+  return ParseArena::allocate(size);
+}
+
+void Ogg::Page::operator delete(void *p)
+{
+  ParseArena::deallocate(p);
+}
+
 offset_t Ogg::Page::fileOffset() const
 {
   return d->fileOffset;
@@ -217,7 +228,8 @@ ByteVectorList Ogg::Page::packets() const
       l.append(d->file->readBlock(sz));
   }
   else
-    debug("Ogg::Page::packets() -- attempting to read packets from an invalid page.");
+    diagnose(Diagnostics::Ogg, Diagnostics::InvalidData,
+             "Ogg::Page::packets() -- attempting to read packets from an invalid page.");
 
   return l;
 }
@@ -62,6 +62,13 @@ namespace TagLib {
       Page(const Page &) = delete;
       Page &operator=(const Page &) = delete;
 
+      /*!
+       * Pages read while a FileRef with FileRef::ArenaAllocation parses a
+       * file are placed in its arena, others on the heap.
+       */
+      static void *operator new(size_t size);
+      static void operator delete(void *p);
+
       /*!
        * Returns the page's position within the file (in bytes).
        */
@@ -222,7 +222,8 @@ void Ogg::PageHeader::read(Ogg::File *file, offset_t pageOffset)
   // we asked for and that the page begins with "OggS".
 
   if(data.size() != 27 || !data.startsWith("OggS")) {
-    debug("Ogg::PageHeader::read() -- error reading page header");
+    diagnose(Diagnostics::Ogg, Diagnostics::InvalidHeader,
+             "Ogg::PageHeader::read() -- error reading page header");
     return;
   }
 
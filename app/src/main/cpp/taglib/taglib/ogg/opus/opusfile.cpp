@@ -59,20 +59,20 @@ bool Ogg::Opus::File::isSupported(IOStream *stream)
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-Opus::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+Opus::File::File(FileName file, bool readProperties, Properties::ReadStyle readStyle) :
   Ogg::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
-Opus::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+Opus::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle readStyle) :
   Ogg::File(stream),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 Opus::File::~File() = default;
@@ -111,13 +111,14 @@ bool Opus::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Opus::File::read(bool readProperties)
+void Opus::File::read(bool readProperties, Properties::ReadStyle readStyle)
 {
   ByteVector opusHeaderData = packet(0);
 
   if(!opusHeaderData.startsWith("OpusHead")) {
     setValid(false);
-    debug("Opus::File::read() -- invalid Opus identification header");
+    diagnose(Diagnostics::Ogg, Diagnostics::InvalidHeader,
+             "Opus::File::read() -- invalid Opus identification header");
     return;
   }
 
@@ -125,12 +126,13 @@ void Opus::File::read(bool readProperties)
 
   if(!commentHeaderData.startsWith("OpusTags")) {
     setValid(false);
-    debug("Opus::File::read() -- invalid Opus tags header");
+    diagnose(Diagnostics::Ogg, Diagnostics::InvalidHeader,
+             "Opus::File::read() -- invalid Opus tags header");
     return;
   }
 
   d->comment = std::make_unique<Ogg::XiphComment>(commentHeaderData.mid(8));
 
   if(readProperties)
-    d->properties = std::make_unique<Properties>(this);
+    d->properties = std::make_unique<Properties>(this, readStyle);
 }
@@ -55,7 +55,7 @@ Opus::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(std::make_unique<PropertiesPrivate>())
 {
-  read(file);
+  read(file, style);
 }
 
 Opus::Properties::~Properties() = default;
@@ -97,7 +97,7 @@ int Opus::Properties::opusVersion() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Opus::Properties::read(File *file)
+void Opus::Properties::read(File *file, ReadStyle style)
 {
   // Get the identification header from the Ogg implementation.
 
@@ -130,6 +130,11 @@ void Opus::Properties::read(File *file)
   // *Channel Mapping Family* (8 bits, unsigned)
   // pos += 1;
 
+  // The identification header has no bitrate, so without the granule
+  // position of the last page neither length nor bitrate are known.
+  if(style == HeaderOnly)
+    return;
+
   const Ogg::PageHeader *first = file->firstPageHeader();
   const Ogg::PageHeader *last  = file->lastPageHeader();
 
@@ -153,10 +158,12 @@ void Opus::Properties::read(File *file)
       }
     }
     else {
-      debug("Opus::Properties::read() -- The PCM values for the start or "
-            "end of this file was incorrect.");
+      diagnose(Diagnostics::Ogg, Diagnostics::InvalidData,
+               "Opus::Properties::read() -- The PCM values for the start or "
+               "end of this file was incorrect.");
     }
   }
   else
-    debug("Opus::Properties::read() -- Could not find valid first and last Ogg pages.");
+    diagnose(Diagnostics::Ogg, Diagnostics::Missing,
+             "Opus::Properties::read() -- Could not find valid first and last Ogg pages.");
 }
@@ -102,7 +102,7 @@ namespace TagLib {
         int opusVersion() const;
 
       private:
-        void read(File *file);
+        void read(File *file, ReadStyle style);
 
         class PropertiesPrivate;
         TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
@@ -59,20 +59,20 @@ bool Ogg::Speex::File::isSupported(IOStream *stream)
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-Speex::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+Speex::File::File(FileName file, bool readProperties, Properties::ReadStyle readStyle) :
   Ogg::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
-Speex::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+Speex::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle readStyle) :
   Ogg::File(stream),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 Speex::File::~File() = default;
@@ -111,12 +111,13 @@ bool Speex::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Speex::File::read(bool readProperties)
+void Speex::File::read(bool readProperties, Properties::ReadStyle readStyle)
 {
   ByteVector speexHeaderData = packet(0);
 
   if(!speexHeaderData.startsWith("Speex   ")) {
-    debug("Speex::File::read() -- invalid Speex identification header");
+    diagnose(Diagnostics::Ogg, Diagnostics::InvalidHeader,
+             "Speex::File::read() -- invalid Speex identification header");
     setValid(false);
     return;
   }
@@ -126,5 +127,5 @@ void Speex::File::read(bool readProperties)
   d->comment = std::make_unique<Ogg::XiphComment>(commentHeaderData);
 
   if(readProperties)
-    d->properties = std::make_unique<Properties>(this);
+    d->properties = std::make_unique<Properties>(this, readStyle);
 }
@@ -125,7 +125,7 @@ namespace TagLib {
         static bool isSupported(IOStream *stream);
 
       private:
-        void read(bool readProperties);
+        void read(bool readProperties, Properties::ReadStyle readStyle);
 
         class FilePrivate;
         TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
@@ -58,7 +58,7 @@ Speex::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(std::make_unique<PropertiesPrivate>())
 {
-  read(file);
+  read(file, style);
 }
 
 Speex::Properties::~Properties() = default;
@@ -97,13 +97,14 @@ int Speex::Properties::speexVersion() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Speex::Properties::read(File *file)
+void Speex::Properties::read(File *file, ReadStyle style)
 {
   // Get the identification header from the Ogg implementation.
 
   const ByteVector data = file->packet(0);
   if(data.size() < 64) {
-    debug("Speex::Properties::read() -- data is too short.");
+    diagnose(Diagnostics::Ogg, Diagnostics::Truncated,
+             "Speex::Properties::read() -- data is too short.");
     return;
   }
 
@@ -146,6 +147,22 @@ void Speex::Properties::read(File *file)
   // frames_per_packet;      /**< Number of frames stored per Ogg packet */
   // unsigned int framesPerPacket = data.mid(pos, 4).toUInt(false);
 
+  if(style == HeaderOnly) {
+    // The last page, and with it the exact length, is at the end of the
+    // file.  Estimate the length from the nominal bitrate instead.
+    if(d->bitrateNominal > 0) {
+      offset_t streamLength = file->length();
+      for(unsigned int i = 0; i < 2; ++i) {
+        streamLength -= file->packet(i).size();
+      }
+      d->length  = static_cast<int>(streamLength * 8000.0 / d->bitrateNominal + 0.5);
+      d->bitrate = static_cast<int>(d->bitrateNominal / 1000.0 + 0.5);
+    }
+    setLengthAccuracy(Estimated);
+    setBitrateAccuracy(Estimated);
+    return;
+  }
+
   const Ogg::PageHeader *first = file->firstPageHeader();
   const Ogg::PageHeader *last  = file->lastPageHeader();
 
@@ -169,15 +186,19 @@ void Speex::Properties::read(File *file)
       }
     }
     else {
-      debug("Speex::Properties::read() -- Either the PCM values for the start or "
-            "end of this file was incorrect or the sample rate is zero.");
+      diagnose(Diagnostics::Ogg, Diagnostics::InvalidData,
+               "Speex::Properties::read() -- Either the PCM values for the start or "
+               "end of this file was incorrect or the sample rate is zero.");
     }
   }
   else
-    debug("Speex::Properties::read() -- Could not find valid first and last Ogg pages.");
+    diagnose(Diagnostics::Ogg, Diagnostics::Missing,
+             "Speex::Properties::read() -- Could not find valid first and last Ogg pages.");
 
   // Alternative to the actual average bitrate.
 
-  if(d->bitrate == 0 && d->bitrateNominal > 0)
+  if(d->bitrate == 0 && d->bitrateNominal > 0) {
     d->bitrate = static_cast<int>(d->bitrateNominal / 1000.0 + 0.5);
+    setBitrateAccuracy(Estimated);
+  }
 }
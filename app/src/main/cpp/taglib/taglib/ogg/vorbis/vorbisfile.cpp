@@ -62,20 +62,20 @@ bool Vorbis::File::isSupported(IOStream *stream)
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-Vorbis::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+Vorbis::File::File(FileName file, bool readProperties, Properties::ReadStyle readStyle) :
   Ogg::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
-Vorbis::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+Vorbis::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle readStyle) :
   Ogg::File(stream),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 Vorbis::File::~File() = default;
@@ -117,12 +117,13 @@ bool Vorbis::File::save()
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Vorbis::File::read(bool readProperties)
+void Vorbis::File::read(bool readProperties, Properties::ReadStyle readStyle)
 {
   ByteVector commentHeaderData = packet(1);
 
   if(commentHeaderData.mid(0, 7) != vorbisCommentHeaderID) {
-    debug("Vorbis::File::read() - Could not find the Vorbis comment header.");
+    diagnose(Diagnostics::Ogg, Diagnostics::Missing,
+             "Vorbis::File::read() - Could not find the Vorbis comment header.");
     setValid(false);
     return;
   }
@@ -130,5 +131,5 @@ void Vorbis::File::read(bool readProperties)
   d->comment = std::make_unique<Ogg::XiphComment>(commentHeaderData.mid(7));
 
   if(readProperties)
-    d->properties = std::make_unique<Properties>(this);
+    d->properties = std::make_unique<Properties>(this, readStyle);
 }
@@ -61,7 +61,7 @@ Vorbis::Properties::Properties(File *file, ReadStyle style) :
   AudioProperties(style),
   d(std::make_unique<PropertiesPrivate>())
 {
-  read(file);
+  read(file, style);
 }
 
 Vorbis::Properties::~Properties() = default;
@@ -110,20 +110,22 @@ int Vorbis::Properties::bitrateMinimum() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void Vorbis::Properties::read(File *file)
+void Vorbis::Properties::read(File *file, ReadStyle style)
 {
   // Get the identification header from the Ogg implementation.
 
   const ByteVector data = file->packet(0);
   if(data.size() < 28) {
-    debug("Vorbis::Properties::read() -- data is too short.");
+    diagnose(Diagnostics::Ogg, Diagnostics::Truncated,
+             "Vorbis::Properties::read() -- data is too short.");
     return;
   }
 
   unsigned int pos = 0;
 
   if(data.mid(pos, 7) != vorbisSetupHeaderID) {
-    debug("Vorbis::Properties::read() -- invalid Vorbis identification header");
+    diagnose(Diagnostics::Ogg, Diagnostics::InvalidHeader,
+             "Vorbis::Properties::read() -- invalid Vorbis identification header");
     return;
   }
 
@@ -146,6 +148,22 @@ void Vorbis::Properties::read(File *file)
 
   d->bitrateMinimum = data.toUInt(pos, false);
 
+  if(style == HeaderOnly) {
+    // The last page, and with it the exact length, is at the end of the
+    // file.  Estimate the length from the nominal bitrate instead.
+    if(d->bitrateNominal > 0) {
+      offset_t streamLength = file->length();
+      for(unsigned int i = 0; i < 3; ++i) {
+        streamLength -= file->packet(i).size();
+      }
+      d->length  = static_cast<int>(streamLength * 8000.0 / d->bitrateNominal + 0.5);
+      d->bitrate = static_cast<int>(d->bitrateNominal / 1000.0 + 0.5);
+    }
+    setLengthAccuracy(Estimated);
+    setBitrateAccuracy(Estimated);
+    return;
+  }
+
   // Find the length of the file.  See http://wiki.xiph.org/VorbisStreamLength/
   // for my notes on the topic.
 
@@ -172,15 +190,19 @@ void Vorbis::Properties::read(File *file)
       }
     }
     else {
-      debug("Vorbis::Properties::read() -- Either the PCM values for the start or "
-            "end of this file was incorrect or the sample rate is zero.");
+      diagnose(Diagnostics::Ogg, Diagnostics::InvalidData,
+               "Vorbis::Properties::read() -- Either the PCM values for the start or "
+               "end of this file was incorrect or the sample rate is zero.");
     }
   }
   else
-    debug("Vorbis::Properties::read() -- Could not find valid first and last Ogg pages.");
+    diagnose(Diagnostics::Ogg, Diagnostics::Missing,
+             "Vorbis::Properties::read() -- Could not find valid first and last Ogg pages.");
 
   // Alternative to the actual average bitrate.
 
-  if(d->bitrate == 0 && d->bitrateNominal > 0)
+  if(d->bitrate == 0 && d->bitrateNominal > 0) {
     d->bitrate = static_cast<int>(d->bitrateNominal / 1000.0 + 0.5);
+    setBitrateAccuracy(Estimated);
+  }
 }
@@ -29,6 +29,7 @@
 
 #include "tdebug.h"
 #include "tpropertymap.h"
+#include "tagutils.h"
 
 using namespace TagLib;
 
@@ -246,24 +247,33 @@ StringList Ogg::XiphComment::complexPropertyKeys() const
 
 List<VariantMap> Ogg::XiphComment::complexProperties(const String &key) const
 {
-  List<VariantMap> props;
+  return complexProperties(key, AllValues);
+}
+
+List<VariantMap> Ogg::XiphComment::complexProperties(const String &key,
+                                                     ComplexPropertySelection selection) const
+{
   const String uppercaseKey = key.upper();
   if(uppercaseKey == "PICTURE") {
-    for(const FLAC::Picture *picture : std::as_const(d->pictureList)) {
-      VariantMap property;
-      property.insert("data", picture->data());
-      property.insert("mimeType", picture->mimeType());
-      property.insert("description", picture->description());
-      property.insert("pictureType",
-        FLAC::Picture::typeToString(picture->type()));
-      property.insert("width", picture->width());
-      property.insert("height", picture->height());
-      property.insert("numColors", picture->numColors());
-      property.insert("colorDepth", picture->colorDepth());
-      props.append(property);
-    }
+    return Utils::selectComplexProperties(d->pictureList, selection,
+      [](const FLAC::Picture *picture) {
+        return picture->type() == FLAC::Picture::FrontCover;
+      },
+      [](const FLAC::Picture *picture) {
+        VariantMap property;
+        property.insert("data", picture->data());
+        property.insert("mimeType", picture->mimeType());
+        property.insert("description", picture->description());
+        property.insert("pictureType",
+          FLAC::Picture::typeToString(picture->type()));
+        property.insert("width", picture->width());
+        property.insert("height", picture->height());
+        property.insert("numColors", picture->numColors());
+        property.insert("colorDepth", picture->colorDepth());
+        return property;
+      });
   }
-  return props;
+  return List<VariantMap>();
 }
 
 bool Ogg::XiphComment::setComplexProperties(const String &key, const List<VariantMap> &value)
@@ -469,7 +479,8 @@ void Ogg::XiphComment::parse(const ByteVector &data)
 
     const int sep = entry.find('=');
     if(sep < 1) {
-      debug("Ogg::XiphComment::parse() - Discarding a field. Separator not found.");
+      diagnose(Diagnostics::Ogg, Diagnostics::InvalidData,
+               "Ogg::XiphComment::parse() - Discarding a field. Separator not found.");
       continue;
     }
 
@@ -477,7 +488,8 @@ void Ogg::XiphComment::parse(const ByteVector &data)
 
     const String key = String(entry.mid(0, sep), String::UTF8).upper();
     if(!checkKey(key)) {
-      debug("Ogg::XiphComment::parse() - Discarding a field. Invalid key.");
+      diagnose(Diagnostics::Ogg, Diagnostics::InvalidData,
+               "Ogg::XiphComment::parse() - Discarding a field. Invalid key.");
       continue;
     }
 
@@ -487,7 +499,8 @@ void Ogg::XiphComment::parse(const ByteVector &data)
 
       const ByteVector picturedata = ByteVector::fromBase64(entry.mid(sep + 1));
       if(picturedata.isEmpty()) {
-        debug("Ogg::XiphComment::parse() - Discarding a field. Invalid base64 data");
+        diagnose(Diagnostics::Ogg, Diagnostics::InvalidData,
+                 "Ogg::XiphComment::parse() - Discarding a field. Invalid base64 data");
         continue;
       }
 
@@ -501,7 +514,8 @@ void Ogg::XiphComment::parse(const ByteVector &data)
         }
         else {
           delete picture;
-          debug("Ogg::XiphComment::parse() - Failed to decode FLAC Picture block");
+          diagnose(Diagnostics::Ogg, Diagnostics::InvalidData,
+                   "Ogg::XiphComment::parse() - Failed to decode FLAC Picture block");
         }
       }
       else {
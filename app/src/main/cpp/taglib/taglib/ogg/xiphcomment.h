@@ -169,6 +169,8 @@ namespace TagLib {
 
       StringList complexPropertyKeys() const override;
       List<VariantMap> complexProperties(const String &key) const override;
+      List<VariantMap> complexProperties(const String &key,
+                                         ComplexPropertySelection selection) const override;
       bool setComplexProperties(const String &key, const List<VariantMap> &value) override;
 
       /*!
@@ -127,6 +127,10 @@ bool RIFF::AIFF::File::save(ID3v2::Version version)
     return false;
   }
 
+  // Collect all changes, so that the audio data is moved at most once.
+
+  beginChunkUpdates();
+
   if(d->hasID3v2) {
     removeChunk("ID3 ");
     removeChunk("id3 ");
@@ -138,6 +142,8 @@ bool RIFF::AIFF::File::save(ID3v2::Version version)
     d->hasID3v2 = true;
   }
 
+  commitChunkUpdates();
+
   return true;
 }
 
@@ -161,7 +167,8 @@ void RIFF::AIFF::File::read(bool readProperties)
         d->hasID3v2 = true;
       }
       else {
-        debug("RIFF::AIFF::File::read() - Duplicate ID3v2 tag found.");
+        diagnose(Diagnostics::RIFF, Diagnostics::Duplicate,
+                 "RIFF::AIFF::File::read() - Duplicate ID3v2 tag found.");
       }
     }
   }
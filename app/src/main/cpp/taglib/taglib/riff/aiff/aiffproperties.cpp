@@ -117,23 +117,27 @@ void RIFF::AIFF::Properties::read(File *file)
       if(data.isEmpty())
         data = file->chunkData(i);
       else
-        debug("RIFF::AIFF::Properties::read() - Duplicate 'COMM' chunk found.");
+        diagnose(Diagnostics::RIFF, Diagnostics::Duplicate,
+                 "RIFF::AIFF::Properties::read() - Duplicate 'COMM' chunk found.");
     }
     else if(name == "SSND") {
       if(streamLength == 0)
         streamLength = file->chunkDataSize(i) + file->chunkPadding(i);
       else
-        debug("RIFF::AIFF::Properties::read() - Duplicate 'SSND' chunk found.");
+        diagnose(Diagnostics::RIFF, Diagnostics::Duplicate,
+                 "RIFF::AIFF::Properties::read() - Duplicate 'SSND' chunk found.");
     }
   }
 
   if(data.size() < 18) {
-    debug("RIFF::AIFF::Properties::read() - 'COMM' chunk not found or too short.");
+    diagnose(Diagnostics::RIFF, Diagnostics::Missing,
+             "RIFF::AIFF::Properties::read() - 'COMM' chunk not found or too short.");
     return;
   }
 
   if(streamLength == 0) {
-    debug("RIFF::AIFF::Properties::read() - 'SSND' chunk not found.");
+    diagnose(Diagnostics::RIFF, Diagnostics::Missing,
+             "RIFF::AIFF::Properties::read() - 'SSND' chunk not found.");
     return;
   }
 
@@ -39,8 +39,38 @@ struct Chunk
   offset_t offset;
   unsigned int size;
   unsigned int padding;
+
+  // Only set while chunk updates are collected, for chunks whose data has
+  // not been written yet.  The offset of such a chunk is not valid.
+  bool pending { false };
+  ByteVector data;
 };
 
+namespace
+{
+  // Chunks whose content does not matter, they can be shrunk or grown to keep
+  // the following chunks in place.
+  bool isPaddingChunk(const ByteVector &name)
+  {
+    return name == "JUNK" || name == "junk" || name == "PAD " || name == "FLLR";
+  }
+
+  // A byte range which has to be copied from its original position.
+  struct Move
+  {
+    offset_t from;
+    offset_t to;
+    offset_t length;
+  };
+
+  // Bytes which have to be written at a position.
+  struct Write
+  {
+    offset_t offset;
+    ByteVector data;
+  };
+}  // namespace
+
 class RIFF::File::FilePrivate
 {
 public:
@@ -55,6 +85,11 @@ public:
   offset_t sizeOffset { 0 };
 
   std::vector<Chunk> chunks;
+
+  // Nesting level of beginChunkUpdates() and the end of the chunks in the
+  // file when it was first called.
+  unsigned int updateLevel { 0 };
+  offset_t chunksEnd { 0 };
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -140,6 +175,9 @@ ByteVector RIFF::File::chunkData(unsigned int i)
     return ByteVector();
   }
 
+  if(d->chunks[i].pending)
+    return d->chunks[i].data;
+
   seek(d->chunks[i].offset);
   return readBlock(d->chunks[i].size);
 }
@@ -151,31 +189,15 @@ void RIFF::File::setChunkData(unsigned int i, const ByteVector &data)
     return;
   }
 
-  // Now update the specific chunk
+  beginChunkUpdates();
 
-  auto it = d->chunks.begin();
-  std::advance(it, i);
-
-  const long long originalSize = static_cast<long long>(it->size) + it->padding;
-
-  writeChunk(it->name, data, it->offset - 8, it->size + it->padding + 8);
-
-  it->size    = data.size();
-  it->padding = data.size() % 2;
-
-  const long long diff = static_cast<long long>(it->size) + it->padding - originalSize;
-
-  // Now update the internal offsets
-
-  it = std::next(it);
-  while(it != d->chunks.end()) {
-    it->offset += static_cast<int>(diff);
-    ++it;
-  }
-
-  // Update the global size.
+  Chunk &chunk = d->chunks[i];
+  chunk.size    = data.size();
+  chunk.padding = data.size() % 2;
+  chunk.pending = true;
+  chunk.data    = data;
 
-  updateGlobalSize();
+  commitChunkUpdates();
 }
 
 void RIFF::File::setChunkData(const ByteVector &name, const ByteVector &data)
@@ -204,43 +226,22 @@ void RIFF::File::setChunkData(const ByteVector &name, const ByteVector &data, bo
     }
   }
 
-  // Couldn't find an existing chunk, so let's create a new one.
+  // Couldn't find an existing chunk, so let's create a new one after the
+  // existing chunks.
 
-  // Adjust the padding of the last chunk to place the new chunk at even position.
-
-  Chunk &last = d->chunks.back();
-
-  offset_t offset = last.offset + last.size + last.padding;
-  if(offset & 1) {
-    if(last.padding == 1) {
-      last.padding = 0; // This should not happen unless the file is corrupted.
-      offset--;
-      removeBlock(offset, 1);
-    }
-    else {
-      insert(ByteVector("\0", 1), offset, 0);
-      last.padding = 1;
-      offset++;
-    }
-  }
-
-  // Now add the chunk to the file.
-
-  writeChunk(name, data, offset, 0);
-
-  // And update our internal structure
+  beginChunkUpdates();
 
   Chunk chunk;
   chunk.name    = name;
   chunk.size    = data.size();
-  chunk.offset  = offset + 8;
+  chunk.offset  = 0;
   chunk.padding = data.size() % 2;
+  chunk.pending = true;
+  chunk.data    = data;
 
   d->chunks.push_back(std::move(chunk));
 
-  // Update the global size.
-
-  updateGlobalSize();
+  commitChunkUpdates();
 }
 
 void RIFF::File::removeChunk(unsigned int i)
@@ -250,29 +251,148 @@ void RIFF::File::removeChunk(unsigned int i)
     return;
   }
 
-  auto it = d->chunks.begin();
-  std::advance(it, i);
+  beginChunkUpdates();
+  d->chunks.erase(d->chunks.begin() + i);
+  commitChunkUpdates();
+}
 
-  const unsigned int removeSize = it->size + it->padding + 8;
-  removeBlock(it->offset - 8, removeSize);
-  it = d->chunks.erase(it);
+void RIFF::File::removeChunk(const ByteVector &name)
+{
+  beginChunkUpdates();
 
-  while(it != d->chunks.end()) {
-    it->offset -= removeSize;
-    ++it;
+  for(int i = static_cast<int>(d->chunks.size()) - 1; i >= 0; --i) {
+    if(d->chunks[i].name == name)
+      removeChunk(i);
   }
 
-  // Update the global size.
+  commitChunkUpdates();
+}
 
-  updateGlobalSize();
+void RIFF::File::beginChunkUpdates()
+{
+  if(d->updateLevel++ > 0)
+    return;
+
+  if(d->chunks.empty()) {
+    d->chunksEnd = d->sizeOffset + 8;
+  }
+  else {
+    const Chunk &last = d->chunks.back();
+    d->chunksEnd = last.offset + last.size + last.padding;
+  }
 }
 
-void RIFF::File::removeChunk(const ByteVector &name)
+void RIFF::File::commitChunkUpdates()
 {
-  for(int i = static_cast<int>(d->chunks.size()) - 1; i >= 0; --i) {
-    if(d->chunks[i].name == name)
-      removeChunk(i);
+  if(d->updateLevel == 0) {
+    debug("RIFF::File::commitChunkUpdates() -- No updates have been started.");
+    return;
   }
+
+  if(--d->updateLevel > 0)
+    return;
+
+  // Lay out the chunks from the beginning and collect what has to be
+  // copied and written.  Chunks which keep their position and data are not
+  // touched, the others are copied at most once.
+
+  std::vector<Move> moves;
+  std::vector<Write> writes;
+
+  const offset_t fileLength = length();
+  offset_t position = d->sizeOffset + 8;
+  bool changed = false;
+
+  for(auto it = d->chunks.begin(); it != d->chunks.end(); ++it) {
+    Chunk &chunk = *it;
+
+    if(chunk.pending) {
+
+      // Place new and changed chunks at even positions by padding the
+      // preceding chunk, which is only missing for corrupted files.
+
+      if((position & 1) && it != d->chunks.begin() && std::prev(it)->padding == 0) {
+        std::prev(it)->padding = 1;
+        writes.push_back({ position, ByteVector(1, '\0') });
+        position++;
+      }
+
+      ByteVector combined = chunk.name;
+      combined.append(ByteVector::fromUInt(chunk.size, d->endianness == BigEndian));
+      combined.append(chunk.data);
+      combined.resize(combined.size() + chunk.padding, '\0');
+      writes.push_back({ position, combined });
+
+      chunk.offset  = position + 8;
+      chunk.pending = false;
+      chunk.data    = ByteVector();
+      position += combined.size();
+      changed = true;
+      continue;
+    }
+
+    const offset_t start = chunk.offset - 8;
+    const offset_t end   = chunk.offset + chunk.size + chunk.padding;
+
+    // Resize a padding chunk to absorb the changes before it, so that the
+    // following chunks can stay where they are.
+
+    if(position != start && isPaddingChunk(chunk.name) && std::next(it) != d->chunks.end()) {
+      const offset_t available = end - position - 8;
+      if(available >= 0 && available % 2 == 0 && available <= 0xFFFFFFFF) {
+        chunk.size    = static_cast<unsigned int>(available);
+        chunk.padding = 0;
+        chunk.offset  = position + 8;
+        writes.push_back({ position, chunk.name + ByteVector::fromUInt(chunk.size, d->endianness == BigEndian) });
+        position = end;
+        changed = true;
+        continue;
+      }
+    }
+
+    if(position != start) {
+      moves.push_back({ start, position, end - start });
+      chunk.offset = position + 8;
+      changed = true;
+    }
+    position += end - start;
+  }
+
+  // Anything after the last chunk stays after it.
+
+  if(position != d->chunksEnd && fileLength > d->chunksEnd)
+    moves.push_back({ d->chunksEnd, position, fileLength - d->chunksEnd });
+
+  if(!changed && position == d->chunksEnd)
+    return;
+
+  const offset_t newLength = position + std::max<offset_t>(fileLength - d->chunksEnd, 0);
+
+  if(newLength > fileLength)
+    insert(ByteVector(static_cast<unsigned int>(newLength - fileLength), '\0'), fileLength, 0);
+
+  // Blocks moving to the front are copied first, in order, then those moving
+  // to the back, in reverse order, so that no block is overwritten before it
+  // has been copied.
+
+  for(const auto &move : moves) {
+    if(move.to < move.from)
+      copyBlock(move.from, move.to, move.length);
+  }
+  for(auto it = moves.rbegin(); it != moves.rend(); ++it) {
+    if(it->to > it->from)
+      copyBlock(it->from, it->to, it->length);
+  }
+
+  for(const auto &write : writes) {
+    seek(write.offset);
+    writeBlock(write.data);
+  }
+
+  if(newLength < fileLength)
+    truncate(newLength);
+
+  updateGlobalSize();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -301,12 +421,14 @@ void RIFF::File::read()
     const unsigned int chunkSize = readBlock(4).toUInt(bigEndian);
 
     if(!isValidChunkName(chnkName)) {
-      debug("RIFF::File::read() -- Chunk '" + chnkName + "' has invalid ID");
+      diagnose(Diagnostics::RIFF, Diagnostics::InvalidHeader,
+               "RIFF::File::read() -- Chunk '" + chnkName + "' has invalid ID");
       break;
     }
 
     if(static_cast<long long>(offset) + 8 + chunkSize > length()) {
-      debug("RIFF::File::read() -- Chunk '" + chnkName + "' has invalid size (larger than the file size)");
+      diagnose(Diagnostics::RIFF, Diagnostics::InvalidSize,
+               "RIFF::File::read() -- Chunk '" + chnkName + "' has invalid size (larger than the file size)");
       break;
     }
 
@@ -344,19 +466,28 @@ void RIFF::File::read()
   }
 }
 
-void RIFF::File::writeChunk(const ByteVector &name, const ByteVector &data,
-                            offset_t offset, unsigned long replace)
+void RIFF::File::copyBlock(offset_t from, offset_t to, offset_t length)
 {
-  ByteVector combined;
+  // The ranges may overlap, so copy from the end when moving to the back.
 
-  combined.append(name);
-  combined.append(ByteVector::fromUInt(data.size(), d->endianness == BigEndian));
-  combined.append(data);
+  constexpr offset_t maxBufferSize = 1024 * 1024;
 
-  if(data.size() & 1)
-    combined.resize(combined.size() + 1, '\0');
+  offset_t done = 0;
+  while(done < length) {
+    const offset_t size = std::min(length - done, maxBufferSize);
+    const offset_t offset = to > from ? length - done - size : done;
 
-  insert(combined, offset, replace);
+    seek(from + offset);
+    const ByteVector buffer = readBlock(static_cast<size_t>(size));
+    if(static_cast<offset_t>(buffer.size()) != size) {
+      debug("RIFF::File::copyBlock() -- Could not read the block.");
+      return;
+    }
+
+    seek(to + offset);
+    writeBlock(buffer);
+    done += size;
+  }
 }
 
 void RIFF::File::updateGlobalSize()
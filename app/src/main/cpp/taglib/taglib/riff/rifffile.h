@@ -101,7 +101,8 @@ namespace TagLib {
       /*!
        * Sets the data for the specified chunk to \a data.
        *
-       * \warning This will update the file immediately.
+       * \warning This will update the file immediately, unless changes are
+       * being collected, see beginChunkUpdates().
        */
       void setChunkData(unsigned int i, const ByteVector &data);
 
@@ -110,7 +111,8 @@ namespace TagLib {
        * given name already exists it will be overwritten, otherwise it will be
        * created after the existing chunks.
        *
-       * \warning This will update the file immediately.
+       * \warning This will update the file immediately, unless changes are
+       * being collected, see beginChunkUpdates().
        */
       void setChunkData(const ByteVector &name, const ByteVector &data);
 
@@ -123,29 +125,55 @@ namespace TagLib {
        * whether or not the chunk \a name exists. It should only be used for
        * "LIST" chunks.
        *
-       * \warning This will update the file immediately.
+       * \warning This will update the file immediately, unless changes are
+       * being collected, see beginChunkUpdates().
        */
       void setChunkData(const ByteVector &name, const ByteVector &data, bool alwaysCreate);
 
       /*!
        * Removes the specified chunk.
        *
-       * \warning This will update the file immediately.
+       * \warning This will update the file immediately, unless changes are
+       * being collected, see beginChunkUpdates().
        */
       void removeChunk(unsigned int i);
 
       /*!
        * Removes the chunk \a name.
        *
-       * \warning This will update the file immediately.
+       * \warning This will update the file immediately, unless changes are
+       * being collected, see beginChunkUpdates().
        * \warning This removes all the chunks with the given name.
        */
       void removeChunk(const ByteVector &name);
 
+      /*!
+       * Starts collecting chunk changes.  Until the matching call of
+       * commitChunkUpdates(), setChunkData() and removeChunk() only update
+       * the chunk list, and chunkData() returns the new data.  Calls may be
+       * nested.
+       *
+       * \note chunkOffset() is not valid for new or changed chunks until the
+       * changes are written.
+       */
+      void beginChunkUpdates();
+
+      /*!
+       * Writes all chunk changes collected since beginChunkUpdates() at once.
+       * The final layout is computed first, so each chunk is moved at most
+       * once, and padding chunks ("JUNK", "PAD ") are resized to keep the
+       * following chunks in place where possible.  Nothing is written before
+       * the outermost call.
+       */
+      void commitChunkUpdates();
+
     private:
       void read();
-      void writeChunk(const ByteVector &name, const ByteVector &data,
-                      offset_t offset, unsigned long replace = 0);
+
+      /*!
+       * Copies \a length bytes from \a from to \a to, the ranges may overlap.
+       */
+      void copyBlock(offset_t from, offset_t to, offset_t length);
 
       /*!
        * Update the global RIFF size based on the current internal structure.
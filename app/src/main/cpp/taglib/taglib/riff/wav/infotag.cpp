@@ -219,12 +219,13 @@ void RIFF::Info::Tag::removeUnsupportedProperties(const StringList &props)
 
 PropertyMap RIFF::Info::Tag::setProperties(const PropertyMap &props)
 {
-  static Map<String, ByteVector> idForPropertyKey;
-  if(idForPropertyKey.isEmpty()) {
+  static const Map<String, ByteVector> idForPropertyKey = [] {
+    Map<String, ByteVector> m;
     for(const auto &[id, key] : propertyKeyForId) {
-      idForPropertyKey[key] = id;
+      m[key] = id;
     }
-  }
+    return m;
+  }();
 
   const PropertyMap origProps = properties();
   for(const auto &[key, _] : origProps) {
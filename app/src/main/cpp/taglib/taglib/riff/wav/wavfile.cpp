@@ -110,7 +110,9 @@ RIFF::Info::Tag *RIFF::WAV::File::InfoTag() const
 
 void RIFF::WAV::File::strip(TagTypes tags)
 {
+  beginChunkUpdates();
   removeTagChunks(tags);
+  commitChunkUpdates();
 
   if(tags & ID3v2)
     d->tag.set(ID3v2Index, new ID3v2::Tag(nullptr, 0, d->ID3v2FrameFactory));
@@ -157,6 +159,10 @@ bool RIFF::WAV::File::save(TagTypes tags, StripTags strip, ID3v2::Version versio
     return false;
   }
 
+  // Collect all changes, so that the audio data is moved at most once.
+
+  beginChunkUpdates();
+
   if(strip == StripOthers)
     File::strip(static_cast<TagTypes>(AllTags & ~tags));
 
@@ -178,6 +184,8 @@ bool RIFF::WAV::File::save(TagTypes tags, StripTags strip, ID3v2::Version versio
     }
   }
 
+  commitChunkUpdates();
+
   return true;
 }
 
@@ -206,7 +214,8 @@ void RIFF::WAV::File::read(bool readProperties)
         d->hasID3v2 = true;
       }
       else {
-        debug("RIFF::WAV::File::read() - Duplicate ID3v2 tag found.");
+        diagnose(Diagnostics::RIFF, Diagnostics::Duplicate,
+                 "RIFF::WAV::File::read() - Duplicate ID3v2 tag found.");
       }
     }
     else if(name == "LIST") {
@@ -217,7 +226,8 @@ void RIFF::WAV::File::read(bool readProperties)
           d->hasInfo = true;
         }
         else {
-          debug("RIFF::WAV::File::read() - Duplicate INFO tag found.");
+          diagnose(Diagnostics::RIFF, Diagnostics::Duplicate,
+                   "RIFF::WAV::File::read() - Duplicate INFO tag found.");
         }
       }
     }
@@ -117,29 +117,34 @@ void RIFF::WAV::Properties::read(File *file)
       if(data.isEmpty())
         data = file->chunkData(i);
       else
-        debug("RIFF::WAV::Properties::read() - Duplicate 'fmt ' chunk found.");
+        diagnose(Diagnostics::RIFF, Diagnostics::Duplicate,
+                 "RIFF::WAV::Properties::read() - Duplicate 'fmt ' chunk found.");
     }
     else if(name == "data") {
       if(streamLength == 0)
         streamLength = file->chunkDataSize(i) + file->chunkPadding(i);
       else
-        debug("RIFF::WAV::Properties::read() - Duplicate 'data' chunk found.");
+        diagnose(Diagnostics::RIFF, Diagnostics::Duplicate,
+                 "RIFF::WAV::Properties::read() - Duplicate 'data' chunk found.");
     }
     else if(name == "fact") {
       if(totalSamples == 0)
         totalSamples = file->chunkData(i).toUInt(0, false);
       else
-        debug("RIFF::WAV::Properties::read() - Duplicate 'fact' chunk found.");
+        diagnose(Diagnostics::RIFF, Diagnostics::Duplicate,
+                 "RIFF::WAV::Properties::read() - Duplicate 'fact' chunk found.");
     }
   }
 
   if(data.size() < 16) {
-    debug("RIFF::WAV::Properties::read() - 'fmt ' chunk not found or too short.");
+    diagnose(Diagnostics::RIFF, Diagnostics::Missing,
+             "RIFF::WAV::Properties::read() - 'fmt ' chunk not found or too short.");
     return;
   }
 
   if(streamLength == 0) {
-    debug("RIFF::WAV::Properties::read() - 'data' chunk not found.");
+    diagnose(Diagnostics::RIFF, Diagnostics::Missing,
+             "RIFF::WAV::Properties::read() - 'data' chunk not found.");
     return;
   }
 
@@ -147,13 +152,15 @@ void RIFF::WAV::Properties::read(File *file)
   if((d->format & 0xffff) == 0xfffe) {
     // if extensible then read the format from the subformat
     if(data.size() != 40) {
-      debug("RIFF::WAV::Properties::read() - extensible size incorrect");
+      diagnose(Diagnostics::RIFF, Diagnostics::InvalidSize,
+               "RIFF::WAV::Properties::read() - extensible size incorrect");
       return;
     }
     d->format = data.toShort(24, false);
   }
   if(d->format != FORMAT_PCM && d->format != FORMAT_IEEE_FLOAT && totalSamples == 0) {
-    debug("RIFF::WAV::Properties::read() - Non-PCM format, but 'fact' chunk not found.");
+    diagnose(Diagnostics::RIFF, Diagnostics::Missing,
+             "RIFF::WAV::Properties::read() - Non-PCM format, but 'fact' chunk not found.");
     return;
   }
 
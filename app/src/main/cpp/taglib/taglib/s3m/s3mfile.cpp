@@ -147,13 +147,15 @@ void S3M::File::read(bool)
   if(!isOpen())
     return;
 
+  Mod::HeaderReader reader(this);
+
   READ_STRING(d->tag.setTitle, 28);
   READ_BYTE_AS(mark);
   READ_BYTE_AS(type);
 
   READ_ASSERT(mark == 0x1A && type == 0x10);
 
-  seek(32);
+  reader.seek(32);
 
   READ_U16L_AS(length);
   READ_U16L_AS(sampleCount);
@@ -165,7 +167,7 @@ void S3M::File::read(bool)
   READ_U16L(d->properties.setTrackerVersion);
   READ_U16L(d->properties.setFileFormatVersion);
 
-  READ_ASSERT(readBlock(4) == "SCRM");
+  READ_ASSERT(reader.readBlock(4) == "SCRM");
 
   READ_BYTE(d->properties.setGlobalVolume);
   READ_BYTE(d->properties.setBpmSpeed);
@@ -181,7 +183,7 @@ void S3M::File::read(bool)
   // Hm, but there is "UltraClick-removal" and some other
   // variables in ScreamTracker III's GUI.
 
-  seek(12, Current);
+  reader.seek(12, Current);
 
   int channels = 0;
   for(int i = 0; i < 32; ++ i) {
@@ -193,7 +195,7 @@ void S3M::File::read(bool)
   }
   d->properties.setChannels(channels);
 
-  seek(96);
+  reader.seek(96);
   unsigned short realLength = 0;
   for(unsigned short i = 0; i < length; ++ i) {
     READ_BYTE_AS(order);
@@ -202,7 +204,7 @@ void S3M::File::read(bool)
   }
   d->properties.setLengthInPatterns(realLength);
 
-  seek(channels, Current);
+  reader.seek(channels, Current);
 
   // Note: The S3M spec mentions samples and instruments, but in
   //       the header there are only pointers to instruments.
@@ -210,10 +212,10 @@ void S3M::File::read(bool)
   //       instead samples (SCRS).
   StringList comment;
   for(unsigned short i = 0; i < sampleCount; ++ i) {
-    seek(96L + length + (static_cast<long>(i) << 1));
+    reader.seek(96L + length + (static_cast<long>(i) << 1));
 
     READ_U16L_AS(sampleHeaderOffset);
-    seek(static_cast<long>(sampleHeaderOffset) << 4);
+    reader.seek(static_cast<long>(sampleHeaderOffset) << 4);
 
     READ_BYTE_AS(sampleType);
     READ_STRING_AS(dosFileName, 13);
@@ -223,18 +225,18 @@ void S3M::File::read(bool)
     READ_U32L_AS(repeatStop);
     READ_BYTE_AS(sampleVolume);
 
-    seek(1, Current);
+    reader.seek(1, Current);
 
     READ_BYTE_AS(packing);
     READ_BYTE_AS(sampleFlags);
     READ_U32L_AS(baseFrequency);
 
-    seek(12, Current);
+    reader.seek(12, Current);
 
     READ_STRING_AS(sampleName, 28);
     // The next 4 bytes should be "SCRS", but I've found
     // files that are otherwise ok with 4 nils instead.
-    // READ_ASSERT(readBlock(4) == "SCRS");
+    // READ_ASSERT(reader.readBlock(4) == "SCRS");
 
     comment.append(sampleName);
   }
@@ -156,6 +156,27 @@ List<VariantMap> Tag::complexProperties(const String &) const
   return {};
 }
 
+List<VariantMap> Tag::complexProperties(const String &key,
+                                        ComplexPropertySelection selection) const
+{
+  const List<VariantMap> props = complexProperties(key);
+  if(selection == AllValues || props.size() <= 1)
+    return props;
+
+  if(selection == FrontCoverOrFirst) {
+    for(const auto &property : props) {
+      if(property.value("pictureType").toString() == "Front Cover")
+        return List<VariantMap>({ property });
+    }
+  }
+  return List<VariantMap>({ props.front() });
+}
+
+unsigned int Tag::complexPropertyCount(const String &key) const
+{
+  return complexProperties(key).size();
+}
+
 bool Tag::setComplexProperties(const String &, const List<VariantMap> &)
 {
   return false;
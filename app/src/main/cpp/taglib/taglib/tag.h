@@ -116,6 +116,45 @@ namespace TagLib {
      */
     virtual List<VariantMap> complexProperties(const String &key) const;
 
+    /*!
+     * Selects which values of a complex property are returned by
+     * complexProperties(const String &, ComplexPropertySelection).
+     */
+    enum ComplexPropertySelection {
+      //! All values, the same as complexProperties(const String &)
+      AllValues,
+      //! Only the first value
+      FirstValue,
+      //! Only the first value with the pictureType "Front Cover", or the first
+      //! value if there is no front cover
+      FrontCoverOrFirst
+    };
+
+    /*!
+     * Get the complex properties for a given \a key like
+     * complexProperties(const String &), but only those picked by
+     * \a selection.  Formats which keep the values in the file until they are
+     * needed, such as the pictures of FLAC files, only load the values which
+     * are returned, so this is cheaper than taking the front of the full list
+     * if a file has many pictures.
+     *
+     * The default implementation picks from the result of
+     * complexProperties(const String &).
+     */
+    virtual List<VariantMap> complexProperties(const String &key,
+                                               ComplexPropertySelection selection) const;
+
+    /*!
+     * Returns the number of values complexProperties(const String &) would
+     * return for \a key.  Formats which keep the values in the file until
+     * they are needed, such as the pictures of FLAC files, count them without
+     * loading them.
+     *
+     * The default implementation returns the size of the result of
+     * complexProperties(const String &).
+     */
+    virtual unsigned int complexPropertyCount(const String &key) const;
+
     /*!
      * Set all complex properties for a given \a key using variant maps as
      * \a value with the same format as returned by complexProperties().
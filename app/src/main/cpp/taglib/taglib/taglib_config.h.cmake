@@ -3,9 +3,18 @@
 #ifndef TAGLIB_TAGLIB_CONFIG_H
 #define TAGLIB_TAGLIB_CONFIG_H
 
-/* These values are no longer used. This file is present only for compatibility reasons. */
+/* The optional formats which are built, see the WITH_* options in CMakeLists.txt. */
 
-#define   TAGLIB_WITH_ASF 1
-#define   TAGLIB_WITH_MP4 1
+#cmakedefine   TAGLIB_WITH_APE 1
+#cmakedefine   TAGLIB_WITH_ASF 1
+#cmakedefine   TAGLIB_WITH_DSF 1
+#cmakedefine   TAGLIB_WITH_MOD 1
+#cmakedefine   TAGLIB_WITH_MP4 1
+#cmakedefine   TAGLIB_WITH_RIFF 1
+#cmakedefine   TAGLIB_WITH_TRUEAUDIO 1
+#cmakedefine   TAGLIB_WITH_VORBIS 1
+
+/* List and Map store their elements in a std::vector, this changes the ABI. */
+#cmakedefine  TAGLIB_CONTIGUOUS_CONTAINERS 1
 
 #endif
@@ -135,10 +135,16 @@ StringList TagUnion::complexPropertyKeys() const
 }
 
 List<VariantMap> TagUnion::complexProperties(const String &key) const
+{
+  return complexProperties(key, AllValues);
+}
+
+List<VariantMap> TagUnion::complexProperties(const String &key,
+                                             ComplexPropertySelection selection) const
 {
   for(const auto &t : d->tags) {
     if(t) {
-      const List<VariantMap> props = t->complexProperties(key);
+      const List<VariantMap> props = t->complexProperties(key, selection);
       if(!props.isEmpty()) {
         return props;
       }
@@ -147,6 +153,19 @@ List<VariantMap> TagUnion::complexProperties(const String &key) const
   return List<VariantMap>();
 }
 
+unsigned int TagUnion::complexPropertyCount(const String &key) const
+{
+  // Counts the values of the same tag which complexProperties() returns.
+  for(const auto &t : d->tags) {
+    if(t) {
+      if(const unsigned int count = t->complexPropertyCount(key)) {
+        return count;
+      }
+    }
+  }
+  return 0;
+}
+
 bool TagUnion::setComplexProperties(const String &key, const List<VariantMap> &value)
 {
   bool combinedResult = false;
@@ -64,6 +64,9 @@ namespace TagLib {
 
     StringList complexPropertyKeys() const override;
     List<VariantMap> complexProperties(const String &key) const override;
+    List<VariantMap> complexProperties(const String &key,
+                                       ComplexPropertySelection selection) const override;
+    unsigned int complexPropertyCount(const String &key) const override;
     bool setComplexProperties(const String &key, const List<VariantMap> &value) override;
 
     String title() const override;
@@ -25,11 +25,14 @@
 
 #include "tagutils.h"
 
+#include <algorithm>
+
 #include "tfile.h"
 
 #include "id3v1tag.h"
 #include "id3v2header.h"
 #include "apetag.h"
+#include "apefooter.h"
 
 using namespace TagLib;
 
@@ -71,22 +74,90 @@ offset_t Utils::findID3v2(File *file)
   return -1;
 }
 
-offset_t Utils::findAPE(File *file, offset_t id3v1Location)
+ByteVector Utils::TailProbe::id3v1Data() const
+{
+  if(id3v1Location < dataOffset)
+    return ByteVector();
+
+  return data.mid(static_cast<unsigned int>(id3v1Location - dataOffset), 128);
+}
+
+ByteVector Utils::TailProbe::apeData() const
+{
+  if(apeFooterLocation < dataOffset)
+    return ByteVector();
+
+  return data.mid(0, static_cast<unsigned int>(apeFooterLocation - dataOffset) + APE::Footer::size());
+}
+
+Utils::TailProbe Utils::probeTail(File *file, unsigned int length)
 {
+  TailProbe probe;
+
   if(!file->isValid())
-    return -1;
+    return probe;
 
-  if(id3v1Location >= 0)
-    file->seek(id3v1Location - 32, File::Beginning);
-  else
-    file->seek(-32, File::End);
+  const offset_t fileLength = file->length();
+  const offset_t size = std::min<offset_t>(fileLength, length);
 
-  const offset_t p = file->tell();
+  file->seek(fileLength - size);
+  probe.dataOffset = file->tell();
+  probe.data = file->readBlock(static_cast<size_t>(size));
 
-  if(file->readBlock(8) == APE::Tag::fileIdentifier())
-    return p;
+  // Takes the bytes from the buffer and only falls back to the file if they
+  // are not covered by it.
 
-  return -1;
+  const auto at = [file, &probe](offset_t offset, unsigned int count) {
+    if(offset >= probe.dataOffset &&
+       offset + count <= probe.dataOffset + static_cast<offset_t>(probe.data.size()))
+      return probe.data.mid(static_cast<unsigned int>(offset - probe.dataOffset), count);
+
+    file->seek(offset);
+    return file->readBlock(count);
+  };
+
+  // ID3v1, see findID3v1() for the distinction from an APE footer.
+
+  if(fileLength >= 131) {
+    const ByteVector data = at(fileLength - 131, 8);
+    if(data.containsAt(ID3v1::Tag::fileIdentifier(), 3) && data != APE::Tag::fileIdentifier())
+      probe.id3v1Location = fileLength - 128;
+  }
+  else if(fileLength >= 128) {
+    if(at(fileLength - 128, 3) == ID3v1::Tag::fileIdentifier())
+      probe.id3v1Location = fileLength - 128;
+  }
+
+  const offset_t end = probe.id3v1Location >= 0 ? probe.id3v1Location : fileLength;
+
+  // Lyrics3v2 is terminated by a six digit size and "LYRICS200", the size
+  // counts the block from "LYRICSBEGIN" up to the terminator.
+
+  if(end >= 26) {
+    const ByteVector trailer = at(end - 15, 15);
+    if(trailer.size() == 15 && trailer.containsAt("LYRICS200", 6) &&
+       std::all_of(trailer.begin(), trailer.begin() + 6, [](char c) { return c >= '0' && c <= '9'; })) {
+      const offset_t blockSize = String(trailer.mid(0, 6)).toInt();
+      const offset_t start = end - 15 - blockSize;
+      if(start >= 0 && at(start, 11) == "LYRICSBEGIN")
+        probe.lyrics3Location = start;
+    }
+  }
+
+  // The APE footer directly precedes ID3v1 and, if present, Lyrics3v2.
+
+  const auto findFooter = [&at](offset_t tagEnd) -> offset_t {
+    if(tagEnd >= APE::Footer::size() &&
+       at(tagEnd - APE::Footer::size(), 8) == APE::Tag::fileIdentifier())
+      return tagEnd - APE::Footer::size();
+    return -1;
+  };
+
+  probe.apeFooterLocation = findFooter(end);
+  if(probe.apeFooterLocation < 0 && probe.lyrics3Location >= 0)
+    probe.apeFooterLocation = findFooter(probe.lyrics3Location);
+
+  return probe;
 }
 
 ByteVector TagLib::Utils::readHeader(IOStream *stream, unsigned int length,
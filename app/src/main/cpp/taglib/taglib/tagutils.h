@@ -31,6 +31,7 @@
 #ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
 
 #include "tbytevector.h"
+#include "tag.h"
 
 namespace TagLib {
 
@@ -43,10 +44,57 @@ namespace TagLib {
 
     offset_t findID3v2(File *file);
 
-    offset_t findAPE(File *file, offset_t id3v1Location);
+    // The tags at the end of a file, located with a single read of its last
+    // bytes.  The blocks returned by id3v1Data() and apeData() share the
+    // buffer and are empty if the tag does not start inside of it.
+    struct TailProbe
+    {
+      ByteVector data;
+      offset_t dataOffset { 0 };
+
+      offset_t id3v1Location { -1 };
+      offset_t lyrics3Location { -1 };
+      offset_t apeFooterLocation { -1 };
+
+      // The 128 bytes of the ID3v1 tag.
+      ByteVector id3v1Data() const;
+
+      // Everything from the start of the buffer up to the end of the APE
+      // footer, suitable for APE::Tag(File *, offset_t, const ByteVector &).
+      ByteVector apeData() const;
+    };
+
+    TailProbe probeTail(File *file, unsigned int length = 8192);
 
     ByteVector readHeader(IOStream *stream, unsigned int length, bool skipID3v2,
                           offset_t *headerOffset = nullptr);
+
+    // Builds the values of a complex property for the items which are picked
+    // by selection, see Tag::complexProperties().  toProperty(item) is only
+    // called for the items which are returned, so values which are expensive
+    // to get are not fetched for the others.
+    template<typename Items, typename IsFrontCover, typename ToProperty>
+    List<VariantMap> selectComplexProperties(const Items &items,
+                                             Tag::ComplexPropertySelection selection,
+                                             IsFrontCover isFrontCover,
+                                             ToProperty toProperty)
+    {
+      List<VariantMap> props;
+      if(selection == Tag::FrontCoverOrFirst) {
+        for(const auto &item : items) {
+          if(isFrontCover(item)) {
+            props.append(toProperty(item));
+            return props;
+          }
+        }
+      }
+      for(const auto &item : items) {
+        props.append(toProperty(item));
+        if(selection != Tag::AllValues)
+          break;
+      }
+      return props;
+    }
   }  // namespace Utils
 }  // namespace TagLib
 
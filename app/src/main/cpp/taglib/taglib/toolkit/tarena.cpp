@@ -0,0 +1,146 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tarena.h"
+
+#include <new>
+
+using namespace TagLib;
+
+namespace
+{
+  // Every block starts with a header holding the arena it was taken from, or
+  // null for heap blocks, so that deallocate() works without a lookup.
+  constexpr size_t headerSize = alignof(std::max_align_t);
+
+  constexpr size_t chunkSize = 16 * 1024;
+  constexpr size_t largeAllocation = 1024;
+  constexpr size_t maximumSize = 1024 * 1024;
+
+  thread_local ParseArena *currentArena = nullptr;
+
+  // The number of active scopes on all threads, so that isActive() can skip
+  // the thread local lookup while no arena is in use at all.
+  std::atomic<unsigned int> activeScopes { 0 };
+
+  size_t roundUp(size_t size)
+  {
+    return (size + headerSize - 1) & ~(headerSize - 1);
+  }
+}  // namespace
+
+ParseArena::ParseArena() :
+  owner(std::this_thread::get_id())
+{
+}
+
+ParseArena::~ParseArena()
+{
+  for(char *chunk : chunks)
+    ::operator delete(chunk);
+}
+
+void ParseArena::release()
+{
+  unref();
+}
+
+size_t ParseArena::size() const
+{
+  return used;
+}
+
+void *ParseArena::allocate(size_t size) // static
+{
+  ParseArena *arena = currentArena;
+  void *block = nullptr;
+  if(arena && size <= largeAllocation)
+    block = arena->allocateBlock(headerSize + roundUp(size));
+  if(!block) {
+    arena = nullptr;
+    block = ::operator new(headerSize + size);
+  }
+
+  *static_cast<ParseArena **>(block) = arena;
+  return static_cast<char *>(block) + headerSize;
+}
+
+bool ParseArena::isActive() // static
+{
+  return activeScopes.load(std::memory_order_relaxed) != 0 && currentArena;
+}
+
+void ParseArena::deallocate(void *p) noexcept // static
+{
+  if(!p)
+    return;
+
+  void *block = static_cast<char *>(p) - headerSize;
+  if(ParseArena *arena = *static_cast<ParseArena **>(block))
+    arena->unref();
+  else
+    ::operator delete(block);
+}
+
+ParseArena::Scope::Scope(ParseArena *arena) :
+  previous(currentArena),
+  active(arena && arena->owner == std::this_thread::get_id())
+{
+  if(active) {
+    currentArena = arena;
+    activeScopes.fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+ParseArena::Scope::~Scope()
+{
+  if(active) {
+    currentArena = previous;
+    activeScopes.fetch_sub(1, std::memory_order_relaxed);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// private members
+////////////////////////////////////////////////////////////////////////////////
+
+void *ParseArena::allocateBlock(size_t size)
+{
+  if(static_cast<size_t>(limit - position) < size) {
+    if(chunks.size() * chunkSize >= maximumSize)
+      return nullptr;
+
+    chunks.push_back(static_cast<char *>(::operator new(chunkSize)));
+    position = chunks.back();
+    limit = position + chunkSize;
+  }
+
+  void *block = position;
+  position += size;
+  used += size;
+  references.fetch_add(1, std::memory_order_relaxed);
+  return block;
+}
+
+void ParseArena::unref()
+{
+  if(references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    delete this;
+}
@@ -0,0 +1,176 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_ARENA_H
+#define TAGLIB_ARENA_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "taglib_export.h"
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  //! A monotonic arena for the small objects created while parsing a file
+
+  /*!
+   * While a Scope is active on a thread, allocate() hands out memory from the
+   * arena instead of the heap.  Freeing arena memory only drops a reference,
+   * the chunks are released together once the owner called release() and
+   * every object placed in the arena has been destroyed.  Implicitly shared
+   * values such as String and ByteVector can therefore outlive the FileRef
+   * which owned the arena.
+   *
+   * Only the thread which created the arena allocates from it, so the bump
+   * pointer needs no synchronization.  Large requests and requests after the
+   * arena reached its maximum size go to the heap.
+   *
+   * \note A single value which outlives the parse keeps all chunks of its
+   * arena, up to its maximum size of 1 MiB, alive.  Values which are kept
+   * for long should be rebuilt outside of a Scope, since implicit copies
+   * share the arena memory.
+   */
+  class TAGLIB_EXPORT ParseArena
+  {
+  public:
+    ParseArena();
+
+    ParseArena(const ParseArena &) = delete;
+    ParseArena &operator=(const ParseArena &) = delete;
+
+    /*!
+     * Drops the reference of the owner.  The arena must not be used for new
+     * allocations afterwards.
+     */
+    void release();
+
+    /*!
+     * Returns the number of bytes handed out by this arena.
+     */
+    size_t size() const;
+
+    /*!
+     * Allocates \a size bytes from the arena which is active on this thread,
+     * or from the heap if there is none.
+     */
+    static void *allocate(size_t size);
+
+    /*!
+     * Frees memory returned by allocate(), regardless of where it came from.
+     */
+    static void deallocate(void *p) noexcept;
+
+    /*!
+     * Returns true if an arena is active on this thread.
+     */
+    static bool isActive();
+
+    /*!
+     * Creates a shared \a T in the active arena, or with std::make_shared()
+     * if there is none, so that objects created outside of a Scope do not pay
+     * for the block header.
+     */
+    template <class T, class... Args>
+    static std::shared_ptr<T> makeShared(Args &&... args);
+
+    /*!
+     * Makes \a arena the active arena of the calling thread until the scope
+     * ends.  A null \a arena or an arena created by another thread leaves
+     * the current state untouched.
+     */
+    class TAGLIB_EXPORT Scope
+    {
+    public:
+      explicit Scope(ParseArena *arena);
+      ~Scope();
+
+      Scope(const Scope &) = delete;
+      Scope &operator=(const Scope &) = delete;
+
+    private:
+      ParseArena *previous;
+      bool active;
+    };
+
+    /*!
+     * A standard allocator on top of allocate() and deallocate(), e.g. for
+     * std::allocate_shared().
+     */
+    template <class T>
+    class Allocator
+    {
+    public:
+      using value_type = T;
+
+      Allocator() = default;
+      template <class U>
+      Allocator(const Allocator<U> &) noexcept {}
+
+      T *allocate(size_t n)
+      {
+        return static_cast<T *>(ParseArena::allocate(n * sizeof(T)));
+      }
+
+      void deallocate(T *p, size_t) noexcept
+      {
+        ParseArena::deallocate(p);
+      }
+
+      template <class U>
+      bool operator==(const Allocator<U> &) const noexcept { return true; }
+      template <class U>
+      bool operator!=(const Allocator<U> &) const noexcept { return false; }
+    };
+
+  private:
+    ~ParseArena();
+
+    void *allocateBlock(size_t size);
+    void unref();
+
+    std::atomic<size_t> references { 1 };
+    const std::thread::id owner;
+    std::vector<char *> chunks;
+    char *position { nullptr };
+    char *limit { nullptr };
+    size_t used { 0 };
+  };
+
+  template <class T, class... Args>
+  std::shared_ptr<T> ParseArena::makeShared(Args &&... args)
+  {
+    if(isActive())
+      return std::allocate_shared<T>(Allocator<T>(), std::forward<Args>(args)...);
+    return std::make_shared<T>(std::forward<Args>(args)...);
+  }
+
+}  // namespace TagLib
+
+#endif
+
+#endif
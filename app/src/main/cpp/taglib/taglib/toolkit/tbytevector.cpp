@@ -31,6 +31,7 @@
 #include <cstring>
 #include <iostream>
 
+#include "tarena.h"
 #include "tdebug.h"
 #include "tutils.h"
 
@@ -250,12 +251,12 @@ class ByteVector::ByteVectorPrivate
 {
 public:
   ByteVectorPrivate(unsigned int l, char c) :
-    data(std::make_shared<std::vector<char>>(l, c)),
+    data(ParseArena::makeShared<std::vector<char>>(l, c)),
     offset(0),
     length(l) { }
 
   ByteVectorPrivate(const char *s, unsigned int l) :
-    data(std::make_shared<std::vector<char>>(s, s + l)),
+    data(ParseArena::makeShared<std::vector<char>>(s, s + l)),
     offset(0),
     length(l) { }
 
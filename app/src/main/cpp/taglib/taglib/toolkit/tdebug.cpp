@@ -41,12 +41,12 @@ namespace TagLib
   // The instance is defined in tdebuglistener.cpp.
   extern DebugListener *debugListener;
 
-  void debug(const String &s)
+  void (debug)(const String &s)
   {
     debugListener->printMessage("TagLib: " + s + "\n");
   }
 
-  void debugData(const ByteVector &v)
+  void (debugData)(const ByteVector &v)
   {
     for(unsigned int i = 0; i < v.size(); ++i) {
       const std::string bits = std::bitset<8>(v[i]).to_string();
@@ -26,6 +26,9 @@
 #ifndef TAGLIB_DEBUG_H
 #define TAGLIB_DEBUG_H
 
+#include "tdiagnostics.h"
+#include "tdebuglistener.h"
+
 namespace TagLib {
 
   class String;
@@ -58,12 +61,31 @@ namespace TagLib {
    */
   void debugData(const ByteVector &v);
 
+  // The arguments are only evaluated if the messages are enabled, so that
+  // disabling them saves building the strings as well.
+
+  #define debug(x) \
+    (TagLib::debugMessagesEnabled() ? TagLib::debug(x) : (void)0)
+  #define debugData(x) \
+    (TagLib::debugMessagesEnabled() ? TagLib::debugData(x) : (void)0)
+
 #else
 
   #define debug(x)      ((void)0)
   #define debugData(x)  ((void)0)
 
 #endif
+
+  /*!
+   * Counts a problem of \a kind found in a file of \a format, see
+   * Diagnostics, and outputs \a message like debug().  The counter is updated
+   * even if the message is compiled out or disabled.
+   *
+   * \internal
+   */
+  #define diagnose(format, kind, message) \
+    (TagLib::Diagnostics::record(format, kind), debug(message))
+
 }  // namespace TagLib
 
 #endif
@@ -25,6 +25,7 @@
 
 #include "tdebuglistener.h"
 
+#include <atomic>
 #include <iostream>
 
 #ifdef _WIN32
@@ -60,6 +61,8 @@ namespace
   };
 
   DefaultListener defaultListener;
+
+  std::atomic<bool> messagesEnabled { true };
 }  // namespace
 
 namespace TagLib
@@ -81,4 +84,14 @@ namespace TagLib
     else
       debugListener = &defaultListener;
   }
+
+  void setDebugMessagesEnabled(bool enabled)
+  {
+    messagesEnabled.store(enabled, std::memory_order_relaxed);
+  }
+
+  bool debugMessagesEnabled()
+  {
+    return messagesEnabled.load(std::memory_order_relaxed);
+  }
 }  // namespace TagLib
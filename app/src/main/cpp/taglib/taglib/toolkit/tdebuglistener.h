@@ -71,6 +71,26 @@ namespace TagLib
    * \see DebugListener
    */
   TAGLIB_EXPORT void setDebugListener(DebugListener *listener);
+
+  /*!
+   * Enables or disables the debug messages.  While they are disabled, TagLib
+   * does not even build the messages, so reading many broken files does not
+   * pay for formatting text which nobody reads.  They are enabled by default.
+   *
+   * \note The messages are only compiled in if TagLib is built without NDEBUG
+   * or with TRACE_IN_RELEASE.  The counters in Diagnostics are kept in either
+   * case.
+   *
+   * \see debugMessagesEnabled()
+   */
+  TAGLIB_EXPORT void setDebugMessagesEnabled(bool enabled);
+
+  /*!
+   * Returns true if the debug messages are passed to the listener.
+   *
+   * \see setDebugMessagesEnabled()
+   */
+  TAGLIB_EXPORT bool debugMessagesEnabled();
 }  // namespace TagLib
 
 #endif
@@ -0,0 +1,110 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tdiagnostics.h"
+
+#include <array>
+#include <atomic>
+#include <iterator>
+
+#include "tstring.h"
+
+using namespace TagLib;
+
+namespace
+{
+  std::array<std::array<std::atomic<unsigned long long>, Diagnostics::KindCount>,
+             Diagnostics::FormatCount> counters {};
+
+  const char *const formatNames[] = {
+    "generic", "mpeg", "id3v1", "id3v2", "ape", "flac", "ogg", "mp4", "riff",
+    "asf", "mpc", "wavpack", "trueaudio", "dsf", "dsdiff"
+  };
+  static_assert(std::size(formatNames) == Diagnostics::FormatCount,
+                "formatNames does not match Diagnostics::Format");
+
+  const char *const kindNames[] = {
+    "invalidHeader", "invalidSize", "truncated", "missing", "duplicate",
+    "invalidData", "unsupported"
+  };
+  static_assert(std::size(kindNames) == Diagnostics::KindCount,
+                "kindNames does not match Diagnostics::Kind");
+
+  bool isValid(Diagnostics::Format format, Diagnostics::Kind kind)
+  {
+    return format >= 0 && format < Diagnostics::FormatCount &&
+           kind >= 0 && kind < Diagnostics::KindCount;
+  }
+}  // namespace
+
+unsigned long long Diagnostics::count(Format format, Kind kind)
+{
+  if(!isValid(format, kind))
+    return 0;
+
+  return counters[format][kind].load(std::memory_order_relaxed);
+}
+
+unsigned long long Diagnostics::count(Format format)
+{
+  if(!isValid(format, InvalidHeader))
+    return 0;
+
+  unsigned long long total = 0;
+  for(const auto &counter : counters[format])
+    total += counter.load(std::memory_order_relaxed);
+  return total;
+}
+
+void Diagnostics::reset()
+{
+  for(auto &kinds : counters) {
+    for(auto &counter : kinds)
+      counter.store(0, std::memory_order_relaxed);
+  }
+}
+
+String Diagnostics::toString()
+{
+  String formats;
+  for(int format = 0; format < FormatCount; ++format) {
+    String kinds;
+    for(int kind = 0; kind < KindCount; ++kind) {
+      const unsigned long long n = counters[format][kind].load(std::memory_order_relaxed);
+      if(n == 0)
+        continue;
+      if(!kinds.isEmpty())
+        kinds += ",";
+      kinds += "\"" + String(kindNames[kind]) + "\":" + String::fromLongLong(static_cast<long long>(n));
+    }
+    if(kinds.isEmpty())
+      continue;
+    if(!formats.isEmpty())
+      formats += ",";
+    formats += "\"" + String(formatNames[format]) + "\":{" + kinds + "}";
+  }
+  return "{" + formats + "}";
+}
+
+void Diagnostics::record(Format format, Kind kind)
+{
+  if(isValid(format, kind))
+    counters[format][kind].fetch_add(1, std::memory_order_relaxed);
+}
@@ -0,0 +1,126 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_DIAGNOSTICS_H
+#define TAGLIB_DIAGNOSTICS_H
+
+#include "taglib_export.h"
+
+namespace TagLib {
+
+  class String;
+
+  //! Counters of the problems found while reading files
+
+  /*!
+   * Every time a parser comes across a malformed or unsupported part of a file
+   * it increments a counter for the format and the kind of the problem.  The
+   * counters are kept whether or not the debug messages are enabled, see
+   * setDebugMessagesEnabled(), and cost one atomic increment each, so they can
+   * be used to find out how many of the files in a large scan are broken and
+   * how, without listening to the messages.
+   *
+   * The counters are shared by all threads of the process.
+   */
+  namespace Diagnostics {
+
+    /*!
+     * The format in which a problem was found.
+     */
+    enum Format {
+      //! Shared code such as zlib decompression
+      Generic,
+      MPEG,
+      ID3v1,
+      ID3v2,
+      APE,
+      FLAC,
+      Ogg,
+      MP4,
+      RIFF,
+      ASF,
+      MPC,
+      WavPack,
+      TrueAudio,
+      DSF,
+      DSDIFF,
+      //! The number of formats, not a format
+      FormatCount
+    };
+
+    /*!
+     * The kind of a problem.
+     */
+    enum Kind {
+      //! An identifier, a sync word or a type field has an unexpected value
+      InvalidHeader,
+      //! A size field does not fit the data or the file
+      InvalidSize,
+      //! The data ends before the structure that is being read
+      Truncated,
+      //! A required header, chunk or atom is not there
+      Missing,
+      //! The same structure appears more than once and was skipped
+      Duplicate,
+      //! The content of a structure could not be decoded
+      InvalidData,
+      //! The structure is valid, but TagLib does not support it
+      Unsupported,
+      //! The number of kinds, not a kind
+      KindCount
+    };
+
+    /*!
+     * Returns how many problems of \a kind were found in files of \a format
+     * since the start of the process or the last call to reset().
+     */
+    TAGLIB_EXPORT unsigned long long count(Format format, Kind kind);
+
+    /*!
+     * Returns how many problems of any kind were found in files of \a format.
+     */
+    TAGLIB_EXPORT unsigned long long count(Format format);
+
+    /*!
+     * Sets all of the counters to zero.
+     */
+    TAGLIB_EXPORT void reset();
+
+    /*!
+     * Returns the counters which are not zero as a single line JSON object,
+     * grouped by format, e.g. {"mp4":{"truncated":2},"riff":{"invalidSize":1}}.
+     */
+    TAGLIB_EXPORT String toString();
+
+#ifndef DO_NOT_DOCUMENT
+
+    /*!
+     * Increments the counter of \a kind for \a format.
+     *
+     * \internal
+     */
+    void record(Format format, Kind kind);
+
+#endif
+
+  }  // namespace Diagnostics
+}  // namespace TagLib
+
+#endif
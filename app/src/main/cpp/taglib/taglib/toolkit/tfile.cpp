@@ -25,6 +25,12 @@
 
 #include "tfile.h"
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <utility>
+#include <vector>
+
 #include "tfilestream.h"
 #include "tpropertymap.h"
 #include "tstring.h"
@@ -43,10 +49,78 @@
 # define W_OK 2
 #endif
 
-#include "wavpackfile.h"
-
 using namespace TagLib;
 
+namespace
+{
+  // findAny() reads this much at a time, since it is used to skip over large
+  // regions of a file.
+  constexpr unsigned int FindBlockSize = 16 * 1024;
+
+  // Finds the leftmost occurrence of any of a set of patterns.  Positions are
+  // first filtered by their byte, which rules out most of them with a single
+  // table lookup, and only the patterns starting with that byte are compared.
+
+  class PatternMatcher
+  {
+  public:
+    explicit PatternMatcher(const ByteVectorList &patterns)
+    {
+      int i = 0;
+      for(const auto &pattern : patterns) {
+        if(!pattern.isEmpty()) {
+          const auto first = static_cast<unsigned char>(pattern[0]);
+          if(candidates[first].empty())
+            firstBytes.push_back(first);
+          candidates[first].emplace_back(i, pattern);
+        }
+        ++i;
+      }
+    }
+
+    // Returns the position of the leftmost match starting in [from, end) in
+    // data, or -1.  Patterns have to fit in data, but may extend beyond end.
+    int find(const ByteVector &data, unsigned int from, unsigned int end, int *index) const
+    {
+      if(firstBytes.empty())
+        return -1;
+
+      const auto begin = reinterpret_cast<const unsigned char *>(data.data());
+      const unsigned char *p = begin + from;
+      const unsigned char *const last = begin + end;
+
+      while(p < last) {
+        if(firstBytes.size() == 1) {
+          p = static_cast<const unsigned char *>(
+            ::memchr(p, firstBytes.front(), last - p));
+          if(!p)
+            return -1;
+        }
+        else if(candidates[*p].empty()) {
+          ++p;
+          continue;
+        }
+
+        const auto position = static_cast<unsigned int>(p - begin);
+        for(const auto &[patternIndex, pattern] : candidates[*p]) {
+          if(data.containsAt(pattern, position)) {
+            if(index)
+              *index = patternIndex;
+            return static_cast<int>(position);
+          }
+        }
+        ++p;
+      }
+
+      return -1;
+    }
+
+  private:
+    std::array<std::vector<std::pair<int, ByteVector>>, 256> candidates;
+    std::vector<unsigned char> firstBytes;
+  };
+}  // namespace
+
 class File::FilePrivate
 {
 public:
@@ -116,6 +190,17 @@ List<VariantMap> File::complexProperties(const String &key) const
   return tag()->complexProperties(key);
 }
 
+List<VariantMap> File::complexProperties(const String &key,
+                                         Tag::ComplexPropertySelection selection) const
+{
+  return tag()->complexProperties(key, selection);
+}
+
+unsigned int File::complexPropertyCount(const String &key) const
+{
+  return tag()->complexPropertyCount(key);
+}
+
 bool File::setComplexProperties(const String &key, const List<VariantMap> &value)
 {
   return tag()->setComplexProperties(key, value);
@@ -133,87 +218,100 @@ void File::writeBlock(const ByteVector &data)
 
 offset_t File::find(const ByteVector &pattern, offset_t fromOffset, const ByteVector &before)
 {
-  if(!d->stream || pattern.size() > bufferSize())
-      return -1;
+  if(pattern.isEmpty())
+    return -1;
 
-  // The position in the file that the current buffer starts at.
+  // The search stops at "before", so it is just one more pattern to look for.
 
-  offset_t bufferOffset = fromOffset;
+  if(before.isEmpty())
+    return findAny(ByteVectorList { pattern }, fromOffset);
 
-  // These variables are used to keep track of a partial match that happens at
-  // the end of a buffer.
+  int index = -1;
+  const offset_t location = findAny(ByteVectorList { pattern, before }, fromOffset, &index);
+  return index == 0 ? location : -1;
+}
 
-  int previousPartialMatch = -1;
-  int beforePreviousPartialMatch = -1;
+offset_t File::findAny(const ByteVectorList &patterns, offset_t fromOffset, int *index)
+{
+  if(index)
+    *index = -1;
+
+  return findAny(patterns, fromOffset, [index](offset_t, int patternIndex) {
+    if(index)
+      *index = patternIndex;
+    return true;
+  });
+}
 
-  // Save the location of the current read pointer.  We will restore the
-  // position using seek() before all returns.
+offset_t File::findAny(const ByteVectorList &patterns, offset_t fromOffset,
+                       const std::function<bool(offset_t, int)> &accept)
+{
+  if(!d->stream)
+    return -1;
 
-  offset_t originalPosition = tell();
+  unsigned int maxPatternSize = 0;
+  for(const auto &pattern : patterns)
+    maxPatternSize = std::max(maxPatternSize, pattern.size());
 
-  // Start the search at the offset.
+  if(maxPatternSize == 0 || maxPatternSize > bufferSize())
+    return -1;
 
-  seek(fromOffset);
+  const PatternMatcher matcher(patterns);
 
-  // This loop is the crux of the find method.  There are three cases that we
-  // want to account for:
-  //
-  // (1) The previously searched buffer contained a partial match of the search
-  // pattern and we want to see if the next one starts with the remainder of
-  // that pattern.
-  //
-  // (2) The search pattern is wholly contained within the current buffer.
-  //
-  // (3) The current buffer ends with a partial match of the pattern.  We will
-  // note this for use in the next iteration, where we will check for the rest
-  // of the pattern.
-  //
-  // All three of these are done in two steps.  First we check for the pattern
-  // and do things appropriately if a match (or partial match) is found.  We
-  // then check for "before".  The order is important because it gives priority
-  // to "real" matches.
-
-  for(auto buffer = readBlock(bufferSize()); !buffer.isEmpty(); buffer = readBlock(bufferSize())) {
-
-    // (1) previous partial match
-
-    if(previousPartialMatch >= 0 && static_cast<int>(bufferSize()) > previousPartialMatch) {
-      const int patternOffset = (bufferSize() - previousPartialMatch);
-      if(buffer.containsAt(pattern, 0, patternOffset)) {
-        seek(originalPosition);
-        return bufferOffset - bufferSize() + previousPartialMatch;
-      }
-    }
+  // A match can straddle two blocks, so the last maxPatternSize - 1 bytes of
+  // a window are carried over to the next one and matches which start there
+  // are left for the next window.  This keeps the result the leftmost match
+  // even when a shorter pattern follows a longer one which did not fit.
 
-    if(!before.isEmpty() && beforePreviousPartialMatch >= 0 && static_cast<int>(bufferSize()) > beforePreviousPartialMatch) {
-      const int beforeOffset = (bufferSize() - beforePreviousPartialMatch);
-      if(buffer.containsAt(before, 0, beforeOffset)) {
-        seek(originalPosition);
-        return -1;
-      }
-    }
+  const unsigned int overlap = maxPatternSize - 1;
 
-    // (2) pattern contained in current buffer
+  // Save the location of the current read pointer.  We will restore the
+  // position using seek() before all returns.
 
-    long location = buffer.find(pattern);
-    if(location >= 0) {
-      seek(originalPosition);
-      return bufferOffset + location;
-    }
+  const offset_t originalPosition = tell();
 
-    if(!before.isEmpty() && buffer.find(before) >= 0) {
-      seek(originalPosition);
-      return -1;
-    }
+  seek(fromOffset);
 
-    // (3) partial match
+  ByteVector window;
+  offset_t windowOffset = fromOffset;
 
-    previousPartialMatch = buffer.endsWithPartialMatch(pattern);
+  while(true) {
+    const ByteVector block = readBlock(FindBlockSize);
+    const bool atEnd = block.isEmpty();
+
+    window.append(block);
+
+    if(atEnd || window.size() > overlap) {
+      const unsigned int end = atEnd ? window.size() : window.size() - overlap;
+
+      // Rejected matches are skipped within the same window, without reading
+      // it again.  accept() may read from the file, so the read position is
+      // restored before the next block.
+
+      bool rejected = false;
+      unsigned int from = 0;
+      int patternIndex = -1;
+      int location;
+      while((location = matcher.find(window, from, end, &patternIndex)) >= 0) {
+        if(accept(windowOffset + location, patternIndex)) {
+          seek(originalPosition);
+          return windowOffset + location;
+        }
+        rejected = true;
+        from = location + 1;
+      }
 
-    if(!before.isEmpty())
-      beforePreviousPartialMatch = buffer.endsWithPartialMatch(before);
+      if(atEnd)
+        break;
 
-    bufferOffset += bufferSize();
+      if(rejected) {
+        clear();
+        seek(windowOffset + window.size());
+      }
+
+      window = window.mid(end);
+      windowOffset += end;
+    }
   }
 
   // Since we hit the end of the file, reset the status before continuing.
@@ -225,7 +323,6 @@ offset_t File::find(const ByteVector &pattern, offset_t fromOffset, const ByteVe
   return -1;
 }
 
-
 offset_t File::rfind(const ByteVector &pattern, offset_t fromOffset, const ByteVector &before)
 {
   if(!d->stream || pattern.size() > bufferSize())
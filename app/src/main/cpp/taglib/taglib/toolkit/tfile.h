@@ -26,7 +26,10 @@
 #ifndef TAGLIB_FILE_H
 #define TAGLIB_FILE_H
 
+#include <functional>
+
 #include "tbytevector.h"
+#include "tbytevectorlist.h"
 #include "tiostream.h"
 #include "taglib_export.h"
 #include "taglib.h"
@@ -148,6 +151,22 @@ namespace TagLib {
      */
     virtual List<VariantMap> complexProperties(const String &key) const;
 
+    /*!
+     * Get the complex properties for a given \a key picked by \a selection.
+     * The default implementation calls Tag::complexProperties() with
+     * \a selection.
+     * \see Tag::complexProperties(const String &, Tag::ComplexPropertySelection)
+     */
+    virtual List<VariantMap> complexProperties(const String &key,
+                                               Tag::ComplexPropertySelection selection) const;
+
+    /*!
+     * Returns the number of complex properties for \a key.
+     * The default implementation calls Tag::complexPropertyCount().
+     * \see Tag::complexPropertyCount()
+     */
+    virtual unsigned int complexPropertyCount(const String &key) const;
+
     /*!
      * Set all complex properties for \a key using the variant maps \a value.
      * The default implementation calls Tag::setComplexProperties().
@@ -206,6 +225,36 @@ namespace TagLib {
               offset_t fromOffset = 0,
               const ByteVector &before = ByteVector());
 
+    /*!
+     * Returns the offset in the file that the first occurrence of any of
+     * \a patterns starts at or -1 if none of them can be found.  If \a index
+     * is not null, it is set to the position of the matching pattern in
+     * \a patterns, or to -1 if there is no match.  When several patterns
+     * start at the same offset, the one which comes first in \a patterns wins.
+     *
+     * All of the patterns are looked for in a single pass over the file, which
+     * is much faster than calling find() once per pattern.  Searching starts at
+     * \a fromOffset, which defaults to the beginning of the file.  Empty
+     * patterns never match.
+     *
+     * \note Like find(), none of the patterns can be longer than the buffer
+     * size used by readBlock().
+     */
+    offset_t findAny(const ByteVectorList &patterns,
+                     offset_t fromOffset = 0,
+                     int *index = nullptr);
+
+    /*!
+     * Like findAny(const ByteVectorList &, offset_t, int *), but only stops at
+     * a match if \a accept returns true for its offset and the index of the
+     * matching pattern.  Otherwise the search goes on from the next byte in
+     * the same pass, so a match that has to be validated, e.g. an MPEG frame
+     * sync, does not restart the search.  \a accept may read from the file.
+     */
+    offset_t findAny(const ByteVectorList &patterns,
+                     offset_t fromOffset,
+                     const std::function<bool(offset_t offset, int index)> &accept);
+
     /*!
      * Returns the offset in the file that \a pattern occurs at or -1 if it can
      * not be found.  If \a before is set, the search will only continue until the
@@ -28,7 +28,10 @@
 #ifdef _WIN32
 # include <windows.h>
 #else
+# include <cerrno>
 # include <cstdio>
+# include <fcntl.h>
+# include <sys/stat.h>
 # include <unistd.h>
 #endif
 
@@ -85,6 +88,18 @@ namespace
     return 0;
   }
 
+  size_t readFileAt([[maybe_unused]] int fileDescriptor, [[maybe_unused]] ByteVector &buffer,
+                    [[maybe_unused]] offset_t position)
+  {
+    return 0;
+  }
+
+  size_t writeFileAt([[maybe_unused]] int fileDescriptor, [[maybe_unused]] const ByteVector &buffer,
+                     [[maybe_unused]] offset_t position)
+  {
+    return 0;
+  }
+
 #else   // _WIN32
 
   struct FileNameHandle : public std::string
@@ -122,6 +137,39 @@ namespace
     return fwrite(buffer.data(), sizeof(char), buffer.size(), file);
   }
 
+  // pread() and pwrite() may transfer less than requested, e.g. when
+  // interrupted by a signal, so they are repeated until done or at the end.
+
+  size_t readFileAt(int fileDescriptor, ByteVector &buffer, offset_t position)
+  {
+    size_t count = 0;
+    while(count < buffer.size()) {
+      const ssize_t n = pread(fileDescriptor, buffer.data() + count, buffer.size() - count,
+                              static_cast<off_t>(position + count));
+      if(n < 0 && errno == EINTR)
+        continue;
+      if(n <= 0)
+        break;
+      count += static_cast<size_t>(n);
+    }
+    return count;
+  }
+
+  size_t writeFileAt(int fileDescriptor, const ByteVector &buffer, offset_t position)
+  {
+    size_t count = 0;
+    while(count < buffer.size()) {
+      const ssize_t n = pwrite(fileDescriptor, buffer.data() + count, buffer.size() - count,
+                               static_cast<off_t>(position + count));
+      if(n < 0 && errno == EINTR)
+        continue;
+      if(n <= 0)
+        break;
+      count += static_cast<size_t>(n);
+    }
+    return count;
+  }
+
 #endif  // _WIN32
 }  // namespace
 
@@ -133,9 +181,41 @@ public:
   {
   }
 
+  // Reads or writes at the current position, either through the stdio
+  // handle or with positional I/O on the descriptor.
+
+  size_t read(ByteVector &buffer)
+  {
+    if(descriptor < 0)
+      return readFile(file, buffer);
+
+    const size_t count = readFileAt(descriptor, buffer, position);
+    position += count;
+    return count;
+  }
+
+  size_t write(const ByteVector &buffer)
+  {
+    if(descriptor < 0)
+      return writeFile(file, buffer);
+
+    const size_t count = writeFileAt(descriptor, buffer, position);
+    position += count;
+    return count;
+  }
+
   FileHandle file { InvalidFileHandle };
   FileNameHandle name;
   bool readOnly { true };
+
+  // Only used for positional I/O, in which case file is not open.
+  int descriptor { -1 };
+  bool ownsDescriptor { false };
+  offset_t position { 0 };
+
+  // The length is cached as most formats ask for it for every chunk or atom,
+  // it is only changed by this stream.  Negative if it has to be read again.
+  offset_t length { -1 };
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -180,10 +260,39 @@ FileStream::FileStream(int fileDescriptor, bool openReadOnly) :
     debug("Could not open file using file descriptor");
 }
 
+FileStream::FileStream(int fileDescriptor, bool openReadOnly, DescriptorOwnership ownership) :
+  d(std::make_unique<FileStreamPrivate>(""))
+{
+#ifdef _WIN32
+
+  debug("Positional I/O on file descriptors is not supported on Windows");
+
+#else
+
+  const int flags = fcntl(fileDescriptor, F_GETFL);
+  if(flags == -1) {
+    debug("Could not open file using file descriptor");
+    return;
+  }
+
+  d->descriptor = fileDescriptor;
+  d->ownsDescriptor = (ownership == TakeOwnership);
+  d->readOnly = openReadOnly || (flags & O_ACCMODE) == O_RDONLY;
+
+#endif
+}
+
 FileStream::~FileStream()
 {
-  if(isOpen())
+  if(d->descriptor >= 0) {
+#ifndef _WIN32
+    if(d->ownsDescriptor)
+      close(d->descriptor);
+#endif
+  }
+  else if(isOpen()) {
     closeFile(d->file);
+  }
 }
 
 FileName FileStream::name() const
@@ -210,7 +319,7 @@ ByteVector FileStream::readBlock(size_t length)
 
   ByteVector buffer(static_cast<unsigned int>(length));
 
-  const size_t count = readFile(d->file, buffer);
+  const size_t count = d->read(buffer);
   buffer.resize(static_cast<unsigned int>(count));
 
   return buffer;
@@ -228,7 +337,8 @@ void FileStream::writeBlock(const ByteVector &data)
     return;
   }
 
-  writeFile(d->file, data);
+  d->length = -1;
+  d->write(data);
 }
 
 void FileStream::insert(const ByteVector &data, offset_t start, size_t replace)
@@ -243,6 +353,8 @@ void FileStream::insert(const ByteVector &data, offset_t start, size_t replace)
     return;
   }
 
+  d->length = -1;
+
   if(data.size() == replace) {
     seek(start);
     writeBlock(data);
@@ -283,7 +395,7 @@ void FileStream::insert(const ByteVector &data, offset_t start, size_t replace)
     // to overwrite.  Appropriately increment the readPosition.
 
     seek(readPosition);
-    const auto bytesRead = static_cast<unsigned int>(readFile(d->file, aboutToOverwrite));
+    const auto bytesRead = static_cast<unsigned int>(d->read(aboutToOverwrite));
     aboutToOverwrite.resize(bytesRead);
     readPosition += bufferLength;
 
@@ -319,6 +431,8 @@ void FileStream::removeBlock(offset_t start, size_t length)
     return;
   }
 
+  d->length = -1;
+
   unsigned int bufferLength = bufferSize();
 
   offset_t readPosition = start + length;
@@ -328,7 +442,7 @@ void FileStream::removeBlock(offset_t start, size_t length)
 
   for(unsigned int bytesRead = -1; bytesRead != 0;) {
     seek(readPosition);
-    bytesRead = static_cast<unsigned int>(readFile(d->file, buffer));
+    bytesRead = static_cast<unsigned int>(d->read(buffer));
     readPosition += bytesRead;
 
     // Check to see if we just read the last block.  We need to call clear()
@@ -340,7 +454,7 @@ void FileStream::removeBlock(offset_t start, size_t length)
     }
 
     seek(writePosition);
-    writeFile(d->file, buffer);
+    d->write(buffer);
 
     writePosition += bytesRead;
   }
@@ -355,7 +469,7 @@ bool FileStream::readOnly() const
 
 bool FileStream::isOpen() const
 {
-  return (d->file != InvalidFileHandle);
+  return (d->file != InvalidFileHandle || d->descriptor >= 0);
 }
 
 void FileStream::seek(offset_t offset, Position p)
@@ -397,6 +511,22 @@ void FileStream::seek(offset_t offset, Position p)
     return;
   }
 
+  if(d->descriptor >= 0) {
+    offset_t position = offset;
+    if(whence == SEEK_CUR)
+      position += d->position;
+    else if(whence == SEEK_END)
+      position += length();
+
+    if(position < 0) {
+      debug("FileStream::seek() -- Invalid position.");
+      return;
+    }
+
+    d->position = position;
+    return;
+  }
+
   fseek(d->file, offset, whence);
 
 #endif
@@ -410,7 +540,8 @@ void FileStream::clear()
 
 #else
 
-  clearerr(d->file);
+  if(d->descriptor < 0)
+    clearerr(d->file);
 
 #endif
 }
@@ -431,6 +562,9 @@ offset_t FileStream::tell() const
 
 #else
 
+  if(d->descriptor >= 0)
+    return d->position;
+
   return ftell(d->file);
 
 #endif
@@ -443,12 +577,16 @@ offset_t FileStream::length()
     return 0;
   }
 
+  if(d->length >= 0)
+    return d->length;
+
 #ifdef _WIN32
 
   LARGE_INTEGER fileSize;
 
   if(GetFileSizeEx(d->file, &fileSize)) {
-    return fileSize.QuadPart;
+    d->length = fileSize.QuadPart;
+    return d->length;
   }
 
   debug("FileStream::length() -- Failed to get the file size.");
@@ -456,14 +594,20 @@ offset_t FileStream::length()
 
 #else
 
-  const offset_t curpos = tell();
+  // Seeking to the end would discard the stdio buffer, fstat() does not.
+  // Pending writes have to be flushed first to be included in the size.
 
-  seek(0, End);
-  const offset_t endpos = tell();
+  if(d->descriptor < 0 && !d->readOnly)
+    fflush(d->file);
 
-  seek(curpos, Beginning);
+  struct stat st;
+  if(fstat(d->descriptor >= 0 ? d->descriptor : fileno(d->file), &st) == 0) {
+    d->length = static_cast<offset_t>(st.st_size);
+    return d->length;
+  }
 
-  return endpos;
+  debug("FileStream::length() -- Failed to get the file size.");
+  return 0;
 
 #endif
 }
@@ -474,6 +618,8 @@ offset_t FileStream::length()
 
 void FileStream::truncate(offset_t length)
 {
+  d->length = -1;
+
 #ifdef _WIN32
 
   const offset_t currentPos = tell();
@@ -488,8 +634,9 @@ void FileStream::truncate(offset_t length)
 
 #else
 
-  fflush(d->file);
-  const int error = ftruncate(fileno(d->file), length);
+  if(d->descriptor < 0)
+    fflush(d->file);
+  const int error = ftruncate(d->descriptor >= 0 ? d->descriptor : fileno(d->file), length);
   if(error != 0)
     debug("FileStream::truncate() -- Couldn't truncate the file.");
 
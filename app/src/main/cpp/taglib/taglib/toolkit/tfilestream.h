@@ -59,6 +59,29 @@ namespace TagLib {
      */
     FileStream(int fileDescriptor, bool openReadOnly = false);
 
+    /*!
+     * Whether a FileStream closes the file descriptor it was constructed with.
+     */
+    enum DescriptorOwnership {
+      //! The descriptor is closed when the stream is destroyed.
+      TakeOwnership,
+      //! The descriptor is left open, it is owned by the caller.
+      BorrowDescriptor
+    };
+
+    /*!
+     * Construct a File object which accesses \a fileDescriptor with positional
+     * I/O (pread() and pwrite()) at a position kept by the stream itself,
+     * without stdio buffering.  Since the position of the descriptor is never
+     * used, several streams can share one descriptor, also across threads.
+     *
+     * If \a ownership is BorrowDescriptor, the descriptor has to stay open
+     * for the lifetime of the stream and is not closed by it.
+     *
+     * \note This is not available on Windows, where isOpen() returns false.
+     */
+    FileStream(int fileDescriptor, bool openReadOnly, DescriptorOwnership ownership);
+
     /*!
      * Destroys this FileStream instance.
      */
@@ -136,7 +159,9 @@ namespace TagLib {
     offset_t tell() const override;
 
     /*!
-     * Returns the length of the file.
+     * Returns the length of the file.  It is read once and cached until the
+     * file is modified through this stream, changes made by others while the
+     * stream is open are not noticed.
      */
     offset_t length() override;
 
@@ -29,6 +29,7 @@
 #include <list>
 #include <initializer_list>
 #include <memory>
+#include <vector>
 
 #include "taglib.h"
 
@@ -50,14 +51,24 @@ namespace TagLib {
    * return types of functions.  The above example will just copy a pointer rather
    * than copying the data in the list.  When your \e shared list's data changes,
    * only \e then will the data be copied.
+   *
+   * If TagLib is built with \c WITH_CONTIGUOUS_CONTAINERS, the elements are
+   * stored in a std::vector instead of a std::list.  This saves an allocation
+   * per element and makes traversal and operator[] cheap, but like for a
+   * std::vector, inserting or erasing elements invalidates iterators.
    */
 
   template <class T> class List
   {
   public:
 #ifndef DO_NOT_DOCUMENT
+#ifdef TAGLIB_CONTIGUOUS_CONTAINERS
+    using Iterator = typename std::vector<T>::iterator;
+    using ConstIterator = typename std::vector<T>::const_iterator;
+#else
     using Iterator = typename std::list<T>::iterator;
     using ConstIterator = typename std::list<T>::const_iterator;
+#endif
 #endif
 
     /*!
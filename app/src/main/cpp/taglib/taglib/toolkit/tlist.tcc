@@ -45,6 +45,14 @@ public:
   bool autoDelete{};
 };
 
+// The container storing the elements, see TAGLIB_CONTIGUOUS_CONTAINERS.
+
+#ifdef TAGLIB_CONTIGUOUS_CONTAINERS
+template <class TP> using ListContainer = std::vector<TP>;
+#else
+template <class TP> using ListContainer = std::list<TP>;
+#endif
+
 // A generic implementation
 
 template <class T>
@@ -52,12 +60,12 @@ template <class TP> class List<T>::ListPrivate  : public ListPrivateBase
 {
 public:
   using ListPrivateBase::ListPrivateBase;
-  ListPrivate(const std::list<TP> &l) : list(l) {}
+  ListPrivate(const ListContainer<TP> &l) : list(l) {}
   ListPrivate(std::initializer_list<TP> init) : list(init) {}
   void clear() {
     list.clear();
   }
-  std::list<TP> list;
+  ListContainer<TP> list;
 };
 
 // A partial specialization for all pointer types that implements the
@@ -68,7 +76,7 @@ template <class TP> class List<T>::ListPrivate<TP *> : public ListPrivateBase
 {
 public:
   using ListPrivateBase::ListPrivateBase;
-  ListPrivate(const std::list<TP *> &l) : list(l) {}
+  ListPrivate(const ListContainer<TP *> &l) : list(l) {}
   ListPrivate(std::initializer_list<TP *> init) : list(init) {}
   ~ListPrivate() {
     clear();
@@ -82,7 +90,7 @@ public:
     }
     list.clear();
   }
-  std::list<TP *> list;
+  ListContainer<TP *> list;
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -184,7 +192,7 @@ template <class T>
 List<T> &List<T>::prepend(const T &item)
 {
   detach();
-  d->list.push_front(item);
+  d->list.insert(d->list.begin(), item);
   return *this;
 }
 
@@ -340,7 +348,11 @@ template <class T>
 void List<T>::sort()
 {
   detach();
+#ifdef TAGLIB_CONTIGUOUS_CONTAINERS
+  std::stable_sort(d->list.begin(), d->list.end());
+#else
   d->list.sort();
+#endif
 }
 
 template <class T>
@@ -348,7 +360,11 @@ template <class Compare>
 void List<T>::sort(Compare&& comp)
 {
   detach();
+#ifdef TAGLIB_CONTIGUOUS_CONTAINERS
+  std::stable_sort(d->list.begin(), d->list.end(), std::forward<Compare>(comp));
+#else
   d->list.sort(std::forward<Compare>(comp));
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -28,6 +28,8 @@
 
 #include <map>
 #include <memory>
+#include <type_traits>
+#include <vector>
 #include <initializer_list>
 #include <utility>
 
@@ -41,13 +43,21 @@ namespace TagLib {
    * This implements a standard map container that associates a key with a value
    * and has fast key-based lookups.  This map is also implicitly shared making
    * it suitable for pass-by-value usage.
+   *
+   * If TagLib is built with \c WITH_CONTIGUOUS_CONTAINERS, the entries are
+   * kept in a std::vector sorted by key instead of a std::map.  Lookups are
+   * still logarithmic, but inserting or erasing entries invalidates
+   * iterators.
    */
 
   template <class Key, class T> class Map
   {
   public:
 #ifndef DO_NOT_DOCUMENT
-#ifdef WANT_CLASS_INSTANTIATION_OF_MAP
+#ifdef TAGLIB_CONTIGUOUS_CONTAINERS
+    using Iterator = typename std::vector<std::pair<std::remove_const_t<Key>, T>>::iterator;
+    using ConstIterator = typename std::vector<std::pair<std::remove_const_t<Key>, T>>::const_iterator;
+#elif defined(WANT_CLASS_INSTANTIATION_OF_MAP)
     // Some STL implementations get snippy over the use of the
     // class keyword to distinguish different templates; Sun Studio
     // in particular finds multiple specializations in certain rare
@@ -188,7 +198,8 @@ namespace TagLib {
     /*!
      * Returns a reference to the value associated with \a key.
      *
-     * \note This has undefined behavior if the key is not present in the map.
+     * If the map does not contain \a key, it returns a reference to a
+     * default-constructed value and the map is not changed.
      */
     const T &operator[](const Key &key) const;
 
@@ -23,6 +23,8 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <algorithm>
+
 namespace TagLib {
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -35,6 +37,61 @@ class Map<Key, T>::MapPrivate
 {
 public:
   MapPrivate() = default;
+#ifdef TAGLIB_CONTIGUOUS_CONTAINERS
+  // Entries have to be assignable, so the key can not be const.
+  using Entry = std::pair<std::remove_const_t<KeyP>, TP>;
+
+  MapPrivate(const std::vector<Entry> &m) : map(m) {}
+  MapPrivate(std::initializer_list<std::pair<const KeyP, TP>> init)
+  {
+    // As with std::map, the first of several entries with the same key wins.
+    for(const auto &entry : init) {
+      auto it = lowerBound(map.begin(), map.end(), entry.first);
+      if(it == map.end() || entry.first < it->first)
+        map.insert(it, entry);
+    }
+  }
+
+  typename std::vector<Entry>::iterator find(const KeyP &key)
+  {
+    auto it = lowerBound(map.begin(), map.end(), key);
+    return it != map.end() && !(key < it->first) ? it : map.end();
+  }
+
+  typename std::vector<Entry>::const_iterator find(const KeyP &key) const
+  {
+    auto it = lowerBound(map.cbegin(), map.cend(), key);
+    return it != map.cend() && !(key < it->first) ? it : map.cend();
+  }
+
+  // Returns the value for key, inserting a default constructed one if there
+  // is none, like std::map::operator[].
+  TP &lookup(const KeyP &key)
+  {
+    auto it = lowerBound(map.begin(), map.end(), key);
+    if(it == map.end() || key < it->first)
+      it = map.insert(it, Entry(key, TP()));
+    return it->second;
+  }
+
+  void erase(const KeyP &key)
+  {
+    auto it = find(key);
+    if(it != map.end())
+      map.erase(it);
+  }
+
+  std::vector<Entry> map;
+
+private:
+  template <class Iterator>
+  static Iterator lowerBound(Iterator begin, Iterator end, const KeyP &key)
+  {
+    return std::lower_bound(begin, end, key, [](const Entry &entry, const KeyP &k) {
+      return entry.first < k;
+    });
+  }
+#else
 #ifdef WANT_CLASS_INSTANTIATION_OF_MAP
   MapPrivate(const std::map<class KeyP, class TP>& m) : map(m) {}
   MapPrivate(std::initializer_list<std::pair<const class KeyP, class TP>> init) : map(init) {}
@@ -46,6 +103,12 @@ public:
 
   std::map<KeyP, TP> map;
 #endif
+
+  auto find(const KeyP &key) { return map.find(key); }
+  auto find(const KeyP &key) const { return map.find(key); }
+  TP &lookup(const KeyP &key) { return map[key]; }
+  void erase(const KeyP &key) { map.erase(key); }
+#endif
 };
 
 template <class Key, class T>
@@ -108,7 +171,7 @@ template <class Key, class T>
 Map<Key, T> &Map<Key, T>::insert(const Key &key, const T &value)
 {
   detach();
-  d->map[key] = value;
+  d->lookup(key) = value;
   return *this;
 }
 
@@ -130,19 +193,19 @@ template <class Key, class T>
 typename Map<Key, T>::Iterator Map<Key, T>::find(const Key &key)
 {
   detach();
-  return d->map.find(key);
+  return d->find(key);
 }
 
 template <class Key, class T>
 typename Map<Key,T>::ConstIterator Map<Key, T>::find(const Key &key) const
 {
-  return d->map.find(key);
+  return d->find(key);
 }
 
 template <class Key, class T>
 bool Map<Key, T>::contains(const Key &key) const
 {
-  return d->map.find(key) != d->map.end();
+  return d->find(key) != d->map.end();
 }
 
 template <class Key, class T>
@@ -156,7 +219,7 @@ template <class Key, class T>
 Map<Key, T> &Map<Key,T>::erase(const Key &key)
 {
   detach();
-  d->map.erase(key);
+  d->erase(key);
   return *this;
 }
 
@@ -169,21 +232,25 @@ unsigned int Map<Key, T>::size() const
 template <class Key, class T>
 T Map<Key, T>::value(const Key &key, const T &defaultValue) const
 {
-  auto it = d->map.find(key);
+  auto it = d->find(key);
   return it != d->map.end() ? it->second : defaultValue;
 }
 
 template <class Key, class T>
 const T &Map<Key, T>::operator[](const Key &key) const
 {
-  return d->map[key];
+  // Inserting here would change the entries shared with the copies of this
+  // map, and with contiguous containers move them.
+  static const T defaultValue {};
+  auto it = d->find(key);
+  return it != d->map.end() ? it->second : defaultValue;
 }
 
 template <class Key, class T>
 T &Map<Key, T>::operator[](const Key &key)
 {
   detach();
-  return d->map[key];
+  return d->lookup(key);
 }
 
 template <class Key, class T>
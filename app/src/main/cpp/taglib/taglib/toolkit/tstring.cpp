@@ -25,12 +25,17 @@
 
 #include "tstring.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <climits>
-#include <utf8.h>
+#include <cstring>
+#include <memory>
 
+#include "tarena.h"
 #include "tdebug.h"
 #include "tstringlist.h"
+#include "tunicode.h"
 #include "tutils.h"
 
 namespace
@@ -44,14 +49,21 @@ namespace
                                                            : String::UTF16BE;
   }
 
+  // Returns true if the Latin-1 or UTF-8 string only contains 7-bit characters.
+  bool isAsciiData(const char *s, size_t length)
+  {
+    return Unicode::asciiPrefixLength(s, length) == length;
+  }
+
   // Converts a Latin-1 string into UTF-16(without BOM/CPU byte order)
-  // and copies it to the internal buffer.
-  void copyFromLatin1(std::wstring &data, const char *s, size_t length)
+  // and appends it to the buffer.
+  void appendLatin1(std::wstring &data, const char *s, size_t length)
   {
-    data.resize(length);
+    const size_t offset = data.size();
+    data.resize(offset + length);
 
     for(size_t i = 0; i < length; ++i)
-      data[i] = static_cast<unsigned char>(s[i]);
+      data[offset + i] = static_cast<unsigned char>(s[i]);
   }
 
   // Converts a UTF-8 string into UTF-16(without BOM/CPU byte order)
@@ -60,15 +72,14 @@ namespace
   {
     data.resize(length);
 
-    try {
-      const std::wstring::iterator dstEnd = utf8::utf8to16(s, s + length, data.begin());
-      data.resize(dstEnd - data.begin());
-    }
-    catch(const utf8::exception &e) {
-      const String message(e.what());
-      debug("String::copyFromUTF8() - UTF8-CPP error: " + message);
+    const size_t size = Unicode::utf8ToUTF16(s, length, &data[0]);
+    if(size == Unicode::Invalid) {
+      debug("String::copyFromUTF8() - Invalid UTF-8 string.");
       data.clear();
+      return;
     }
+
+    data.resize(size);
   }
 
   // Helper functions to read a UTF-16 character from an array.
@@ -130,6 +141,180 @@ namespace
         data[i] = c;
     }
   }
+
+  // The numeric value of a Latin-1 byte or a UTF-16 code unit, so that both
+  // representations can be compared with each other.
+  unsigned int charValue(char c)
+  {
+    return static_cast<unsigned char>(c);
+  }
+
+  unsigned int charValue(wchar_t c)
+  {
+    return static_cast<unsigned int>(c);
+  }
+
+  bool charEqual(char c1, wchar_t c2)
+  {
+    return charValue(c1) == charValue(c2);
+  }
+
+  // Every Latin-1 character in UTF-16, so that the const operator[] can return
+  // a reference to a character of a compact string without widening it.
+  struct Latin1Table
+  {
+    constexpr Latin1Table() : chars()
+    {
+      for(unsigned int i = 0; i < 256; ++i)
+        chars[i] = static_cast<wchar_t>(i);
+    }
+
+    wchar_t chars[256];
+  };
+
+  constexpr Latin1Table latin1Table;
+
+  // std::basic_string::find() and rfind() for a compact and a UTF-16 string,
+  // comparing them character by character.
+  template <class Haystack, class Needle>
+  size_t findMixed(const Haystack &haystack, const Needle &needle, size_t offset)
+  {
+    if(offset > haystack.size() || needle.size() > haystack.size() - offset)
+      return std::string::npos;
+
+    const auto it = std::search(haystack.begin() + offset, haystack.end(),
+                                needle.begin(), needle.end(),
+                                [](auto c1, auto c2) { return charValue(c1) == charValue(c2); });
+    return it != haystack.end() || needle.empty()
+      ? static_cast<size_t>(it - haystack.begin()) : std::string::npos;
+  }
+
+  template <class Haystack, class Needle>
+  size_t rfindMixed(const Haystack &haystack, const Needle &needle, size_t offset)
+  {
+    if(needle.size() > haystack.size())
+      return std::string::npos;
+
+    const size_t last = std::min(offset, haystack.size() - needle.size());
+    const auto end = haystack.begin() + last + needle.size();
+    const auto it = std::find_end(haystack.begin(), end,
+                                  needle.begin(), needle.end(),
+                                  [](auto c1, auto c2) { return charValue(c1) == charValue(c2); });
+    return it != end || needle.empty()
+      ? static_cast<size_t>(it - haystack.begin()) : std::string::npos;
+  }
+
+  // Encodes Latin-1 or UTF-16 as UTF-8, see Unicode::utf16ToUTF8().
+  size_t toUTF8(const unsigned char *s, size_t length, char *out)
+  {
+    return Unicode::latin1ToUTF8(reinterpret_cast<const char *>(s), length, out);
+  }
+
+  size_t toUTF8(const wchar_t *s, size_t length, char *out)
+  {
+    return Unicode::utf16ToUTF8(s, length, out);
+  }
+
+  // Encodes the characters in [begin, end), either Latin-1 bytes or UTF-16
+  // code units, as \a t.
+  template <typename T>
+  ByteVector encode(const T *begin, const T *end, String::Type t)
+  {
+    const auto size = static_cast<unsigned int>(end - begin);
+
+    switch(t)
+    {
+    case String::Latin1:
+      {
+        ByteVector v(size, 0);
+        char *p = v.data();
+
+        for(const T *c = begin; c != end; ++c) {
+          *p++ = static_cast<char>(*c);
+        }
+
+        return v;
+      }
+    case String::UTF8:
+      {
+        ByteVector v(size * 3, 0);
+
+        const size_t length = toUTF8(begin, size, v.data());
+        if(length == Unicode::Invalid) {
+          debug("String::data() - Invalid UTF-16 string.");
+          v.clear();
+        }
+        else {
+          v.resize(static_cast<unsigned int>(length));
+        }
+
+        return v;
+      }
+    case String::UTF16:
+      {
+        ByteVector v(2 + size * 2, 0);
+        char *p = v.data();
+
+        // We use little-endian encoding here and need a BOM.
+
+        *p++ = '\xff';
+        *p++ = '\xfe';
+
+        for(const T *c = begin; c != end; ++c) {
+          *p++ = static_cast<char>(*c & 0xff);
+          *p++ = static_cast<char>(*c >> 8);
+        }
+
+        return v;
+      }
+    case String::UTF16BE:
+      {
+        ByteVector v(size * 2, 0);
+        char *p = v.data();
+
+        for(const T *c = begin; c != end; ++c) {
+          *p++ = static_cast<char>(*c >> 8);
+          *p++ = static_cast<char>(*c & 0xff);
+        }
+
+        return v;
+      }
+    case String::UTF16LE:
+      {
+        ByteVector v(size * 2, 0);
+        char *p = v.data();
+
+        for(const T *c = begin; c != end; ++c) {
+          *p++ = static_cast<char>(*c & 0xff);
+          *p++ = static_cast<char>(*c >> 8);
+        }
+
+        return v;
+      }
+    default:
+      {
+        debug("String::data() - Invalid Type value.");
+        return ByteVector();
+      }
+    }
+  }
+
+  // Returns the object stored in \a cache, which is created by \a create on
+  // first use.  If another thread was faster, its result is used and ours
+  // discarded.
+  template <typename T, typename F>
+  const T &cachedValue(std::atomic<T *> &cache, F create)
+  {
+    if(const T *value = cache.load(std::memory_order_acquire))
+      return *value;
+
+    auto value = std::make_unique<T>(create());
+    T *expected = nullptr;
+    if(cache.compare_exchange_strong(expected, value.get(), std::memory_order_acq_rel))
+      return *value.release();
+
+    return *expected;
+  }
 }  // namespace
 
 namespace TagLib {
@@ -137,15 +322,178 @@ namespace TagLib {
   class String::StringPrivate
   {
   public:
+    StringPrivate() = default;
+
+    ~StringPrivate()
+    {
+      clearCaches();
+    }
+
+    StringPrivate(const StringPrivate &) = delete;
+    StringPrivate &operator=(const StringPrivate &) = delete;
+
+    void clearCaches()
+    {
+      for(auto &s : cstring)
+        delete s.exchange(nullptr);
+      delete wide.exchange(nullptr);
+    }
+
+    void setLatin1(const char *s, size_t length)
+    {
+      latin1.assign(s, length);
+      ascii = isAsciiData(s, length);
+    }
+
+    void setUTF8(const char *s, size_t length)
+    {
+      // ASCII is the same in UTF-8 and Latin-1 and needs no decoding.
+      if(isAsciiData(s, length)) {
+        latin1.assign(s, length);
+        ascii = true;
+      }
+      else {
+        TagLib::wstring w;
+        copyFromUTF8(w, s, length);
+        setWide(std::move(w));
+      }
+    }
+
     /*!
-     * Stores string in UTF-16. The byte order depends on the CPU endian.
+     * Takes \a w as the content, which is stored in the compact form if it
+     * only contains Latin-1 characters.
      */
+    void setWide(TagLib::wstring &&w)
+    {
+      if(std::any_of(w.begin(), w.end(), [](wchar_t c) { return charValue(c) > 0xff; })) {
+        std::string().swap(latin1);
+        data = std::move(w);
+        compact = false;
+      }
+      else {
+        latin1.resize(w.size());
+        for(size_t i = 0; i < w.size(); ++i)
+          latin1[i] = static_cast<char>(w[i]);
+        ascii = isAsciiData(latin1.data(), latin1.size());
+        TagLib::wstring().swap(data);
+        compact = true;
+      }
+    }
+
+    // Drops everything after the first null character.
+    void truncateAtNull()
+    {
+      if(compact) {
+        const size_t length = ::strlen(latin1.c_str());
+        if(length < latin1.size()) {
+          latin1.resize(length);
+          ascii = isAsciiData(latin1.data(), length);
+        }
+      }
+      else {
+        TagLib::wstring w;
+        w.swap(data);
+        w.resize(::wcslen(w.c_str()));
+        setWide(std::move(w));
+      }
+    }
+
+    /*!
+     * Switches from the compact to the UTF-16 form, which is needed to hand
+     * out mutable iterators and references.  Requires exclusive ownership.
+     */
+    void promote()
+    {
+      if(!compact)
+        return;
+
+      appendLatin1(data, latin1.data(), latin1.size());
+      std::string().swap(latin1);
+      compact = false;
+    }
+
+    /*!
+     * Returns the content in UTF-16.  For compact strings it is created on
+     * first use and kept until the string is modified, so it is only used by
+     * toCWString() and the const iterators, which have to point into a
+     * wstring.
+     */
+    const TagLib::wstring &wideData()
+    {
+      if(!compact)
+        return data;
+
+      return cachedValue(wide, [this] {
+        TagLib::wstring w;
+        appendLatin1(w, latin1.data(), latin1.size());
+        return w;
+      });
+    }
+
+    size_t size() const
+    {
+      return compact ? latin1.size() : data.size();
+    }
+
+    void append(const char *s, size_t length)
+    {
+      if(compact) {
+        latin1.append(s, length);
+        ascii = ascii && isAsciiData(s, length);
+      }
+      else {
+        appendLatin1(data, s, length);
+      }
+    }
+
+    void append(wchar_t c)
+    {
+      if(compact && charValue(c) <= 0xff) {
+        latin1 += static_cast<char>(c);
+        ascii = ascii && charValue(c) < 0x80;
+      }
+      else {
+        promote();
+        data += c;
+      }
+    }
+
+    void append(const StringPrivate &s)
+    {
+      if(s.compact) {
+        append(s.latin1.data(), s.latin1.size());
+      }
+      else {
+        promote();
+        data += s.data;
+      }
+    }
+
+    /*!
+     * If all characters are Latin-1, they are stored one byte each in
+     * \a latin1 and \a compact is true.  Otherwise \a data stores the string
+     * in UTF-16.  The byte order depends on the CPU endian.
+     */
+    std::string latin1;
     TagLib::wstring data;
+    bool compact { true };
 
     /*!
-     * This is only used to hold the the most recent value of toCString().
+     * True if \a latin1 only contains 7-bit characters, so that it is valid
+     * UTF-8 as well.
      */
-    std::string cstring;
+    bool ascii { true };
+
+    /*!
+     * The values of toCString() which can not be served from \a latin1, Latin1
+     * at index 0 and UTF8 at index 1, and the UTF-16 form of compact strings.
+     * They are created on first use and shared by all implicit copies of the
+     * string, which may be used from different threads, so they are published
+     * atomically.  They are only dropped when the data is modified, which
+     * requires exclusive ownership.
+     */
+    std::atomic<std::string *> cstring[2] {};
+    std::atomic<TagLib::wstring *> wide { nullptr };
 };
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -153,19 +501,19 @@ namespace TagLib {
 ////////////////////////////////////////////////////////////////////////////////
 
 String::String() :
-  d(std::make_shared<StringPrivate>())
+  d(ParseArena::makeShared<StringPrivate>())
 {
 }
 
 String::String(const String &) = default;
 
 String::String(const std::string &s, Type t) :
-  d(std::make_shared<StringPrivate>())
+  d(ParseArena::makeShared<StringPrivate>())
 {
   if(t == Latin1)
-    copyFromLatin1(d->data, s.c_str(), s.length());
+    d->setLatin1(s.c_str(), s.length());
   else if(t == String::UTF8)
-    copyFromUTF8(d->data, s.c_str(), s.length());
+    d->setUTF8(s.c_str(), s.length());
   else {
     debug("String::String() -- std::string should not contain UTF16.");
   }
@@ -177,10 +525,12 @@ String::String(const wstring &s) :
 }
 
 String::String(const wstring &s, Type t) :
-  d(std::make_shared<StringPrivate>())
+  d(ParseArena::makeShared<StringPrivate>())
 {
   if(t == UTF16 || t == UTF16BE || t == UTF16LE) {
-    copyFromUTF16(d->data, s.c_str(), s.length(), t);
+    TagLib::wstring w;
+    copyFromUTF16(w, s.c_str(), s.length(), t);
+    d->setWide(std::move(w));
   }
   else {
     debug("String::String() -- TagLib::wstring should not contain Latin1 or UTF-8.");
@@ -193,10 +543,12 @@ String::String(const wchar_t *s) :
 }
 
 String::String(const wchar_t *s, Type t) :
-  d(std::make_shared<StringPrivate>())
+  d(ParseArena::makeShared<StringPrivate>())
 {
   if(t == UTF16 || t == UTF16BE || t == UTF16LE) {
-    copyFromUTF16(d->data, s, ::wcslen(s), t);
+    TagLib::wstring w;
+    copyFromUTF16(w, s, ::wcslen(s), t);
+    d->setWide(std::move(w));
   }
   else {
     debug("String::String() -- const wchar_t * should not contain Latin1 or UTF-8.");
@@ -204,54 +556,60 @@ String::String(const wchar_t *s, Type t) :
 }
 
 String::String(const char *s, Type t) :
-  d(std::make_shared<StringPrivate>())
+  d(ParseArena::makeShared<StringPrivate>())
 {
   if(t == Latin1)
-    copyFromLatin1(d->data, s, ::strlen(s));
+    d->setLatin1(s, ::strlen(s));
   else if(t == String::UTF8)
-    copyFromUTF8(d->data, s, ::strlen(s));
+    d->setUTF8(s, ::strlen(s));
   else {
     debug("String::String() -- const char * should not contain UTF16.");
   }
 }
 
 String::String(wchar_t c, Type t) :
-  d(std::make_shared<StringPrivate>())
+  d(ParseArena::makeShared<StringPrivate>())
 {
-  if(t == UTF16 || t == UTF16BE || t == UTF16LE)
-    copyFromUTF16(d->data, &c, 1, t);
+  if(t == UTF16 || t == UTF16BE || t == UTF16LE) {
+    TagLib::wstring w;
+    copyFromUTF16(w, &c, 1, t);
+    d->setWide(std::move(w));
+  }
   else {
     debug("String::String() -- wchar_t should not contain Latin1 or UTF-8.");
   }
 }
 
 String::String(char c, Type t) :
-  d(std::make_shared<StringPrivate>())
+  d(ParseArena::makeShared<StringPrivate>())
 {
   if(t == Latin1)
-    copyFromLatin1(d->data, &c, 1);
+    d->setLatin1(&c, 1);
   else if(t == String::UTF8)
-    copyFromUTF8(d->data, &c, 1);
+    d->setUTF8(&c, 1);
   else {
     debug("String::String() -- char should not contain UTF16.");
   }
 }
 
 String::String(const ByteVector &v, Type t) :
-  d(std::make_shared<StringPrivate>())
+  d(ParseArena::makeShared<StringPrivate>())
 {
   if(v.isEmpty())
     return;
 
   if(t == Latin1)
-    copyFromLatin1(d->data, v.data(), v.size());
+    d->setLatin1(v.data(), v.size());
   else if(t == UTF8)
-    copyFromUTF8(d->data, v.data(), v.size());
-  else
-    copyFromUTF16(d->data, v.data(), v.size() / 2, t);
+    d->setUTF8(v.data(), v.size());
+  else {
+    TagLib::wstring w;
+    copyFromUTF16(w, v.data(), v.size() / 2, t);
+    d->setWide(std::move(w));
+  }
 
   // If we hit a null in the ByteVector, shrink the string again.
-  d->data.resize(::wcslen(d->data.c_str()));
+  d->truncateAtNull();
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -260,66 +618,110 @@ String::~String() = default;
 
 std::string String::to8Bit(bool unicode) const
 {
-  const ByteVector v = data(unicode ? UTF8 : Latin1);
+  if(d->compact && (!unicode || d->ascii))
+    return d->latin1;
+
+  if(unicode) {
+    // Encode directly into the result, not via data().
+    std::string s(d->size() * 3, '\0');
+    const size_t length = d->compact
+      ? Unicode::latin1ToUTF8(d->latin1.data(), d->latin1.size(), &s[0])
+      : Unicode::utf16ToUTF8(d->data.data(), d->data.size(), &s[0]);
+    if(length == Unicode::Invalid) {
+      debug("String::to8Bit() - Invalid UTF-16 string.");
+      return std::string();
+    }
+
+    s.resize(length);
+    return s;
+  }
+
+  const ByteVector v = data(Latin1);
   return std::string(v.data(), v.size());
 }
 
 TagLib::wstring String::toWString() const
 {
+  if(d->compact) {
+    TagLib::wstring w;
+    appendLatin1(w, d->latin1.data(), d->latin1.size());
+    return w;
+  }
+
   return d->data;
 }
 
 const char *String::toCString(bool unicode) const
 {
-  d->cstring = to8Bit(unicode);
-  return d->cstring.c_str();
+  if(d->compact && (!unicode || d->ascii))
+    return d->latin1.c_str();
+
+  return cachedValue(d->cstring[unicode ? 1 : 0], [this, unicode] {
+    return to8Bit(unicode);
+  }).c_str();
 }
 
 const wchar_t *String::toCWString() const
 {
-  return d->data.c_str();
+  return d->wideData().c_str();
 }
 
 String::Iterator String::begin()
 {
   detach();
+  d->promote();
   return d->data.begin();
 }
 
 String::ConstIterator String::begin() const
 {
-  return d->data.begin();
+  return d->wideData().begin();
 }
 
 String::ConstIterator String::cbegin() const
 {
-  return d->data.cbegin();
+  return d->wideData().cbegin();
 }
 
 String::Iterator String::end()
 {
   detach();
+  d->promote();
   return d->data.end();
 }
 
 String::ConstIterator String::end() const
 {
-  return d->data.end();
+  return d->wideData().end();
 }
 
 String::ConstIterator String::cend() const
 {
-  return d->data.cend();
+  return d->wideData().cend();
 }
 
 int String::find(const String &s, int offset) const
 {
-  return static_cast<int>(d->data.find(s.d->data, offset));
+  if(d->compact && s.d->compact)
+    return static_cast<int>(d->latin1.find(s.d->latin1, offset));
+  if(!d->compact && !s.d->compact)
+    return static_cast<int>(d->data.find(s.d->data, offset));
+
+  if(d->compact)
+    return static_cast<int>(findMixed(d->latin1, s.d->data, offset));
+  return static_cast<int>(findMixed(d->data, s.d->latin1, offset));
 }
 
 int String::rfind(const String &s, int offset) const
 {
-  return static_cast<int>(d->data.rfind(s.d->data, offset));
+  if(d->compact && s.d->compact)
+    return static_cast<int>(d->latin1.rfind(s.d->latin1, offset));
+  if(!d->compact && !s.d->compact)
+    return static_cast<int>(d->data.rfind(s.d->data, offset));
+
+  if(d->compact)
+    return static_cast<int>(rfindMixed(d->latin1, s.d->data, offset));
+  return static_cast<int>(rfindMixed(d->data, s.d->latin1, offset));
 }
 
 StringList String::split(const String &separator) const
@@ -349,13 +751,21 @@ String String::substr(unsigned int position, unsigned int n) const
 {
   if(position == 0 && n >= size())
     return *this;
+
+  if(d->compact) {
+    String s;
+    s.d->latin1 = d->latin1.substr(position, n);
+    s.d->ascii = d->ascii || isAsciiData(s.d->latin1.data(), s.d->latin1.size());
+    return s;
+  }
+
   return String(d->data.substr(position, n));
 }
 
 String &String::append(const String &s)
 {
   detach();
-  d->data += s.d->data;
+  d->append(*s.d);
   return *this;
 }
 
@@ -368,21 +778,38 @@ String & String::clear()
 String String::upper() const
 {
   String s;
-  s.d->data.reserve(size());
 
-  for(wchar_t c : *this) {
+  if(d->compact) {
+    s.d->latin1.reserve(size());
+
+    for(char c : d->latin1) {
+      if(c >= 'a' && c <= 'z')
+        s.d->latin1.push_back(c + 'A' - 'a');
+      else
+        s.d->latin1.push_back(c);
+    }
+
+    s.d->ascii = d->ascii;
+    return s;
+  }
+
+  TagLib::wstring w;
+  w.reserve(size());
+
+  for(wchar_t c : d->data) {
     if(c >= 'a' && c <= 'z')
-      s.d->data.push_back(c + 'A' - 'a');
+      w.push_back(c + 'A' - 'a');
     else
-      s.d->data.push_back(c);
+      w.push_back(c);
   }
 
+  s.d->setWide(std::move(w));
   return s;
 }
 
 unsigned int String::size() const
 {
-  return static_cast<unsigned int>(d->data.size());
+  return static_cast<unsigned int>(d->size());
 }
 
 unsigned int String::length() const
@@ -392,99 +819,45 @@ unsigned int String::length() const
 
 bool String::isEmpty() const
 {
-  return d->data.empty();
+  return d->size() == 0;
 }
 
 ByteVector String::data(Type t) const
 {
-  switch(t)
-  {
-  case Latin1:
-    {
-      ByteVector v(size(), 0);
-      char *p = v.data();
+  if(d->compact) {
+    // Latin-1, and ASCII in UTF-8, are stored as they are.
+    if(t == Latin1 || (t == UTF8 && d->ascii))
+      return ByteVector(d->latin1.data(), size());
 
-      for(wchar_t c : *this) {
-        *p++ = static_cast<char>(c);
-      }
-
-      return v;
-    }
-  case UTF8:
-    {
-      ByteVector v(size() * 4, 0);
-
-      try {
-        const auto dstEnd = utf8::utf16to8(begin(), end(), v.begin());
-        v.resize(static_cast<unsigned int>(dstEnd - v.begin()));
-      }
-      catch(const utf8::exception &e) {
-        const String message(e.what());
-        debug("String::data() - UTF8-CPP error: " + message);
-        v.clear();
-      }
-
-      return v;
-    }
-  case UTF16:
-    {
-      ByteVector v(2 + size() * 2, 0);
-      char *p = v.data();
-
-      // We use little-endian encoding here and need a BOM.
-
-      *p++ = '\xff';
-      *p++ = '\xfe';
-
-      for(wchar_t c : *this) {
-        *p++ = static_cast<char>(c & 0xff);
-        *p++ = static_cast<char>(c >> 8);
-      }
-
-      return v;
-    }
-  case UTF16BE:
-    {
-      ByteVector v(size() * 2, 0);
-      char *p = v.data();
-
-      for(wchar_t c : *this) {
-        *p++ = static_cast<char>(c >> 8);
-        *p++ = static_cast<char>(c & 0xff);
-      }
-
-      return v;
-    }
-  case UTF16LE:
-    {
-      ByteVector v(size() * 2, 0);
-      char *p = v.data();
-
-      for(wchar_t c : *this) {
-        *p++ = static_cast<char>(c & 0xff);
-        *p++ = static_cast<char>(c >> 8);
-      }
-
-      return v;
-    }
-  default:
-    {
-      debug("String::data() - Invalid Type value.");
-      return ByteVector();
-    }
+    const auto p = reinterpret_cast<const unsigned char *>(d->latin1.data());
+    return encode(p, p + d->latin1.size(), t);
   }
+
+  return encode(d->data.data(), d->data.data() + d->data.size(), t);
 }
 
 int String::toInt(bool *ok) const
 {
-  const wchar_t *beginPtr = d->data.c_str();
-  wchar_t *endPtr;
+  long value;
+  bool consumed;
   errno = 0;
-  const long value = ::wcstol(beginPtr, &endPtr, 10);
 
-  // Has wcstol() consumed the entire string and not overflowed?
+  if(d->compact) {
+    const char *beginPtr = d->latin1.c_str();
+    char *endPtr;
+    value = ::strtol(beginPtr, &endPtr, 10);
+    consumed = endPtr > beginPtr && *endPtr == '\0';
+  }
+  else {
+    const wchar_t *beginPtr = d->data.c_str();
+    wchar_t *endPtr;
+    value = ::wcstol(beginPtr, &endPtr, 10);
+    consumed = endPtr > beginPtr && *endPtr == L'\0';
+  }
+
+  // Has strtol() consumed the entire string and not overflowed?
   if(ok) {
-    *ok = (errno == 0 && endPtr > beginPtr && *endPtr == L'\0');
+    *ok = (errno == 0 && consumed);
     *ok = (*ok && value > INT_MIN && value < INT_MAX);
   }
 
@@ -493,24 +866,40 @@ int String::toInt(bool *ok) const
 
 String String::stripWhiteSpace() const
 {
-  static const wchar_t *WhiteSpaceChars = L"\t\n\f\r ";
+  static const char *WhiteSpaceChars = "\t\n\f\r ";
+  static const wchar_t *WideWhiteSpaceChars = L"\t\n\f\r ";
 
-  const size_t pos1 = d->data.find_first_not_of(WhiteSpaceChars);
-  if(pos1 == std::wstring::npos)
+  size_t pos1;
+  size_t pos2;
+  if(d->compact) {
+    pos1 = d->latin1.find_first_not_of(WhiteSpaceChars);
+    pos2 = d->latin1.find_last_not_of(WhiteSpaceChars);
+  }
+  else {
+    pos1 = d->data.find_first_not_of(WideWhiteSpaceChars);
+    pos2 = d->data.find_last_not_of(WideWhiteSpaceChars);
+  }
+
+  if(pos1 == std::string::npos)
     return String();
 
-  const size_t pos2 = d->data.find_last_not_of(WhiteSpaceChars);
   return substr(static_cast<unsigned int>(pos1), static_cast<unsigned int>(pos2 - pos1 + 1));
 }
 
 bool String::isLatin1() const
 {
-  return std::none_of(this->begin(), this->end(), [](auto c) { return c >= 256; });
+  if(d->compact)
+    return true;
+
+  return std::none_of(d->data.begin(), d->data.end(), [](auto c) { return c >= 256; });
 }
 
 bool String::isAscii() const
 {
-  return std::none_of(this->begin(), this->end(), [](auto c) { return c >= 128; });
+  if(d->compact)
+    return d->ascii;
+
+  return std::none_of(d->data.begin(), d->data.end(), [](auto c) { return c >= 128; });
 }
 
 String String::number(int n) // static
@@ -526,17 +915,33 @@ String String::fromLongLong(long long n) // static
 wchar_t &String::operator[](int i)
 {
   detach();
+  d->promote();
   return d->data[i];
 }
 
 const wchar_t &String::operator[](int i) const
 {
+  if(d->compact)
+    return latin1Table.chars[static_cast<unsigned char>(d->latin1[i])];
+
   return d->data[i];
 }
 
 bool String::operator==(const String &s) const
 {
-  return (d == s.d || d->data == s.d->data);
+  if(d == s.d)
+    return true;
+
+  if(d->compact && s.d->compact)
+    return d->latin1 == s.d->latin1;
+
+  if(!d->compact && !s.d->compact)
+    return d->data == s.d->data;
+
+  const StringPrivate &narrow = d->compact ? *d : *s.d;
+  const StringPrivate &wide = d->compact ? *s.d : *d;
+  return std::equal(narrow.latin1.begin(), narrow.latin1.end(),
+                    wide.data.begin(), wide.data.end(), charEqual);
 }
 
 bool String::operator!=(const String &s) const
@@ -546,7 +951,10 @@ bool String::operator!=(const String &s) const
 
 bool String::operator==(const char *s) const
 {
-  const wchar_t *p = toCWString();
+  if(d->compact)
+    return ::strcmp(d->latin1.c_str(), s) == 0;
+
+  const wchar_t *p = d->data.c_str();
 
   while(*p != L'\0' || *s != '\0') {
     if(*p++ != static_cast<unsigned char>(*s++))
@@ -562,6 +970,11 @@ bool String::operator!=(const char *s) const
 
 bool String::operator==(const wchar_t *s) const
 {
+  if(d->compact) {
+    return std::equal(d->latin1.begin(), d->latin1.end(),
+                      s, s + ::wcslen(s), charEqual);
+  }
+
   return (d->data == s);
 }
 
@@ -574,7 +987,7 @@ String &String::operator+=(const String &s)
 {
   detach();
 
-  d->data += s.d->data;
+  d->append(*s.d);
   return *this;
 }
 
@@ -582,7 +995,8 @@ String &String::operator+=(const wchar_t *s)
 {
   detach();
 
-  d->data += s;
+  for(int i = 0; s[i] != 0; i++)
+    d->append(s[i]);
   return *this;
 }
 
@@ -590,8 +1004,7 @@ String &String::operator+=(const char *s)
 {
   detach();
 
-  for(int i = 0; s[i] != 0; i++)
-    d->data += static_cast<unsigned char>(s[i]);
+  d->append(s, ::strlen(s));
   return *this;
 }
 
@@ -599,7 +1012,7 @@ String &String::operator+=(wchar_t c)
 {
   detach();
 
-  d->data += c;
+  d->append(c);
   return *this;
 }
 
@@ -607,7 +1020,7 @@ String &String::operator+=(char c)
 {
   detach();
 
-  d->data += static_cast<unsigned char>(c);
+  d->append(&c, 1);
   return *this;
 }
 
@@ -664,7 +1077,19 @@ void String::swap(String &s) noexcept
 
 bool String::operator<(const String &s) const
 {
-  return (d->data < s.d->data);
+  if(d->compact && s.d->compact)
+    return d->latin1 < s.d->latin1;
+
+  if(!d->compact && !s.d->compact)
+    return d->data < s.d->data;
+
+  const auto less = [](auto c1, auto c2) { return charValue(c1) < charValue(c2); };
+  if(d->compact) {
+    return std::lexicographical_compare(d->latin1.begin(), d->latin1.end(),
+                                        s.d->data.begin(), s.d->data.end(), less);
+  }
+  return std::lexicographical_compare(d->data.begin(), d->data.end(),
+                                      s.d->latin1.begin(), s.d->latin1.end(), less);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -673,8 +1098,15 @@ bool String::operator<(const String &s) const
 
 void String::detach()
 {
-  if(d.use_count() > 1)
-    String(d->data.c_str()).swap(*this);
+  if(d.use_count() > 1) {
+    if(d->compact)
+      String(d->latin1.c_str()).swap(*this);
+    else
+      String(d->data.c_str()).swap(*this);
+  }
+  else {
+    d->clearCaches();
+  }
 }
 
 }  // namespace TagLib
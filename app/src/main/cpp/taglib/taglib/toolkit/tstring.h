@@ -67,10 +67,13 @@ namespace TagLib {
   //! A \e wide string class suitable for unicode.
 
   /*!
-   * This is an implicitly shared \e wide string.  For storage it uses
-   * TagLib::wstring, but as this is an <i>implementation detail</i> this of
-   * course could change.  Strings are stored internally as UTF-16(without BOM/
-   * CPU byte order)
+   * This is an implicitly shared \e wide string.  Strings which only contain
+   * Latin1 characters, which is the case for most tags, are stored with one
+   * byte per character.  All others are stored as UTF-16(without BOM/CPU byte
+   * order) in a TagLib::wstring.  The Latin1 form is switched to UTF-16 when
+   * a non-Latin1 character is added or a mutable iterator or reference is
+   * requested.  As this is an <i>implementation detail</i> this of course
+   * could change.
    *
    * The use of implicit sharing means that copying a string is cheap, the only
    * \e cost comes into play when the copy is modified.  Prior to that the string
@@ -215,12 +218,15 @@ namespace TagLib {
      * by the user.
      *
      * The returned pointer remains valid until this String instance is destroyed
-     * or toCString() is called again.
+     * or modified.  It may be called concurrently on copies of the same String
+     * from different threads.
      *
      * \warning This however has the side effect that the returned string will remain
      * in memory <b>in addition to</b> other memory that is consumed by this
      * String instance.  So, this method should not be used on large strings or
      * where memory is critical.  Consider using to8Bit() instead to avoid it.
+     * This does not apply to Latin1 strings if \a unicode is false and to ASCII
+     * strings, for which the internal data is returned.
      *
      * \see to8Bit()
      */
@@ -238,7 +244,8 @@ namespace TagLib {
      * or any other method of this String is called.
      *
      * \note This returns a pointer to the String's internal data without any
-     * conversions.
+     * conversions, unless the string is stored as Latin1.  Then a UTF-16 copy
+     * is created and kept in addition to it.
      *
      * \see toWString()
      */
@@ -251,11 +258,17 @@ namespace TagLib {
 
     /*!
      * Returns a const iterator pointing to the beginning of the string.
+     *
+     * \note If the string is stored as Latin1, this creates a UTF-16 copy which
+     * is kept in addition to it until the string is modified.
      */
     ConstIterator begin() const;
 
     /*!
      * Returns a const iterator pointing to the beginning of the string.
+     *
+     * \note If the string is stored as Latin1, this creates a UTF-16 copy which
+     * is kept in addition to it until the string is modified.
      */
     ConstIterator cbegin() const;
 
@@ -268,12 +281,18 @@ namespace TagLib {
     /*!
      * Returns a const iterator pointing to the end of the string (the position
      * after the last character).
+     *
+     * \note If the string is stored as Latin1, this creates a UTF-16 copy which
+     * is kept in addition to it until the string is modified.
      */
     ConstIterator end() const;
 
     /*!
      * Returns a const iterator pointing to the end of the string (the position
      * after the last character).
+     *
+     * \note If the string is stored as Latin1, this creates a UTF-16 copy which
+     * is kept in addition to it until the string is modified.
      */
     ConstIterator cend() const;
 
@@ -392,6 +411,9 @@ namespace TagLib {
 
     /*!
      * Returns a const reference to the character at position \a i.
+     *
+     * \note If the string is stored as Latin1, the reference does not point
+     * into the string, so it can not be used to reach the other characters.
      */
     const wchar_t &operator[](int i) const;
 
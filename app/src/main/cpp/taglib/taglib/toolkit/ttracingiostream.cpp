@@ -0,0 +1,227 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "ttracingiostream.h"
+
+#include <chrono>
+
+#include "tstring.h"
+
+using namespace TagLib;
+
+namespace
+{
+  using Clock = std::chrono::steady_clock;
+
+  long long elapsed(const Clock::time_point &start)
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+  }
+} // namespace
+
+class TracingIOStream::TracingIOStreamPrivate
+{
+public:
+  TracingIOStreamPrivate(IOStream *stream, bool recordEvents) :
+    stream(stream),
+    recordEvents(recordEvents)
+  {
+  }
+
+  void record(Operation operation, offset_t offset, offset_t length, long long nanoseconds)
+  {
+    summary.nanoseconds += nanoseconds;
+    if(recordEvents)
+      events.append({ operation, offset, length, nanoseconds });
+  }
+
+  // The stream length is needed to classify reads as head or tail reads.  It
+  // is cached, so that tracing does not add calls to the wrapped stream.
+  offset_t streamLength()
+  {
+    if(cachedLength < 0)
+      cachedLength = stream->length();
+    return cachedLength;
+  }
+
+  IOStream *stream;
+  const bool recordEvents;
+  List<Event> events;
+  Summary summary;
+  offset_t cachedLength { -1 };
+};
+
+String TracingIOStream::Summary::toString() const
+{
+  return "{\"seeks\":" + String::number(seekCount)
+    + ",\"reads\":" + String::number(readCount)
+    + ",\"writes\":" + String::number(writeCount)
+    + ",\"inserts\":" + String::number(insertCount)
+    + ",\"removes\":" + String::number(removeCount)
+    + ",\"truncates\":" + String::number(truncateCount)
+    + ",\"bytesRead\":" + String::fromLongLong(bytesRead)
+    + ",\"bytesWritten\":" + String::fromLongLong(bytesWritten)
+    + ",\"seekDistance\":" + String::fromLongLong(seekDistance)
+    + ",\"headReads\":" + String::number(headReads)
+    + ",\"tailReads\":" + String::number(tailReads)
+    + ",\"nanoseconds\":" + String::fromLongLong(nanoseconds) + "}";
+}
+
+////////////////////////////////////////////////////////////////////////////////
+// public members
+////////////////////////////////////////////////////////////////////////////////
+
+TracingIOStream::TracingIOStream(IOStream *stream, bool recordEvents) :
+  d(std::make_unique<TracingIOStreamPrivate>(stream, recordEvents))
+{
+}
+
+TracingIOStream::~TracingIOStream() = default;
+
+IOStream *TracingIOStream::stream() const
+{
+  return d->stream;
+}
+
+const List<TracingIOStream::Event> &TracingIOStream::events() const
+{
+  return d->events;
+}
+
+TracingIOStream::Summary TracingIOStream::summary() const
+{
+  return d->summary;
+}
+
+void TracingIOStream::reset()
+{
+  d->events.clear();
+  d->summary = Summary();
+}
+
+FileName TracingIOStream::name() const
+{
+  return d->stream->name();
+}
+
+ByteVector TracingIOStream::readBlock(size_t length)
+{
+  const offset_t offset = d->stream->tell();
+  const auto start = Clock::now();
+  ByteVector data = d->stream->readBlock(length);
+  const long long ns = elapsed(start);
+
+  d->summary.readCount++;
+  d->summary.bytesRead += data.size();
+  if(offset < d->streamLength() / 2)
+    d->summary.headReads++;
+  else
+    d->summary.tailReads++;
+
+  d->record(Read, offset, data.size(), ns);
+  return data;
+}
+
+void TracingIOStream::writeBlock(const ByteVector &data)
+{
+  const offset_t offset = d->stream->tell();
+  const auto start = Clock::now();
+  d->stream->writeBlock(data);
+  const long long ns = elapsed(start);
+
+  d->cachedLength = -1;
+  d->summary.writeCount++;
+  d->summary.bytesWritten += data.size();
+  d->record(Write, offset, data.size(), ns);
+}
+
+void TracingIOStream::insert(const ByteVector &data, offset_t start, size_t replace)
+{
+  const auto begin = Clock::now();
+  d->stream->insert(data, start, replace);
+  const long long ns = elapsed(begin);
+
+  d->cachedLength = -1;
+  d->summary.insertCount++;
+  d->summary.bytesWritten += data.size();
+  d->record(Insert, start, data.size(), ns);
+}
+
+void TracingIOStream::removeBlock(offset_t start, size_t length)
+{
+  const auto begin = Clock::now();
+  d->stream->removeBlock(start, length);
+  const long long ns = elapsed(begin);
+
+  d->cachedLength = -1;
+  d->summary.removeCount++;
+  d->record(Remove, start, static_cast<offset_t>(length), ns);
+}
+
+bool TracingIOStream::readOnly() const
+{
+  return d->stream->readOnly();
+}
+
+bool TracingIOStream::isOpen() const
+{
+  return d->stream->isOpen();
+}
+
+void TracingIOStream::seek(offset_t offset, Position p)
+{
+  const offset_t before = d->stream->tell();
+  const auto start = Clock::now();
+  d->stream->seek(offset, p);
+  const long long ns = elapsed(start);
+  const offset_t after = d->stream->tell();
+
+  const offset_t distance = after > before ? after - before : before - after;
+  d->summary.seekCount++;
+  d->summary.seekDistance += distance;
+  d->record(Seek, after, distance, ns);
+}
+
+void TracingIOStream::clear()
+{
+  d->stream->clear();
+}
+
+offset_t TracingIOStream::tell() const
+{
+  return d->stream->tell();
+}
+
+offset_t TracingIOStream::length()
+{
+  d->cachedLength = d->stream->length();
+  return d->cachedLength;
+}
+
+void TracingIOStream::truncate(offset_t length)
+{
+  const auto start = Clock::now();
+  d->stream->truncate(length);
+  const long long ns = elapsed(start);
+
+  d->cachedLength = -1;
+  d->summary.truncateCount++;
+  d->record(Truncate, length, 0, ns);
+}
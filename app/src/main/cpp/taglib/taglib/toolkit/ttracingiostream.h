@@ -0,0 +1,165 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_TRACINGIOSTREAM_H
+#define TAGLIB_TRACINGIOSTREAM_H
+
+#include "tlist.h"
+#include "tiostream.h"
+#include "taglib_export.h"
+#include "taglib.h"
+
+namespace TagLib {
+
+  class String;
+
+  //! An IOStream decorator which records every operation on another stream
+
+  /*!
+   * This wraps an existing IOStream, such as a FileStream or a
+   * ByteVectorStream, and forwards all calls to it.  Every seek, read, write,
+   * insert, remove and truncate is recorded together with its offset, length
+   * and duration, so that the access pattern of a parser can be inspected.
+   *
+   * \code
+   * FileStream file("song.mp3", true);
+   * TracingIOStream stream(&file);
+   * FileRef f(&stream);
+   * std::cout << stream.summary().toString() << std::endl;
+   * \endcode
+   *
+   * The wrapped stream is not owned and has to outlive this object.
+   */
+  class TAGLIB_EXPORT TracingIOStream : public IOStream
+  {
+  public:
+    /*!
+     * The kind of a recorded operation.
+     */
+    enum Operation {
+      Seek,
+      Read,
+      Write,
+      Insert,
+      Remove,
+      Truncate
+    };
+
+    /*!
+     * A single recorded operation.  For seeks \a offset is the target position
+     * and \a length the distance moved, for reads and writes it is the position
+     * and the number of bytes actually transferred.
+     */
+    struct Event {
+      Operation operation;
+      offset_t offset;
+      offset_t length;
+      long long nanoseconds;
+    };
+
+    /*!
+     * Aggregated statistics of all operations since construction or the last
+     * call to reset().
+     */
+    struct Summary {
+      unsigned int seekCount { 0 };
+      unsigned int readCount { 0 };
+      unsigned int writeCount { 0 };
+      unsigned int insertCount { 0 };
+      unsigned int removeCount { 0 };
+      unsigned int truncateCount { 0 };
+
+      offset_t bytesRead { 0 };
+      offset_t bytesWritten { 0 };
+
+      //! The sum of the absolute distances of all position changes.
+      offset_t seekDistance { 0 };
+
+      //! Reads starting in the first half of the stream.
+      unsigned int headReads { 0 };
+      //! Reads starting in the second half of the stream.
+      unsigned int tailReads { 0 };
+
+      long long nanoseconds { 0 };
+
+      /*!
+       * Returns the summary as a single line JSON object.
+       */
+      String toString() const;
+    };
+
+    /*!
+     * Constructs a TracingIOStream which forwards to \a stream.  If
+     * \a recordEvents is false only the summary is maintained.
+     */
+    TracingIOStream(IOStream *stream, bool recordEvents = true);
+
+    /*!
+     * Destroys this TracingIOStream instance.  The wrapped stream is left
+     * untouched.
+     */
+    ~TracingIOStream() override;
+
+    TracingIOStream(const TracingIOStream &) = delete;
+    TracingIOStream &operator=(const TracingIOStream &) = delete;
+
+    /*!
+     * Returns the wrapped stream.
+     */
+    IOStream *stream() const;
+
+    /*!
+     * Returns all recorded operations in the order in which they happened.
+     * This is empty if the stream was created without \a recordEvents.
+     */
+    const List<Event> &events() const;
+
+    /*!
+     * Returns the statistics of all operations.
+     */
+    Summary summary() const;
+
+    /*!
+     * Clears the recorded operations and the summary.
+     */
+    void reset();
+
+    FileName name() const override;
+    ByteVector readBlock(size_t length) override;
+    void writeBlock(const ByteVector &data) override;
+    void insert(const ByteVector &data, offset_t start = 0, size_t replace = 0) override;
+    void removeBlock(offset_t start = 0, size_t length = 0) override;
+    bool readOnly() const override;
+    bool isOpen() const override;
+    void seek(offset_t offset, Position p = Beginning) override;
+    void clear() override;
+    offset_t tell() const override;
+    offset_t length() override;
+    void truncate(offset_t length) override;
+
+  private:
+    class TracingIOStreamPrivate;
+    TAGLIB_MSVC_SUPPRESS_WARNING_NEEDS_TO_HAVE_DLL_INTERFACE
+    std::unique_ptr<TracingIOStreamPrivate> d;
+  };
+
+}  // namespace TagLib
+
+#endif
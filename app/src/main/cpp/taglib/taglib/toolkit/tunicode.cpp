@@ -0,0 +1,217 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tunicode.h"
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# include <emmintrin.h>
+# define TAGLIB_UNICODE_SSE2
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+# include <arm_neon.h>
+# define TAGLIB_UNICODE_NEON
+#endif
+
+using namespace TagLib;
+
+namespace
+{
+  bool isContinuation(unsigned char c)
+  {
+    return (c & 0xc0) == 0x80;
+  }
+
+  // UTF-16 code units are masked to 16 bits, wchar_t may be wider.
+  unsigned int codeUnit(wchar_t c)
+  {
+    return static_cast<unsigned int>(c) & 0xffff;
+  }
+
+  unsigned int codeUnit(unsigned char c)
+  {
+    return c;
+  }
+
+  template <typename T>
+  size_t encodeUTF8(const T *s, size_t length, char *out)
+  {
+    size_t n = 0;
+    size_t i = 0;
+
+    while(i < length) {
+      // Copy runs of ASCII eight characters at a time.
+      while(i + 8 <= length) {
+        unsigned int bits = 0;
+        for(size_t k = 0; k < 8; ++k)
+          bits |= codeUnit(s[i + k]);
+        if(bits >= 0x80)
+          break;
+        for(size_t k = 0; k < 8; ++k)
+          out[n + k] = static_cast<char>(s[i + k]);
+        i += 8;
+        n += 8;
+      }
+      if(i == length)
+        break;
+
+      unsigned int c = codeUnit(s[i++]);
+      if(c < 0x80) {
+        out[n++] = static_cast<char>(c);
+      }
+      else if(c < 0x800) {
+        out[n++] = static_cast<char>(0xc0 | (c >> 6));
+        out[n++] = static_cast<char>(0x80 | (c & 0x3f));
+      }
+      else if(c < 0xd800 || c > 0xdfff) {
+        out[n++] = static_cast<char>(0xe0 | (c >> 12));
+        out[n++] = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        out[n++] = static_cast<char>(0x80 | (c & 0x3f));
+      }
+      else {
+        // A surrogate pair, which takes four bytes for two code units.
+        if(c > 0xdbff || i == length)
+          return Unicode::Invalid;
+        const unsigned int trail = codeUnit(s[i++]);
+        if(trail < 0xdc00 || trail > 0xdfff)
+          return Unicode::Invalid;
+        c = 0x10000 + ((c - 0xd800) << 10) + (trail - 0xdc00);
+        out[n++] = static_cast<char>(0xf0 | (c >> 18));
+        out[n++] = static_cast<char>(0x80 | ((c >> 12) & 0x3f));
+        out[n++] = static_cast<char>(0x80 | ((c >> 6) & 0x3f));
+        out[n++] = static_cast<char>(0x80 | (c & 0x3f));
+      }
+    }
+
+    return n;
+  }
+}  // namespace
+
+size_t Unicode::asciiPrefixLength(const char *s, size_t length)
+{
+  size_t i = 0;
+
+  // A block with a non-ASCII byte is left to the loops below, which find the
+  // exact position.
+
+#if defined(TAGLIB_UNICODE_SSE2)
+  for(; i + 16 <= length; i += 16) {
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+    if(_mm_movemask_epi8(v) != 0)
+      break;
+  }
+#elif defined(TAGLIB_UNICODE_NEON)
+  for(; i + 16 <= length; i += 16) {
+    const uint8x16_t v = vld1q_u8(reinterpret_cast<const uint8_t *>(s + i));
+    if(vmaxvq_u8(v) >= 0x80)
+      break;
+  }
+#endif
+
+  for(; i + 8 <= length; i += 8) {
+    uint64_t word;
+    ::memcpy(&word, s + i, sizeof(word));
+    if(word & 0x8080808080808080ULL)
+      break;
+  }
+
+  while(i < length && (s[i] & 0x80) == 0)
+    ++i;
+
+  return i;
+}
+
+size_t Unicode::utf8ToUTF16(const char *s, size_t length, wchar_t *out)
+{
+  const auto p = reinterpret_cast<const unsigned char *>(s);
+
+  // Tag values usually start with a long ASCII run, later runs between
+  // multibyte characters are short and copied one by one.
+  size_t i = asciiPrefixLength(s, length);
+  for(size_t k = 0; k < i; ++k)
+    out[k] = p[k];
+  size_t n = i;
+
+  while(i < length) {
+    if(p[i] < 0x80) {
+      out[n++] = p[i++];
+      continue;
+    }
+
+    const unsigned int c = p[i];
+    unsigned int cp;
+
+    if(c < 0xc2) {
+      // A continuation byte or an overlong two byte sequence.
+      return Invalid;
+    }
+    if(c < 0xe0) {
+      if(i + 1 >= length || !isContinuation(p[i + 1]))
+        return Invalid;
+      cp = ((c & 0x1f) << 6) | (p[i + 1] & 0x3f);
+      i += 2;
+    }
+    else if(c < 0xf0) {
+      if(i + 2 >= length || !isContinuation(p[i + 1]) || !isContinuation(p[i + 2]))
+        return Invalid;
+      // Reject overlong forms and surrogates.
+      if((c == 0xe0 && p[i + 1] < 0xa0) || (c == 0xed && p[i + 1] > 0x9f))
+        return Invalid;
+      cp = ((c & 0x0f) << 12) | ((p[i + 1] & 0x3f) << 6) | (p[i + 2] & 0x3f);
+      i += 3;
+    }
+    else if(c < 0xf5) {
+      if(i + 3 >= length || !isContinuation(p[i + 1]) ||
+         !isContinuation(p[i + 2]) || !isContinuation(p[i + 3]))
+        return Invalid;
+      // Reject overlong forms and code points beyond U+10FFFF.
+      if((c == 0xf0 && p[i + 1] < 0x90) || (c == 0xf4 && p[i + 1] > 0x8f))
+        return Invalid;
+      cp = ((c & 0x07) << 18) | ((p[i + 1] & 0x3f) << 12) |
+           ((p[i + 2] & 0x3f) << 6) | (p[i + 3] & 0x3f);
+      i += 4;
+    }
+    else {
+      return Invalid;
+    }
+
+    if(cp < 0x10000) {
+      out[n++] = static_cast<wchar_t>(cp);
+    }
+    else {
+      cp -= 0x10000;
+      out[n++] = static_cast<wchar_t>(0xd800 + (cp >> 10));
+      out[n++] = static_cast<wchar_t>(0xdc00 + (cp & 0x3ff));
+    }
+  }
+
+  return n;
+}
+
+size_t Unicode::utf16ToUTF8(const wchar_t *s, size_t length, char *out)
+{
+  return encodeUTF8(s, length, out);
+}
+
+size_t Unicode::latin1ToUTF8(const char *s, size_t length, char *out)
+{
+  return encodeUTF8(reinterpret_cast<const unsigned char *>(s), length, out);
+}
@@ -0,0 +1,73 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#ifndef TAGLIB_TUNICODE_H
+#define TAGLIB_TUNICODE_H
+
+#include <cstddef>
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+namespace TagLib {
+
+  namespace Unicode {
+
+    /*!
+     * Returned by the conversion functions if the input is not well-formed.
+     */
+    constexpr size_t Invalid = static_cast<size_t>(-1);
+
+    /*!
+     * Returns the number of leading 7-bit characters of the \a length bytes at
+     * \a s.  This is the fast path of all conversions and uses SSE2 or NEON
+     * where available.
+     */
+    size_t asciiPrefixLength(const char *s, size_t length);
+
+    /*!
+     * Decodes \a length bytes of UTF-8 into UTF-16 code units, one per
+     * wchar_t.  \a out must have room for \a length code units.  Returns the
+     * number of code units written or Invalid if \a s is not valid UTF-8,
+     * which includes overlong forms, surrogates and code points beyond
+     * U+10FFFF.
+     */
+    size_t utf8ToUTF16(const char *s, size_t length, wchar_t *out);
+
+    /*!
+     * Encodes \a length UTF-16 code units as UTF-8.  \a out must have room for
+     * 3 * \a length bytes.  Returns the number of bytes written or Invalid if
+     * \a s contains an unpaired surrogate.
+     */
+    size_t utf16ToUTF8(const wchar_t *s, size_t length, char *out);
+
+    /*!
+     * Encodes \a length Latin-1 characters as UTF-8.  \a out must have room for
+     * 2 * \a length bytes.  Returns the number of bytes written.
+     */
+    size_t latin1ToUTF8(const char *s, size_t length, char *out);
+
+  }  // namespace Unicode
+}  // namespace TagLib
+
+#endif
+
+#endif
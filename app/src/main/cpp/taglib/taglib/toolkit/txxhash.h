@@ -0,0 +1,140 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+
+#ifndef TAGLIB_TXXHASH_H
+#define TAGLIB_TXXHASH_H
+
+// THIS FILE IS NOT A PART OF THE TAGLIB API
+
+#ifndef DO_NOT_DOCUMENT  // tell Doxygen not to document this header
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TagLib
+{
+  namespace Utils
+  {
+    namespace
+    {
+      // XXH64, see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+
+      constexpr uint64_t Prime1 = 0x9E3779B185EBCA87ULL;
+      constexpr uint64_t Prime2 = 0xC2B2AE3D27D4EB4FULL;
+      constexpr uint64_t Prime3 = 0x165667B19E3779F9ULL;
+      constexpr uint64_t Prime4 = 0x85EBCA77C2B2AE63ULL;
+      constexpr uint64_t Prime5 = 0x27D4EB2F165667C5ULL;
+
+      inline uint64_t rotateLeft(uint64_t value, int bits)
+      {
+        return (value << bits) | (value >> (64 - bits));
+      }
+
+      inline uint64_t readLE64(const unsigned char *p)
+      {
+        uint64_t value = 0;
+        for(int i = 7; i >= 0; --i)
+          value = (value << 8) | p[i];
+        return value;
+      }
+
+      inline uint32_t readLE32(const unsigned char *p)
+      {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+               (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+      }
+
+      inline uint64_t round(uint64_t accumulator, uint64_t input)
+      {
+        accumulator += input * Prime2;
+        accumulator = rotateLeft(accumulator, 31);
+        return accumulator * Prime1;
+      }
+
+      inline uint64_t mergeRound(uint64_t accumulator, uint64_t value)
+      {
+        accumulator ^= round(0, value);
+        return accumulator * Prime1 + Prime4;
+      }
+
+      /*!
+       * Returns the XXH64 hash of \a length bytes at \a data.
+       */
+      inline uint64_t xxh64(const char *data, size_t length, uint64_t seed = 0)
+      {
+        auto p = reinterpret_cast<const unsigned char *>(data);
+        const unsigned char *const end = p + length;
+        uint64_t h;
+
+        if(length >= 32) {
+          uint64_t v1 = seed + Prime1 + Prime2;
+          uint64_t v2 = seed + Prime2;
+          uint64_t v3 = seed;
+          uint64_t v4 = seed - Prime1;
+          const unsigned char *const limit = end - 32;
+          do {
+            v1 = round(v1, readLE64(p));
+            v2 = round(v2, readLE64(p + 8));
+            v3 = round(v3, readLE64(p + 16));
+            v4 = round(v4, readLE64(p + 24));
+            p += 32;
+          } while(p <= limit);
+
+          h = rotateLeft(v1, 1) + rotateLeft(v2, 7) + rotateLeft(v3, 12) + rotateLeft(v4, 18);
+          h = mergeRound(h, v1);
+          h = mergeRound(h, v2);
+          h = mergeRound(h, v3);
+          h = mergeRound(h, v4);
+        }
+        else {
+          h = seed + Prime5;
+        }
+
+        h += length;
+
+        for(; p + 8 <= end; p += 8) {
+          h ^= round(0, readLE64(p));
+          h = rotateLeft(h, 27) * Prime1 + Prime4;
+        }
+        if(p + 4 <= end) {
+          h ^= static_cast<uint64_t>(readLE32(p)) * Prime1;
+          h = rotateLeft(h, 23) * Prime2 + Prime3;
+          p += 4;
+        }
+        for(; p < end; ++p) {
+          h ^= *p * Prime5;
+          h = rotateLeft(h, 11) * Prime1;
+        }
+
+        h ^= h >> 33;
+        h *= Prime2;
+        h ^= h >> 29;
+        h *= Prime3;
+        h ^= h >> 32;
+        return h;
+      }
+    }  // namespace
+  }  // namespace Utils
+}  // namespace TagLib
+
+#endif
+
+#endif
@@ -87,7 +87,8 @@ ByteVector zlib::decompress([[maybe_unused]] const ByteVector &data)
       if(result != Z_STREAM_ERROR)
         inflateEnd(&stream);
 
-      debug("zlib::decompress() - Error reading compressed stream.");
+      diagnose(Diagnostics::Generic, Diagnostics::InvalidData,
+               "zlib::decompress() - Error reading compressed stream.");
       return ByteVector();
     }
 
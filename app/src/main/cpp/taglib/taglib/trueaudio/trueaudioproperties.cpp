@@ -106,12 +106,14 @@ int TrueAudio::Properties::ttaVersion() const
 void TrueAudio::Properties::read(const ByteVector &data, offset_t streamLength)
 {
   if(data.size() < 4) {
-    debug("TrueAudio::Properties::read() -- data is too short.");
+    diagnose(Diagnostics::TrueAudio, Diagnostics::Truncated,
+             "TrueAudio::Properties::read() -- data is too short.");
     return;
   }
 
   if(!data.startsWith("TTA")) {
-    debug("TrueAudio::Properties::read() -- invalid header signature.");
+    diagnose(Diagnostics::TrueAudio, Diagnostics::InvalidHeader,
+             "TrueAudio::Properties::read() -- invalid header signature.");
     return;
   }
 
@@ -124,7 +126,8 @@ void TrueAudio::Properties::read(const ByteVector &data, offset_t streamLength)
   // TTA2 headers are in development, and have a different format
   if(1 == d->version) {
     if(data.size() < 18) {
-      debug("TrueAudio::Properties::read() -- data is too short.");
+      diagnose(Diagnostics::TrueAudio, Diagnostics::Truncated,
+               "TrueAudio::Properties::read() -- data is too short.");
       return;
     }
 
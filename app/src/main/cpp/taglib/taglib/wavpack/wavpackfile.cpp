@@ -73,20 +73,20 @@ bool WavPack::File::isSupported(IOStream *stream)
 // public members
 ////////////////////////////////////////////////////////////////////////////////
 
-WavPack::File::File(FileName file, bool readProperties, Properties::ReadStyle) :
+WavPack::File::File(FileName file, bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(file),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
-WavPack::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle) :
+WavPack::File::File(IOStream *stream, bool readProperties, Properties::ReadStyle readStyle) :
   TagLib::File(stream),
   d(std::make_unique<FilePrivate>())
 {
   if(isOpen())
-    read(readProperties);
+    read(readProperties, readStyle);
 }
 
 WavPack::File::~File() = default;
@@ -227,21 +227,22 @@ bool WavPack::File::hasAPETag() const
 // private members
 ////////////////////////////////////////////////////////////////////////////////
 
-void WavPack::File::read(bool readProperties)
+void WavPack::File::read(bool readProperties, Properties::ReadStyle readStyle)
 {
-  // Look for an ID3v1 tag
+  // Look for an ID3v1 tag and an APE tag, both from a single read of the
+  // end of the file
 
-  d->ID3v1Location = Utils::findID3v1(this);
+  const Utils::TailProbe tail = Utils::probeTail(this);
 
-  if(d->ID3v1Location >= 0)
-    d->tag.set(WavID3v1Index, new ID3v1::Tag(this, d->ID3v1Location));
+  d->ID3v1Location = tail.id3v1Location;
 
-  // Look for an APE tag
+  if(d->ID3v1Location >= 0)
+    d->tag.set(WavID3v1Index, new ID3v1::Tag(this, d->ID3v1Location, tail.id3v1Data()));
 
-  d->APELocation = Utils::findAPE(this, d->ID3v1Location);
+  d->APELocation = tail.apeFooterLocation;
 
   if(d->APELocation >= 0) {
-    d->tag.set(WavAPEIndex, new APE::Tag(this, d->APELocation));
+    d->tag.set(WavAPEIndex, new APE::Tag(this, d->APELocation, tail.apeData()));
     d->APESize = APETag()->footer()->completeTagSize();
     d->APELocation = d->APELocation + APE::Footer::size() - d->APESize;
   }
@@ -262,6 +263,6 @@ void WavPack::File::read(bool readProperties)
     else
       streamLength = length();
 
-    d->properties = std::make_unique<Properties>(this, streamLength);
+    d->properties = std::make_unique<Properties>(this, streamLength, readStyle);
   }
 }
@@ -62,7 +62,7 @@ WavPack::Properties::Properties(File *file, offset_t streamLength, ReadStyle sty
   AudioProperties(style),
   d(std::make_unique<PropertiesPrivate>())
 {
-  read(file, streamLength);
+  read(file, streamLength, style);
 }
 
 WavPack::Properties::~Properties() = default;
@@ -230,7 +230,7 @@ namespace
 
 }  // namespace
 
-void WavPack::Properties::read(File *file, offset_t streamLength)
+void WavPack::Properties::read(File *file, offset_t streamLength, ReadStyle style)
 {
   offset_t offset = 0;
 
@@ -239,12 +239,14 @@ void WavPack::Properties::read(File *file, offset_t streamLength)
     const ByteVector data = file->readBlock(32);
 
     if(data.size() < 32) {
-      debug("WavPack::Properties::read() -- data is too short.");
+      diagnose(Diagnostics::WavPack, Diagnostics::Truncated,
+               "WavPack::Properties::read() -- data is too short.");
       break;
     }
 
     if(!data.startsWith("wvpk")) {
-      debug("WavPack::Properties::read() -- Block header not found.");
+      diagnose(Diagnostics::WavPack, Diagnostics::Missing,
+               "WavPack::Properties::read() -- Block header not found.");
       break;
     }
 
@@ -260,7 +262,8 @@ void WavPack::Properties::read(File *file, offset_t streamLength)
     }
 
     if(blockSize < 24 || blockSize > 1048576) {
-      debug("WavPack::Properties::read() -- Invalid block header found.");
+      diagnose(Diagnostics::WavPack, Diagnostics::InvalidHeader,
+               "WavPack::Properties::read() -- Invalid block header found.");
       break;
     }
 
@@ -272,7 +275,8 @@ void WavPack::Properties::read(File *file, offset_t streamLength)
       const ByteVector block = file->readBlock(adjustedBlockSize);
 
       if(block.size() < adjustedBlockSize) {
-        debug("WavPack::Properties::read() -- block is too short.");
+        diagnose(Diagnostics::WavPack, Diagnostics::Truncated,
+                 "WavPack::Properties::read() -- block is too short.");
         break;
       }
 
@@ -302,8 +306,9 @@ void WavPack::Properties::read(File *file, offset_t streamLength)
     offset += blockSize + 8;
   }
 
+  // Streams of unknown size store the total in the final block only.
   if(d->sampleFrames == ~0u)
-    d->sampleFrames = seekFinalIndex(file, streamLength);
+    d->sampleFrames = style != HeaderOnly ? seekFinalIndex(file, streamLength) : 0;
 
   if(d->sampleFrames > 0 && d->sampleRate > 0) {
     const double length = d->sampleFrames * 1000.0 / d->sampleRate;
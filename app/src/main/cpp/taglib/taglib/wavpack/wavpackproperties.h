@@ -108,7 +108,7 @@ namespace TagLib {
       int version() const;
 
     private:
-      void read(File *file, offset_t streamLength);
+      void read(File *file, offset_t streamLength, ReadStyle style);
       unsigned int seekFinalIndex(File *file, offset_t streamLength);
 
       class PropertiesPrivate;
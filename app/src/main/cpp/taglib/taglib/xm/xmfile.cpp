@@ -63,7 +63,7 @@ namespace
  *
  *   StructReader header;
  *   header.u16L(value1).u16L(value2).string(value3, 22). ...;
- *   if(header.read(*this, headerSize) < std::min(header.size(), headerSize))
+ *   if(header.read(reader, headerSize) < std::min(header.size(), headerSize))
  *     ERROR();
  *
  * Maybe if this is useful to other formats these classes can be moved to
@@ -75,10 +75,10 @@ public:
   virtual ~Reader() = default;
 
   /*!
-   * Reads associated values from \a file, but never reads more
+   * Reads associated values from \a reader, but never reads more
    * then \a limit bytes.
    */
-  virtual unsigned int read(TagLib::File &file, unsigned int limit) = 0;
+  virtual unsigned int read(Mod::HeaderReader &reader, unsigned int limit) = 0;
 
   /*!
    * Returns the number of bytes this reader would like to read.
@@ -93,10 +93,10 @@ public:
   {
   }
 
-  unsigned int read(TagLib::File &file, unsigned int limit) override
+  unsigned int read(Mod::HeaderReader &reader, unsigned int limit) override
   {
     unsigned int count = std::min(m_size, limit);
-    file.seek(count, TagLib::File::Current);
+    reader.seek(count, TagLib::File::Current);
     return count;
   }
 
@@ -129,9 +129,9 @@ public:
   {
   }
 
-  unsigned int read(TagLib::File &file, unsigned int limit) override
+  unsigned int read(Mod::HeaderReader &reader, unsigned int limit) override
   {
-    ByteVector data = file.readBlock(std::min(m_size, limit));
+    ByteVector data = reader.readBlock(std::min(m_size, limit));
     unsigned int count = data.size();
     int index = data.find(static_cast<char>(0));
     if(index > -1) {
@@ -155,9 +155,9 @@ class ByteReader : public ValueReader<unsigned char>
 {
 public:
   using ValueReader::ValueReader;
-  unsigned int read(TagLib::File &file, unsigned int limit) override
+  unsigned int read(Mod::HeaderReader &reader, unsigned int limit) override
   {
-    ByteVector data = file.readBlock(std::min(1U,limit));
+    ByteVector data = reader.readBlock(std::min(1U,limit));
     if(!data.isEmpty()) {
       value = data[0];
     }
@@ -189,9 +189,9 @@ public:
   U16Reader(unsigned short &value, bool bigEndian)
   : NumberReader<unsigned short>(value, bigEndian) {}
 
-  unsigned int read(TagLib::File &file, unsigned int limit) override
+  unsigned int read(Mod::HeaderReader &reader, unsigned int limit) override
   {
-    ByteVector data = file.readBlock(std::min(2U,limit));
+    ByteVector data = reader.readBlock(std::min(2U,limit));
     value = data.toUShort(bigEndian);
     return data.size();
   }
@@ -210,9 +210,9 @@ public:
   {
   }
 
-  unsigned int read(TagLib::File &file, unsigned int limit) override
+  unsigned int read(Mod::HeaderReader &reader, unsigned int limit) override
   {
-    ByteVector data = file.readBlock(std::min(4U,limit));
+    ByteVector data = reader.readBlock(std::min(4U,limit));
     value = data.toUInt(bigEndian);
     return data.size();
   }
@@ -322,13 +322,13 @@ public:
     });
   }
 
-  unsigned int read(TagLib::File &file, unsigned int limit) override
+  unsigned int read(Mod::HeaderReader &reader, unsigned int limit) override
   {
     unsigned int sumcount = 0;
     for(const auto &rdr : std::as_const(m_readers)) {
       if(limit == 0)
         break;
-      unsigned int count = rdr->read(file, limit);
+      unsigned int count = rdr->read(reader, limit);
       limit    -= count;
       sumcount += count;
     }
@@ -493,8 +493,10 @@ void XM::File::read(bool)
   if(!isOpen())
     return;
 
-  seek(0);
-  ByteVector magic = readBlock(17);
+  Mod::HeaderReader reader(this);
+
+  reader.seek(0);
+  ByteVector magic = reader.readBlock(17);
   // it's all 0x00 for stripped XM files:
   READ_ASSERT(magic == "Extended Module: " || magic == ByteVector(17, 0));
 
@@ -528,7 +530,7 @@ void XM::File::read(bool)
         .u16L(tempo)
         .u16L(bpmSpeed);
 
-  unsigned int count = header.read(*this, static_cast<unsigned int>(headerSize - 4));
+  unsigned int count = header.read(reader, static_cast<unsigned int>(headerSize - 4));
   unsigned int size = std::min(static_cast<unsigned int>(headerSize - 4), header.size());
 
   READ_ASSERT(count == size);
@@ -542,7 +544,7 @@ void XM::File::read(bool)
   d->properties.setTempo(tempo);
   d->properties.setBpmSpeed(bpmSpeed);
 
-  seek(60 + headerSize);
+  reader.seek(60 + headerSize);
 
   // read patterns:
   for(unsigned short i = 0; i < patternCount; ++ i) {
@@ -555,11 +557,11 @@ void XM::File::read(bool)
     StructReader pattern;
     pattern.byte(packingType).u16L(rowCount).u16L(dataSize);
 
-    unsigned int ptCnt = pattern.read(*this, static_cast<unsigned int>(patternHeaderLength - 4));
+    unsigned int ptCnt = pattern.read(reader, static_cast<unsigned int>(patternHeaderLength - 4));
     READ_ASSERT(ptCnt == std::min(patternHeaderLength - 4U,
                                   static_cast<unsigned long>(pattern.size())));
 
-    seek(patternHeaderLength - (4 + ptCnt) + dataSize, Current);
+    reader.seek(patternHeaderLength - (4 + ptCnt) + dataSize, Current);
   }
 
   StringList instrumentNames;
@@ -579,7 +581,7 @@ void XM::File::read(bool)
     instrument.string(instrumentName, 22).byte(instrumentType).u16L(sampleCount);
 
     // 4 for instrumentHeaderSize
-    unsigned int inCnt = 4 + instrument.read(*this, static_cast<unsigned int>(instrumentHeaderSize - 4));
+    unsigned int inCnt = 4 + instrument.read(reader, static_cast<unsigned int>(instrumentHeaderSize - 4));
     READ_ASSERT(inCnt == std::min(instrumentHeaderSize,
                                   static_cast<unsigned long>(instrument.size() + 4)));
 
@@ -588,9 +590,9 @@ void XM::File::read(bool)
       unsigned long sampleHeaderSize = 0;
       sumSampleCount += sampleCount;
       // wouldn't know which header size to assume otherwise:
-      READ_ASSERT(instrumentHeaderSize >= inCnt + 4 && readU32L(sampleHeaderSize));
+      READ_ASSERT(instrumentHeaderSize >= inCnt + 4 && reader.readU32L(sampleHeaderSize));
       // skip unhandled header proportion:
-      seek(instrumentHeaderSize - inCnt - 4, Current);
+      reader.seek(instrumentHeaderSize - inCnt - 4, Current);
 
       for(unsigned short j = 0; j < sampleCount; ++ j) {
         unsigned long sampleLength = 0;
@@ -615,11 +617,11 @@ void XM::File::read(bool)
               .byte(compression)
               .string(sampleName, 22);
 
-        unsigned int smCnt = sample.read(*this, static_cast<unsigned int>(sampleHeaderSize));
+        unsigned int smCnt = sample.read(reader, static_cast<unsigned int>(sampleHeaderSize));
         READ_ASSERT(smCnt == std::min(sampleHeaderSize,
                                       static_cast<unsigned long>(sample.size())));
         // skip unhandled header proportion:
-        seek(sampleHeaderSize - smCnt, Current);
+        reader.seek(sampleHeaderSize - smCnt, Current);
 
         offset += sampleLength;
         sampleNames.append(sampleName);
@@ -629,7 +631,7 @@ void XM::File::read(bool)
       offset = instrumentHeaderSize - inCnt;
     }
     instrumentNames.append(instrumentName);
-    seek(offset, Current);
+    reader.seek(offset, Current);
   }
 
   d->properties.setSampleCount(sumSampleCount);
@@ -31,7 +31,9 @@
 #include "tpropertymap.h"
 #include "tdebug.h"
 #include "tag.h"
+#ifdef TAGLIB_WITH_APE
 #include "apefile.h"
+#endif
 #include "apetag.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -48,7 +50,9 @@ class TestAPETag : public CppUnit::TestFixture
   CPPUNIT_TEST(testPropertyInterface2);
   CPPUNIT_TEST(testInvalidKeys);
   CPPUNIT_TEST(testTextBinary);
+#ifdef TAGLIB_WITH_APE
   CPPUNIT_TEST(testID3v1Collision);
+#endif
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -168,6 +172,7 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector(), item.binaryData());
   }
 
+#ifdef TAGLIB_WITH_APE
   void testID3v1Collision()
   {
     ScopedFileCopy copy("no-tags", ".mpc");
@@ -185,6 +190,7 @@ public:
       CPPUNIT_ASSERT(!f.hasID3v1Tag());
     }
   }
+#endif
 
 };
 
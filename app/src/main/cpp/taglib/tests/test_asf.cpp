@@ -25,11 +25,14 @@
 
 #include <string>
 #include <cstdio>
+#include <cstdint>
 
 #include "tstringlist.h"
 #include "tbytevectorlist.h"
 #include "tpropertymap.h"
 #include "tag.h"
+#include "tfilestream.h"
+#include "ttracingiostream.h"
 #include "asffile.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -53,6 +56,9 @@ class TestASF : public CppUnit::TestFixture
   CPPUNIT_TEST(testProperties);
   CPPUNIT_TEST(testPropertiesAllSupported);
   CPPUNIT_TEST(testRepeatedSave);
+  CPPUNIT_TEST(testReadHeaderOnce);
+  CPPUNIT_TEST(testReadLargeHeader);
+  CPPUNIT_TEST(testValuesDoNotShareHeader);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -407,6 +413,90 @@ public:
     }
   }
 
+  void testReadHeaderOnce()
+  {
+    FileStream fileStream(TEST_FILE_PATH_C("silence-1.wma"), true);
+    TracingIOStream stream(&fileStream, false);
+    ASF::File f(&stream);
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(String("test"), f.tag()->title());
+    CPPUNIT_ASSERT_EQUAL(1U, stream.summary().readCount);
+  }
+
+  void testReadLargeHeader()
+  {
+    ScopedFileCopy copy("silence-1", ".wma");
+    string newname = copy.fileName();
+
+    const ByteVector data(200000, 'x');
+    {
+      ASF::File f(newname.c_str());
+      ASF::Picture picture;
+      picture.setMimeType("image/jpeg");
+      picture.setType(ASF::Picture::FrontCover);
+      picture.setPicture(data);
+      f.tag()->setAttribute("WM/Picture", picture);
+      f.tag()->setTitle("title");
+      f.save();
+    }
+    {
+      // The first block is too short for the picture, the rest of the
+      // header is read with a second call.
+      FileStream fileStream(newname.c_str(), true);
+      TracingIOStream stream(&fileStream, false);
+      ASF::File f(&stream);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(2U, stream.summary().readCount);
+      CPPUNIT_ASSERT_EQUAL(String("title"), f.tag()->title());
+      const ASF::AttributeList pictures = f.tag()->attribute("WM/Picture");
+      CPPUNIT_ASSERT_EQUAL(1U, pictures.size());
+      CPPUNIT_ASSERT(pictures.front().toPicture().isValid());
+      CPPUNIT_ASSERT_EQUAL(data, pictures.front().toPicture().picture());
+      CPPUNIT_ASSERT_EQUAL(3712, f.audioProperties()->lengthInMilliseconds());
+    }
+  }
+
+  void testValuesDoNotShareHeader()
+  {
+    ScopedFileCopy copy("silence-1", ".wma");
+    string newname = copy.fileName();
+
+    const ByteVector data = ByteVector("TagLibPictureData").append(ByteVector(100000, 'x'));
+    const ByteVector mcdi("\x01\x02\x03\x04", 4);
+    {
+      ASF::File f(newname.c_str());
+      ASF::Picture picture;
+      picture.setMimeType("image/jpeg");
+      picture.setType(ASF::Picture::FrontCover);
+      picture.setPicture(data);
+      f.tag()->setAttribute("WM/Picture", picture);
+      f.tag()->setAttribute("WM/MCDI", mcdi);
+      f.save();
+    }
+    {
+      ASF::File f(newname.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      const offset_t pictureOffset = f.find("TagLibPictureData");
+      CPPUNIT_ASSERT(pictureOffset > 0);
+      f.seek(16);
+      const long long headerSize = f.readBlock(8).toLongLong(false);
+
+      // The picture is a slice of the header buffer, which holds the first
+      // headerSize bytes of the file.  The small value must be a copy outside
+      // of it.
+      const ByteVector picture = f.tag()->attribute("WM/Picture").front().toPicture().picture();
+      const ByteVector value = f.tag()->attribute("WM/MCDI").front().toByteVector();
+      CPPUNIT_ASSERT_EQUAL(data, picture);
+      CPPUNIT_ASSERT_EQUAL(mcdi, value);
+
+      const auto pictureAddress = reinterpret_cast<uintptr_t>(picture.data());
+      const auto headerBegin = pictureAddress - static_cast<uintptr_t>(pictureOffset);
+      const auto headerEnd = headerBegin + static_cast<uintptr_t>(headerSize);
+      const auto valueAddress = reinterpret_cast<uintptr_t>(value.data());
+      CPPUNIT_ASSERT(valueAddress < headerBegin || valueAddress >= headerEnd);
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestASF);
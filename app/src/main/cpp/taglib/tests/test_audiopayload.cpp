@@ -0,0 +1,226 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <string>
+
+#ifndef _WIN32
+# include <fcntl.h>
+# include <unistd.h>
+#endif
+
+#include "audiopayload.h"
+#include "fileref.h"
+#include "tag.h"
+#include "txxhash.h"
+#ifdef TAGLIB_WITH_RIFF
+#include "wavfile.h"
+#endif
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestAudioPayload : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestAudioPayload);
+  CPPUNIT_TEST(testRanges);
+  CPPUNIT_TEST(testUnsupported);
+  CPPUNIT_TEST(testTagEdits);
+  CPPUNIT_TEST(testDifferentAudio);
+  CPPUNIT_TEST(testSameAudioDifferentTags);
+  CPPUNIT_TEST(testXXH64);
+  CPPUNIT_TEST(testKnownDigest);
+#ifdef TAGLIB_WITH_RIFF
+  CPPUNIT_TEST(testThreads);
+#endif
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testRanges()
+  {
+#ifdef TAGLIB_WITH_RIFF
+    {
+      FileRef f(TEST_FILE_PATH_C("empty.wav"));
+      const List<AudioPayload::Range> ranges = AudioPayload::ranges(f.file());
+      CPPUNIT_ASSERT_EQUAL(1U, ranges.size());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(44), ranges.front().offset);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(14700), ranges.front().length);
+    }
+#endif
+    {
+      FileRef f(TEST_FILE_PATH_C("lame_cbr.mp3"));
+      const List<AudioPayload::Range> ranges = AudioPayload::ranges(f.file());
+      CPPUNIT_ASSERT_EQUAL(1U, ranges.size());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(208), ranges.front().offset);
+    }
+#ifdef TAGLIB_WITH_VORBIS
+    {
+      // The header packets of Opus end on the first two pages.
+      FileRef f(TEST_FILE_PATH_C("correctness_gain_silent_output.opus"));
+      const List<AudioPayload::Range> ranges = AudioPayload::ranges(f.file());
+      CPPUNIT_ASSERT(ranges.size() > 1);
+      CPPUNIT_ASSERT(ranges.front().offset > 0);
+    }
+#endif
+  }
+
+  void testUnsupported()
+  {
+#ifdef TAGLIB_WITH_MOD
+    FileRef f(TEST_FILE_PATH_C("test.xm"));
+    CPPUNIT_ASSERT(!f.isNull());
+    CPPUNIT_ASSERT(AudioPayload::ranges(f.file()).isEmpty());
+    CPPUNIT_ASSERT(AudioPayload::hash(f.file()).isEmpty());
+#endif
+    CPPUNIT_ASSERT(AudioPayload::ranges(nullptr).isEmpty());
+  }
+
+  void testTagEdits()
+  {
+    checkTagEdit("lame_cbr.mp3", ".mp3");
+    checkTagEdit("sinewave.flac", ".flac");
+#ifdef TAGLIB_WITH_MP4
+    checkTagEdit("no-tags.m4a", ".m4a");
+#endif
+#ifdef TAGLIB_WITH_RIFF
+    checkTagEdit("empty.wav", ".wav");
+    checkTagEdit("noise.aif", ".aif");
+#endif
+#ifdef TAGLIB_WITH_DSF
+    checkTagEdit("empty10ms.dsf", ".dsf");
+#endif
+#ifdef TAGLIB_WITH_VORBIS
+    checkTagEdit("empty.ogg", ".ogg");
+    checkTagEdit("correctness_gain_silent_output.opus", ".opus");
+#endif
+  }
+
+  void testDifferentAudio()
+  {
+    CPPUNIT_ASSERT(hash("lame_cbr.mp3") != hash("xing.mp3"));
+    CPPUNIT_ASSERT(hash("sinewave.flac") != hash("no-tags.flac"));
+#ifdef TAGLIB_WITH_RIFF
+    CPPUNIT_ASSERT(hash("empty.wav") != hash("alaw.wav"));
+#endif
+  }
+
+  void testSameAudioDifferentTags()
+  {
+#ifdef TAGLIB_WITH_MP4
+    CPPUNIT_ASSERT_EQUAL(hash("no-tags.m4a"), hash("has-tags.m4a"));
+#endif
+#ifdef TAGLIB_WITH_VORBIS
+    CPPUNIT_ASSERT_EQUAL(hash("empty.ogg"), hash("test.ogg"));
+#endif
+  }
+
+  void testXXH64()
+  {
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0xEF46DB3751D8E999ULL), Utils::xxh64("", 0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0xD24EC4F1A98C6E5BULL), Utils::xxh64("a", 1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<uint64_t>(0x44BC2CF5AD770999ULL), Utils::xxh64("abc", 3));
+  }
+
+  void testKnownDigest()
+  {
+    // The digests are stored by applications, so they must not change.
+    CPPUNIT_ASSERT_EQUAL(ByteVector::fromULongLong(0x22641F4A4A1AF0CDULL), hash("lame_cbr.mp3"));
+    CPPUNIT_ASSERT_EQUAL(ByteVector::fromULongLong(0xB66B786BD10EE1C4ULL), hash("sinewave.flac"));
+  }
+
+#ifdef TAGLIB_WITH_RIFF
+  void testThreads()
+  {
+#ifndef _WIN32
+    // A WAV file with 20 MiB of audio, so that several threads get blocks.
+    ByteVector samples(20 * 1024 * 1024 + 123, 0);
+    unsigned int seed = 1;
+    for(auto &c : samples) {
+      seed = seed * 1103515245U + 12345U;
+      c = static_cast<char>(seed >> 16);
+    }
+    const ByteVector format = ByteVector::fromShort(1, false)
+      .append(ByteVector::fromShort(2, false))
+      .append(ByteVector::fromUInt(44100, false))
+      .append(ByteVector::fromUInt(44100 * 4, false))
+      .append(ByteVector::fromShort(4, false))
+      .append(ByteVector::fromShort(16, false));
+    const ByteVector body = ByteVector("WAVE")
+      .append("fmt ").append(ByteVector::fromUInt(format.size(), false)).append(format)
+      .append("data").append(ByteVector::fromUInt(samples.size(), false)).append(samples);
+
+    const ScopedTempFile file(".wav", ByteVector("RIFF")
+      .append(ByteVector::fromUInt(body.size(), false)).append(body));
+    const string name = file.fileName();
+
+    ByteVector sequential;
+    ByteVector single;
+    ByteVector parallel;
+    {
+      RIFF::WAV::File f(name.c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      const int fd = ::open(name.c_str(), O_RDONLY);
+      CPPUNIT_ASSERT(fd >= 0);
+      sequential = AudioPayload::hash(&f);
+      single = AudioPayload::hash(&f, fd, 1);
+      parallel = AudioPayload::hash(&f, fd, 4);
+      ::close(fd);
+    }
+
+    CPPUNIT_ASSERT_EQUAL(8U, sequential.size());
+    CPPUNIT_ASSERT_EQUAL(sequential, single);
+    CPPUNIT_ASSERT_EQUAL(sequential, parallel);
+#endif
+  }
+#endif
+
+private:
+  static ByteVector hash(const char *fileName)
+  {
+    FileRef f(testFilePath(fileName).c_str());
+    return AudioPayload::hash(f.file());
+  }
+
+  static void checkTagEdit(const string &fileName, const string &ext)
+  {
+    const ScopedFileCopy copy(fileName.substr(0, fileName.size() - ext.size()), ext);
+    const string newname = copy.fileName();
+
+    ByteVector before;
+    {
+      FileRef f(newname.c_str());
+      before = AudioPayload::hash(f.file());
+      // Large enough to move the audio data of every format.
+      f.tag()->setTitle(longText(10000));
+      f.tag()->setArtist("Artist");
+      CPPUNIT_ASSERT(f.save());
+    }
+    CPPUNIT_ASSERT_EQUAL(8U, before.size());
+    {
+      FileRef f(newname.c_str());
+      CPPUNIT_ASSERT_EQUAL(longText(10000), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(before, AudioPayload::hash(f.file()));
+    }
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestAudioPayload);
@@ -23,7 +23,6 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
-#include "asfpicture.h"
 #include "flacpicture.h"
 #include "flacfile.h"
 #include "tbytevector.h"
@@ -31,8 +30,13 @@
 #include "tzlib.h"
 #include "fileref.h"
 #include "apetag.h"
+#ifdef TAGLIB_WITH_ASF
+#include "asfpicture.h"
 #include "asftag.h"
+#endif
+#ifdef TAGLIB_WITH_MP4
 #include "mp4tag.h"
+#endif
 #include "xiphcomment.h"
 #include "id3v1tag.h"
 #include "id3v2tag.h"
@@ -69,17 +73,27 @@ class TestComplexProperties : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestComplexProperties);
   CPPUNIT_TEST(testReadMp3Picture);
+#ifdef TAGLIB_WITH_MP4
   CPPUNIT_TEST(testReadM4aPicture);
+#endif
+#ifdef TAGLIB_WITH_VORBIS
   CPPUNIT_TEST(testReadOggPicture);
+#endif
   CPPUNIT_TEST(testReadWriteFlacPicture);
   CPPUNIT_TEST(testReadWriteMultipleProperties);
   CPPUNIT_TEST(testSetGetId3Geob);
   CPPUNIT_TEST(testSetGetId3Picture);
   CPPUNIT_TEST(testSetGetApePicture);
+#ifdef TAGLIB_WITH_ASF
   CPPUNIT_TEST(testSetGetAsfPicture);
+#endif
+#ifdef TAGLIB_WITH_MP4
   CPPUNIT_TEST(testSetGetMp4Picture);
+#endif
   CPPUNIT_TEST(testSetGetXiphPicture);
   CPPUNIT_TEST(testNonExistent);
+  CPPUNIT_TEST(testSelectPicture);
+  CPPUNIT_TEST(testSelectedPictureIsShared);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -103,6 +117,7 @@ public:
     }
   }
 
+#ifdef TAGLIB_WITH_MP4
   void testReadM4aPicture()
   {
     const ByteVector expectedData1(
@@ -145,7 +160,9 @@ public:
     CPPUNIT_ASSERT_EQUAL(String("image/jpeg"),
       picture.value("mimeType").value<String>());
   }
+#endif
 
+#ifdef TAGLIB_WITH_VORBIS
   void testReadOggPicture()
   {
     FileRef f(TEST_FILE_PATH_C("lowercase-fields.ogg"), false);
@@ -167,6 +184,7 @@ public:
     CPPUNIT_ASSERT_EQUAL(5, picture.value("width").value<int>());
     CPPUNIT_ASSERT_EQUAL(6, picture.value("height").value<int>());
   }
+#endif
 
   void testReadWriteFlacPicture()
   {
@@ -327,6 +345,7 @@ public:
       item.binaryData());
   }
 
+#ifdef TAGLIB_WITH_ASF
   void testSetGetAsfPicture()
   {
     VariantMap picture(TEST_PICTURE);
@@ -344,7 +363,9 @@ public:
       asfPicture.description());
     CPPUNIT_ASSERT_EQUAL(ASF::Picture::FrontCover, asfPicture.type());
   }
+#endif
 
+#ifdef TAGLIB_WITH_MP4
   void testSetGetMp4Picture()
   {
     VariantMap picture(TEST_PICTURE);
@@ -360,6 +381,7 @@ public:
       covr.data());
     CPPUNIT_ASSERT_EQUAL(MP4::CoverArt::JPEG, covr.format());
   }
+#endif
 
   void testSetGetXiphPicture()
   {
@@ -412,6 +434,107 @@ public:
       CPPUNIT_ASSERT(tag.complexProperties(PICTURE_KEY).isEmpty());
     }
   }
+
+  void testSelectPicture()
+  {
+    {
+      ID3v2::Tag tag;
+      tagSelectPicture(tag);
+    }
+    {
+      APE::Tag tag;
+      tagSelectPicture(tag);
+    }
+#ifdef TAGLIB_WITH_ASF
+    {
+      ASF::Tag tag;
+      tagSelectPicture(tag);
+    }
+#endif
+    {
+      Ogg::XiphComment tag;
+      tagSelectPicture(tag);
+    }
+#ifdef TAGLIB_WITH_MP4
+    {
+      MP4::Tag tag;
+      CPPUNIT_ASSERT(tag.setComplexProperties(PICTURE_KEY, {
+        {{"data", ByteVector("PNG data")}, {"mimeType", "image/png"}},
+        {{"data", ByteVector("JPEG data")}, {"mimeType", "image/jpeg"}}
+      }));
+      const List<VariantMap> pictures =
+        tag.complexProperties(PICTURE_KEY, Tag::FrontCoverOrFirst);
+      CPPUNIT_ASSERT_EQUAL(1U, pictures.size());
+      CPPUNIT_ASSERT_EQUAL(String("image/png"),
+        pictures.front().value("mimeType").value<String>());
+    }
+#endif
+    {
+      ScopedFileCopy copy("silence-44-s", ".flac");
+      {
+        FLAC::File f(copy.fileName().c_str(), false);
+        tagSelectPicture(f);
+        f.save();
+      }
+      {
+        FileRef f(copy.fileName().c_str(), false);
+        CPPUNIT_ASSERT_EQUAL(2U, f.complexPropertyCount(PICTURE_KEY));
+        const List<VariantMap> pictures =
+          f.complexProperties(PICTURE_KEY, Tag::FrontCoverOrFirst);
+        CPPUNIT_ASSERT_EQUAL(1U, pictures.size());
+        CPPUNIT_ASSERT_EQUAL(TEST_PICTURE.value("data").value<ByteVector>(),
+          pictures.front().value("data").value<ByteVector>());
+      }
+    }
+    {
+      ID3v1::Tag tag;
+      CPPUNIT_ASSERT(tag.complexProperties(PICTURE_KEY, Tag::FrontCoverOrFirst).isEmpty());
+    }
+  }
+
+  void testSelectedPictureIsShared()
+  {
+    ID3v2::Tag tag;
+    CPPUNIT_ASSERT(tag.setComplexProperties(PICTURE_KEY, {TEST_PICTURE}));
+    const auto frame = dynamic_cast<const ID3v2::AttachedPictureFrame *>(
+      tag.frameListMap()["APIC"].front());
+    CPPUNIT_ASSERT(frame);
+
+    const List<VariantMap> pictures =
+      tag.complexProperties(PICTURE_KEY, Tag::FrontCoverOrFirst);
+    const ByteVector data = pictures.front().value("data").value<ByteVector>();
+    const ByteVector framePicture = frame->picture();
+    CPPUNIT_ASSERT(framePicture.data() == data.data());
+  }
+
+  template <typename T>
+  void tagSelectPicture(T &tag)
+  {
+    VariantMap backCover(TEST_PICTURE);
+    backCover.insert("data", ByteVector("PNG data"));
+    backCover.insert("mimeType", "image/png");
+    backCover.insert("pictureType", "Back Cover");
+    CPPUNIT_ASSERT(tag.setComplexProperties(PICTURE_KEY, {backCover, TEST_PICTURE}));
+
+    CPPUNIT_ASSERT_EQUAL(2U, tag.complexProperties(PICTURE_KEY).size());
+    CPPUNIT_ASSERT_EQUAL(2U,
+      tag.complexProperties(PICTURE_KEY, Tag::AllValues).size());
+    CPPUNIT_ASSERT_EQUAL(2U, tag.complexPropertyCount(PICTURE_KEY));
+    CPPUNIT_ASSERT_EQUAL(0U, tag.complexPropertyCount("NONEXISTENT"));
+
+    const List<VariantMap> first =
+      tag.complexProperties(PICTURE_KEY, Tag::FirstValue);
+    CPPUNIT_ASSERT_EQUAL(1U, first.size());
+    CPPUNIT_ASSERT(first.front() == tag.complexProperties(PICTURE_KEY).front());
+
+    const List<VariantMap> cover =
+      tag.complexProperties(PICTURE_KEY, Tag::FrontCoverOrFirst);
+    CPPUNIT_ASSERT_EQUAL(1U, cover.size());
+    CPPUNIT_ASSERT_EQUAL(String("Front Cover"),
+      cover.front().value("pictureType").value<String>());
+    CPPUNIT_ASSERT_EQUAL(TEST_PICTURE.value("data").value<ByteVector>(),
+      cover.front().value("data").value<ByteVector>());
+  }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestComplexProperties);
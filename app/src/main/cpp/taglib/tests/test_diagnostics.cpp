@@ -0,0 +1,159 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include <string>
+
+#include "tdebuglistener.h"
+#include "tdiagnostics.h"
+#include "tstring.h"
+#include "tstringlist.h"
+#include "aifffile.h"
+#include "id3v2tag.h"
+#include "unknownframe.h"
+#ifdef TAGLIB_WITH_MP4
+#include "mp4file.h"
+#endif
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  class CollectingListener : public DebugListener
+  {
+  public:
+    void printMessage(const String &msg) override
+    {
+      messages.append(msg);
+    }
+
+    StringList messages;
+  };
+}  // namespace
+
+class TestDiagnostics : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestDiagnostics);
+  CPPUNIT_TEST(testCount);
+  CPPUNIT_TEST(testReset);
+  CPPUNIT_TEST(testToString);
+  CPPUNIT_TEST(testOutOfRange);
+  CPPUNIT_TEST(testMessagesDisabled);
+  CPPUNIT_TEST(testRenderNotCounted);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp() override
+  {
+    Diagnostics::reset();
+  }
+
+  void tearDown() override
+  {
+    setDebugMessagesEnabled(true);
+    setDebugListener(nullptr);
+    Diagnostics::reset();
+  }
+
+  void testCount()
+  {
+    {
+      RIFF::AIFF::File f(TEST_FILE_PATH_C("duplicate_id3v2.aiff"));
+      CPPUNIT_ASSERT(f.isValid());
+    }
+    CPPUNIT_ASSERT_EQUAL(1ULL, Diagnostics::count(Diagnostics::RIFF, Diagnostics::Duplicate));
+    CPPUNIT_ASSERT_EQUAL(1ULL, Diagnostics::count(Diagnostics::RIFF));
+    CPPUNIT_ASSERT_EQUAL(0ULL, Diagnostics::count(Diagnostics::MP4));
+
+#ifdef TAGLIB_WITH_MP4
+    {
+      MP4::File f(TEST_FILE_PATH_C("infloop.m4a"));
+      CPPUNIT_ASSERT(f.isValid());
+    }
+    CPPUNIT_ASSERT(Diagnostics::count(Diagnostics::MP4) > 0);
+    CPPUNIT_ASSERT_EQUAL(1ULL, Diagnostics::count(Diagnostics::RIFF));
+#endif
+  }
+
+  void testReset()
+  {
+    {
+      RIFF::AIFF::File f(TEST_FILE_PATH_C("duplicate_id3v2.aiff"));
+    }
+    CPPUNIT_ASSERT_EQUAL(1ULL, Diagnostics::count(Diagnostics::RIFF));
+    Diagnostics::reset();
+    CPPUNIT_ASSERT_EQUAL(0ULL, Diagnostics::count(Diagnostics::RIFF));
+    CPPUNIT_ASSERT_EQUAL(0ULL, Diagnostics::count(Diagnostics::RIFF, Diagnostics::Duplicate));
+  }
+
+  void testToString()
+  {
+    CPPUNIT_ASSERT_EQUAL(String("{}"), Diagnostics::toString());
+    {
+      RIFF::AIFF::File f(TEST_FILE_PATH_C("duplicate_id3v2.aiff"));
+    }
+    CPPUNIT_ASSERT_EQUAL(String("{\"riff\":{\"duplicate\":1}}"), Diagnostics::toString());
+  }
+
+  void testOutOfRange()
+  {
+    CPPUNIT_ASSERT_EQUAL(0ULL, Diagnostics::count(Diagnostics::FormatCount));
+    CPPUNIT_ASSERT_EQUAL(0ULL, Diagnostics::count(Diagnostics::FLAC, Diagnostics::KindCount));
+  }
+
+  void testMessagesDisabled()
+  {
+    CollectingListener listener;
+    setDebugListener(&listener);
+
+    CPPUNIT_ASSERT(debugMessagesEnabled());
+    setDebugMessagesEnabled(false);
+    CPPUNIT_ASSERT(!debugMessagesEnabled());
+    {
+      RIFF::AIFF::File f(TEST_FILE_PATH_C("duplicate_id3v2.aiff"));
+    }
+    CPPUNIT_ASSERT(listener.messages.isEmpty());
+    CPPUNIT_ASSERT_EQUAL(1ULL, Diagnostics::count(Diagnostics::RIFF, Diagnostics::Duplicate));
+
+    setDebugMessagesEnabled(true);
+    {
+      RIFF::AIFF::File f(TEST_FILE_PATH_C("duplicate_id3v2.aiff"));
+    }
+    CPPUNIT_ASSERT_EQUAL(2ULL, Diagnostics::count(Diagnostics::RIFF, Diagnostics::Duplicate));
+#ifndef NDEBUG
+    CPPUNIT_ASSERT_EQUAL(1U, listener.messages.size());
+    CPPUNIT_ASSERT(listener.messages.front().find("Duplicate ID3v2 tag") != -1);
+#endif
+  }
+
+  void testRenderNotCounted()
+  {
+    // Frames dropped while saving are not problems of a parsed file.
+    ID3v2::Tag tag;
+    tag.addFrame(new ID3v2::UnknownFrame(ByteVector("WXYZ\0\0\0\0\0\0", 10)));
+    tag.setTitle("Title");
+    CPPUNIT_ASSERT(!tag.render().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0ULL, Diagnostics::count(Diagnostics::ID3v2));
+  }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestDiagnostics);
@@ -23,7 +23,23 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <cstring>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 #include "tfile.h"
+#include "tfilestream.h"
+#include "tag.h"
+#include "fileref.h"
+#ifdef TAGLIB_WITH_RIFF
+#include "wavfile.h"
+#endif
+#ifdef TAGLIB_WITH_MP4
+#include "mp4file.h"
+#endif
 #include "plainfile.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -35,8 +51,20 @@ class TestFile : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE(TestFile);
   CPPUNIT_TEST(testFindInSmallFile);
   CPPUNIT_TEST(testRFindInSmallFile);
+  CPPUNIT_TEST(testFindAny);
+  CPPUNIT_TEST(testFindAnyAcrossBlocks);
+  CPPUNIT_TEST(testFindAnyAccept);
   CPPUNIT_TEST(testSeek);
   CPPUNIT_TEST(testTruncate);
+  CPPUNIT_TEST(testBorrowedDescriptor);
+  CPPUNIT_TEST(testPositionalWrite);
+  CPPUNIT_TEST(testCachedLength);
+#ifdef TAGLIB_WITH_RIFF
+  CPPUNIT_TEST(testReadSyscallsManyChunks);
+#endif
+#ifdef TAGLIB_WITH_MP4
+  CPPUNIT_TEST(testReadSyscallsManyAtoms);
+#endif
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -97,6 +125,135 @@ public:
     }
   }
 
+  void testFindAny()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(ByteVector("0123456239", 10));
+      file.truncate(10);
+    }
+    {
+      PlainFile file(name.c_str());
+      file.seek(5);
+
+      int index = -2;
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2),
+                           file.findAny(ByteVectorList { "45", "23" }, 0, &index));
+      CPPUNIT_ASSERT_EQUAL(1, index);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4),
+                           file.findAny(ByteVectorList { "45", "23" }, 3, &index));
+      CPPUNIT_ASSERT_EQUAL(0, index);
+
+      // Patterns which start at the same offset are ranked by their order.
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2),
+                           file.findAny(ByteVectorList { "2", "23" }, 0, &index));
+      CPPUNIT_ASSERT_EQUAL(0, index);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2),
+                           file.findAny(ByteVectorList { "23", "2" }, 0, &index));
+      CPPUNIT_ASSERT_EQUAL(0, index);
+
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1),
+                           file.findAny(ByteVectorList { "x", "9a" }, 0, &index));
+      CPPUNIT_ASSERT_EQUAL(-1, index);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.findAny(ByteVectorList()));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(9),
+                           file.findAny(ByteVectorList { ByteVector(), "9" }, 0, &index));
+      CPPUNIT_ASSERT_EQUAL(1, index);
+
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2), file.find("23", 0, "45"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.find("45", 0, "23"));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4), file.find("45", 3, "23"));
+
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(5), file.tell());
+    }
+  }
+
+  void testFindAnyAcrossBlocks()
+  {
+    // Matches on both sides of the block boundaries, and a long pattern
+    // which starts before a short one but spans two blocks.
+    ByteVector data(100000, 'x');
+    const unsigned int longAt = 16384 - 3;
+    const unsigned int shortAt = 16384 + 10;
+    ::memcpy(data.data() + longAt, "0123456789", 10);
+    ::memcpy(data.data() + shortAt, "ab", 2);
+    ::memcpy(data.data() + 99998, "yz", 2);
+
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+    {
+      PlainFile file(name.c_str());
+      int index = -1;
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(longAt),
+                           file.findAny(ByteVectorList { "ab", "0123456789" }, 0, &index));
+      CPPUNIT_ASSERT_EQUAL(1, index);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(shortAt),
+                           file.findAny(ByteVectorList { "ab", "0123456789" }, longAt + 1, &index));
+      CPPUNIT_ASSERT_EQUAL(0, index);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(99998),
+                           file.findAny(ByteVectorList { "yz", "y" }, shortAt, &index));
+      CPPUNIT_ASSERT_EQUAL(0, index);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1),
+                           file.findAny(ByteVectorList { "ba", "zz" }, 0, &index));
+
+      for(offset_t from = 0; from < 100000; from += 16383) {
+        file.seek(from);
+        const ByteVector v = file.readBlock(data.size());
+        const int expected = v.find("yz");
+        CPPUNIT_ASSERT_EQUAL(from + expected, file.find("yz", from));
+        CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), file.find("yz", from, "x"));
+      }
+    }
+  }
+
+  void testFindAnyAccept()
+  {
+    ByteVector data(40000, 'x');
+    ::memcpy(data.data() + 100, "ab", 2);
+    ::memcpy(data.data() + 20000, "ab", 2);
+    ::memcpy(data.data() + 30000, "cd", 2);
+
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+    {
+      PlainFile file(name.c_str());
+      file.seek(0);
+      file.writeBlock(data);
+      file.truncate(data.size());
+    }
+    {
+      PlainFile file(name.c_str());
+      file.seek(7);
+
+      // Rejected matches are skipped, even when accept() reads elsewhere.
+      List<offset_t> offsets;
+      const offset_t location = file.findAny(ByteVectorList { "ab", "cd" }, 0,
+        [&](offset_t offset, int index) {
+          offsets.append(offset);
+          file.seek(0);
+          file.readBlock(10);
+          return index == 1;
+        });
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(30000), location);
+      CPPUNIT_ASSERT_EQUAL(3U, offsets.size());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(100), offsets[0]);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(20000), offsets[1]);
+
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1),
+        file.findAny(ByteVectorList { "ab" }, 0, [](offset_t, int) { return false; }));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(7), file.tell());
+    }
+  }
+
   void testSeek()
   {
     ScopedFileCopy copy("empty", ".ogg");
@@ -139,6 +296,168 @@ public:
     }
   }
 
+  void testBorrowedDescriptor()
+  {
+#ifndef _WIN32
+    const int fd = ::open(TEST_FILE_PATH_C("empty.ogg"), O_RDONLY);
+    CPPUNIT_ASSERT(fd >= 0);
+    {
+      FileStream a(fd, true, FileStream::BorrowDescriptor);
+      FileStream b(fd, true, FileStream::BorrowDescriptor);
+      CPPUNIT_ASSERT(a.isOpen());
+      CPPUNIT_ASSERT(a.readOnly());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4328), a.length());
+
+      // Both streams keep their own position on the shared descriptor.
+      a.seek(-100, IOStream::End);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("OggS"), b.readBlock(4));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4228), a.tell());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4), b.tell());
+      CPPUNIT_ASSERT_EQUAL(100U, a.readBlock(200).size());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4328), a.tell());
+      CPPUNIT_ASSERT(a.readBlock(1).isEmpty());
+
+      a.seek(-10, IOStream::Current);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4318), a.tell());
+      a.seek(-5000, IOStream::Current);
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4318), a.tell());
+    }
+    CPPUNIT_ASSERT(::fcntl(fd, F_GETFD) != -1);
+    CPPUNIT_ASSERT_EQUAL(0, ::close(fd));
+#endif
+  }
+
+  void testPositionalWrite()
+  {
+#ifndef _WIN32
+    ScopedFileCopy copy("xing", ".mp3");
+    std::string name = copy.fileName();
+
+    const int fd = ::open(name.c_str(), O_RDWR);
+    CPPUNIT_ASSERT(fd >= 0);
+    {
+      FileStream stream(fd, false, FileStream::BorrowDescriptor);
+      CPPUNIT_ASSERT(!stream.readOnly());
+
+      FileRef f(&stream);
+      CPPUNIT_ASSERT(!f.isNull());
+      f.tag()->setTitle(String(std::string(3000, 'x')));
+      CPPUNIT_ASSERT(f.save());
+    }
+    {
+      FileStream stream(fd, false, FileStream::TakeOwnership);
+      FileRef f(&stream);
+      CPPUNIT_ASSERT_EQUAL(String(std::string(3000, 'x')), f.tag()->title());
+      CPPUNIT_ASSERT(f.audioProperties());
+      f.tag()->setTitle("short");
+      CPPUNIT_ASSERT(f.save());
+    }
+    CPPUNIT_ASSERT(::fcntl(fd, F_GETFD) == -1);
+    {
+      FileRef f(name.c_str());
+      CPPUNIT_ASSERT_EQUAL(String("short"), f.tag()->title());
+    }
+#endif
+  }
+
+  void testCachedLength()
+  {
+    ScopedFileCopy copy("empty", ".ogg");
+    std::string name = copy.fileName();
+
+    FileStream stream(name.c_str());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4328), stream.length());
+
+    stream.seek(0, IOStream::End);
+    stream.writeBlock("abcd");
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4332), stream.length());
+    stream.insert("xyz", 100);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4335), stream.length());
+    stream.removeBlock(0, 35);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4300), stream.length());
+    stream.truncate(2000);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(2000), stream.length());
+
+    stream.seek(-4, IOStream::End);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1996), stream.tell());
+    CPPUNIT_ASSERT_EQUAL(4U, stream.readBlock(10).size());
+  }
+
+  // The lookup of the length must not discard the stdio buffer, otherwise a
+  // file with many small chunks or atoms is read with several system calls
+  // per chunk.
+
+#ifdef TAGLIB_WITH_RIFF
+  void testReadSyscallsManyChunks()
+  {
+#ifdef __linux__
+    ByteVector body("WAVE");
+    body.append("fmt ").append(ByteVector::fromUInt(16, false));
+    body.append(ByteVector::fromShort(1, false)).append(ByteVector::fromShort(2, false));
+    body.append(ByteVector::fromUInt(44100, false)).append(ByteVector::fromUInt(176400, false));
+    body.append(ByteVector::fromShort(4, false)).append(ByteVector::fromShort(16, false));
+    for(int i = 0; i < 2000; ++i)
+      body.append("junk").append(ByteVector::fromUInt(8, false)).append(ByteVector(8, '\0'));
+    body.append("data").append(ByteVector::fromUInt(4000, false)).append(ByteVector(4000, '\0'));
+
+    const ScopedTempFile file(".wav", ByteVector("RIFF")
+      .append(ByteVector::fromUInt(body.size(), false)).append(body));
+
+    const long long before = readSyscalls();
+    {
+      RIFF::WAV::File f(file.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+    }
+    const long long count = readSyscalls() - before;
+
+    CPPUNIT_ASSERT(count < 100);
+#endif
+  }
+#endif
+
+#ifdef TAGLIB_WITH_MP4
+  void testReadSyscallsManyAtoms()
+  {
+#ifdef __linux__
+    ByteVector moov;
+    for(int i = 0; i < 2000; ++i)
+      moov.append(ByteVector::fromUInt(16)).append("free").append(ByteVector(8, '\0'));
+
+    const ScopedTempFile file(".m4a", ByteVector::fromUInt(16)
+      .append("ftypM4A ").append(ByteVector::fromUInt(0))
+      .append(ByteVector::fromUInt(moov.size() + 8)).append("moov").append(moov));
+
+    const long long before = readSyscalls();
+    {
+      MP4::File f(file.fileName().c_str());
+      CPPUNIT_ASSERT(f.isValid());
+    }
+    const long long count = readSyscalls() - before;
+
+    CPPUNIT_ASSERT(count < 100);
+#endif
+  }
+#endif
+
+private:
+
+#ifdef __linux__
+  // Number of read system calls of this process so far.
+
+  static long long readSyscalls()
+  {
+    std::ifstream io("/proc/self/io");
+    std::string key;
+    long long value;
+    while(io >> key >> value) {
+      if(key == "syscr:")
+        return value;
+    }
+    return -1;
+  }
+#endif
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFile);
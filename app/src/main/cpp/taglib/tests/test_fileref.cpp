@@ -25,34 +25,64 @@
 
 #include <string>
 #include <cstdio>
+#include <thread>
 
+#include "tarena.h"
 #include "tfilestream.h"
 #include "tbytevectorstream.h"
 #include "tag.h"
+#include "tpropertymap.h"
 #include "fileref.h"
+#ifdef TAGLIB_WITH_VORBIS
 #include "oggflacfile.h"
 #include "vorbisfile.h"
+#endif
 #include "mpegfile.h"
+#ifdef TAGLIB_WITH_APE
 #include "mpcfile.h"
+#endif
+#ifdef TAGLIB_WITH_ASF
 #include "asffile.h"
+#endif
+#ifdef TAGLIB_WITH_VORBIS
 #include "speexfile.h"
+#endif
 #include "flacfile.h"
+#ifdef TAGLIB_WITH_TRUEAUDIO
 #include "trueaudiofile.h"
+#endif
+#ifdef TAGLIB_WITH_MP4
 #include "mp4file.h"
+#endif
+#ifdef TAGLIB_WITH_RIFF
 #include "wavfile.h"
+#endif
+#ifdef TAGLIB_WITH_APE
 #include "apefile.h"
+#endif
+#ifdef TAGLIB_WITH_RIFF
 #include "aifffile.h"
+#endif
+#ifdef TAGLIB_WITH_APE
 #include "wavpackfile.h"
+#endif
+#ifdef TAGLIB_WITH_VORBIS
 #include "opusfile.h"
+#endif
+#ifdef TAGLIB_WITH_MOD
 #include "xmfile.h"
+#endif
+#ifdef TAGLIB_WITH_DSF
 #include "dsffile.h"
 #include "dsdifffile.h"
+#endif
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
 using namespace std;
 using namespace TagLib;
 
+#if defined(TAGLIB_WITH_VORBIS) && defined(TAGLIB_WITH_MP4)
 namespace
 {
   class DummyResolver : public FileRef::FileTypeResolver
@@ -78,35 +108,62 @@ namespace
     }
   };
 } // namespace
+#endif
 
 class TestFileRef : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestFileRef);
+#ifdef TAGLIB_WITH_ASF
   CPPUNIT_TEST(testASF);
+#endif
+#ifdef TAGLIB_WITH_APE
   CPPUNIT_TEST(testMusepack);
+#endif
+#ifdef TAGLIB_WITH_VORBIS
   CPPUNIT_TEST(testVorbis);
   CPPUNIT_TEST(testSpeex);
+#endif
   CPPUNIT_TEST(testFLAC);
   CPPUNIT_TEST(testMP3);
+#ifdef TAGLIB_WITH_VORBIS
   CPPUNIT_TEST(testOGA_FLAC);
   CPPUNIT_TEST(testOGA_Vorbis);
+#endif
+#ifdef TAGLIB_WITH_MP4
   CPPUNIT_TEST(testMP4_1);
   CPPUNIT_TEST(testMP4_2);
   CPPUNIT_TEST(testMP4_3);
   CPPUNIT_TEST(testMP4_4);
+#endif
+#ifdef TAGLIB_WITH_TRUEAUDIO
   CPPUNIT_TEST(testTrueAudio);
+#endif
+#ifdef TAGLIB_WITH_APE
   CPPUNIT_TEST(testAPE);
+#endif
+#ifdef TAGLIB_WITH_RIFF
   CPPUNIT_TEST(testWav);
   CPPUNIT_TEST(testAIFF_1);
   CPPUNIT_TEST(testAIFF_2);
+#endif
+#ifdef TAGLIB_WITH_APE
   CPPUNIT_TEST(testWavPack);
+#endif
+#ifdef TAGLIB_WITH_VORBIS
   CPPUNIT_TEST(testOpus);
+#endif
+#ifdef TAGLIB_WITH_DSF
   CPPUNIT_TEST(testDSF);
   CPPUNIT_TEST(testDSDIFF);
+#endif
   CPPUNIT_TEST(testUnsupported);
   CPPUNIT_TEST(testAudioProperties);
   CPPUNIT_TEST(testDefaultFileExtensions);
+#if defined(TAGLIB_WITH_VORBIS) && defined(TAGLIB_WITH_MP4)
   CPPUNIT_TEST(testFileResolver);
+#endif
+  CPPUNIT_TEST(testParseArena);
+  CPPUNIT_TEST(testArenaAllocation);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -239,25 +296,33 @@ public:
     }
   }
 
+#ifdef TAGLIB_WITH_APE
   void testMusepack()
   {
     fileRefSave<MPC::File>("click", ".mpc");
   }
+#endif
 
+#ifdef TAGLIB_WITH_ASF
   void testASF()
   {
     fileRefSave<ASF::File>("silence-1", ".wma");
   }
+#endif
 
+#ifdef TAGLIB_WITH_VORBIS
   void testVorbis()
   {
     fileRefSave<Ogg::Vorbis::File>("empty", ".ogg");
   }
+#endif
 
+#ifdef TAGLIB_WITH_VORBIS
   void testSpeex()
   {
     fileRefSave<Ogg::Speex::File>("empty", ".spx");
   }
+#endif
 
   void testFLAC()
   {
@@ -269,80 +334,110 @@ public:
     fileRefSave<MPEG::File>("xing", ".mp3");
   }
 
+#ifdef TAGLIB_WITH_TRUEAUDIO
   void testTrueAudio()
   {
     fileRefSave<TrueAudio::File>("empty", ".tta");
   }
+#endif
 
+#ifdef TAGLIB_WITH_MP4
   void testMP4_1()
   {
     fileRefSave<MP4::File>("has-tags", ".m4a");
   }
+#endif
 
+#ifdef TAGLIB_WITH_MP4
   void testMP4_2()
   {
     fileRefSave<MP4::File>("no-tags", ".m4a");
   }
+#endif
 
+#ifdef TAGLIB_WITH_MP4
   void testMP4_3()
   {
     fileRefSave<MP4::File>("no-tags", ".3g2");
   }
+#endif
 
+#ifdef TAGLIB_WITH_MP4
   void testMP4_4()
   {
     fileRefSave<MP4::File>("blank_video", ".m4v");
   }
+#endif
 
+#ifdef TAGLIB_WITH_RIFF
   void testWav()
   {
     fileRefSave<RIFF::WAV::File>("empty", ".wav");
   }
+#endif
 
+#ifdef TAGLIB_WITH_VORBIS
   void testOGA_FLAC()
   {
     fileRefSave<Ogg::FLAC::File>("empty_flac", ".oga");
   }
+#endif
 
+#ifdef TAGLIB_WITH_VORBIS
   void testOGA_Vorbis()
   {
     fileRefSave<Ogg::Vorbis::File>("empty_vorbis", ".oga");
   }
+#endif
 
+#ifdef TAGLIB_WITH_APE
   void testAPE()
   {
     fileRefSave<APE::File>("mac-399", ".ape");
   }
+#endif
 
+#ifdef TAGLIB_WITH_RIFF
   void testAIFF_1()
   {
     fileRefSave<RIFF::AIFF::File>("empty", ".aiff");
   }
+#endif
 
+#ifdef TAGLIB_WITH_RIFF
   void testAIFF_2()
   {
     fileRefSave<RIFF::AIFF::File>("alaw", ".aifc");
   }
+#endif
 
+#ifdef TAGLIB_WITH_APE
   void testWavPack()
   {
     fileRefSave<WavPack::File>("click", ".wv");
   }
+#endif
 
+#ifdef TAGLIB_WITH_VORBIS
   void testOpus()
   {
     fileRefSave<Ogg::Opus::File>("correctness_gain_silent_output", ".opus");
   }
+#endif
 
+#ifdef TAGLIB_WITH_DSF
   void testDSF()
   {
     fileRefSave<DSF::File>("empty10ms",".dsf");
   }
+#endif
 
+#ifdef TAGLIB_WITH_DSF
   void testDSDIFF()
   {
     fileRefSave<DSDIFF::File>("empty10ms",".dff");
   }
+#endif
 
   void testUnsupported()
   {
@@ -364,29 +459,62 @@ public:
   void testDefaultFileExtensions()
   {
     const StringList extensions = FileRef::defaultFileExtensions();
+    CPPUNIT_ASSERT(extensions.contains("flac"));
+    CPPUNIT_ASSERT(extensions.contains("mp3"));
+#ifdef TAGLIB_WITH_APE
     CPPUNIT_ASSERT(extensions.contains("mpc"));
+    CPPUNIT_ASSERT(extensions.contains("ape"));
+    CPPUNIT_ASSERT(extensions.contains("wv"));
+#else
+    CPPUNIT_ASSERT(!extensions.contains("ape"));
+#endif
+#ifdef TAGLIB_WITH_ASF
     CPPUNIT_ASSERT(extensions.contains("wma"));
+#else
+    CPPUNIT_ASSERT(!extensions.contains("wma"));
+#endif
+#ifdef TAGLIB_WITH_VORBIS
     CPPUNIT_ASSERT(extensions.contains("ogg"));
     CPPUNIT_ASSERT(extensions.contains("spx"));
-    CPPUNIT_ASSERT(extensions.contains("flac"));
-    CPPUNIT_ASSERT(extensions.contains("mp3"));
+    CPPUNIT_ASSERT(extensions.contains("oga"));
+    CPPUNIT_ASSERT(extensions.contains("opus"));
+#else
+    CPPUNIT_ASSERT(!extensions.contains("ogg"));
+#endif
+#ifdef TAGLIB_WITH_TRUEAUDIO
     CPPUNIT_ASSERT(extensions.contains("tta"));
+#else
+    CPPUNIT_ASSERT(!extensions.contains("tta"));
+#endif
+#ifdef TAGLIB_WITH_MP4
     CPPUNIT_ASSERT(extensions.contains("m4a"));
     CPPUNIT_ASSERT(extensions.contains("3g2"));
     CPPUNIT_ASSERT(extensions.contains("m4v"));
+#else
+    CPPUNIT_ASSERT(!extensions.contains("m4a"));
+#endif
+#ifdef TAGLIB_WITH_RIFF
     CPPUNIT_ASSERT(extensions.contains("wav"));
-    CPPUNIT_ASSERT(extensions.contains("oga"));
-    CPPUNIT_ASSERT(extensions.contains("ape"));
     CPPUNIT_ASSERT(extensions.contains("aiff"));
     CPPUNIT_ASSERT(extensions.contains("aifc"));
-    CPPUNIT_ASSERT(extensions.contains("wv"));
-    CPPUNIT_ASSERT(extensions.contains("opus"));
+#else
+    CPPUNIT_ASSERT(!extensions.contains("wav"));
+#endif
+#ifdef TAGLIB_WITH_MOD
     CPPUNIT_ASSERT(extensions.contains("xm"));
+#else
+    CPPUNIT_ASSERT(!extensions.contains("xm"));
+#endif
+#ifdef TAGLIB_WITH_DSF
     CPPUNIT_ASSERT(extensions.contains("dsf"));
     CPPUNIT_ASSERT(extensions.contains("dff"));
     CPPUNIT_ASSERT(extensions.contains("dsdiff"));
+#else
+    CPPUNIT_ASSERT(!extensions.contains("dsf"));
+#endif
   }
 
+#if defined(TAGLIB_WITH_VORBIS) && defined(TAGLIB_WITH_MP4)
   void testFileResolver()
   {
     {
@@ -413,6 +541,81 @@ public:
 
     FileRef::clearFileTypeResolvers();
   }
+#endif
+
+  void testParseArena()
+  {
+    auto arena = new ParseArena;
+    String s;
+    ByteVector v;
+    CPPUNIT_ASSERT(!ParseArena::isActive());
+    {
+      ParseArena::Scope scope(arena);
+      CPPUNIT_ASSERT(ParseArena::isActive());
+      s = String("arena string");
+      v = ByteVector("arena bytes");
+    }
+    CPPUNIT_ASSERT(!ParseArena::isActive());
+    const size_t size = arena->size();
+    CPPUNIT_ASSERT(size > 0);
+
+    // Values created outside of a scope do not use the arena.
+    String("heap string");
+    ByteVector("heap bytes");
+    CPPUNIT_ASSERT_EQUAL(size, arena->size());
+
+    // Scopes on other threads do not use the arena.
+    thread([arena] {
+      ParseArena::Scope scope(arena);
+      String("heap string");
+    }).join();
+    CPPUNIT_ASSERT_EQUAL(size, arena->size());
+
+    // The values keep the arena alive after the owner released it.
+    arena->release();
+    CPPUNIT_ASSERT_EQUAL(String("arena string"), s);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("arena bytes"), v);
+  }
+
+  void testArenaAllocation()
+  {
+    for(const char *name : { "rare_frames.mp3", "has-tags.m4a", "lowercase-fields.ogg",
+                             "empty.ogg", "no-tags.flac", "unsupported-extension.xx" }) {
+      const string path = testFilePath(name);
+      const FileRef heap(path.c_str());
+
+      PropertyMap properties;
+      String title;
+      {
+        const FileRef arena(path.c_str(), true, AudioProperties::Average,
+                            FileRef::ArenaAllocation);
+        CPPUNIT_ASSERT_EQUAL(heap.isNull(), arena.isNull());
+        if(arena.isNull())
+          continue;
+        properties = arena.properties();
+        title = arena.tag()->title();
+        CPPUNIT_ASSERT_EQUAL(heap.complexPropertyKeys(), arena.complexPropertyKeys());
+        CPPUNIT_ASSERT_EQUAL(heap.audioProperties()->lengthInMilliseconds(),
+                             arena.audioProperties()->lengthInMilliseconds());
+      }
+      CPPUNIT_ASSERT(heap.properties() == properties);
+      CPPUNIT_ASSERT_EQUAL(heap.tag()->title(), title);
+    }
+
+    ScopedFileCopy copy("xing", ".mp3");
+    {
+      FileRef f(copy.fileName().c_str(), true, AudioProperties::Average,
+                FileRef::ArenaAllocation);
+      f.tag()->setTitle("arena title");
+      f.tag()->setArtist("arena artist");
+      CPPUNIT_ASSERT(f.save());
+    }
+    {
+      FileRef f(copy.fileName().c_str());
+      CPPUNIT_ASSERT_EQUAL(String("arena title"), f.tag()->title());
+      CPPUNIT_ASSERT_EQUAL(String("arena artist"), f.tag()->artist());
+    }
+  }
 
 };
 
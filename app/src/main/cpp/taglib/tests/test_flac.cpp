@@ -30,6 +30,8 @@
 #include "tbytevectorlist.h"
 #include "tpropertymap.h"
 #include "tag.h"
+#include "tfilestream.h"
+#include "ttracingiostream.h"
 #include "flacfile.h"
 #include "xiphcomment.h"
 #include "id3v1tag.h"
@@ -68,6 +70,7 @@ class TestFLAC : public CppUnit::TestFixture
   CPPUNIT_TEST(testRemoveXiphField);
   CPPUNIT_TEST(testEmptySeekTable);
   CPPUNIT_TEST(testPictureStoredAfterComment);
+  CPPUNIT_TEST(testLazyPicture);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -668,6 +671,71 @@ public:
     CPPUNIT_ASSERT(fileData.startsWith(expectedData));
   }
 
+  void testLazyPicture()
+  {
+    const ByteVector picData(200000, 'x');
+
+    ScopedFileCopy copy("no-tags", ".flac");
+    {
+      FLAC::File f(copy.fileName().c_str());
+      auto pic = new FLAC::Picture;
+      pic->setData(picData);
+      pic->setType(FLAC::Picture::FrontCover);
+      pic->setMimeType("image/png");
+      f.addPicture(pic);
+      f.xiphComment(true)->setTitle("Title");
+      f.save();
+    }
+    {
+      FileStream stream(copy.fileName().c_str());
+      TracingIOStream tracing(&stream);
+      FLAC::File f(&tracing);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.tag()->title());
+
+      // The image data is not read until it is needed.
+
+      CPPUNIT_ASSERT(tracing.summary().bytesRead < 150000);
+      const List<FLAC::Picture *> pictures = f.pictureList();
+      CPPUNIT_ASSERT_EQUAL(1U, pictures.size());
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), pictures[0]->mimeType());
+      CPPUNIT_ASSERT_EQUAL(1U, f.complexPropertyCount("PICTURE"));
+      CPPUNIT_ASSERT(tracing.summary().bytesRead < 150000);
+
+      // Growing the comment moves the picture, which is still found.
+
+      f.xiphComment()->setTitle(longText(10000));
+      CPPUNIT_ASSERT(f.save());
+      CPPUNIT_ASSERT_EQUAL(picData, pictures[0]->data());
+      CPPUNIT_ASSERT_EQUAL(FLAC::Picture::FrontCover, pictures[0]->type());
+    }
+    {
+      FileStream stream(copy.fileName().c_str());
+      TracingIOStream tracing(&stream);
+      FLAC::File f(&tracing);
+      CPPUNIT_ASSERT_EQUAL(longText(10000), f.tag()->title());
+      const List<FLAC::Picture *> pictures = f.pictureList();
+      CPPUNIT_ASSERT_EQUAL(1U, pictures.size());
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), pictures[0]->mimeType());
+
+      // A picture which is removed but kept does not depend on the file, so
+      // its unread data has to be loaded by removePicture().
+
+      CPPUNIT_ASSERT(tracing.summary().bytesRead < 150000);
+      FLAC::Picture *picture = pictures[0];
+      f.removePicture(picture, false);
+      f.xiphComment()->setTitle("Title");
+      CPPUNIT_ASSERT(f.save());
+      CPPUNIT_ASSERT_EQUAL(picData, picture->data());
+      CPPUNIT_ASSERT_EQUAL(String("image/png"), picture->mimeType());
+      delete picture;
+    }
+    {
+      FLAC::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.pictureList().isEmpty());
+    }
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestFLAC);
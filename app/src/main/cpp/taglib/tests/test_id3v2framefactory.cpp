@@ -32,12 +32,18 @@
 #include "tpropertymap.h"
 #include "mpegfile.h"
 #include "flacfile.h"
+#ifdef TAGLIB_WITH_TRUEAUDIO
 #include "trueaudiofile.h"
 #include "trueaudioproperties.h"
+#endif
+#ifdef TAGLIB_WITH_RIFF
 #include "wavfile.h"
 #include "aifffile.h"
+#endif
+#ifdef TAGLIB_WITH_DSF
 #include "dsffile.h"
 #include "dsdifffile.h"
+#endif
 #include "id3v2tag.h"
 #include "id3v2frame.h"
 #include "id3v2framefactory.h"
@@ -110,11 +116,17 @@ class TestId3v2FrameFactory : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE(TestId3v2FrameFactory);
   CPPUNIT_TEST(testMPEG);
   CPPUNIT_TEST(testFLAC);
+#ifdef TAGLIB_WITH_TRUEAUDIO
   CPPUNIT_TEST(testTrueAudio);
+#endif
+#ifdef TAGLIB_WITH_RIFF
   CPPUNIT_TEST(testWAV);
   CPPUNIT_TEST(testAIFF);
+#endif
+#ifdef TAGLIB_WITH_DSF
   CPPUNIT_TEST(testDSF);
   CPPUNIT_TEST(testDSDIFF);
+#endif
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -254,6 +266,7 @@ public:
     );
   }
 
+#ifdef TAGLIB_WITH_TRUEAUDIO
   void testTrueAudio()
   {
     ScopedFileCopy copy("empty", ".tta");
@@ -278,7 +291,9 @@ public:
       }
     );
   }
+#endif
 
+#ifdef TAGLIB_WITH_RIFF
   void testWAV()
   {
     ScopedFileCopy copy("empty", ".wav");
@@ -303,7 +318,9 @@ public:
       }
     );
   }
+#endif
 
+#ifdef TAGLIB_WITH_RIFF
   void testAIFF()
   {
     ScopedFileCopy copy("empty", ".aiff");
@@ -328,7 +345,9 @@ public:
       }
     );
   }
+#endif
 
+#ifdef TAGLIB_WITH_DSF
   void testDSF()
   {
     ScopedFileCopy copy("empty10ms", ".dsf");
@@ -353,7 +372,9 @@ public:
       }
     );
   }
+#endif
 
+#ifdef TAGLIB_WITH_DSF
   void testDSDIFF()
   {
     ScopedFileCopy copy("empty10ms", ".dff");
@@ -378,6 +399,7 @@ public:
       }
     );
   }
+#endif
 
 };
 
@@ -23,6 +23,8 @@
  *   http://www.mozilla.org/MPL/                                           *
  ***************************************************************************/
 
+#include <utility>
+
 #include "tstring.h"
 #include "tmap.h"
 #include <cppunit/extensions/HelperMacros.h>
@@ -36,6 +38,8 @@ class TestMap : public CppUnit::TestFixture
   CPPUNIT_TEST(testInsert);
   CPPUNIT_TEST(testDetach);
   CPPUNIT_TEST(testBracedInit);
+  CPPUNIT_TEST(testOrder);
+  CPPUNIT_TEST(testConstLookup);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -91,6 +95,60 @@ public:
     CPPUNIT_ASSERT(m2.contains("SIX") && m2["SIX"] == 6);
   }
 
+  void testOrder()
+  {
+    // Both the std::map and the contiguous storage iterate in key order and
+    // keep the first of several equal keys given in an initializer list.
+    Map<String, int> m1 {
+      {"B", 2},
+      {"C", 3},
+      {"A", 1},
+      {"B", 4}
+    };
+    CPPUNIT_ASSERT_EQUAL(3U, m1.size());
+    CPPUNIT_ASSERT_EQUAL(2, m1["B"]);
+
+    m1.insert("D", 5);
+    m1["AA"] = 6;
+    m1.erase("C");
+    String keys;
+    int sum = 0;
+    for(const auto &[key, value] : std::as_const(m1)) {
+      keys += key;
+      sum += value;
+    }
+    CPPUNIT_ASSERT_EQUAL(String("AAABD"), keys);
+    CPPUNIT_ASSERT_EQUAL(14, sum);
+    CPPUNIT_ASSERT(m1.find("C") == m1.end());
+    CPPUNIT_ASSERT_EQUAL(6, m1.value("AA"));
+
+    Map<const String, int> m2;
+    m2.insert("Y", 1);
+    m2.insert("X", 2);
+    CPPUNIT_ASSERT_EQUAL(String("X"), m2.begin()->first);
+  }
+
+  void testConstLookup()
+  {
+    // A missing key must not be inserted into the entries shared with m2.
+    Map<String, int> m1 {
+      {"A", 1},
+      {"C", 3}
+    };
+    const Map<String, int> m2 = m1;
+    const auto begin = m2.begin();
+    const auto end = m2.end();
+
+    CPPUNIT_ASSERT_EQUAL(0, std::as_const(m1)["B"]);
+    CPPUNIT_ASSERT_EQUAL(2U, m1.size());
+    CPPUNIT_ASSERT_EQUAL(2U, m2.size());
+    CPPUNIT_ASSERT(!m2.contains("B"));
+    CPPUNIT_ASSERT(begin == m2.begin());
+    CPPUNIT_ASSERT(end == m2.end());
+    CPPUNIT_ASSERT_EQUAL(String("A"), begin->first);
+    CPPUNIT_ASSERT_EQUAL(1, begin->second);
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestMap);
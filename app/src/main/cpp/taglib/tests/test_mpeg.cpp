@@ -25,9 +25,12 @@
 
 #include <string>
 #include <cstdio>
+#include <cstdlib>
 #include <array>
 
 #include "tstring.h"
+#include "tfilestream.h"
+#include "ttracingiostream.h"
 #include "tpropertymap.h"
 #include "mpegfile.h"
 #include "id3v2tag.h"
@@ -37,6 +40,7 @@
 #include "xingheader.h"
 #include "mpegheader.h"
 #include "id3v2extendedheader.h"
+#include "plainfile.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -51,6 +55,8 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testAudioPropertiesVBRIHeader);
   CPPUNIT_TEST(testAudioPropertiesNoVBRHeaders);
   CPPUNIT_TEST(testAudioPropertiesADTS);
+  CPPUNIT_TEST(testAudioPropertiesHeaderOnly);
+  CPPUNIT_TEST(testAudioPropertiesHeaderOnlyXingHeader);
   CPPUNIT_TEST(testSkipInvalidFrames1);
   CPPUNIT_TEST(testSkipInvalidFrames2);
   CPPUNIT_TEST(testSkipInvalidFrames3);
@@ -68,7 +74,9 @@ class TestMPEG : public CppUnit::TestFixture
   CPPUNIT_TEST(testEmptyID3v2);
   CPPUNIT_TEST(testEmptyID3v1);
   CPPUNIT_TEST(testEmptyAPE);
+  CPPUNIT_TEST(testAPEBeforeLyrics3v2);
   CPPUNIT_TEST(testIgnoreGarbage);
+  CPPUNIT_TEST(testGarbageWithFalseSyncs);
   CPPUNIT_TEST(testExtendedHeader);
   CPPUNIT_TEST(testReadStyleFast);
   CPPUNIT_TEST_SUITE_END();
@@ -133,6 +141,40 @@ public:
     CPPUNIT_ASSERT_EQUAL(209, lastHeader.frameLength());
   }
 
+  void testAudioPropertiesHeaderOnly()
+  {
+    {
+      MPEG::File f(TEST_FILE_PATH_C("bladeenc.mp3"));
+      CPPUNIT_ASSERT_EQUAL(3553, f.audioProperties()->lengthInMilliseconds());
+      CPPUNIT_ASSERT_EQUAL(AudioProperties::Exact, f.audioProperties()->lengthAccuracy());
+      CPPUNIT_ASSERT_EQUAL(AudioProperties::Exact, f.audioProperties()->bitrateAccuracy());
+    }
+    {
+      FileStream stream(TEST_FILE_PATH_C("bladeenc.mp3"), true);
+      TracingIOStream tracing(&stream);
+      MPEG::File f(&tracing, true, MPEG::Properties::HeaderOnly);
+      CPPUNIT_ASSERT(f.audioProperties());
+      CPPUNIT_ASSERT_EQUAL(3, f.audioProperties()->lengthInSeconds());
+      CPPUNIT_ASSERT(abs(f.audioProperties()->lengthInMilliseconds() - 3553) < 100);
+      CPPUNIT_ASSERT_EQUAL(64, f.audioProperties()->bitrate());
+      CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+      CPPUNIT_ASSERT_EQUAL(AudioProperties::Estimated, f.audioProperties()->lengthAccuracy());
+      CPPUNIT_ASSERT_EQUAL(AudioProperties::Exact, f.audioProperties()->bitrateAccuracy());
+      // The only read at the end of the file is the lookup of the tags.
+      CPPUNIT_ASSERT_EQUAL(1U, tracing.summary().tailReads);
+    }
+  }
+
+  void testAudioPropertiesHeaderOnlyXingHeader()
+  {
+    MPEG::File f(TEST_FILE_PATH_C("lame_vbr.mp3"), true, MPEG::Properties::HeaderOnly);
+    CPPUNIT_ASSERT(f.audioProperties());
+    CPPUNIT_ASSERT_EQUAL(1887164, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(70, f.audioProperties()->bitrate());
+    CPPUNIT_ASSERT_EQUAL(AudioProperties::Exact, f.audioProperties()->lengthAccuracy());
+    CPPUNIT_ASSERT_EQUAL(AudioProperties::Exact, f.audioProperties()->bitrateAccuracy());
+  }
+
   void testAudioPropertiesADTS()
   {
     const std::array readStyles = {
@@ -538,6 +580,38 @@ public:
     }
   }
 
+  void testAPEBeforeLyrics3v2()
+  {
+    ScopedFileCopy copy("ape-id3v1", ".mp3");
+
+    // Audio, APE, Lyrics3v2 and ID3v1, as written by some older taggers.
+    const ByteVector lyrics3("LYRICSBEGININD0000210LYR00009[00:01]La000038LYRICS200");
+    String title;
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.hasAPETag());
+      CPPUNIT_ASSERT(f.hasID3v1Tag());
+      title = f.APETag()->title();
+      f.insert(lyrics3, f.length() - 128);
+    }
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.hasAPETag());
+      CPPUNIT_ASSERT(f.hasID3v1Tag());
+      CPPUNIT_ASSERT_EQUAL(title, f.APETag()->title());
+      f.APETag()->setTitle("Lyrics3v2");
+      f.save(MPEG::File::APE, File::StripNone);
+    }
+    {
+      MPEG::File f(copy.fileName().c_str());
+      CPPUNIT_ASSERT(f.hasAPETag());
+      CPPUNIT_ASSERT(f.hasID3v1Tag());
+      CPPUNIT_ASSERT_EQUAL(String("Lyrics3v2"), f.APETag()->title());
+      f.seek(-128 - static_cast<offset_t>(lyrics3.size()), File::End);
+      CPPUNIT_ASSERT_EQUAL(lyrics3, f.readBlock(lyrics3.size()));
+    }
+  }
+
   void testIgnoreGarbage()
   {
     const ScopedFileCopy copy("garbage", ".mp3");
@@ -559,6 +633,32 @@ public:
     }
   }
 
+  void testGarbageWithFalseSyncs()
+  {
+    // 1 MiB in front of the tag, with an invalid frame sync every 64 bytes.
+    ByteVector garbage(1024 * 1024, 'x');
+    for(unsigned int i = 0; i < garbage.size(); i += 64) {
+      garbage[i] = '\xFF';
+      garbage[i + 1] = '\xE0';
+    }
+
+    const ScopedFileCopy copy("garbage", ".mp3");
+    {
+      PlainFile file(copy.fileName().c_str());
+      file.insert(garbage, 0, 0);
+    }
+    {
+      FileStream stream(copy.fileName().c_str());
+      TracingIOStream tracing(&stream);
+      MPEG::File f(&tracing, true, MPEG::Properties::Average);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT(f.hasID3v2Tag());
+      CPPUNIT_ASSERT_EQUAL(String("Title A"), f.ID3v2Tag()->title());
+      // The garbage is read once, not again after every rejected sync.
+      CPPUNIT_ASSERT(tracing.summary().bytesRead < 2 * garbage.size());
+    }
+  }
+
   void testExtendedHeader()
   {
     const ScopedFileCopy copy("extended-header", ".mp3");
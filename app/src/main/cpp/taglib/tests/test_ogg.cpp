@@ -48,6 +48,7 @@ class TestOGG : public CppUnit::TestFixture
   CPPUNIT_TEST(testDictInterface1);
   CPPUNIT_TEST(testDictInterface2);
   CPPUNIT_TEST(testAudioProperties);
+  CPPUNIT_TEST(testAudioPropertiesHeaderOnly);
   CPPUNIT_TEST(testPageChecksum);
   CPPUNIT_TEST(testPageGranulePosition);
   CPPUNIT_TEST_SUITE_END();
@@ -201,6 +202,23 @@ public:
     CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->bitrateMinimum());
   }
 
+  void testAudioPropertiesHeaderOnly()
+  {
+    Ogg::Vorbis::File f(TEST_FILE_PATH_C("empty.ogg"), true, Ogg::Vorbis::Properties::HeaderOnly);
+    CPPUNIT_ASSERT(f.audioProperties());
+    CPPUNIT_ASSERT_EQUAL(112, f.audioProperties()->bitrate());
+    CPPUNIT_ASSERT_EQUAL(2, f.audioProperties()->channels());
+    CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+    CPPUNIT_ASSERT_EQUAL(112000, f.audioProperties()->bitrateNominal());
+    // The length is estimated from the nominal bitrate and the size of the
+    // audio pages.  The silence in this file is coded with far fewer bits,
+    // so the estimate is much shorter than the exact 3685 ms.
+    CPPUNIT_ASSERT_EQUAL(30, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->lengthInSeconds());
+    CPPUNIT_ASSERT_EQUAL(AudioProperties::Estimated, f.audioProperties()->lengthAccuracy());
+    CPPUNIT_ASSERT_EQUAL(AudioProperties::Estimated, f.audioProperties()->bitrateAccuracy());
+  }
+
   void testPageChecksum()
   {
     ScopedFileCopy copy("empty", ".ogg");
@@ -40,6 +40,7 @@ class TestOpus : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestOpus);
   CPPUNIT_TEST(testAudioProperties);
+  CPPUNIT_TEST(testAudioPropertiesHeaderOnly);
   CPPUNIT_TEST(testReadComments);
   CPPUNIT_TEST(testWriteComments);
   CPPUNIT_TEST(testSplitPackets);
@@ -60,6 +61,19 @@ public:
     CPPUNIT_ASSERT_EQUAL(1, f.audioProperties()->opusVersion());
   }
 
+  void testAudioPropertiesHeaderOnly()
+  {
+    Ogg::Opus::File f(TEST_FILE_PATH_C("correctness_gain_silent_output.opus"), true,
+                      Ogg::Opus::Properties::HeaderOnly);
+    CPPUNIT_ASSERT(f.audioProperties());
+    CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->bitrate());
+    CPPUNIT_ASSERT_EQUAL(1, f.audioProperties()->channels());
+    CPPUNIT_ASSERT_EQUAL(48000, f.audioProperties()->sampleRate());
+    CPPUNIT_ASSERT_EQUAL(AudioProperties::Unknown, f.audioProperties()->lengthAccuracy());
+    CPPUNIT_ASSERT_EQUAL(AudioProperties::Unknown, f.audioProperties()->bitrateAccuracy());
+  }
+
   void testReadComments()
   {
     Ogg::Opus::File f(TEST_FILE_PATH_C("correctness_gain_silent_output.opus"));
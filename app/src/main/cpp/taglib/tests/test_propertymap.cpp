@@ -26,11 +26,17 @@
 #include "tpropertymap.h"
 #include "tag.h"
 #include "apetag.h"
+#ifdef TAGLIB_WITH_ASF
 #include "asftag.h"
+#endif
 #include "id3v1tag.h"
 #include "id3v2tag.h"
+#ifdef TAGLIB_WITH_RIFF
 #include "infotag.h"
+#endif
+#ifdef TAGLIB_WITH_MP4
 #include "mp4tag.h"
+#endif
 #include "xiphcomment.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -42,11 +48,17 @@ class TestPropertyMap : public CppUnit::TestFixture
   CPPUNIT_TEST_SUITE(TestPropertyMap);
   CPPUNIT_TEST(testInvalidKeys);
   CPPUNIT_TEST(testGetSetApe);
+#ifdef TAGLIB_WITH_ASF
   CPPUNIT_TEST(testGetSetAsf);
+#endif
   CPPUNIT_TEST(testGetSetId3v1);
   CPPUNIT_TEST(testGetSetId3v2);
+#ifdef TAGLIB_WITH_RIFF
   CPPUNIT_TEST(testGetSetInfo);
+#endif
+#ifdef TAGLIB_WITH_MP4
   CPPUNIT_TEST(testGetSetMp4);
+#endif
   CPPUNIT_TEST(testGetSetXiphComment);
   CPPUNIT_TEST(testGetSet);
   CPPUNIT_TEST_SUITE_END();
@@ -151,20 +163,26 @@ public:
     tagGetSet<APE::Tag>();
   }
 
+#ifdef TAGLIB_WITH_ASF
   void testGetSetAsf()
   {
     tagGetSet<ASF::Tag>();
   }
+#endif
 
+#ifdef TAGLIB_WITH_MP4
   void testGetSetMp4()
   {
     tagGetSet<MP4::Tag>();
   }
+#endif
 
+#ifdef TAGLIB_WITH_RIFF
   void testGetSetInfo()
   {
     tagGetSet<RIFF::Info::Tag>();
   }
+#endif
 
   void testGetSet()
   {
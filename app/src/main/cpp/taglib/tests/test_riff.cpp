@@ -27,8 +27,11 @@
 #include <cstdio>
 
 #include "tbytevectorlist.h"
+#include "tbytevectorstream.h"
+#include "ttracingiostream.h"
 #include "tag.h"
 #include "rifffile.h"
+#include "plainfile.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
 
@@ -41,6 +44,9 @@ public:
   PublicRIFF(FileName file) : RIFF::File(file, BigEndian)
   {
   }
+  PublicRIFF(IOStream *stream) : RIFF::File(stream, BigEndian)
+  {
+  }
   unsigned int riffSize()
   {
     return RIFF::File::riffSize();
@@ -89,6 +95,8 @@ public:
   }
   void removeChunk(unsigned int i) { RIFF::File::removeChunk(i); }
   void removeChunk(const ByteVector &name) { RIFF::File::removeChunk(name); }
+  void beginChunkUpdates() { RIFF::File::beginChunkUpdates(); }
+  void commitChunkUpdates() { RIFF::File::commitChunkUpdates(); }
 };
 
 class TestRIFF : public CppUnit::TestFixture
@@ -99,6 +107,8 @@ class TestRIFF : public CppUnit::TestFixture
   CPPUNIT_TEST(testLastChunkAtEvenPosition2);
   CPPUNIT_TEST(testLastChunkAtEvenPosition3);
   CPPUNIT_TEST(testChunkOffset);
+  CPPUNIT_TEST(testChunkUpdates);
+  CPPUNIT_TEST(testPaddingChunk);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -325,6 +335,100 @@ public:
     CPPUNIT_ASSERT_EQUAL(ByteVector("TEST"), f.readBlock(4));
   }
 
+  void testChunkUpdates()
+  {
+    const ByteVector data(0x400, ' ');
+
+    // The same changes made one by one and collected must give the same file.
+
+    ByteVector expected;
+    {
+      ScopedFileCopy copy("empty", ".aiff");
+      {
+        PublicRIFF f(copy.fileName().c_str());
+        f.setChunkData(0, data);
+        f.removeChunk("TEST");
+        f.setChunkData("NEW ", "abc");
+      }
+      expected = PlainFile(copy.fileName().c_str()).readAll();
+    }
+
+    ScopedFileCopy copy("empty", ".aiff");
+    {
+      PublicRIFF f(copy.fileName().c_str());
+      f.beginChunkUpdates();
+      f.setChunkData(0, data);
+      f.removeChunk("TEST");
+      f.setChunkData("NEW ", "abc");
+      CPPUNIT_ASSERT_EQUAL(3U, f.chunkCount());
+      CPPUNIT_ASSERT_EQUAL(data, f.chunkData(0));
+      CPPUNIT_ASSERT_EQUAL(ByteVector("abc"), f.chunkData(2));
+      CPPUNIT_ASSERT_EQUAL(5928U, f.riffSize());
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(5936), f.length());
+      f.commitChunkUpdates();
+
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0x000C + 8), f.chunkOffset(0));
+      CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0x0414 + 8), f.chunkOffset(1));
+      CPPUNIT_ASSERT_EQUAL(ByteVector("NEW "), f.chunkName(2));
+      f.seek(f.chunkOffset(2) - 8);
+      CPPUNIT_ASSERT_EQUAL(ByteVector("NEW "), f.readBlock(4));
+      CPPUNIT_ASSERT_EQUAL(static_cast<unsigned int>(expected.size() - 8), f.riffSize());
+    }
+    CPPUNIT_ASSERT(expected == PlainFile(copy.fileName().c_str()).readAll());
+  }
+
+  void testPaddingChunk()
+  {
+    ByteVector data("FORM");
+    data.append(ByteVector::fromUInt(4 + 12 + 108 + 1008));
+    data.append("AIFF");
+    data.append("COMM").append(ByteVector::fromUInt(4)).append("abcd");
+    data.append("JUNK").append(ByteVector::fromUInt(100)).append(ByteVector(100, '\0'));
+    data.append("SSND").append(ByteVector::fromUInt(1000)).append(ByteVector(1000, 'x'));
+
+    ByteVectorStream stream(data);
+    TracingIOStream tracing(&stream);
+    PublicRIFF f(&tracing);
+    CPPUNIT_ASSERT_EQUAL(3U, f.chunkCount());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(140), f.chunkOffset(2));
+
+    // Growing and shrinking the first chunk resizes the padding chunk, the
+    // audio data is neither moved nor rewritten.
+
+    f.setChunkData(0, ByteVector(40, 'a'));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(20), f.chunkOffset(0));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(68), f.chunkOffset(1));
+    CPPUNIT_ASSERT_EQUAL(64U, f.chunkDataSize(1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(140), f.chunkOffset(2));
+
+    f.setChunkData(0, ByteVector());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(28), f.chunkOffset(1));
+    CPPUNIT_ASSERT_EQUAL(104U, f.chunkDataSize(1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(140), f.chunkOffset(2));
+
+    CPPUNIT_ASSERT(tracing.summary().bytesWritten < 1000);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1140), f.length());
+    CPPUNIT_ASSERT_EQUAL(1132U, f.riffSize());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(1000, 'x'), f.chunkData(2));
+
+    // Without enough room in the padding chunk the audio data is moved once.
+
+    tracing.reset();
+    f.setChunkData(0, ByteVector(200, 'b'));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(228), f.chunkOffset(1));
+    CPPUNIT_ASSERT_EQUAL(104U, f.chunkDataSize(1));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(340), f.chunkOffset(2));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(1000, 'x'), f.chunkData(2));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(1340), f.length());
+
+    stream.seek(0);
+    PublicRIFF reread(&stream);
+    CPPUNIT_ASSERT_EQUAL(3U, reread.chunkCount());
+    CPPUNIT_ASSERT_EQUAL(ByteVector(200, 'b'), reread.chunkData(0));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("JUNK"), reread.chunkName(1));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(1000, 'x'), reread.chunkData(2));
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestRIFF);
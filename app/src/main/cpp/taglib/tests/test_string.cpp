@@ -54,6 +54,10 @@ class TestString : public CppUnit::TestFixture
   CPPUNIT_TEST(testEncodeNonBMP);
   CPPUNIT_TEST(testIterator);
   CPPUNIT_TEST(testInvalidUTF8);
+  CPPUNIT_TEST(testUTF8LongRuns);
+  CPPUNIT_TEST(testCompactStorage);
+  CPPUNIT_TEST(testCompactAndWide);
+  CPPUNIT_TEST(testCompactFind);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -371,6 +375,145 @@ public:
     CPPUNIT_ASSERT(String(ByteVector("\xED\xB0\x80\xED\xA0\x80"), String::UTF8).isEmpty());
   }
 
+  void testUTF8LongRuns()
+  {
+    // Long enough to go through the block-wise ASCII paths.
+    const string ascii(100, 'a');
+
+    const string mixed = ascii + "\xf0\x9f\x8e\xb5" + ascii + "\xe9\x9f\xb3\xe6\xa5\xbd" + ascii;
+    const String s(mixed, String::UTF8);
+    CPPUNIT_ASSERT_EQUAL(304U, s.size());
+    CPPUNIT_ASSERT_EQUAL(L'\xd83c', s[100]);
+    CPPUNIT_ASSERT_EQUAL(L'\xdfb5', s[101]);
+    CPPUNIT_ASSERT_EQUAL(L'\x97f3', s[202]);
+    CPPUNIT_ASSERT_EQUAL(mixed, s.to8Bit(true));
+    CPPUNIT_ASSERT_EQUAL(ByteVector(mixed.c_str()), s.data(String::UTF8));
+
+    for(size_t i : { 0, 7, 8, 15, 16, 17, 70, 99 }) {
+      string invalid = ascii;
+      invalid[i] = '\x80';
+      CPPUNIT_ASSERT(String(invalid, String::UTF8).isEmpty());
+      invalid[i] = '\xe9';
+      CPPUNIT_ASSERT(String(invalid, String::UTF8).isEmpty());
+    }
+
+    // Sequences cut off at the end of the input.
+    CPPUNIT_ASSERT(String(ascii + "\xf0\x9f\x8e", String::UTF8).isEmpty());
+    CPPUNIT_ASSERT(String(ascii + "\xe9\x9f", String::UTF8).isEmpty());
+
+    // Unpaired surrogates can not be encoded.
+    wstring lead(ascii.begin(), ascii.end());
+    lead += L'\xd83c';
+    CPPUNIT_ASSERT(String(lead).to8Bit(true).empty());
+    CPPUNIT_ASSERT(String(lead).data(String::UTF8).isEmpty());
+    wstring trail(ascii.begin(), ascii.end());
+    trail.insert(50, 1, L'\xdfb5');
+    CPPUNIT_ASSERT(String(trail).to8Bit(true).empty());
+  }
+
+  void testCompactStorage()
+  {
+    const String ascii("plain ascii", String::UTF8);
+    CPPUNIT_ASSERT(ascii.isAscii());
+    CPPUNIT_ASSERT_EQUAL(ascii.toCString(false), ascii.toCString(true));
+    CPPUNIT_ASSERT_EQUAL(ascii.data(String::Latin1), ascii.data(String::UTF8));
+
+    const String latin1(ByteVector("caf\xe9"), String::Latin1);
+    CPPUNIT_ASSERT(latin1.isLatin1());
+    CPPUNIT_ASSERT(!latin1.isAscii());
+    CPPUNIT_ASSERT_EQUAL(ByteVector("caf\xe9"), latin1.data(String::Latin1));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("caf\xc3\xa9"), latin1.data(String::UTF8));
+    CPPUNIT_ASSERT_EQUAL(string("caf\xc3\xa9"), latin1.to8Bit(true));
+    CPPUNIT_ASSERT_EQUAL(ByteVector("c\0a\0f\0\xe9\0", 8), latin1.data(String::UTF16LE));
+    CPPUNIT_ASSERT_EQUAL(String(L"caf\u00e9"), latin1);
+    CPPUNIT_ASSERT_EQUAL(String("caf\xc3\xa9", String::UTF8), latin1);
+    CPPUNIT_ASSERT(latin1 == L"caf\u00e9");
+    CPPUNIT_ASSERT(latin1 == "caf\xe9");
+    CPPUNIT_ASSERT_EQUAL(L'\u00e9', latin1[3]);
+    CPPUNIT_ASSERT(wcscmp(L"caf\u00e9", latin1.toCWString()) == 0);
+
+    const String nulTerminated(ByteVector("ab\0\xe9", 4), String::Latin1);
+    CPPUNIT_ASSERT_EQUAL(String("ab"), nulTerminated);
+    CPPUNIT_ASSERT(nulTerminated.isAscii());
+
+    CPPUNIT_ASSERT_EQUAL(String("\xe9t\xe9"), String(" \t\xe9t\xe9\n").stripWhiteSpace());
+    CPPUNIT_ASSERT_EQUAL(String("CAF\xe9"), latin1.upper());
+    CPPUNIT_ASSERT_EQUAL(String("f\xe9"), latin1.substr(2));
+    CPPUNIT_ASSERT(String("caf").substr(0, 2).isAscii());
+    CPPUNIT_ASSERT_EQUAL(-42, String("-42").toInt());
+  }
+
+  void testCompactAndWide()
+  {
+    const String latin1("abc\xe9");
+    const String wide(L"abc\u20ac");
+    CPPUNIT_ASSERT(!wide.isLatin1());
+
+    // Mutable access switches to UTF-16 without changing the value.
+    String promoted("abc\xe9");
+    CPPUNIT_ASSERT(promoted.begin() != promoted.end());
+    CPPUNIT_ASSERT_EQUAL(latin1, promoted);
+    CPPUNIT_ASSERT(promoted.isLatin1());
+    CPPUNIT_ASSERT(!(latin1 < promoted));
+    CPPUNIT_ASSERT(!(promoted < latin1));
+    CPPUNIT_ASSERT(latin1 < wide);
+    CPPUNIT_ASSERT(!(wide < latin1));
+    CPPUNIT_ASSERT(wide < String("abd"));
+    CPPUNIT_ASSERT_EQUAL(1, wide.find("bc"));
+    CPPUNIT_ASSERT_EQUAL(1, promoted.find("bc"));
+    CPPUNIT_ASSERT_EQUAL(-1, latin1.find(wide));
+
+    String s("abc");
+    s += L'\u00e9';
+    CPPUNIT_ASSERT_EQUAL(latin1, s);
+    CPPUNIT_ASSERT(!s.isAscii());
+    s += L'\u20ac';
+    CPPUNIT_ASSERT(!s.isLatin1());
+    s += "\xe9";
+    s += latin1;
+    CPPUNIT_ASSERT_EQUAL(String(L"abc\u00e9\u20ac\u00e9abc\u00e9"), s);
+    CPPUNIT_ASSERT_EQUAL(string("abc\xc3\xa9\xe2\x82\xac\xc3\xa9" "abc\xc3\xa9"),
+                         s.to8Bit(true));
+
+    String t("x");
+    t += wide;
+    t += L"\u00e9";
+    CPPUNIT_ASSERT_EQUAL(String(L"xabc\u20ac\u00e9"), t);
+
+    // A Latin-1 string appended to itself.
+    String u("\xe9");
+    u += u;
+    CPPUNIT_ASSERT_EQUAL(String("\xe9\xe9"), u);
+    CPPUNIT_ASSERT_EQUAL(string("\xe9\xe9"), string(u.toCString()));
+  }
+
+  void testCompactFind()
+  {
+    // Searches where only one side is stored as Latin-1 give the same results
+    // as searching the UTF-16 forms.
+    const String latin1("ab\xe9" "ab\xe9");
+    const String wide(L"\u20ac\u00e9ab\u20ac");
+    const String patterns[] = {
+      String(), String("ab"), String("\xe9"), String(L"\u00e9ab\u20ac"),
+      String(L"\u20ac"), String("ab\xe9" "ab\xe9" "a")
+    };
+    const int offsets[] = { -1, 0, 1, 3, 5, 6, 7 };
+    for(const auto &text : { latin1, wide }) {
+      const wstring w = text.toWString();
+      for(const auto &pattern : patterns) {
+        const wstring p = pattern.toWString();
+        for(int offset : offsets) {
+          if(offset >= 0)
+            CPPUNIT_ASSERT_EQUAL(static_cast<int>(w.find(p, offset)), text.find(pattern, offset));
+          CPPUNIT_ASSERT_EQUAL(static_cast<int>(w.rfind(p, offset)), text.rfind(pattern, offset));
+        }
+      }
+    }
+
+    CPPUNIT_ASSERT_EQUAL(static_cast<wchar_t>(0xe9), latin1[2]);
+    CPPUNIT_ASSERT_EQUAL(static_cast<wchar_t>(0x20ac), wide[0]);
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(TestString);
@@ -0,0 +1,224 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+// These tests are most useful when built with ENABLE_THREAD_SANITIZER.
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "tag_c.h"
+#include "tstring.h"
+#include "tstringlist.h"
+#include "tpropertymap.h"
+#include "tvariant.h"
+#include "fileref.h"
+#include "tag.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+namespace
+{
+  unsigned int threadCount()
+  {
+    return max(4U, thread::hardware_concurrency());
+  }
+
+  vector<string> corpus()
+  {
+    vector<string> files;
+    for(const auto &entry : filesystem::directory_iterator(TESTS_DIR "data")) {
+      if(entry.is_regular_file())
+        files.push_back(entry.path().string());
+    }
+    sort(files.begin(), files.end());
+    return files;
+  }
+
+  // Reads everything FileRef offers and folds it into a number, which has to
+  // be the same in every thread.
+  size_t parse(const string &path)
+  {
+    FileRef f(path.c_str());
+    if(f.isNull())
+      return 0;
+
+    size_t result = 1;
+    if(const Tag *tag = f.tag()) {
+      result += ::strlen(tag->title().toCString(true)) + ::strlen(tag->artist().toCString());
+      result += tag->album().size() + tag->year() + tag->track();
+    }
+    for(const auto &[key, values] : f.properties()) {
+      result += ::strlen(key.toCString());
+      for(const auto &value : values)
+        result += ::strlen(value.toCString(true));
+    }
+    for(const auto &key : f.complexPropertyKeys()) {
+      for(const auto &property : f.complexProperties(key))
+        result += property.size();
+    }
+    if(const AudioProperties *properties = f.audioProperties())
+      result += properties->lengthInMilliseconds() + properties->sampleRate();
+    return result;
+  }
+
+  class NullResolver : public FileRef::FileTypeResolver
+  {
+  public:
+    File *createFile(FileName, bool, AudioProperties::ReadStyle) const override
+    {
+      return nullptr;
+    }
+  };
+}  // namespace
+
+class TestThreads : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestThreads);
+  CPPUNIT_TEST(testParseCorpus);
+  CPPUNIT_TEST(testSharedString);
+  CPPUNIT_TEST(testFileTypeResolvers);
+  CPPUNIT_TEST(testCStrings);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testParseCorpus()
+  {
+    const vector<string> files = corpus();
+    CPPUNIT_ASSERT(!files.empty());
+
+    vector<size_t> expected(files.size());
+    for(size_t i = 0; i < files.size(); ++i)
+      expected[i] = parse(files[i]);
+
+    // Every thread parses the whole corpus, starting at a different file so
+    // that different formats are parsed at the same time.
+    const unsigned int count = threadCount();
+    vector<vector<size_t>> results(count, vector<size_t>(files.size()));
+    vector<thread> threads;
+    for(unsigned int t = 0; t < count; ++t) {
+      threads.emplace_back([&, t] {
+        for(size_t k = 0; k < files.size(); ++k) {
+          const size_t i = (k + t * files.size() / count) % files.size();
+          results[t][i] = parse(files[i]);
+        }
+      });
+    }
+    for(auto &thread : threads)
+      thread.join();
+
+    for(const auto &result : results)
+      CPPUNIT_ASSERT(result == expected);
+  }
+
+  void testSharedString()
+  {
+    const String shared(L"Ä shared string");
+    vector<thread> threads;
+    atomic<unsigned int> failures(0);
+    for(unsigned int t = 0; t < threadCount(); ++t) {
+      threads.emplace_back([&shared, &failures, t] {
+        const String copy = shared;
+        for(int i = 0; i < 1000; ++i) {
+          const bool unicode = ((i + t) % 2) == 0;
+          const String &s = (i % 3) == 0 ? shared : copy;
+          if(s.toCString(unicode) != s.to8Bit(unicode))
+            ++failures;
+        }
+      });
+    }
+    for(auto &thread : threads)
+      thread.join();
+
+    CPPUNIT_ASSERT_EQUAL(0U, failures.load());
+  }
+
+  void testFileTypeResolvers()
+  {
+    const NullResolver resolver;
+    atomic<bool> done(false);
+
+    thread writer([&] {
+      while(!done) {
+        FileRef::addFileTypeResolver(&resolver);
+        FileRef::clearFileTypeResolvers();
+      }
+    });
+
+    vector<thread> readers;
+    atomic<unsigned int> failures(0);
+    for(unsigned int t = 0; t < threadCount(); ++t) {
+      readers.emplace_back([&failures] {
+        for(int i = 0; i < 100; ++i) {
+          if(FileRef(TEST_FILE_PATH_C("xing.mp3")).isNull())
+            ++failures;
+        }
+      });
+    }
+    for(auto &thread : readers)
+      thread.join();
+    done = true;
+    writer.join();
+
+    FileRef::clearFileTypeResolvers();
+    CPPUNIT_ASSERT_EQUAL(0U, failures.load());
+  }
+
+  void testCStrings()
+  {
+    const string path = testFilePath("extended-header.mp3");
+    const string album = FileRef(path.c_str()).tag()->album().to8Bit(true);
+    CPPUNIT_ASSERT(!album.empty());
+
+    vector<thread> threads;
+    atomic<unsigned int> failures(0);
+    for(unsigned int t = 0; t < threadCount(); ++t) {
+      threads.emplace_back([&path, &album, &failures] {
+        for(int i = 0; i < 50; ++i) {
+          TagLib_File *file = taglib_file_new(path.c_str());
+          if(!file) {
+            ++failures;
+            continue;
+          }
+          const TagLib_Tag *tag = taglib_file_tag(file);
+          if(taglib_tag_album(tag) != album)
+            ++failures;
+          taglib_tag_title(tag);
+          taglib_tag_free_strings();
+          taglib_file_free(file);
+        }
+      });
+    }
+    for(auto &thread : threads)
+      thread.join();
+
+    CPPUNIT_ASSERT_EQUAL(0U, failures.load());
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestThreads);
@@ -0,0 +1,159 @@
+/***************************************************************************
+ *   This library is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU Lesser General Public License version   *
+ *   2.1 as published by the Free Software Foundation.                     *
+ *                                                                         *
+ *   This library is distributed in the hope that it will be useful, but   *
+ *   WITHOUT ANY WARRANTY; without even the implied warranty of            *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU     *
+ *   Lesser General Public License for more details.                       *
+ *                                                                         *
+ *   You should have received a copy of the GNU Lesser General Public      *
+ *   License along with this library; if not, write to the Free Software   *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA         *
+ *   02110-1301  USA                                                       *
+ *                                                                         *
+ *   Alternatively, this file is available under the Mozilla Public        *
+ *   License Version 1.1.  You may obtain a copy of the License at         *
+ *   http://www.mozilla.org/MPL/                                           *
+ ***************************************************************************/
+
+#include "tbytevectorstream.h"
+#include "tfilestream.h"
+#include "ttracingiostream.h"
+#include "tstring.h"
+#include "mpegfile.h"
+#include <cppunit/extensions/HelperMacros.h>
+#include "utils.h"
+
+using namespace std;
+using namespace TagLib;
+
+class TestTracingIOStream : public CppUnit::TestFixture
+{
+  CPPUNIT_TEST_SUITE(TestTracingIOStream);
+  CPPUNIT_TEST(testForward);
+  CPPUNIT_TEST(testSummary);
+  CPPUNIT_TEST(testEvents);
+  CPPUNIT_TEST(testNoEvents);
+  CPPUNIT_TEST(testReset);
+  CPPUNIT_TEST(testParse);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+
+  void testForward()
+  {
+    ByteVector v("abcdefgh");
+    ByteVectorStream data(v);
+    TracingIOStream stream(&data);
+
+    CPPUNIT_ASSERT_EQUAL(&data, static_cast<ByteVectorStream *>(stream.stream()));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(8), stream.length());
+    stream.seek(2);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("cd"), stream.readBlock(2));
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4), stream.tell());
+    stream.writeBlock("xy");
+    stream.insert("12", 0, 0);
+    stream.removeBlock(8, 2);
+    stream.truncate(6);
+    CPPUNIT_ASSERT_EQUAL(ByteVector("12abcd"), *data.data());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(6), stream.length());
+  }
+
+  void testSummary()
+  {
+    ByteVector v("0123456789");
+    ByteVectorStream data(v);
+    TracingIOStream stream(&data);
+
+    stream.readBlock(4);
+    stream.seek(-2, IOStream::End);
+    stream.readBlock(4);
+    stream.seek(0);
+    stream.writeBlock("ab");
+    stream.insert("c", 5, 1);
+    stream.removeBlock(0, 1);
+    stream.truncate(3);
+
+    const TracingIOStream::Summary s = stream.summary();
+    CPPUNIT_ASSERT_EQUAL(2U, s.seekCount);
+    CPPUNIT_ASSERT_EQUAL(2U, s.readCount);
+    CPPUNIT_ASSERT_EQUAL(1U, s.writeCount);
+    CPPUNIT_ASSERT_EQUAL(1U, s.insertCount);
+    CPPUNIT_ASSERT_EQUAL(1U, s.removeCount);
+    CPPUNIT_ASSERT_EQUAL(1U, s.truncateCount);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(6), s.bytesRead);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(3), s.bytesWritten);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4 + 10), s.seekDistance);
+    CPPUNIT_ASSERT_EQUAL(1U, s.headReads);
+    CPPUNIT_ASSERT_EQUAL(1U, s.tailReads);
+    CPPUNIT_ASSERT(s.toString().startsWith("{\"seeks\":2,\"reads\":2,"));
+  }
+
+  void testEvents()
+  {
+    ByteVector v("0123456789");
+    ByteVectorStream data(v);
+    TracingIOStream stream(&data);
+
+    stream.seek(6);
+    stream.readBlock(8);
+    stream.writeBlock("x");
+
+    const List<TracingIOStream::Event> &events = stream.events();
+    CPPUNIT_ASSERT_EQUAL(3U, events.size());
+    CPPUNIT_ASSERT_EQUAL(TracingIOStream::Seek, events[0].operation);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(6), events[0].offset);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(6), events[0].length);
+    CPPUNIT_ASSERT_EQUAL(TracingIOStream::Read, events[1].operation);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(6), events[1].offset);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(4), events[1].length);
+    CPPUNIT_ASSERT_EQUAL(TracingIOStream::Write, events[2].operation);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(10), events[2].offset);
+  }
+
+  void testNoEvents()
+  {
+    ByteVector v("0123456789");
+    ByteVectorStream data(v);
+    TracingIOStream stream(&data, false);
+
+    stream.readBlock(2);
+    CPPUNIT_ASSERT(stream.events().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(1U, stream.summary().readCount);
+  }
+
+  void testReset()
+  {
+    ByteVector v("0123456789");
+    ByteVectorStream data(v);
+    TracingIOStream stream(&data);
+
+    stream.readBlock(2);
+    stream.reset();
+    CPPUNIT_ASSERT(stream.events().isEmpty());
+    CPPUNIT_ASSERT_EQUAL(0U, stream.summary().readCount);
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(0), stream.summary().bytesRead);
+  }
+
+  void testParse()
+  {
+    FileStream file(TEST_FILE_PATH_C("xing.mp3"), true);
+    TracingIOStream stream(&file);
+    {
+      MPEG::File f(&stream);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT(f.audioProperties());
+    }
+
+    const TracingIOStream::Summary s = stream.summary();
+    CPPUNIT_ASSERT_GREATER(0U, s.readCount);
+    CPPUNIT_ASSERT_GREATER(static_cast<offset_t>(0), s.bytesRead);
+    CPPUNIT_ASSERT_EQUAL(s.readCount + s.seekCount, stream.events().size());
+    CPPUNIT_ASSERT_EQUAL(0U, s.writeCount);
+  }
+
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TestTracingIOStream);
@@ -31,6 +31,7 @@
 #include "tbytevectorlist.h"
 #include "tbytevectorstream.h"
 #include "tfilestream.h"
+#include "ttracingiostream.h"
 #include "tpropertymap.h"
 #include "wavfile.h"
 #include "plainfile.h"
@@ -53,6 +54,7 @@ class TestWAV : public CppUnit::TestFixture
   CPPUNIT_TEST(testInfoTag);
   CPPUNIT_TEST(testStripTags);
   CPPUNIT_TEST(testDuplicateTags);
+  CPPUNIT_TEST(testSaveMovesDataOnce);
   CPPUNIT_TEST(testFuzzedFile1);
   CPPUNIT_TEST(testFuzzedFile2);
   CPPUNIT_TEST(testFileWithGarbageAppended);
@@ -287,6 +289,55 @@ public:
     CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(-1), f.find("Title2"));
   }
 
+  void testSaveMovesDataOnce()
+  {
+    ID3v2::Tag id3v2;
+    id3v2.setTitle("Title");
+    RIFF::Info::Tag info;
+    info.setTitle("Title");
+
+    // Both tags are in front of the audio data.
+
+    ByteVector body("WAVE");
+    body.append("fmt ").append(ByteVector::fromUInt(16, false));
+    body.append(ByteVector::fromShort(1, false)).append(ByteVector::fromShort(1, false));
+    body.append(ByteVector::fromUInt(8000, false)).append(ByteVector::fromUInt(8000, false));
+    body.append(ByteVector::fromShort(1, false)).append(ByteVector::fromShort(8, false));
+    const ByteVector infoData = info.render();
+    body.append("LIST").append(ByteVector::fromUInt(infoData.size(), false)).append(infoData);
+    const ByteVector id3v2Data = id3v2.render();
+    body.append("ID3 ").append(ByteVector::fromUInt(id3v2Data.size(), false)).append(id3v2Data);
+    body.append("data").append(ByteVector::fromUInt(100000, false)).append(ByteVector(100000, 'x'));
+
+    ByteVector data("RIFF");
+    data.append(ByteVector::fromUInt(body.size(), false)).append(body);
+    ByteVectorStream stream(data);
+    {
+      TracingIOStream tracing(&stream);
+      RIFF::WAV::File f(&tracing);
+      CPPUNIT_ASSERT(f.isValid());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.ID3v2Tag()->title());
+      CPPUNIT_ASSERT_EQUAL(String("Title"), f.InfoTag()->title());
+
+      f.tag()->setTitle(longText(1000));
+      tracing.reset();
+      CPPUNIT_ASSERT(f.save());
+
+      // Removing and adding each tag used to move the audio data twice.
+      CPPUNIT_ASSERT(tracing.summary().bytesWritten < 110000);
+    }
+
+    stream.seek(0);
+    RIFF::WAV::File f(&stream);
+    CPPUNIT_ASSERT(f.isValid());
+    CPPUNIT_ASSERT_EQUAL(longText(1000), f.ID3v2Tag()->title());
+    CPPUNIT_ASSERT_EQUAL(longText(1000), f.InfoTag()->title());
+    CPPUNIT_ASSERT_EQUAL(100000U, f.audioProperties()->sampleFrames());
+    CPPUNIT_ASSERT_EQUAL(static_cast<offset_t>(36), f.find(ByteVector("data")));
+    f.seek(44);
+    CPPUNIT_ASSERT_EQUAL(ByteVector(100000, 'x'), f.readBlock(100000));
+  }
+
   void testFuzzedFile1()
   {
     RIFF::WAV::File f1(TEST_FILE_PATH_C("infloop.wav"));
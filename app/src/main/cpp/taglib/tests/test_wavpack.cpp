@@ -41,6 +41,7 @@ class TestWavPack : public CppUnit::TestFixture
 {
   CPPUNIT_TEST_SUITE(TestWavPack);
   CPPUNIT_TEST(testNoLengthProperties);
+  CPPUNIT_TEST(testNoLengthHeaderOnly);
   CPPUNIT_TEST(testMultiChannelProperties);
   CPPUNIT_TEST(testDsdStereoProperties);
   CPPUNIT_TEST(testNonStandardRateProperties);
@@ -67,6 +68,17 @@ public:
     CPPUNIT_ASSERT_EQUAL(1031, f.audioProperties()->version());
   }
 
+  void testNoLengthHeaderOnly()
+  {
+    WavPack::File f(TEST_FILE_PATH_C("no_length.wv"), true, WavPack::Properties::HeaderOnly);
+    CPPUNIT_ASSERT(f.audioProperties());
+    CPPUNIT_ASSERT_EQUAL(0, f.audioProperties()->lengthInMilliseconds());
+    CPPUNIT_ASSERT_EQUAL(0U, f.audioProperties()->sampleFrames());
+    CPPUNIT_ASSERT_EQUAL(2, f.audioProperties()->channels());
+    CPPUNIT_ASSERT_EQUAL(44100, f.audioProperties()->sampleRate());
+    CPPUNIT_ASSERT_EQUAL(AudioProperties::Unknown, f.audioProperties()->lengthAccuracy());
+  }
+
   void testMultiChannelProperties()
   {
     WavPack::File f(TEST_FILE_PATH_C("four_channels.wv"));
@@ -24,6 +24,8 @@
  ***************************************************************************/
 
 #include <cassert>
+#include "tfilestream.h"
+#include "ttracingiostream.h"
 #include "xmfile.h"
 #include <cppunit/extensions/HelperMacros.h>
 #include "utils.h"
@@ -111,6 +113,7 @@ class TestXM : public CppUnit::TestFixture
   CPPUNIT_TEST(testReadStrippedTags);
   CPPUNIT_TEST(testWriteTagsShort);
   CPPUNIT_TEST(testWriteTagsLong);
+  CPPUNIT_TEST(testReadSingleBlock);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -164,6 +167,19 @@ public:
     testWriteTags(newCommentLong);
   }
 
+  void testReadSingleBlock()
+  {
+    // The headers of all patterns, instruments and samples are decoded from
+    // one read of the start of the file.
+    FileStream fileStream(TEST_FILE_PATH_C("test.xm"), true);
+    TracingIOStream stream(&fileStream, false);
+    XM::File file(&stream);
+    CPPUNIT_ASSERT(file.isValid());
+    CPPUNIT_ASSERT_EQUAL(titleBefore, file.tag()->title());
+    CPPUNIT_ASSERT_EQUAL(commentBefore, file.tag()->comment());
+    CPPUNIT_ASSERT_EQUAL(1U, stream.summary().readCount);
+  }
+
 private:
   void testRead(FileName fileName, const String &title,
                 const String &comment, const String &trackerName)
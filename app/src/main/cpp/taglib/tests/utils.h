@@ -41,6 +41,8 @@
 #include <string>
 #include <fstream>
 
+#include "tbytevector.h"
+
 using namespace std;
 
 inline string testFilePath(const string &filename)
@@ -151,3 +153,45 @@ private:
   const bool m_deleteFile;
   const string m_filename;
 };
+
+#ifndef _WIN32
+
+// A new file in the temporary directory which holds data and is deleted at
+// the end of the scope.  Unlike ScopedFileCopy, the name is unique, so tests
+// running at the same time do not overwrite each other's files.
+
+class ScopedTempFile
+{
+public:
+  ScopedTempFile(const string &ext, const TagLib::ByteVector &data)
+  {
+    string name = string(P_tmpdir) + "/taglib-test-XXXXXX" + ext;
+    const int fd = ::mkstemps(&name[0], static_cast<int>(ext.size()));
+    if(fd < 0)
+      return;
+    ::close(fd);
+
+    ofstream out(name.c_str(), ios::binary);
+    out.write(data.data(), data.size());
+    m_filename = name;
+  }
+
+  ~ScopedTempFile()
+  {
+    if(!m_filename.empty())
+      deleteFile(m_filename);
+  }
+
+  ScopedTempFile(const ScopedTempFile &) = delete;
+  ScopedTempFile &operator=(const ScopedTempFile &) = delete;
+
+  string fileName() const
+  {
+    return m_filename;
+  }
+
+private:
+  string m_filename;
+};
+
+#endif
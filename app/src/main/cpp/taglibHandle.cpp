@@ -0,0 +1,75 @@
+#include "taglibHandle.h"
+
+#include <fcntl.h>
+
+using namespace std;
+
+namespace {
+
+    bool isReadOnly(int fd) {
+        return (fcntl(fd, F_GETFL) & O_ACCMODE) == O_RDONLY;
+    }
+}
+
+namespace handles {
+
+    File::File(int fd) :
+            fd(fd),
+            stream(fd, isReadOnly(fd), TagLib::FileStream::TakeOwnership),
+            // 与 retrieveMetadataWithFD 一样只读取文件头
+            fileRef(&stream, true, TagLib::AudioProperties::ReadStyle::HeaderOnly) {
+    }
+
+    bool File::isNull() const {
+        return fileRef.isNull();
+    }
+
+    Registry &Registry::instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    int64_t Registry::open(int fd) {
+        const int copy = fcntl(fd, F_DUPFD_CLOEXEC, 0);
+        if (copy < 0) return 0;
+
+        // 在锁外解析，避免阻塞其他句柄上的调用
+        auto file = make_shared<File>(copy);
+        if (file->isNull()) return 0;
+
+        // 声明在锁之前，被淘汰的文件在解锁之后才析构
+        shared_ptr<File> evicted;
+        lock_guard<std::mutex> lock(mutex);
+        const int64_t id = nextId++;
+        lru.emplace_front(id, std::move(file));
+        index.emplace(id, lru.begin());
+        if (lru.size() > capacity) {
+            // 正在使用中的文件由调用方的 shared_ptr 保持存活，用完后才真正关闭
+            evicted = std::move(lru.back().second);
+            index.erase(lru.back().first);
+            lru.pop_back();
+        }
+        return id;
+    }
+
+    shared_ptr<File> Registry::get(int64_t id) {
+        lock_guard<std::mutex> lock(mutex);
+        const auto it = index.find(id);
+        if (it == index.end()) return nullptr;
+
+        lru.splice(lru.begin(), lru, it->second);
+        return it->second->second;
+    }
+
+    void Registry::close(int64_t id) {
+        // 声明在锁之前，文件在解锁之后才析构
+        shared_ptr<File> file;
+        lock_guard<std::mutex> lock(mutex);
+        const auto it = index.find(id);
+        if (it == index.end()) return;
+
+        file = std::move(it->second->second);
+        lru.erase(it->second);
+        index.erase(it);
+    }
+}
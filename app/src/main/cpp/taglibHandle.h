@@ -0,0 +1,72 @@
+#ifndef TAGLIB_HANDLE_H
+#define TAGLIB_HANDLE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+
+#include <fileref.h>
+#include <tfilestream.h>
+
+namespace handles {
+
+    /**
+     * 一个已解析的文件，在多次 JNI 调用之间保留 FileRef 及其标签树
+     *
+     * 持有的是 dup 出来的文件描述符，调用方在 open 之后即可关闭原描述符。
+     * 对同一文件的调用需要持有 mutex 串行执行，TagLib 的 File 不是线程安全的。
+     */
+    struct File {
+        explicit File(int fd);
+
+        File(const File &) = delete;
+        File &operator=(const File &) = delete;
+
+        bool isNull() const;
+
+        const int fd;
+        std::mutex mutex;
+
+        // 析构顺序与声明顺序相反，FileRef 必须先于 FileStream 销毁
+        TagLib::FileStream stream;
+        TagLib::FileRef fileRef;
+    };
+
+    /**
+     * 以 64 位 id 分发句柄，id 从不复用，因此已关闭或被淘汰的句柄只会查找失败，
+     * 不会指向其他文件。同时打开的数量超过 capacity 时关闭最久未使用的句柄。
+     */
+    class Registry {
+    public:
+        static constexpr size_t DEFAULT_CAPACITY = 8;
+
+        static Registry &instance();
+
+        /**
+         * 复制并解析 fd，失败时返回 0
+         */
+        int64_t open(int fd);
+
+        /**
+         * 返回句柄对应的文件并将其标记为最近使用，句柄无效时返回空
+         */
+        std::shared_ptr<File> get(int64_t id);
+
+        void close(int64_t id);
+
+    private:
+        using Entry = std::pair<int64_t, std::shared_ptr<File>>;
+
+        std::mutex mutex;
+        std::list<Entry> lru;   // 表头为最近使用
+        std::unordered_map<int64_t, std::list<Entry>::iterator> index;
+        int64_t nextId = 1;
+        size_t capacity = DEFAULT_CAPACITY;
+    };
+}
+
+#endif //TAGLIB_HANDLE_H
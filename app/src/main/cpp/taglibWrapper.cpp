@@ -1,58 +1,65 @@
 
 #include "taglibWrapper.h"
+#include "taglibHandle.h"
 
 using namespace std;
 
-jstring toString(JNIEnv *env, TagLib::String str) {
-    return env->NewStringUTF(str.toCString(true));
+// 直接以 UTF-16 与 Java 交换字符串，省去 UTF-8 中转，且不受 Modified UTF-8 对
+// 补充平面字符（如 emoji）和 \0 的限制。Android 的 ABI 均为小端序。
+jstring toString(JNIEnv *env, const TagLib::String &str) {
+    const TagLib::ByteVector utf16 = str.data(TagLib::String::UTF16LE);
+    return env->NewString(reinterpret_cast<const jchar *>(utf16.data()),
+                          static_cast<jsize>(utf16.size() / 2));
 }
 
+// Android 上 stderr 没有输出，TagLib 的调试信息构建出来也只会被丢弃，
+// 因此关闭；解析问题改由 getDiagnostics 统计
 extern "C"
-JNIEXPORT jstring JNICALL
-Java_com_lalilu_lmedia_wrapper_Taglib_getLyricWithFD(JNIEnv *env, jobject thiz,
-                                                     jint file_descriptor) {
-    TagLib::FileStream fileStream(file_descriptor, true);
-    TagLib::FileRef fileRef(&fileStream, true, TagLib::AudioProperties::ReadStyle::Fast);
-    if (fileRef.isNull()) return env->NewStringUTF("File is not supported");
+JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved) {
+    TagLib::setDebugMessagesEnabled(false);
+    return JNI_VERSION_1_6;
+}
+
+TagLib::String fromJString(JNIEnv *env, jstring str) {
+    const jsize length = env->GetStringLength(str);
+    TagLib::ByteVector utf16(static_cast<unsigned int>(length) * 2, 0);
+    env->GetStringRegion(str, 0, length, reinterpret_cast<jchar *>(utf16.data()));
+    return {utf16, TagLib::String::UTF16LE};
+}
 
+jstring getLyric(JNIEnv *env, TagLib::FileRef &fileRef) {
     auto map = fileRef.tag()->properties();
 
     auto lyrics = map["LYRICS"];
     if (lyrics.size() > 0 && lyrics[0].size() > 0) {
-        return env->NewStringUTF(lyrics[0].toCString(true));
+        return toString(env, lyrics[0]);
     }
     return nullptr;
 }
 
-extern "C"
-JNIEXPORT jboolean JNICALL
-Java_com_lalilu_lmedia_wrapper_Taglib_writeLyricInto(JNIEnv *env, jobject thiz,
-                                                     jint file_descriptor,
-                                                     jstring lyric) {
-    TagLib::FileStream fileStream(file_descriptor, false);
-    TagLib::FileRef fileRef(&fileStream, true, TagLib::AudioProperties::ReadStyle::Fast);
-    if (fileRef.isNull()) return JNI_FALSE;
-
-    auto lyricStr = env->GetStringUTFChars(lyric, nullptr);
-
+void setLyric(JNIEnv *env, TagLib::FileRef &fileRef, jstring lyric) {
     auto map = fileRef.file()->properties();
-    map.replace("LYRICS", TagLib::String(lyricStr, TagLib::String::Type::UTF8));
+    map.replace("LYRICS", fromJString(env, lyric));
     fileRef.file()->setProperties(map);
-
-    return fileRef.file()->save() ? JNI_TRUE : JNI_FALSE;
 }
 
-extern "C"
-JNIEXPORT jobject JNICALL
-Java_com_lalilu_lmedia_wrapper_Taglib_retrieveMetadataWithFD(JNIEnv *env, jobject thiz,
-                                                             jint file_descriptor) {
-    TagLib::FileStream fileStream(file_descriptor, true);
-    TagLib::FileRef fileRef(&fileStream, true, TagLib::AudioProperties::ReadStyle::Fast);
-    if (fileRef.isNull()) return nullptr;           // 文件读取失败，返回空
+// 只对音频数据计算摘要，标签的修改不影响结果，可用于查找重复的音频。
+// 较大的音频数据由多个线程通过 pread 分段读取
+jstring getAudioHash(JNIEnv *env, TagLib::FileRef &fileRef, int file_descriptor) {
+    auto hash = TagLib::AudioPayload::hash(fileRef.file(), file_descriptor);
+    if (hash.isEmpty()) return nullptr;
 
+    return toString(env, TagLib::String(hash.toHex()));
+}
+
+jobject getMetadata(JNIEnv *env, TagLib::FileRef &fileRef, int file_descriptor,
+                    jlong handle = 0) {
     auto tag = fileRef.tag();
     auto map = tag->properties();
     auto audioProperties = fileRef.audioProperties();
+    // 只统计歌词与封面的大小，内容由 getLyric / getPicture 按需获取。
+    // 封面与 getPicture 一致，只加载这一张；其余图片只计数，不读取数据
+    auto pictures = fileRef.complexProperties("PICTURE", TagLib::Tag::FrontCoverOrFirst);
 
 //    for (auto item = map.cbegin(); item != map.cend(); ++item) {
 //        LOGE("[%s]\n", item->first.toCString(true));
@@ -70,7 +77,7 @@ Java_com_lalilu_lmedia_wrapper_Taglib_retrieveMetadataWithFD(JNIEnv *env, jobjec
     auto album_str = toString(env, tag->album());
     auto artist_str = toString(env, tag->artist());
     auto comment_str = toString(env, tag->comment());
-    auto duration = (jlong) audioProperties->lengthInMilliseconds();
+    auto duration = (jlong) (audioProperties ? audioProperties->lengthInMilliseconds() : 0);
     auto track_num = toString(env, to_string(tag->track()));
     auto disc_num = toString(env, map["DISCNUMBER"].toString());
     auto album_artist_str = toString(env, map["ALBUMARTIST"].toString());
@@ -79,12 +86,32 @@ Java_com_lalilu_lmedia_wrapper_Taglib_retrieveMetadataWithFD(JNIEnv *env, jobjec
     auto genre_str = toString(env, map["GENRE"].toString());
     auto date = toString(env, map["DATE"].toString());
 
+    auto bitrate = (jint) (audioProperties ? audioProperties->bitrate() : 0);
+    auto sample_rate = (jint) (audioProperties ? audioProperties->sampleRate() : 0);
+    auto channels = (jint) (audioProperties ? audioProperties->channels() : 0);
+    auto duration_accuracy = (jint) (audioProperties ? audioProperties->lengthAccuracy()
+                                                     : TagLib::AudioProperties::Unknown);
+
+    auto lyrics = map.value("LYRICS");
+    auto lyric_length = (jint) (lyrics.isEmpty() ? 0 : lyrics.front().size());
+    auto has_lyrics = lyric_length > 0 ? JNI_TRUE : JNI_FALSE;
+
+    auto picture_count = (jint) fileRef.complexPropertyCount("PICTURE");
+    auto picture_size = (jlong) 0;
+    TagLib::String picture_mime_type;
+    if (!pictures.isEmpty()) {
+        const auto &cover = pictures.front();
+        picture_size = (jlong) cover.value("data").toByteVector().size();
+        picture_mime_type = cover.value("mimeType").toString();
+    }
+    auto picture_mime_type_str = toString(env, picture_mime_type);
+
     // 获取需要创建的jclass
     jclass metadata_class = env->FindClass("com/lalilu/lmedia/entity/Metadata");
 
     // 获取构造器方法ID
     jmethodID constructor = env->GetMethodID(metadata_class, "<init>",
-                                             "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;JJJ)V");
+                                             "(Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;Ljava/lang/String;JJJIIIIZIIJLjava/lang/String;J)V");
 
     // 创建对象传入并参数
     jobject metadata_obj_j = env->NewObject(
@@ -103,28 +130,227 @@ Java_com_lalilu_lmedia_wrapper_Taglib_retrieveMetadataWithFD(JNIEnv *env, jobjec
             date,
             duration,
             dateAdded,
-            dateModified
+            dateModified,
+            bitrate,
+            sample_rate,
+            channels,
+            duration_accuracy,
+            has_lyrics,
+            lyric_length,
+            picture_count,
+            picture_size,
+            picture_mime_type_str,
+            handle
     );
 
     return metadata_obj_j;
 }
 
+jbyteArray getPicture(JNIEnv *env, TagLib::FileRef &fileRef) {
+    // 只取封面一张，FLAC 等格式不会再读取其余图片的数据
+    auto pictures = fileRef.complexProperties("PICTURE", TagLib::Tag::FrontCoverOrFirst);
+    if (pictures.isEmpty()) return nullptr;
+
+    // const 的 ByteVector 调用 data() 不会触发写时复制，直接从解析出的数据拷入 Java 数组
+    const auto picture = pictures.front().value("data").toByteVector();
+    auto length = static_cast<jint>(picture.size());
+
+    jbyteArray bytes = env->NewByteArray(length);
+    env->SetByteArrayRegion(bytes, 0, length, reinterpret_cast<const jbyte *>(picture.data()));
+
+    return bytes;
+}
+
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_getLyricWithFD(JNIEnv *env, jobject thiz,
+                                                     jint file_descriptor) {
+    TagLib::FileStream fileStream(file_descriptor, true, TagLib::FileStream::BorrowDescriptor);
+    TagLib::FileRef fileRef(&fileStream, true, TagLib::AudioProperties::ReadStyle::HeaderOnly,
+                            TagLib::FileRef::ArenaAllocation);
+    if (fileRef.isNull()) return env->NewStringUTF("File is not supported");
+
+    return getLyric(env, fileRef);
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_writeLyricInto(JNIEnv *env, jobject thiz,
+                                                     jint file_descriptor,
+                                                     jstring lyric) {
+    TagLib::FileStream fileStream(file_descriptor, false, TagLib::FileStream::BorrowDescriptor);
+    TagLib::FileRef fileRef(&fileStream, true, TagLib::AudioProperties::ReadStyle::Fast);
+    if (fileRef.isNull()) return JNI_FALSE;
+
+    setLyric(env, fileRef, lyric);
+    return fileRef.file()->save() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_retrieveMetadataWithFD(JNIEnv *env, jobject thiz,
+                                                             jint file_descriptor) {
+    TagLib::FileStream fileStream(file_descriptor, true, TagLib::FileStream::BorrowDescriptor);
+    // 扫描时只读取文件头，FUSE/MTP 上不会为了计算时长而跳到文件末尾，
+    // 估算出的时长通过 Metadata.durationAccuracy 标明
+    TagLib::FileRef fileRef(&fileStream, true, TagLib::AudioProperties::ReadStyle::HeaderOnly,
+                            TagLib::FileRef::ArenaAllocation);
+    if (fileRef.isNull()) return nullptr;           // 文件读取失败，返回空
+
+    return getMetadata(env, fileRef, file_descriptor);
+}
+
 extern "C"
 JNIEXPORT jbyteArray JNICALL
 Java_com_lalilu_lmedia_wrapper_Taglib_getPictureWithFD(JNIEnv *env, jobject thiz,
                                                        jint file_descriptor) {
-    TagLib::FileStream fileStream(file_descriptor, true);
-    TagLib::FileRef fileRef(&fileStream, true, TagLib::AudioProperties::ReadStyle::Fast);
+    TagLib::FileStream fileStream(file_descriptor, true, TagLib::FileStream::BorrowDescriptor);
+    TagLib::FileRef fileRef(&fileStream, true, TagLib::AudioProperties::ReadStyle::HeaderOnly,
+                            TagLib::FileRef::ArenaAllocation);
     if (fileRef.isNull()) return nullptr;           // 文件读取失败，返回空
 
-    auto pictures = fileRef.complexProperties("PICTURE");
-    if (pictures.isEmpty()) return nullptr;
+    return getPicture(env, fileRef);
+}
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_profileIOWithFD(JNIEnv *env, jobject thiz,
+                                                      jint file_descriptor) {
+    TagLib::FileStream fileStream(file_descriptor, true, TagLib::FileStream::BorrowDescriptor);
+    TagLib::TracingIOStream stream(&fileStream, false);
+    {
+        // 与 retrieveMetadataWithFD 相同的读取路径
+        TagLib::FileRef fileRef(&stream, true, TagLib::AudioProperties::ReadStyle::HeaderOnly);
+        if (fileRef.isNull()) return nullptr;
 
-    auto picture = pictures.front().value("data").toByteVector();
-    auto length = static_cast<jint>(picture.size());
+        fileRef.tag()->properties();
+        fileRef.audioProperties();
+    }
+    return toString(env, stream.summary().toString());
+}
 
-    jbyteArray bytes = env->NewByteArray(length);
-    env->SetByteArrayRegion(bytes, 0, length, reinterpret_cast<const jbyte *>(picture.data()));
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_getAudioHashWithFD(JNIEnv *env, jobject thiz,
+                                                         jint file_descriptor) {
+    TagLib::FileStream fileStream(file_descriptor, true, TagLib::FileStream::BorrowDescriptor);
+    TagLib::FileRef fileRef(&fileStream, false, TagLib::AudioProperties::ReadStyle::Fast,
+                            TagLib::FileRef::ArenaAllocation);
+    if (fileRef.isNull()) return nullptr;
 
-    return bytes;
-}
\ No newline at end of file
+    return getAudioHash(env, fileRef, file_descriptor);
+}
+
+// 解析问题计数：由所有线程共享，按格式与问题类型分别累计，直到 resetDiagnostics
+
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_getDiagnostics(JNIEnv *env, jobject thiz) {
+    return toString(env, TagLib::Diagnostics::toString());
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_resetDiagnostics(JNIEnv *env, jobject thiz) {
+    TagLib::Diagnostics::reset();
+}
+
+// 句柄 API：open 解析一次文件，之后的读写都复用 native 层保留的解析结果，直到 close
+
+extern "C"
+JNIEXPORT jlong JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_open(JNIEnv *env, jobject thiz,
+                                           jint file_descriptor) {
+    return handles::Registry::instance().open(file_descriptor);
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_openWithMetadata(JNIEnv *env, jobject thiz,
+                                                       jint file_descriptor) {
+    auto &registry = handles::Registry::instance();
+    const jlong handle = registry.open(file_descriptor);
+    auto file = registry.get(handle);
+    if (!file) return nullptr;
+
+    jobject metadata;
+    {
+        lock_guard<mutex> lock(file->mutex);
+        metadata = getMetadata(env, file->fileRef, file->fd, handle);
+    }
+    if (!metadata) registry.close(handle);
+    return metadata;
+}
+
+extern "C"
+JNIEXPORT jobject JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_getMetadata(JNIEnv *env, jobject thiz,
+                                                  jlong handle) {
+    auto file = handles::Registry::instance().get(handle);
+    if (!file) return nullptr;
+
+    lock_guard<mutex> lock(file->mutex);
+    return getMetadata(env, file->fileRef, file->fd, handle);
+}
+
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_getLyric(JNIEnv *env, jobject thiz,
+                                               jlong handle) {
+    auto file = handles::Registry::instance().get(handle);
+    if (!file) return nullptr;
+
+    lock_guard<mutex> lock(file->mutex);
+    return getLyric(env, file->fileRef);
+}
+
+extern "C"
+JNIEXPORT jbyteArray JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_getPicture(JNIEnv *env, jobject thiz,
+                                                 jlong handle) {
+    auto file = handles::Registry::instance().get(handle);
+    if (!file) return nullptr;
+
+    lock_guard<mutex> lock(file->mutex);
+    return getPicture(env, file->fileRef);
+}
+
+extern "C"
+JNIEXPORT jstring JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_getAudioHash(JNIEnv *env, jobject thiz,
+                                                   jlong handle) {
+    auto file = handles::Registry::instance().get(handle);
+    if (!file) return nullptr;
+
+    lock_guard<mutex> lock(file->mutex);
+    return getAudioHash(env, file->fileRef, file->fd);
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_setLyric(JNIEnv *env, jobject thiz,
+                                               jlong handle, jstring lyric) {
+    auto file = handles::Registry::instance().get(handle);
+    if (!file) return JNI_FALSE;
+
+    lock_guard<mutex> lock(file->mutex);
+    setLyric(env, file->fileRef, lyric);
+    return JNI_TRUE;
+}
+
+extern "C"
+JNIEXPORT jboolean JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_save(JNIEnv *env, jobject thiz,
+                                           jlong handle) {
+    auto file = handles::Registry::instance().get(handle);
+    if (!file) return JNI_FALSE;
+
+    lock_guard<mutex> lock(file->mutex);
+    return file->fileRef.save() ? JNI_TRUE : JNI_FALSE;
+}
+
+extern "C"
+JNIEXPORT void JNICALL
+Java_com_lalilu_lmedia_wrapper_Taglib_close(JNIEnv *env, jobject thiz,
+                                            jlong handle) {
+    handles::Registry::instance().close(handle);
+}
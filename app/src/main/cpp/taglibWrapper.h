@@ -4,9 +4,13 @@
 #include <jni.h>
 #include <string>
 #include <android/log.h>
+#include <audiopayload.h>
 #include <fileref.h>
 #include <tpropertymap.h>
+#include <tdebuglistener.h>
+#include <tdiagnostics.h>
 #include <tfilestream.h>
+#include <ttracingiostream.h>
 #include <sys/stat.h>
 
 #define LOG_TAG "LMEDIA_TAGLIB"
@@ -9,14 +9,10 @@ import com.blankj.utilcode.util.Utils
 import com.lalilu.lddc.entity.Lyric
 import com.lalilu.lddc.entity.Song
 import com.lalilu.lddc.screen.FloatScreenState
-import com.lalilu.lddc.util.LrcParser
 import com.lalilu.lddc.util.LyricResultCache
 import com.lalilu.lddc.util.QrcDecryptor
-import com.lalilu.lddc.util.QrcParser
 import com.lalilu.lddc.util.QrcXmlParser
-import com.lalilu.lddc.util.handleLyricWithTranslation
-import com.lalilu.lddc.util.toLrcContent
-import com.lalilu.lmedia.entity.Metadata
+import com.lalilu.lmedia.wrapper.LyricParser
 import com.lalilu.lmedia.wrapper.Taglib
 import io.ktor.client.HttpClient
 import io.ktor.client.engine.okhttp.OkHttp
@@ -150,21 +146,12 @@ class MainViewModel : ViewModel() {
             val lyric = json.decodeFromJsonElement<Lyric>(jsonElement)
             val lyricContent = QrcDecryptor.decryptLyrics(lyric.lyric)
                 ?.let { QrcXmlParser.parseToLyricContent(it) }
-            val lrcItems = lyricContent?.let {
-                QrcParser.parse(it)
-                    .takeIf { it.isNotEmpty() }
-                    ?.map { it.toLrcItem() }
-                    ?: LrcParser.parseLyric(lyricContent)
-            } ?: emptyList()
-
             val trans = QrcDecryptor.decryptLyrics(lyric.trans)
-                ?.let { LrcParser.parseLyric(it) }
-                ?.takeIf { it.isNotEmpty() }
-                ?: emptyList()
 
-            val resultLyric = lrcItems.handleLyricWithTranslation(trans)
-                .toLrcContent()
-                .takeIf { it.isNotBlank() }
+            // 解析、合并翻译及转换为LRC均在native中一次完成
+            val resultLyric = lyricContent
+                ?.let { LyricParser.toLrc(it, trans) }
+                ?.takeIf { it.isNotBlank() }
                 ?: lyricContent
                 ?: lyric.lyric
 
@@ -179,30 +166,36 @@ class MainViewModel : ViewModel() {
     fun handleUri(uri: Uri) {
         viewModelScope.launch(Dispatchers.IO) {
             val contentResolver = Utils.getApp().contentResolver
-            var metadata: Metadata? = null
-            contentResolver.openFileDescriptor(uri, "rw")
-                ?.use { metadata = Taglib.retrieveMetadataWithFD(it.detachFd()) }
-
-            val keywords = metadata?.keywords()
-                ?.takeIf { it.isNotBlank() }
+            // 只解析一次文件，写入歌词时复用同一份解析结果
+            val metadata = contentResolver.openFileDescriptor(uri, "rw")
+                ?.use { Taglib.openWithMetadata(it.fd) }
                 ?: return@launch run {
                     floatScreenState.value = FloatScreenState.Error("获取歌曲信息失败")
                 }
+            val handle = metadata.handle
 
-            floatScreenState.value = FloatScreenState.Searching(keywords)
+            try {
+                val keywords = metadata.keywords()
+                    .takeIf { it.isNotBlank() }
+                    ?: return@launch run {
+                        floatScreenState.value = FloatScreenState.Error("获取歌曲信息失败")
+                    }
 
-            val str = searchAndGetLyric(keywords)
-                .getOrNull()
-                ?: return@launch run {
-                    floatScreenState.value = FloatScreenState.Error("获取歌词失败")
-                }
+                floatScreenState.value = FloatScreenState.Searching(keywords)
 
-            var writeResult = false
-            contentResolver.openFileDescriptor(uri, "rw")
-                ?.use { writeResult = Taglib.writeLyricInto(it.detachFd(), str) }
+                val str = searchAndGetLyric(keywords)
+                    .getOrNull()
+                    ?: return@launch run {
+                        floatScreenState.value = FloatScreenState.Error("获取歌词失败")
+                    }
 
-            floatScreenState.value = if (writeResult) FloatScreenState.Success
-            else FloatScreenState.Error("写入歌词失败")
+                val writeResult = Taglib.setLyric(handle, str) && Taglib.save(handle)
+
+                floatScreenState.value = if (writeResult) FloatScreenState.Success
+                else FloatScreenState.Error("写入歌词失败")
+            } finally {
+                Taglib.close(handle)
+            }
         }
     }
 
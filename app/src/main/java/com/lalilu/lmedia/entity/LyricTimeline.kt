@@ -0,0 +1,33 @@
+package com.lalilu.lmedia.entity
+
+/**
+ * 由 native 解析得到的歌词时间轴，以数组结构存储，所有文本共享同一个字符串 [text]
+ *
+ * 第 i 行的文本为 text[lineTextOffset[i], lineTextOffset[i + 1])，
+ * 其逐字下标范围为 [lineWordOffset[i], lineWordOffset[i + 1])
+ */
+class LyricTimeline(
+    val text: String,
+    val lineStart: LongArray,
+    val lineDuration: LongArray,
+    val lineTextOffset: IntArray,
+    val lineWordOffset: IntArray,
+    val wordStart: LongArray,
+    val wordDuration: LongArray,
+    val wordTextOffset: IntArray,
+    val wordTextLength: IntArray,
+) {
+    val lineCount: Int get() = lineStart.size
+    val wordCount: Int get() = wordStart.size
+
+    fun lineText(index: Int): String =
+        text.substring(lineTextOffset[index], lineTextOffset[index + 1])
+
+    fun lineWords(index: Int): IntRange =
+        lineWordOffset[index] until lineWordOffset[index + 1]
+
+    fun wordText(index: Int): String =
+        text.substring(wordTextOffset[index], wordTextOffset[index] + wordTextLength[index])
+
+    fun wordEndTime(index: Int): Long = wordStart[index] + wordDuration[index]
+}
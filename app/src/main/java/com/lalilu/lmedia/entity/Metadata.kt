@@ -14,8 +14,32 @@ data class Metadata(
     val date: String,
     val duration: Long,
     val dateAdded: Long,
-    val dateModified: Long
+    val dateModified: Long,
+    val bitrate: Int = 0,           // kb/s
+    val sampleRate: Int = 0,        // Hz
+    val channels: Int = 0,
+    /**
+     * duration 的可靠程度，取值为 DURATION_* 常量。扫描时只读取文件头，
+     * 部分格式的时长由码率与文件大小估算
+     */
+    val durationAccuracy: Int = DURATION_EXACT,
+    val hasLyrics: Boolean = false,
+    val lyricLength: Int = 0,       // 字符数
+    val pictureCount: Int = 0,
+    val pictureSize: Long = 0,      // 第一张封面的字节数
+    val pictureMimeType: String = "",
+    /**
+     * 通过句柄 API 获取时为对应的句柄，可用于按需读取歌词与封面，否则为 0
+     */
+    val handle: Long = 0
 ) {
+    companion object {
+        // 与 TagLib::AudioProperties::Accuracy 的取值一致
+        const val DURATION_EXACT = 0
+        const val DURATION_ESTIMATED = 1
+        const val DURATION_UNKNOWN = 2
+    }
+
     fun keywords(): String {
         return "$title $artist $album".replace("null", "")
     }
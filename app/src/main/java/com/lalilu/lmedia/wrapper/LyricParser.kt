@@ -0,0 +1,18 @@
+package com.lalilu.lmedia.wrapper
+
+import com.lalilu.lmedia.entity.LyricTimeline
+
+object LyricParser {
+
+    external fun parseQrc(lyric: String): LyricTimeline?
+    external fun parseLrc(lyric: String): LyricTimeline?
+
+    /**
+     * 解析歌词（优先QRC，失败则按LRC解析），合并翻译后直接输出LRC文本
+     */
+    external fun toLrc(lyric: String, translation: String?): String?
+
+    init {
+        System.loadLibrary("taglib")
+    }
+}
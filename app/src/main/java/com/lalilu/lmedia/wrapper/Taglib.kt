@@ -2,15 +2,69 @@ package com.lalilu.lmedia.wrapper
 
 import com.lalilu.lmedia.entity.Metadata
 
+/**
+ * 所有 *WithFD 方法仅借用传入的文件描述符，native 层不会关闭它，
+ * 由调用方负责关闭(例如 ParcelFileDescriptor.use)
+ */
 object Taglib {
 
     external suspend fun retrieveMetadataWithFD(fileDescriptor: Int): Metadata?
     external suspend fun getLyricWithFD(fileDescriptor: Int): String?
     external suspend fun getPictureWithFD(fileDescriptor: Int): ByteArray?
 
+    /**
+     * 按 retrieveMetadataWithFD 的方式读取一次文件，返回期间的 I/O 统计(JSON)
+     */
+    external suspend fun profileIOWithFD(fileDescriptor: Int): String?
+
+    /**
+     * 返回音频数据(不含标签)的摘要，格式为 16 位十六进制字符串。两个文件的音频数据相同时摘要相同，
+     * 与标签无关，可用于查找重复的音频或确认写入歌词没有改动音频。
+     * 支持 MP3、FLAC、MP4、WAV、AIFF、DSF 与 Ogg，其他格式返回 null
+     */
+    external suspend fun getAudioHashWithFD(fileDescriptor: Int): String?
+
+    /**
+     * 返回自进程启动或上次 resetDiagnostics 以来，解析文件时遇到的问题计数(JSON)，
+     * 按格式与问题类型分组，只包含非零项，例如 {"mp4":{"truncated":2}}。
+     * 计数由所有线程共享，扫描媒体库时可在扫描前后各取一次
+     */
+    external fun getDiagnostics(): String
+    external fun resetDiagnostics()
+
     // TODO 加suspend 会异常
     external fun writeLyricInto(fileDescriptor: Int, lyric: String): Boolean
 
+    /**
+     * 句柄 API：open 只解析一次文件，native 层保留解析结果，之后的读取与写入都基于它，
+     * 直到 close。open 会复制传入的文件描述符，调用方在 open 返回后即可关闭原描述符。
+     *
+     * 同时打开的句柄有数量上限，超出时最久未使用的句柄会被自动关闭，
+     * 之后对它的调用与对无效句柄的调用一样返回 null / false。
+     *
+     * @return 句柄，文件无法解析时返回 0
+     */
+    external fun open(fileDescriptor: Int): Long
+
+    /**
+     * 相当于 open 后立即 getMetadata，只解析一次文件。歌词与封面只统计了大小，
+     * 需要时通过 Metadata.handle 调用 getLyric / getPicture 获取，用完后需要 close
+     *
+     * @return 文件无法解析时返回 null，此时没有需要关闭的句柄
+     */
+    external fun openWithMetadata(fileDescriptor: Int): Metadata?
+    external fun getMetadata(handle: Long): Metadata?
+    external fun getLyric(handle: Long): String?
+    external fun getPicture(handle: Long): ByteArray?
+    external fun getAudioHash(handle: Long): String?
+
+    /**
+     * 仅修改内存中的标签，需要调用 save 写入文件
+     */
+    external fun setLyric(handle: Long, lyric: String): Boolean
+    external fun save(handle: Long): Boolean
+    external fun close(handle: Long)
+
     init {
         System.loadLibrary("taglib")
     }